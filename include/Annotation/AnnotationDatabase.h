@@ -0,0 +1,130 @@
+#pragma once
+
+#include "Annotation/ArgPosition.h"
+
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/ADT/StringRef.h>
+#include <llvm/Support/MemoryBuffer.h>
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace llvm
+{
+	class raw_ostream;
+}
+
+namespace annotation
+{
+
+// Precompiled binary form of an annotation file, which loads without running the text parser
+// A database consists of:
+//   - a 24-byte header: the magic string, the table kind, the record size, and the number of entries, string table bytes and records, all 4-byte little endian
+//   - one 16-byte entry per function, sorted by name: the offset and length of the name in the string table, the index of the first record and the number of records
+//   - the string table
+//   - the records, each a fixed-size effect whose layout is up to the table kind
+// Databases are built by the table tool. loadFromFile() of every annotation table prefers "<file>.db" over "<file>" when the former is at least as new as the latter
+
+enum class AnnotationKind: std::uint8_t
+{
+	Pointer,
+	ModRef,
+	Taint,
+};
+
+using AnnotationRecord = std::array<std::uint8_t, 8>;
+
+class AnnotationDatabaseWriter
+{
+private:
+	struct Entry
+	{
+		std::string name;
+		std::vector<AnnotationRecord> records;
+	};
+
+	AnnotationKind kind;
+	std::vector<Entry> entries;
+public:
+	AnnotationDatabaseWriter(AnnotationKind k): kind(k) {}
+
+	void addEntry(const llvm::StringRef& name, std::vector<AnnotationRecord> records);
+
+	void write(llvm::raw_ostream&);
+	// Write to a file and exit with an error message if that fails
+	void writeToFile(const char* fileName);
+};
+
+class AnnotationDatabaseReader
+{
+private:
+	const std::uint8_t* entryTable;
+	const char* stringTable;
+	const AnnotationRecord* records;
+	std::uint32_t numEntries;
+public:
+	// Validate the buffer and exit with an error message if it is not a well-formed database of the given kind
+	AnnotationDatabaseReader(const llvm::StringRef& buffer, AnnotationKind kind);
+
+	std::uint32_t getNumEntries() const { return numEntries; }
+	llvm::StringRef getName(std::uint32_t) const;
+	llvm::ArrayRef<AnnotationRecord> getRecords(std::uint32_t) const;
+	// Return the index of the entry with the given name, or getNumEntries() if there is none
+	std::uint32_t findEntry(const llvm::StringRef& name) const;
+
+	static bool isDatabase(const llvm::StringRef& buffer);
+};
+
+// The summaries of a database, served from the loaded file itself: the names stay in the buffer and are found by a binary search over the sorted entry table, so that loading neither copies nor hashes them. Only the records are decoded, once per entry, by decode(record, summary)
+template <typename SummaryType>
+class AnnotationDatabaseTable
+{
+private:
+	std::unique_ptr<llvm::MemoryBuffer> buffer;
+	AnnotationDatabaseReader reader;
+	std::vector<SummaryType> summaries;
+public:
+	template <typename DecodeFunc>
+	AnnotationDatabaseTable(std::unique_ptr<llvm::MemoryBuffer> b, AnnotationKind kind, DecodeFunc&& decode): buffer(std::move(b)), reader(buffer->getBuffer(), kind), summaries(reader.getNumEntries())
+	{
+		for (std::uint32_t i = 0; i < reader.getNumEntries(); ++i)
+			for (auto const& record: reader.getRecords(i))
+				decode(record, summaries[i]);
+	}
+
+	std::uint32_t size() const { return reader.getNumEntries(); }
+	llvm::StringRef getName(std::uint32_t i) const { return reader.getName(i); }
+	const SummaryType& getSummary(std::uint32_t i) const { return summaries[i]; }
+
+	const SummaryType* lookup(const llvm::StringRef& name) const
+	{
+		auto i = reader.findEntry(name);
+		if (i == reader.getNumEntries())
+			return nullptr;
+		return &summaries[i];
+	}
+};
+
+// Print an error message and exit. Decoders of the table kinds use this to reject records with an out-of-range field
+void reportMalformedDatabase(const char* reason);
+
+// Return a record byte as an enumerator of E, all of whose enumerators are at most last, and reject the database if the byte is out of range
+template <typename E>
+E decodeEnum(std::uint8_t byte, E last, const char* reason)
+{
+	if (byte > static_cast<std::uint8_t>(last))
+		reportMalformedDatabase(reason);
+	return static_cast<E>(byte);
+}
+
+// Return the content of "<fileName>.db" if it is at least as new as fileName, and the content of fileName otherwise
+std::unique_ptr<llvm::MemoryBuffer> readAnnotationFile(const char* fileName);
+std::string getAnnotationDatabaseName(const llvm::StringRef& fileName);
+
+// Positions take two bytes in a record. An argument index has to fit in the second one
+void encodePosition(const APosition&, std::uint8_t* out);
+APosition decodePosition(const std::uint8_t* in);
+
+}
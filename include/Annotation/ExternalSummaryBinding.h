@@ -0,0 +1,37 @@
+#pragma once
+
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/IR/Module.h>
+
+namespace annotation
+{
+
+// The summaries of all external functions of one module, resolved once up front so that the engines can look them up by llvm::Function instead of hashing the function name on every call
+// Every function declared in the bound module maps to its summary, or to nullptr if the annotation file has none. Summaries are referenced, not copied, so a binding is only valid as long as the table it was built from
+template <typename SummaryType>
+class ExternalSummaryBinding
+{
+private:
+	llvm::DenseMap<const llvm::Function*, const SummaryType*> summaryMap;
+public:
+	template <typename TableType>
+	void bind(const llvm::Module& module, const TableType& table)
+	{
+		summaryMap.clear();
+		for (auto const& f: module)
+			if (f.isDeclaration())
+				summaryMap[&f] = table.lookup(f.getName().str());
+	}
+
+	// Return true and set summary if f belongs to the bound module
+	bool lookup(const llvm::Function* f, const SummaryType*& summary) const
+	{
+		auto itr = summaryMap.find(f);
+		if (itr == summaryMap.end())
+			return false;
+		summary = itr->second;
+		return true;
+	}
+};
+
+}
@@ -1,11 +1,16 @@
 #pragma once
 
+#include "Annotation/AnnotationDatabase.h"
+#include "Annotation/ExternalSummaryBinding.h"
 #include "Annotation/ModRef/ModRefEffectSummary.h"
 
+#include <memory>
 #include <unordered_map>
 
 namespace llvm
 {
+	class Function;
+	class Module;
 	class StringRef;
 }
 
@@ -16,21 +21,39 @@ class ExternalModRefTable
 {
 private:
 	using MapType = std::unordered_map<std::string, ModRefEffectSummary>;
-	MapType table;
+	// The entries of a text file or of a database, whichever the table was loaded from. Copies of a table share them, which makes handing a loaded table to one analysis after another cheap. Only the module binding belongs to each copy
+	std::shared_ptr<const MapType> table;
+	std::shared_ptr<const AnnotationDatabaseTable<ModRefEffectSummary>> database;
+	ExternalSummaryBinding<ModRefEffectSummary> binding;
 
 	static ExternalModRefTable buildTable(const llvm::StringRef&);
+	static ExternalModRefTable loadFromDatabase(std::unique_ptr<llvm::MemoryBuffer>);
 public:
-	using const_iterator = MapType::const_iterator;
-
 	ExternalModRefTable() = default;
 
 	const ModRefEffectSummary* lookup(const llvm::StringRef&) const;
-
-	const_iterator begin() const { return table.begin(); }
-	const_iterator end() const { return table.end(); }
-	size_t size() const { return table.size(); }
-
+	// Functions of the bound module are looked up without touching their names. Any other function falls back to lookup by name
+	const ModRefEffectSummary* lookup(const llvm::Function*) const;
+
+	// Resolve the summaries of all external functions of the module. A copy of the table made afterwards keeps the binding
+	void bindModule(const llvm::Module&);
+
+	// Call cb(name, summary) on every function in the table
+	template <typename Callback>
+	void forEachSummary(Callback&& cb) const
+	{
+		if (table)
+			for (auto const& mapping: *table)
+				cb(llvm::StringRef(mapping.first), mapping.second);
+		if (database)
+			for (std::uint32_t i = 0; i < database->size(); ++i)
+				cb(database->getName(i), database->getSummary(i));
+	}
+	size_t size() const { return (table ? table->size() : 0) + (database ? database->size() : 0); }
+
+	// Load the annotation file, or its precompiled database if that is up to date. See AnnotationDatabase.h
 	static ExternalModRefTable loadFromFile(const char* fileName);
+	void writeDatabase(const char* fileName) const;
 };
 
 }
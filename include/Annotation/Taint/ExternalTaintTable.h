@@ -1,9 +1,12 @@
 #pragma once
 
+#include "Annotation/AnnotationDatabase.h"
+#include "Annotation/ExternalSummaryBinding.h"
 #include "Annotation/Taint/TaintSummary.h"
 
 #include <llvm/ADT/StringRef.h>
 
+#include <memory>
 #include <unordered_map>
 
 namespace annotation
@@ -12,21 +15,40 @@ namespace annotation
 class ExternalTaintTable
 {
 private:
-	std::unordered_map<std::string, TaintSummary> summaryMap;
+	using MapType = std::unordered_map<std::string, TaintSummary>;
+	// The entries of a text file or of a database, whichever the table was loaded from. Copies of a table share them, which makes handing a loaded table to one analysis after another cheap. Only the module binding belongs to each copy
+	std::shared_ptr<const MapType> summaryMap;
+	std::shared_ptr<const AnnotationDatabaseTable<TaintSummary>> database;
+	ExternalSummaryBinding<TaintSummary> binding;
 
 	static ExternalTaintTable buildTable(const llvm::StringRef&);
+	static ExternalTaintTable loadFromDatabase(std::unique_ptr<llvm::MemoryBuffer>);
 public:
-	using const_iterator = typename decltype(summaryMap)::const_iterator;
-
 	ExternalTaintTable() = default;
 
 	const TaintSummary* lookup(const std::string& name) const;
-
-	const_iterator begin() const { return summaryMap.begin(); }
-	const_iterator end() const { return summaryMap.end(); }
-	size_t size() const { return summaryMap.size(); }
-
+	// Functions of the bound module are looked up without touching their names. Any other function falls back to lookup by name
+	const TaintSummary* lookup(const llvm::Function*) const;
+
+	// Resolve the summaries of all external functions of the module. A copy of the table made afterwards keeps the binding
+	void bindModule(const llvm::Module&);
+
+	// Call cb(name, summary) on every function in the table
+	template <typename Callback>
+	void forEachSummary(Callback&& cb) const
+	{
+		if (summaryMap)
+			for (auto const& mapping: *summaryMap)
+				cb(llvm::StringRef(mapping.first), mapping.second);
+		if (database)
+			for (std::uint32_t i = 0; i < database->size(); ++i)
+				cb(database->getName(i), database->getSummary(i));
+	}
+	size_t size() const { return (summaryMap ? summaryMap->size() : 0) + (database ? database->size() : 0); }
+
+	// Load the annotation file, or its precompiled database if that is up to date. See AnnotationDatabase.h
 	static ExternalTaintTable loadFromFile(const char* fileName);
+	void writeDatabase(const char* fileName) const;
 };
 
 }	// end of taint
@@ -13,7 +13,13 @@ class AdaptiveContext
 private:
 	static std::unordered_set<ProgramPoint> trackedCallsites;
 public:
-	static void trackCallSite(const ProgramPoint&);
+	// Return true if the call site was not tracked before
+	static bool trackCallSite(const ProgramPoint&);
+	static bool isTrackedCallSite(const ProgramPoint& pp) { return trackedCallsites.count(pp); }
+	static size_t getNumTrackedCallSites() { return trackedCallsites.size(); }
+	static bool hasTrackedCallSites() { return !trackedCallsites.empty(); }
+	// Tracked call sites refer to contexts, so they have to go along with Context::releaseContexts()
+	static void clearTrackedCallSites() { trackedCallsites.clear(); }
 
 	static const Context* pushContext(const Context*, const llvm::Instruction*);
 	static const Context* pushContext(const ProgramPoint&);
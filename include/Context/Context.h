@@ -1,10 +1,11 @@
 #pragma once
 
+#include "Util/DataStructure/ConcurrentTrieNode.h"
 #include "Util/Hashing.h"
 
 #include <llvm/IR/Instruction.h>
 
-#include <unordered_set>
+#include <vector>
 
 namespace context
 {
@@ -12,7 +13,8 @@ namespace context
 class ProgramPoint;
 
 // This class represents a particualr calling context, which is represented by a stack of callsites
-class Context
+// Contexts are interned in a trie rooted at the global context, so two equal contexts are always the same object
+class Context: public util::ConcurrentTrieNode<Context>
 {
 private:
 	// The call stack is implemented by a linked list
@@ -20,9 +22,9 @@ private:
 	const Context* predContext;
 	size_t sz;
 
-	static std::unordered_set<Context> ctxSet;
+	static Context globalCtx;
 
-	Context(): callSite(nullptr), predContext(nullptr), sz(0) {}
+	constexpr Context(): callSite(nullptr), predContext(nullptr), sz(0) {}
 	Context(const llvm::Instruction* c, const Context* p): callSite(c), predContext(p), sz(p == nullptr ? 1 : p->sz + 1) {}
 public:
 	const llvm::Instruction* getCallSite() const { return callSite; }
@@ -44,6 +46,8 @@ public:
 	static const Context* getGlobalContext();
 
 	static std::vector<const Context*> getAllContexts();
+	// Delete every context but the global one. Contexts refer to call sites by pointer, so a tool that analyzes several modules in turn calls this once the contexts of a module are no longer used, before the module itself goes away
+	static void releaseContexts();
 	friend struct std::hash<Context>;
 };
 
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Dynamic/Analysis/DynamicPointer.h"
+
+#include <cstdint>
+#include <map>
+
+namespace dynamic
+{
+
+// Maps the start address of every live allocation to its allocation site and size. An address belongs to the allocation with the closest start address at or below it, provided it lies within that allocation's size. An allocation of unknown size (size 0, as in v1 logs) is taken to extend up to the next allocation
+// Consecutive lookups tend to hit the same allocation, so the address range of the last hit is cached. Inserting or erasing an allocation shrinks or drops the cached range as needed, which keeps the cache valid without any rescan
+class AddressIndex
+{
+public:
+	struct Allocation
+	{
+		DynamicPointer ptr;
+		std::uint64_t size;
+	};
+private:
+	using MapType = std::map<std::uintptr_t, Allocation>;
+	MapType addrMap;
+
+	bool cacheValid;
+	std::uintptr_t cacheBegin, cacheEnd;
+	MapType::const_iterator cacheItr;
+
+	static std::uintptr_t toInt(const void* addr) { return reinterpret_cast<std::uintptr_t>(addr); }
+public:
+	using value_type = MapType::value_type;
+
+	AddressIndex(): cacheValid(false), cacheBegin(0), cacheEnd(0) {}
+	// The cached iterator must not point into another map
+	AddressIndex(const AddressIndex& other): addrMap(other.addrMap), cacheValid(false), cacheBegin(0), cacheEnd(0) {}
+	AddressIndex(AddressIndex&&) = default;
+	AddressIndex& operator=(const AddressIndex& other)
+	{
+		addrMap = other.addrMap;
+		cacheValid = false;
+		return *this;
+	}
+	AddressIndex& operator=(AddressIndex&&) = default;
+
+	// An existing allocation at the same address is replaced
+	void insert(const void* addr, std::uint64_t size, const DynamicPointer& ptr);
+	// Return false if there is no allocation starting at addr
+	bool erase(const void* addr);
+
+	// Return the allocation starting exactly at addr, or nullptr if there is none
+	const value_type* find(const void* addr) const;
+	// Return the allocation addr falls into, or nullptr if addr lies outside all live allocations
+	const value_type* lookup(const void* addr);
+
+	std::size_t size() const { return addrMap.size(); }
+};
+
+}
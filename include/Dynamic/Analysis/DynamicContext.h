@@ -1,14 +1,13 @@
 #pragma once
 
+#include "Util/DataStructure/ConcurrentTrieNode.h"
 #include "Util/Hashing.h"
 
-#include <unordered_set>
-
 namespace dynamic
 {
 
-// Dynamic version of Context
-class DynamicContext
+// Dynamic version of Context. It is interned in the same way, so replay threads can push contexts without locking
+class DynamicContext: public util::ConcurrentTrieNode<DynamicContext>
 {
 private:
 	using CallSiteType = unsigned;
@@ -17,10 +16,9 @@ private:
 	const DynamicContext* predContext;
 	size_t depth;
 
-	static std::unordered_set<DynamicContext> ctxSet;
-	static const DynamicContext* globalCtx;
+	static DynamicContext globalCtx;
 
-	DynamicContext(): callSite(0), predContext(nullptr), depth(0) {}
+	constexpr DynamicContext(): callSite(0), predContext(nullptr), depth(0) {}
 	DynamicContext(CallSiteType c, const DynamicContext* p): callSite(c), predContext(p), depth(p == nullptr ? 1 : p->depth + 1) {}
 public:
 	CallSiteType getCallSite() const { return callSite; }
@@ -1,34 +1,68 @@
 #pragma once
 
+#include "Dynamic/Analysis/AddressIndex.h"
 #include "Dynamic/Analysis/DynamicMemoryObject.h"
 #include "Dynamic/Instrument/AllocType.h"
+#include "Util/Hashing.h"
 
-#include <map>
+#include <cstdint>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace dynamic
 {
 
+// One change to the live allocations, as made by the DynamicMemory method of the same name. Applying the changes recorded between two points of a replay to the memory at the first point yields the memory at the second, which is much cheaper than keeping a copy of the memory at every point of interest
+struct MemoryDelta
+{
+	enum class Kind: std::uint8_t
+	{
+		Allocate,
+		DeallocateStack,
+		DeallocateHeap,
+		Reallocate,
+	};
+
+	Kind kind;
+	AllocType allocType;
+	unsigned threadId;
+	// The context and id of the allocation site for Allocate, and the context of the frame for DeallocateStack
+	const DynamicContext* ctx;
+	unsigned id;
+	const void* addr;
+	// The new address for Reallocate
+	const void* newAddr;
+	// The size of the block for Allocate and Reallocate, or 0 if it is unknown
+	std::uint64_t size;
+};
+
 class DynamicMemory
 {
 private:
-	using AllocMapType = std::map<const void*, DynamicPointer>;
-	AllocMapType allocMap;
+	AddressIndex allocMap;
 
-	using ContextMapType = std::unordered_map<const DynamicContext*, std::vector<const void*>>;
+	// Stack allocations are grouped by the frame they belong to. Threads running in the same context still have frames of their own, hence the thread id in the key
+	using FrameKey = std::pair<unsigned, const DynamicContext*>;
+	using ContextMapType = std::unordered_map<FrameKey, std::vector<const void*>, util::PairHasher<FrameKey>>;
 	ContextMapType stackCtxMap;
 
-	DynamicMemoryObject insertAllocMap(const DynamicPointer&, const void*);
-	DynamicMemoryObject allocateGlobal(const DynamicPointer&, const void*);
-	DynamicMemoryObject allocateStack(const DynamicPointer&, const void*);
-	DynamicMemoryObject allocateHeap(const DynamicPointer&, const void*);
+	DynamicMemoryObject insertAllocMap(const DynamicPointer&, const void*, std::uint64_t);
+	DynamicMemoryObject allocateGlobal(const DynamicPointer&, const void*, std::uint64_t);
+	DynamicMemoryObject allocateStack(const DynamicPointer&, const void*, std::uint64_t, unsigned);
+	DynamicMemoryObject allocateHeap(const DynamicPointer&, const void*, std::uint64_t);
 public:
 	DynamicMemory() = default;
 
-	DynamicMemoryObject allocate(AllocType type, const DynamicPointer&, const void*);
+	// A size of 0 means that the size is unknown
+	DynamicMemoryObject allocate(AllocType type, const DynamicPointer&, const void*, std::uint64_t size, unsigned threadId);
+	// Addresses outside every live allocation map to the null object
 	DynamicMemoryObject getMemoryObject(const void*);
-	void deallocateStack(const DynamicContext*);
+	void deallocateStack(const DynamicContext*, unsigned threadId);
+	void deallocateHeap(const void*);
+	void reallocateHeap(const void*, const void*, std::uint64_t);
+
+	void apply(const MemoryDelta&);
 };
 
 }
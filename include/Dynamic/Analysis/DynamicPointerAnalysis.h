@@ -1,37 +1,34 @@
 #pragma once
 
-#include "Dynamic/Analysis/DynamicMemory.h"
+#include "Dynamic/Analysis/DynamicReplayer.h"
 #include "Dynamic/Log/LogProcessor.h"
 
+#include <cstddef>
+
 namespace dynamic
 {
 
-class DynamicContext;
-
 class DynamicPointerAnalysis: public LogProcessor<DynamicPointerAnalysis>
 {
 private:
-	using MapType = std::unordered_map<DynamicPointer, DynamicMemoryObject>;
-	MapType ptsMap;
-
-	DynamicMemory memory;
-	const DynamicContext* currCtx;
-	unsigned callerId;
-
-	void setPointsTo(const DynamicPointer&, const DynamicMemoryObject&);
+	DynamicReplayer replayer;
 public:
-	using const_iterator = MapType::const_iterator;
-
 	DynamicPointerAnalysis(const char* fileName);
 
-	void visitAllocRecord(const AllocRecord&);
-	void visitPointerRecord(const PointerRecord&);
-	void visitEnterRecord(const EnterRecord&);
-	void visitExitRecord(const ExitRecord&);
-	void visitCallRecord(const CallRecord&);
+	// Replay the log with numThreads threads. A sequential pass first takes a checkpoint every segmentSize records, and the segments between checkpoints are then replayed in parallel. The merged facts are identical to the ones of process()
+	void processParallel(unsigned numThreads, std::size_t segmentSize);
+
+	void visitAllocRecord(const AllocRecord& rec) { replayer.visitAllocRecord(rec); }
+	void visitPointerRecord(const PointerRecord& rec) { replayer.visitPointerRecord(rec); }
+	void visitEnterRecord(const EnterRecord& rec) { replayer.visitEnterRecord(rec); }
+	void visitExitRecord(const ExitRecord& rec) { replayer.visitExitRecord(rec); }
+	void visitCallRecord(const CallRecord& rec) { replayer.visitCallRecord(rec); }
+	void visitFreeRecord(const FreeRecord& rec) { replayer.visitFreeRecord(rec); }
+	void visitReallocRecord(const ReallocRecord& rec) { replayer.visitReallocRecord(rec); }
+	void visitThreadRecord(const ThreadRecord& rec) { replayer.visitThreadRecord(rec); }
 
-	const_iterator begin() const { return ptsMap.begin(); }
-	const_iterator end() const { return ptsMap.end(); }
+	// Every (pointer, allocation site) pair observed in the log
+	const PointsToFactSet& getPointsToFacts() const { return replayer.getPointsToFacts(); }
 };
 
 }
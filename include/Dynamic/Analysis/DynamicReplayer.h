@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Dynamic/Analysis/DynamicMemory.h"
+#include "Dynamic/Analysis/PointsToFactSet.h"
+#include "Dynamic/Log/LogVisitor.h"
+
+#include <vector>
+
+namespace dynamic
+{
+
+class DynamicContext;
+
+// Replays log records against the dynamic memory model. The replayer is a plain value: copying it takes a snapshot of the current context and of all live allocations, from which the replay can later be resumed
+// A snapshot of the live allocations gets expensive as the program allocates more. A replayer with a journal attached therefore leaves its memory alone and appends the changes to the journal instead. Its copies then only hold the context, and the memory at any of them can be rebuilt from an earlier memory and the journal entries in between
+class DynamicReplayer: public LogConstVisitor<DynamicReplayer>
+{
+private:
+	DynamicMemory memory;
+	const DynamicContext* currCtx;
+	unsigned callerId;
+
+	// The log may interleave the records of several threads (see ThreadedLogReader). currCtx and callerId belong to currThread, and the other threads keep theirs here, indexed by thread id
+	struct ThreadState
+	{
+		const DynamicContext* ctx;
+		unsigned callerId;
+	};
+	std::vector<ThreadState> threadStates;
+	unsigned currThread;
+
+	// When disabled, only the context and the live allocations are tracked. This is all a checkpointing pass needs, and it lets the pass skip the address lookup of pointer records
+	bool trackPointsTo;
+	PointsToFactSet facts;
+
+	std::vector<MemoryDelta>* journal;
+
+	void setPointsTo(const DynamicPointer&, const DynamicMemoryObject&);
+public:
+	DynamicReplayer(bool t = true);
+
+	bool isTrackingPointsTo() const { return trackPointsTo; }
+	void setTrackPointsTo(bool t) { trackPointsTo = t; }
+
+	// Points-to tracking needs the memory, so it must be disabled while a journal is attached
+	std::vector<MemoryDelta>* getJournal() const { return journal; }
+	void setJournal(std::vector<MemoryDelta>* j) { journal = j; }
+
+	DynamicMemory& getMemory() { return memory; }
+	const DynamicMemory& getMemory() const { return memory; }
+
+	PointsToFactSet& getPointsToFacts() { return facts; }
+	const PointsToFactSet& getPointsToFacts() const { return facts; }
+
+	void visitAllocRecord(const AllocRecord&);
+	void visitPointerRecord(const PointerRecord&);
+	void visitEnterRecord(const EnterRecord&);
+	void visitExitRecord(const ExitRecord&);
+	void visitCallRecord(const CallRecord&);
+	void visitFreeRecord(const FreeRecord&);
+	void visitReallocRecord(const ReallocRecord&);
+	void visitThreadRecord(const ThreadRecord&);
+};
+
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Dynamic/Analysis/DynamicPointer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace dynamic
+{
+
+// The set of all (pointer, allocation site) pairs observed during a replay. Both sides are interned into dense 32-bit IDs, and a fact is stored as the two IDs packed into one 64-bit key of an open-addressing hash table
+class PointsToFactSet
+{
+private:
+	std::vector<DynamicPointer> ptrs;
+	std::unordered_map<DynamicPointer, std::uint32_t> ptrIds;
+
+	// Linear probing over a power-of-two sized table that is kept at most half full
+	std::vector<std::uint64_t> table;
+	std::size_t numFacts;
+
+	std::uint32_t intern(const DynamicPointer&);
+	bool insertKey(std::uint64_t);
+	void grow();
+public:
+	PointsToFactSet(): numFacts(0) {}
+
+	// Return true if the fact was not in the set yet
+	bool insert(const DynamicPointer& ptr, const DynamicPointer& allocSite);
+	void merge(const PointsToFactSet&);
+
+	std::size_t size() const { return numFacts; }
+	bool empty() const { return numFacts == 0; }
+
+	// Call cb(ptr, allocSite) on every fact. All facts of the same pointer are visited consecutively
+	template <typename Callback>
+	void forEachFact(Callback&& cb) const
+	{
+		std::vector<std::uint64_t> keys;
+		keys.reserve(numFacts);
+		for (auto key: table)
+			if (key != ~std::uint64_t(0))
+				keys.push_back(key);
+		std::sort(keys.begin(), keys.end());
+
+		for (auto key: keys)
+			cb(ptrs[key >> 32], ptrs[key & 0xffffffffu]);
+	}
+};
+
+}
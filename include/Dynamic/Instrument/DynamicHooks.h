@@ -21,6 +21,8 @@ private:
 	llvm::Function* exitHook;
 	llvm::Function* globalHook;
 	llvm::Function* mainHook;
+	llvm::Function* freeHook;
+	llvm::Function* reallocHook;
 public:
 	DynamicHooks(llvm::Module&);
 
@@ -32,6 +34,8 @@ public:
 	llvm::Function* getExitHook() { return exitHook; }
 	llvm::Function* getGlobalHook() { return globalHook; }
 	llvm::Function* getMainHook() { return mainHook; }
+	llvm::Function* getFreeHook() { return freeHook; }
+	llvm::Function* getReallocHook() { return reallocHook; }
 
 	bool isHook(const llvm::Function*) const;
 };
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <llvm/ADT/DenseSet.h>
+
+namespace llvm
+{
+	class Module;
+	class Value;
+}
+
+namespace dynamic
+{
+
+// Collects the pointer values whose HookPointer call can be left out
+class HookPruner
+{
+private:
+	llvm::DenseSet<const llvm::Value*> prunedValues;
+	unsigned numCopies;
+	unsigned numPrecise;
+public:
+	HookPruner(): numCopies(0), numPrecise(0) {}
+
+	// Prune bitcasts and all-zero GEPs of a hooked pointer whose definition dominates them. Such a copy observes the same address in the same context as its source, and the static analysis gives it the same allocation sites, so its hook adds nothing to verification
+	void pruneTrivialCopies(llvm::Module&);
+	// Prune a value whose runtime target is already known. Note that the value is then trusted rather than checked by pts-verify
+	void prunePreciseValue(const llvm::Value*);
+
+	bool isPruned(const llvm::Value* v) const { return prunedValues.count(v); }
+
+	unsigned getNumPrunedCopies() const { return numCopies; }
+	unsigned getNumPrunedPreciseValues() const { return numPrecise; }
+};
+
+}
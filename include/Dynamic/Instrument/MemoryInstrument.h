@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Annotation/Pointer/ExternalPointerTable.h"
+#include "Dynamic/Instrument/HookPruner.h"
+#include "Dynamic/Instrument/SamplingPolicy.h"
 
 namespace llvm
 {
@@ -14,14 +16,26 @@ class MemoryInstrument
 {
 private:
 	annotation::ExternalPointerTable extTable;
+	SamplingPolicy samplingPolicy;
+
+	HookPruner pruner;
+	unsigned numPointerHooks;
+	unsigned numPrunedHooks;
 public:
-	MemoryInstrument() = default;
+	MemoryInstrument(): samplingPolicy(SamplingPolicy::getAllPolicy()), numPointerHooks(0), numPrunedHooks(0) {}
 
 	void loadExternalTable(const char* fileName)
 	{
 		extTable = annotation::ExternalPointerTable::loadFromFile(fileName);
 	}
 
+	void setSamplingPolicy(const SamplingPolicy& p) { samplingPolicy = p; }
+
+	// Pointer values marked by the pruner get no HookPointer call
+	HookPruner& getHookPruner() { return pruner; }
+	unsigned getNumPointerHooks() const { return numPointerHooks; }
+	unsigned getNumPrunedHooks() const { return numPrunedHooks; }
+
 	void runOnModule(llvm::Module&);
 };
 
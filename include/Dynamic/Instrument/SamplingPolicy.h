@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+
+namespace dynamic
+{
+
+// Decides which executions of a pointer hook site get logged. Every site has its own hit counter, and the decision is made inline in the instrumented code, so a skipped hit costs a load, an add, a store and a branch
+// Only pointer hooks are sampled. Allocation, call, enter and exit hooks are still logged every time, since the replay needs them to track contexts and live memory
+class SamplingPolicy
+{
+public:
+	enum class Mode: std::uint8_t
+	{
+		// Log every hit
+		All,
+		// Log the first `length` hits out of every `period` hits of a site. Periodic sampling is the special case of a length of 1
+		Window,
+		// Log the first `length` hits of a site and nothing afterwards
+		FirstN,
+	};
+private:
+	Mode mode;
+	unsigned period;
+	unsigned length;
+
+	SamplingPolicy(Mode m, unsigned p, unsigned l): mode(m), period(p), length(l) {}
+public:
+	Mode getMode() const { return mode; }
+	unsigned getPeriod() const { return period; }
+	unsigned getLength() const { return length; }
+
+	bool isSamplingAll() const { return mode == Mode::All; }
+
+	static SamplingPolicy getAllPolicy()
+	{
+		return SamplingPolicy(Mode::All, 1, 1);
+	}
+	static SamplingPolicy getPeriodicPolicy(unsigned p)
+	{
+		return getWindowPolicy(p, 1);
+	}
+	static SamplingPolicy getWindowPolicy(unsigned p, unsigned l)
+	{
+		if (p <= 1 || l >= p)
+			return getAllPolicy();
+		return SamplingPolicy(Mode::Window, p, l == 0 ? 1 : l);
+	}
+	static SamplingPolicy getFirstNPolicy(unsigned n)
+	{
+		return SamplingPolicy(Mode::FirstN, 0, n);
+	}
+};
+
+}
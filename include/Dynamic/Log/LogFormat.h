@@ -0,0 +1,211 @@
+#pragma once
+
+// Encoding helpers for the v2 log format. This header is shared by the C runtime and the C++ readers, so everything here is plain C
+//
+// A v1 log is a bare sequence of records: a 1-byte tag followed by the fixed-width fields of LogRecord
+// A v2 log starts with LOG_V2_MAGIC and is followed by a sequence of blocks. Each block consists of:
+//   - LOG_BLOCK_SYNC, which lets a reader find the next block in a damaged file
+//   - a flag byte (LOG_BLOCK_COMPRESSED if the payload is compressed)
+//   - the raw payload size and the stored payload size, both 4-byte little endian
+//   - the payload
+// The payload holds records encoded as the 1-byte tag, the alloc type byte for alloc records, the id (or the sequence number of a sync record) as a varint, each address as the zigzag varint of its difference from the previous address in the same block, and the block size of an alloc or realloc record as a trailing varint. Every block starts with a previous address of 0, so blocks can be decoded independently
+// Compressed payloads use a byte-oriented LZ77 scheme in the style of LZ4 (see logCompressBlock)
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define LOG_V2_MAGIC "PTSLOG\x02\n"
+#define LOG_V2_MAGIC_SIZE 8
+#define LOG_BLOCK_SYNC "\xffPBK"
+#define LOG_BLOCK_SYNC_SIZE 4
+#define LOG_BLOCK_HEADER_SIZE (LOG_BLOCK_SYNC_SIZE + 1 + 4 + 4)
+#define LOG_BLOCK_COMPRESSED 1
+
+// The larger of an alloc record (a tag, an alloc type, a 32-bit varint and two 64-bit varints) and a realloc record (a tag and three 64-bit varints)
+#define LOG_V2_MAX_RECORD_SIZE (1 + 10 + 10 + 10)
+
+// Upper bound of the output size of logCompressBlock for an input of size n
+#define LOG_COMPRESS_BOUND(n) ((n) + (n) / 255 + 16)
+#define LOG_COMPRESS_HASH_BITS 12
+#define LOG_COMPRESS_HASH_SIZE (1 << LOG_COMPRESS_HASH_BITS)
+
+static inline size_t logEncodeVarint(uint8_t* out, uint64_t val)
+{
+	size_t len = 0;
+	while (val >= 0x80)
+	{
+		out[len++] = (uint8_t)(val | 0x80);
+		val >>= 7;
+	}
+	out[len++] = (uint8_t)val;
+	return len;
+}
+
+// Return the number of bytes consumed, or 0 if the input ends before the varint does
+static inline size_t logDecodeVarint(const uint8_t* in, const uint8_t* end, uint64_t* val)
+{
+	uint64_t ret = 0;
+	unsigned shift = 0;
+	const uint8_t* curr = in;
+	while (curr < end && shift < 64)
+	{
+		uint8_t byte = *curr++;
+		ret |= (uint64_t)(byte & 0x7f) << shift;
+		if ((byte & 0x80) == 0)
+		{
+			*val = ret;
+			return curr - in;
+		}
+		shift += 7;
+	}
+	return 0;
+}
+
+static inline uint64_t logZigzagEncode(int64_t val)
+{
+	return ((uint64_t)val << 1) ^ (uint64_t)(val >> 63);
+}
+
+static inline int64_t logZigzagDecode(uint64_t val)
+{
+	return (int64_t)(val >> 1) ^ -(int64_t)(val & 1);
+}
+
+static inline void logWriteU32(uint8_t* out, uint32_t val)
+{
+	out[0] = (uint8_t)val;
+	out[1] = (uint8_t)(val >> 8);
+	out[2] = (uint8_t)(val >> 16);
+	out[3] = (uint8_t)(val >> 24);
+}
+
+static inline uint32_t logReadU32(const uint8_t* in)
+{
+	return (uint32_t)in[0] | ((uint32_t)in[1] << 8) | ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24);
+}
+
+static inline uint8_t* logWriteLength(uint8_t* out, size_t len)
+{
+	while (len >= 255)
+	{
+		*out++ = 255;
+		len -= 255;
+	}
+	*out++ = (uint8_t)len;
+	return out;
+}
+
+// Compress src into dst, which must hold at least LOG_COMPRESS_BOUND(srcSize) bytes. hashTable is scratch space of LOG_COMPRESS_HASH_SIZE entries. Return the compressed size
+// The output is a sequence of (token, literal length, literals, match offset, match length) groups. The high nibble of the token is the literal length and the low nibble is the match length minus 4; a nibble of 15 is followed by extra length bytes. The last group has literals only
+static inline size_t logCompressBlock(const uint8_t* src, size_t srcSize, uint8_t* dst, uint32_t* hashTable)
+{
+	const size_t minMatch = 4;
+	const size_t maxOffset = 65535;
+
+	uint8_t* out = dst;
+	size_t anchor = 0, pos = 0;
+
+	memset(hashTable, 0xff, sizeof(uint32_t) * LOG_COMPRESS_HASH_SIZE);
+	while (srcSize >= minMatch && pos + minMatch <= srcSize)
+	{
+		uint32_t seq;
+		memcpy(&seq, src + pos, sizeof(seq));
+		uint32_t hash = (seq * 2654435761u) >> (32 - LOG_COMPRESS_HASH_BITS);
+		uint32_t candidate = hashTable[hash];
+		hashTable[hash] = (uint32_t)pos;
+
+		if (candidate == 0xffffffffu || pos - candidate > maxOffset || memcmp(src + candidate, src + pos, minMatch) != 0)
+		{
+			++pos;
+			continue;
+		}
+
+		size_t matchLen = minMatch;
+		while (pos + matchLen < srcSize && src[candidate + matchLen] == src[pos + matchLen])
+			++matchLen;
+
+		size_t litLen = pos - anchor;
+		size_t extraMatch = matchLen - minMatch;
+		uint8_t* token = out++;
+		*token = (uint8_t)(((litLen < 15 ? litLen : 15) << 4) | (extraMatch < 15 ? extraMatch : 15));
+		if (litLen >= 15)
+			out = logWriteLength(out, litLen - 15);
+		memcpy(out, src + anchor, litLen);
+		out += litLen;
+
+		size_t offset = pos - candidate;
+		*out++ = (uint8_t)offset;
+		*out++ = (uint8_t)(offset >> 8);
+		if (extraMatch >= 15)
+			out = logWriteLength(out, extraMatch - 15);
+
+		pos += matchLen;
+		anchor = pos;
+	}
+
+	size_t litLen = srcSize - anchor;
+	*out++ = (uint8_t)((litLen < 15 ? litLen : 15) << 4);
+	if (litLen >= 15)
+		out = logWriteLength(out, litLen - 15);
+	memcpy(out, src + anchor, litLen);
+	out += litLen;
+
+	return out - dst;
+}
+
+static inline int logReadLength(const uint8_t** in, const uint8_t* end, size_t* len)
+{
+	uint8_t byte;
+	do
+	{
+		if (*in >= end)
+			return 0;
+		byte = *(*in)++;
+		*len += byte;
+	} while (byte == 255);
+	return 1;
+}
+
+// Decompress src into dst, which must hold exactly dstSize bytes. Return 1 on success and 0 if the input is malformed
+static inline int logDecompressBlock(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize)
+{
+	const uint8_t* in = src;
+	const uint8_t* inEnd = src + srcSize;
+	size_t outPos = 0;
+
+	while (in < inEnd)
+	{
+		uint8_t token = *in++;
+
+		size_t litLen = token >> 4;
+		if (litLen == 15 && !logReadLength(&in, inEnd, &litLen))
+			return 0;
+		if (litLen > (size_t)(inEnd - in) || litLen > dstSize - outPos)
+			return 0;
+		memcpy(dst + outPos, in, litLen);
+		in += litLen;
+		outPos += litLen;
+
+		// The last group has no match
+		if (in == inEnd)
+			break;
+
+		if (inEnd - in < 2)
+			return 0;
+		size_t offset = (size_t)in[0] | ((size_t)in[1] << 8);
+		in += 2;
+		size_t matchLen = token & 0xf;
+		if (matchLen == 15 && !logReadLength(&in, inEnd, &matchLen))
+			return 0;
+		matchLen += 4;
+
+		if (offset == 0 || offset > outPos || matchLen > dstSize - outPos)
+			return 0;
+		// The match may overlap with its own output, so copy byte by byte
+		for (size_t i = 0; i < matchLen; ++i, ++outPos)
+			dst[outPos] = dst[outPos - offset];
+	}
+
+	return outPos == dstSize;
+}
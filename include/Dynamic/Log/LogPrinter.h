@@ -17,6 +17,9 @@ public:
 	void visitEnterRecord(const EnterRecord&);
 	void visitExitRecord(const ExitRecord&);
 	void visitCallRecord(const CallRecord&);
+	void visitFreeRecord(const FreeRecord&);
+	void visitReallocRecord(const ReallocRecord&);
+	void visitThreadRecord(const ThreadRecord&);
 };
 
 }
@@ -1,7 +1,7 @@
 #pragma once
 
-#include "Dynamic/Log/LogReader.h"
 #include "Dynamic/Log/LogVisitor.h"
+#include "Dynamic/Log/ThreadedLogReader.h"
 
 namespace dynamic
 {
@@ -10,14 +10,16 @@ template <typename SubClass, typename RetType = void>
 class LogProcessor: public LogConstVisitor<SubClass, RetType>
 {
 private:
-	LazyLogReader reader;
+	ThreadedLogReader reader;
+protected:
+	const ThreadedLogReader& getReader() const { return reader; }
 public:
 	LogProcessor(const char* fileName): reader(fileName) {}
 
 	void process()
 	{
-		while (auto rec = reader.readLogRecord())
-			this->visit(*rec);
+		for (auto const& rec: reader)
+			this->visit(rec);
 	}
 };
 
@@ -2,6 +2,7 @@
 
 #include "Dynamic/Log/LogRecord.h"
 
+#include <cstdint>
 #include <experimental/optional>
 #include <fstream>
 #include <vector>
@@ -17,14 +18,28 @@ public:
 	static std::vector<LogRecord> readLogFromFile(const char* fileName);
 };
 
+// Reads both the v1 and the v2 log format (see LogFormat.h). The format is detected from the file header
 class LazyLogReader
 {
 private:
 	std::ifstream ifs;
+
+	// For v2 logs, the decoded payload of the current block, the read position in it and the address the next delta is relative to
+	bool isV2;
+	std::vector<std::uint8_t> block, storedBlock;
+	std::size_t blockPos;
+	std::uint64_t prevAddress;
+
+	bool findNextBlock();
+	bool readBlock();
+	std::experimental::optional<LogRecord> readV2Record();
 public:
 	LazyLogReader(const char* fileName);
 
 	std::experimental::optional<LogRecord> readLogRecord();
 };
 
+// Decode one v2 record starting at pos and advance pos past it. Return false if the record is truncated or malformed
+bool decodeV2Record(const std::uint8_t*& pos, const std::uint8_t* end, std::uint64_t& prevAddress, LogRecord& rec);
+
 }
@@ -2,11 +2,15 @@
 
 // We won't put the following structs into a namespace because of C compatibility
 
+#include <stdint.h>
+
 struct AllocRecord
 {
 	char type;
 	unsigned id;
 	void* address;
+	// The size of the block in bytes, or 0 if it is unknown. Only v2 logs carry sizes
+	uint64_t size;
 };
 
 struct PointerRecord
@@ -30,13 +34,42 @@ struct CallRecord
 	unsigned id;
 };
 
+struct FreeRecord
+{
+	void* address;
+};
+
+struct ReallocRecord
+{
+	void* oldAddress;
+	void* newAddress;
+	// As in AllocRecord
+	uint64_t newSize;
+};
+
+// Alloc, free and realloc records are numbered across all threads of a run. A sync record tells that the records following it in the same stream were written after the first seq of them. See MemoryHooks.c
+struct SyncRecord
+{
+	uint64_t seq;
+};
+
+// Never stored in a log file. ThreadedLogReader yields it before a record that belongs to a different thread than the previous one
+struct ThreadRecord
+{
+	unsigned id;
+};
+
 enum LogRecordType
 {
 	TAllocRec,
 	TPointerRec,
 	TEnterRec,
 	TExitRec,
-	TCallRec
+	TCallRec,
+	TFreeRec,
+	TReallocRec,
+	TSyncRec,
+	TThreadRec
 };
 
 struct LogRecord
@@ -49,5 +82,9 @@ struct LogRecord
 		struct EnterRecord enterRecord;
 		struct ExitRecord exitRecord;
 		struct CallRecord callRecord;
+		struct FreeRecord freeRecord;
+		struct ReallocRecord reallocRecord;
+		struct SyncRecord syncRecord;
+		struct ThreadRecord threadRecord;
 	};
 };
@@ -25,10 +25,22 @@ public:
 				return static_cast<SubClass*>(this)->visitExitRecord(rec.exitRecord);
 			case LogRecordType::TCallRec:
 				return static_cast<SubClass*>(this)->visitCallRecord(rec.callRecord);
-			default:
-				std::abort();
+			case LogRecordType::TFreeRec:
+				return static_cast<SubClass*>(this)->visitFreeRecord(rec.freeRecord);
+			case LogRecordType::TReallocRec:
+				return static_cast<SubClass*>(this)->visitReallocRecord(rec.reallocRecord);
+			case LogRecordType::TSyncRec:
+				return static_cast<SubClass*>(this)->visitSyncRecord(rec.syncRecord);
+			case LogRecordType::TThreadRec:
+				return static_cast<SubClass*>(this)->visitThreadRecord(rec.threadRecord);
 		}
+		// The readers reject unknown record tags, so every record has one of the types above
+		__builtin_unreachable();
 	}
+
+	// Only readers that merge the streams of several threads care about these two, so by default they are ignored
+	RetType visitSyncRecord(const SyncRecord&) { return RetType(); }
+	RetType visitThreadRecord(const ThreadRecord&) { return RetType(); }
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "Dynamic/Log/LogRecord.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+namespace dynamic
+{
+
+// Maps the whole log file into memory and decodes records straight from the mapped bytes. Both the v1 and the v2 log format are supported. Only compressed v2 blocks need a copy, since they have to be decompressed first
+class MappedLogReader
+{
+private:
+	const std::uint8_t* data;
+	std::size_t size;
+
+	bool isV2;
+public:
+	class const_iterator
+	{
+	private:
+		const MappedLogReader* reader;
+
+		// The bytes records are currently decoded from: the rest of the file for v1, the current block for v2
+		const std::uint8_t* pos;
+		const std::uint8_t* end;
+		// v2 only: where the next block starts and the address the next delta is relative to
+		const std::uint8_t* nextBlock;
+		std::uint64_t prevAddress;
+		// v2 only: the decompressed payload of the current block, if it was compressed. Shared so that copying an iterator stays cheap
+		std::shared_ptr<std::vector<std::uint8_t>> blockBuffer;
+
+		LogRecord currRecord;
+
+		bool readBlock();
+		void advance();
+
+		const_iterator(): reader(nullptr), pos(nullptr), end(nullptr), nextBlock(nullptr), prevAddress(0), currRecord() {}
+		explicit const_iterator(const MappedLogReader* r);
+
+		friend class MappedLogReader;
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = LogRecord;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const LogRecord*;
+		using reference = const LogRecord&;
+
+		reference operator*() const { return currRecord; }
+		pointer operator->() const { return &currRecord; }
+
+		const_iterator& operator++()
+		{
+			advance();
+			return *this;
+		}
+		const_iterator operator++(int)
+		{
+			auto ret = *this;
+			advance();
+			return ret;
+		}
+
+		// All past-the-end iterators compare equal
+		bool operator==(const const_iterator& rhs) const
+		{
+			return reader == rhs.reader && pos == rhs.pos;
+		}
+		bool operator!=(const const_iterator& rhs) const
+		{
+			return !(*this == rhs);
+		}
+	};
+
+	MappedLogReader(const char* fileName);
+	~MappedLogReader();
+
+	MappedLogReader(const MappedLogReader&) = delete;
+	MappedLogReader(MappedLogReader&&) noexcept;
+	MappedLogReader& operator=(const MappedLogReader&) = delete;
+	MappedLogReader& operator=(MappedLogReader&&) = delete;
+
+	const_iterator begin() const { return const_iterator(this); }
+	const_iterator end() const { return const_iterator(); }
+};
+
+}
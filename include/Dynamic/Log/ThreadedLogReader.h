@@ -0,0 +1,85 @@
+#pragma once
+
+#include "Dynamic/Log/MappedLogReader.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+namespace dynamic
+{
+
+// Reads all the streams a run has written: fileName for the thread that initialized the runtime, and fileName.1, fileName.2, ... for the other threads. The streams are merged into one sequence in which the alloc, free and realloc records of all threads appear in the order the runtime numbered them, and every other record stays between the same two of them as when it was written (see the sync records in MemoryHooks.c). Sync records themselves are consumed here
+// Whenever the next record belongs to a different thread than the previous one, a ThreadRecord carrying the thread id (the stream number) comes first. The sequence starts out in thread 0
+class ThreadedLogReader
+{
+private:
+	std::vector<MappedLogReader> streams;
+public:
+	class const_iterator
+	{
+	private:
+		const ThreadedLogReader* reader;
+
+		// The next record of each stream, which is never a sync record, and the number of allocation events that have to be merged before it
+		std::vector<MappedLogReader::const_iterator> heads;
+		std::vector<std::uint64_t> seen;
+		// The number of allocation events merged so far
+		std::uint64_t numEvents;
+
+		unsigned currThread;
+		// The number of records yielded before the current one. It tells positions apart, since the heads alone do not when a ThreadRecord is pending
+		std::size_t index;
+		LogRecord currRecord;
+
+		void skipSyncRecords(unsigned);
+		unsigned pickStream(bool isEvent) const;
+		void advance();
+
+		const_iterator(): reader(nullptr), numEvents(0), currThread(0), index(0), currRecord() {}
+		explicit const_iterator(const ThreadedLogReader* r);
+
+		friend class ThreadedLogReader;
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = LogRecord;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const LogRecord*;
+		using reference = const LogRecord&;
+
+		reference operator*() const { return currRecord; }
+		pointer operator->() const { return &currRecord; }
+
+		const_iterator& operator++()
+		{
+			advance();
+			return *this;
+		}
+		const_iterator operator++(int)
+		{
+			auto ret = *this;
+			advance();
+			return ret;
+		}
+
+		// All past-the-end iterators compare equal
+		bool operator==(const const_iterator& rhs) const
+		{
+			return reader == rhs.reader && index == rhs.index;
+		}
+		bool operator!=(const const_iterator& rhs) const
+		{
+			return !(*this == rhs);
+		}
+	};
+
+	ThreadedLogReader(const char* fileName);
+
+	unsigned getNumThreads() const { return streams.size(); }
+
+	const_iterator begin() const { return const_iterator(this); }
+	const_iterator end() const { return const_iterator(); }
+};
+
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <llvm/Analysis/AliasAnalysis.h>
+
+namespace llvm
+{
+	class ImmutablePass;
+}
+
+namespace tpa
+{
+
+class SemiSparsePointerAnalysis;
+
+// Makes the results of a finished pointer analysis available to LLVM passes through the AAResults interface. Queries the analysis cannot answer with NoAlias or MustAlias fall through to the next alias analysis in the chain
+// Unlike PointerAnalysis::alias(), which compares addresses, LLVM asks whether two accesses overlap. A NoAlias from TPA is therefore only passed on when the two accesses cannot reach each other within a memory block
+// The adapter refers to the pointer analysis and to the module it ran on, both of which must outlive it
+class TPAAAResult: public llvm::AAResultBase<TPAAAResult>
+{
+private:
+	friend llvm::AAResultBase<TPAAAResult>;
+
+	const SemiSparsePointerAnalysis& ptrAnalysis;
+
+	bool accessesOverlapInBlock(const llvm::MemoryLocation&, const llvm::MemoryLocation&) const;
+public:
+	TPAAAResult(const SemiSparsePointerAnalysis& p): ptrAnalysis(p) {}
+
+	llvm::AliasResult alias(const llvm::MemoryLocation&, const llvm::MemoryLocation&);
+};
+
+// For the legacy pass manager: add the returned pass before the passes that should see TPA results
+llvm::ImmutablePass* createTPAAAWrapperPass(TPAAAResult&);
+
+}
@@ -3,6 +3,7 @@
 #include "Annotation/Pointer/ExternalPointerTable.h"
 #include "PointerAnalysis/MemoryModel/MemoryManager.h"
 #include "PointerAnalysis/MemoryModel/PointerManager.h"
+#include "PointerAnalysis/Support/AliasCache.h"
 #include "PointerAnalysis/Support/PtsSet.h"
 
 #include <llvm/IR/CallSite.h>
@@ -25,6 +26,9 @@ protected:
 	MemoryManager memManager;
 	annotation::ExternalPointerTable extTable;
 
+	// Alias queries only read the analysis results, so caching their answers does not change the observable state
+	mutable AliasCache aliasCache;
+
 	void getCallees(const llvm::ImmutableCallSite& cs, PtsSet pSet, std::vector<const llvm::Function*>& funcs) const
 	{
 		if (pSet.has(MemoryManager::getUniversalObject()))
@@ -59,6 +63,11 @@ public:
 	{
 		extTable = annotation::ExternalPointerTable::loadFromFile(extFileName);
 	}
+	// Use a table that has already been loaded, so that analyzing many modules parses the annotation file only once. The copy shares the entries of table
+	void setExternalPointerTable(const annotation::ExternalPointerTable& table)
+	{
+		extTable = table;
+	}
 
 	PtsSet getPtsSet(const Pointer* ptr) const
 	{
@@ -80,8 +89,25 @@ public:
 	{
 		assert(val != nullptr);
 
+		auto pSet = PtsSet::getEmptySet();
+		if (!lookupPtsSet(val, pSet))
+			assert(false && "cannot find corresponding ptr for value?");
+		return pSet;
+	}
+
+	// Same as getPtsSet(val), but return false instead of asserting if the analysis has no pointer for val
+	bool lookupPtsSet(const llvm::Value* val, PtsSet& pSet) const
+	{
 		auto ptrs = ptrManager.getPointersWithValue(val->stripPointerCasts());
-		assert(!ptrs.empty());
+		if (ptrs.empty())
+			return false;
+
+		// The common case, e.g. everywhere when the analysis is context-insensitive. Merging a single set would copy it only to find the same set in the intern table
+		if (ptrs.size() == 1)
+		{
+			pSet = getPtsSet(ptrs.front());
+			return true;
+		}
 
 		std::vector<PtsSet> pSets;
 		pSets.reserve(ptrs.size());
@@ -89,7 +115,25 @@ public:
 		for (auto ptr: ptrs)
 			pSets.emplace_back(getPtsSet(ptr));
 
-		return PtsSet::mergeAll(pSets);
+		pSet = PtsSet::mergeAll(pSets);
+		return true;
+	}
+
+	// Whether the two values may hold the same address in any context. A value that the analysis has no pointer for, e.g. one that is not a pointer or is in an unreachable function, may alias anything
+	AliasResult alias(const llvm::Value* v0, const llvm::Value* v1) const
+	{
+		assert(v0 != nullptr && v1 != nullptr);
+
+		auto s0 = PtsSet::getEmptySet(), s1 = PtsSet::getEmptySet();
+		if (!lookupPtsSet(v0, s0) || !lookupPtsSet(v1, s1))
+			return AliasResult::MayAlias;
+
+		return alias(s0, s1);
+	}
+
+	AliasResult alias(const PtsSet& s0, const PtsSet& s1) const
+	{
+		return aliasCache.alias(s0, s1);
 	}
 
 	std::vector<const llvm::Function*> getCallees(const llvm::ImmutableCallSite& cs, const context::Context* ctx = nullptr) const
@@ -4,6 +4,11 @@
 #include "PointerAnalysis/Support/Env.h"
 #include "PointerAnalysis/Support/Memo.h"
 
+namespace util
+{
+	class PhaseStatistics;
+}
+
 namespace tpa
 {
 
@@ -14,11 +19,26 @@ class SemiSparsePointerAnalysis: public PointerAnalysis<SemiSparsePointerAnalysi
 private:
 	Env env;
 	Memo memo;
+
+	size_t numIterations;
+
+	util::PhaseStatistics* phaseStats;
+
+	void addObjectCounters() const;
 public:
-	SemiSparsePointerAnalysis() = default;
+	SemiSparsePointerAnalysis(): numIterations(0), phaseStats(nullptr) {}
+
+	// Record the global and the main analysis of runOnProgram() as two phases, along with the number of objects they created
+	void setPhaseStatistics(util::PhaseStatistics& stats)
+	{
+		phaseStats = &stats;
+	}
 
 	void runOnProgram(const SemiSparseProgram&);
 
+	// Number of program points the solver evaluated in runOnProgram()
+	size_t getNumIterations() const { return numIterations; }
+
 	PtsSet getPtsSetImpl(const Pointer*) const;
 };
 
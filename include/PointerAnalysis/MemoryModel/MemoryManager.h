@@ -42,6 +42,8 @@ public:
 	static const MemoryObject* getUniversalObject() { return &uObj; }
 	static const MemoryObject* getNullObject() { return &nObj; }
 	size_t getPointerSize() const { return ptrSize; }
+	size_t getNumMemoryBlocks() const { return allocMap.size(); }
+	size_t getNumMemoryObjects() const { return objSet.size(); }
 
 	const MemoryObject* allocateGlobalMemory(const llvm::GlobalVariable*, const TypeLayout*);
 	const MemoryObject* allocateMemoryForFunction(const llvm::Function* f);
@@ -45,6 +45,8 @@ public:
 	const Pointer* getPointer(const context::Context* ctx, const llvm::Value* val) const;
 	// Return a vector of Pointers, whose elements corresponds to the same llvm::Value. Return NULL if not such Pointer is found
 	PointerVector getPointersWithValue(const llvm::Value* val) const;
+
+	size_t getNumPointers() const { return ptrSet.size(); }
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "PointerAnalysis/Support/PtsSet.h"
+
+#include <cstdint>
+#include <unordered_map>
+
+namespace tpa
+{
+
+// Alias results are about the addresses two pointers may hold, not about the memory accessed through them: pointers to two different fields of a struct do not alias, even though an access through the first one may be wide enough to cover the second
+enum class AliasResult: std::uint8_t
+{
+	NoAlias,
+	MayAlias,
+	// Both pointers always hold the same address
+	MustAlias,
+};
+
+// Memoizes alias results per pair of points-to sets. Sets are interned, so a key is just the identities of the two sets, and the many pointers that share a points-to set share the cached result as well
+class AliasCache
+{
+private:
+	using KeyType = std::pair<PtsSet, PtsSet>;
+	std::unordered_map<KeyType, AliasResult, util::PairHasher<KeyType>> cache;
+public:
+	AliasResult alias(const PtsSet& s0, const PtsSet& s1);
+
+	size_t size() const { return cache.size(); }
+	void clear() { cache.clear(); }
+
+	// The uncached query
+	static AliasResult computeAlias(const PtsSet& s0, const PtsSet& s1);
+};
+
+}
@@ -34,6 +34,8 @@ private:
 		return mapInsertPair.second || setInsertPair.second;
 	}
 public:
+	using const_iterator = typename CalleeMap::const_iterator;
+
 	CallGraph() = default;
 
 	bool insertEdge(const CallerType& caller, const CalleeType& callee)
@@ -60,6 +62,10 @@ public:
 	else
 		return util::iteratorRange(itr->second.begin(), itr->second.end());
 	}
+
+	// Iterate over (caller, callee set) pairs
+	const_iterator begin() const { return calleeMap.begin(); }
+	const_iterator end() const { return calleeMap.end(); }
 };
 
 }
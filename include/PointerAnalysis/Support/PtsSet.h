@@ -61,8 +61,15 @@ public:
 	static PtsSet getEmptySet();
 	static PtsSet getSingletonSet(const MemoryObject*);
 	static std::vector<const MemoryObject*> intersects(const PtsSet& s0, const PtsSet& s1);
+	// Return true if s0 and s1 have an object in common. Cheaper than intersects() when only the answer matters
+	static bool overlaps(const PtsSet& s0, const PtsSet& s1);
 	static PtsSet mergeAll(const std::vector<PtsSet>&);
 
+	// Free every interned set except the empty set. This is only safe when no other PtsSet is alive, e.g. between the analyses of two modules
+	static void releaseInternedSets();
+	// Number of distinct sets interned so far, including the empty set
+	static size_t getNumInternedSets() { return existingSet.size(); }
+
 	friend std::hash<PtsSet>;
 };
 
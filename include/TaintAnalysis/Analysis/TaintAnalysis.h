@@ -4,6 +4,14 @@
 #include "TaintAnalysis/Support/TaintEnv.h"
 #include "TaintAnalysis/Support/TaintMemo.h"
 
+#include <string>
+#include <vector>
+
+namespace llvm
+{
+	class raw_ostream;
+}
+
 namespace tpa
 {
 	class SemiSparsePointerAnalysis;
@@ -22,15 +30,52 @@ private:
 
 	annotation::ExternalTaintTable extTable;
 	const tpa::SemiSparsePointerAnalysis& ptrAnalysis;
+
+	// If cacheFileName is not empty, results of the previous run are loaded from it and only changed functions are re-analyzed
+	std::string cacheFileName;
+	std::vector<std::string> configFileNames;
+	bool rebuildCache;
+
+	// If reportFileName is not empty, violations are written to it as JSON Lines instead of being printed to stderr
+	std::string reportFileName;
+	// Same as reportFileName, for an already open stream. Takes precedence over reportFileName
+	llvm::raw_ostream* reportStream;
+
+	size_t numIterations;
 public:
-	TaintAnalysis(const tpa::SemiSparsePointerAnalysis& p): ptrAnalysis(p) {}
+	TaintAnalysis(const tpa::SemiSparsePointerAnalysis& p): ptrAnalysis(p), rebuildCache(false), reportStream(nullptr), numIterations(0) {}
 
 	void loadExternalTaintTable(const char* extFileName)
 	{
 		extTable = annotation::ExternalTaintTable::loadFromFile(extFileName);
 	}
+	void setExternalTaintTable(const annotation::ExternalTaintTable& table)
+	{
+		extTable = table;
+	}
+
+	// configFiles are all annotation files the analysis depends on. Editing any of them invalidates the cache
+	// If rebuild is true, the content of the cache is ignored and replaced with the results of a full run. This is the only way to drop taint that an incremental run kept from an earlier one
+	void enableIncrementalMode(const char* cacheFile, std::vector<std::string> configFiles, bool rebuild = false)
+	{
+		cacheFileName = cacheFile;
+		configFileNames = std::move(configFiles);
+		rebuildCache = rebuild;
+	}
+
+	void setReportFile(const char* reportFile)
+	{
+		reportFileName = reportFile;
+	}
+	void setReportStream(llvm::raw_ostream& os)
+	{
+		reportStream = &os;
+	}
 
 	bool runOnDefUseModule(const DefUseModule&);
+
+	// Number of program points the solver evaluated in runOnDefUseModule(). With incremental mode on, restored functions are not counted
+	size_t getNumIterations() const { return numIterations; }
 };
 
 }
\ No newline at end of file
@@ -1,7 +1,7 @@
 #pragma once
 
 #include "Annotation/Taint/ExternalTaintTable.h"
-#include "TaintAnalysis/Support/ProgramPointSet.h"
+#include "TaintAnalysis/Precision/PrecisionLossTracker.h"
 #include "TaintAnalysis/Support/TaintEnv.h"
 #include "TaintAnalysis/Support/TaintMemo.h"
 
@@ -23,15 +23,25 @@ private:
 
 	annotation::ExternalTaintTable extTable;
 	const tpa::SemiSparsePointerAnalysis& ptrAnalysis;
+
+	// Maximum number of program points the precision loss tracker may visit. 0 means no limit
+	unsigned trackingBudget;
+
+	size_t numIterations;
 public:
-	TrackingTaintAnalysis(const tpa::SemiSparsePointerAnalysis& p): ptrAnalysis(p) {}
+	TrackingTaintAnalysis(const tpa::SemiSparsePointerAnalysis& p): ptrAnalysis(p), trackingBudget(0), numIterations(0) {}
 
 	void loadExternalTaintTable(const char* extFileName)
 	{
 		extTable = annotation::ExternalTaintTable::loadFromFile(extFileName);
 	}
 
-	std::pair<bool, ProgramPointSet> runOnDefUseModule(const DefUseModule&);
+	void setTrackingBudget(unsigned b) { trackingBudget = b; }
+
+	std::pair<bool, LossSiteList> runOnDefUseModule(const DefUseModule&);
+
+	// Number of program points the solver evaluated in runOnDefUseModule(), not counting the steps of the tracker
+	size_t getNumIterations() const { return numIterations; }
 };
 
 }
\ No newline at end of file
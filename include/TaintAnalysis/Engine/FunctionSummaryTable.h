@@ -0,0 +1,75 @@
+#pragma once
+
+#include "TaintAnalysis/Support/TaintStore.h"
+#include "Util/Hashing.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace llvm
+{
+	class Function;
+}
+
+namespace tpa
+{
+	class MemoryObject;
+	class SemiSparsePointerAnalysis;
+}
+
+namespace taint
+{
+
+// Many functions (mostly small utilities) behave the same no matter which context they are called from: every pointer they load from or store to has the same points-to set in all contexts, and they only call functions of the same kind. Their effect is fully determined by the taint of their arguments and of the memory they read. This class decides which functions fall into that category and memoizes their effect keyed by that input, so that the call sites of such functions can be evaluated without walking the callee body once per context
+// A summary applies the stores of the callee as weak updates. Functions with a store that the regular transfer function would turn into a strong update are therefore not summarized, since the summary would be less precise than walking the body
+class FunctionSummaryTable
+{
+public:
+	using TaintVector = std::vector<TaintLattice>;
+
+	struct Summary
+	{
+		TaintLattice retVal;
+		std::vector<std::pair<const tpa::MemoryObject*, TaintLattice>> memEffects;
+	};
+private:
+	const tpa::SemiSparsePointerAnalysis& ptrAnalysis;
+
+	struct FunctionInfo
+	{
+		bool summarizable;
+		// The objects f and its callees may load from, in a fixed order. Their taint at the call site is part of the summary key
+		std::vector<const tpa::MemoryObject*> readObjs;
+	};
+	// A function is mapped to an unsummarizable entry while its own check is in progress, which makes recursive functions unsummarizable
+	std::unordered_map<const llvm::Function*, FunctionInfo> infoMap;
+
+	// The key is the taint of the arguments followed by the taint of readObjs
+	using SummaryMap = std::unordered_map<TaintVector, Summary, util::ContainerHasher<TaintVector>>;
+	std::unordered_map<const llvm::Function*, SummaryMap> summaries;
+
+	bool enabled;
+
+	const FunctionInfo& getFunctionInfo(const llvm::Function*);
+	Summary evalFunction(const llvm::Function*, const TaintVector& argVals, const TaintStore& entryStore);
+public:
+	FunctionSummaryTable(const tpa::SemiSparsePointerAnalysis& p): ptrAnalysis(p), enabled(true) {}
+
+	// When disabled, no function is considered summarizable and every call goes through the callee body
+	void setEnabled(bool e) { enabled = e; }
+
+	bool isSummarizable(const llvm::Function*);
+
+	// Return the effect of calling f with arguments tainted as argVals and memory tainted as callerStore. f must be summarizable
+	const Summary& applySummary(const llvm::Function* f, const TaintVector& argVals, const TaintStore& callerStore);
+
+	size_t getNumSummaries() const
+	{
+		size_t ret = 0;
+		for (auto const& mapping: summaries)
+			ret += mapping.second.size();
+		return ret;
+	}
+};
+
+}
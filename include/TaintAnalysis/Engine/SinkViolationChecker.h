@@ -37,7 +37,8 @@ private:
 	void checkCallSiteWithEntry(const ProgramPoint&, const annotation::SinkTaintEntry&, SinkViolationList&);
 	SinkViolationList checkCallSiteWithSummary(const ProgramPoint&, const annotation::TaintSummary&);
 
-	void checkSinkViolation(const SinkSignature&, SinkViolationRecord&);
+	// Return the violations found at the given sink, or nullptr if there are none
+	const SinkViolationList* checkSinkViolation(const SinkSignature&, SinkViolationRecord&);
 public:
 	SinkViolationChecker(const TaintEnv& e, const TaintMemo& m, const annotation::ExternalTaintTable& t, const tpa::SemiSparsePointerAnalysis& p): env(e), memo(m), table(t), ptrAnalysis(p) {}
 
@@ -50,6 +51,19 @@ public:
 			checkSinkViolation(sig, ret);
 		return ret;
 	}
+
+	// Same as above, but also hand the violations of each sink to the callback as soon as they are found
+	template <typename SigContainer, typename Callback>
+	SinkViolationRecord checkSinkViolation(const SigContainer& sinks, Callback&& onViolation)
+	{
+		SinkViolationRecord ret;
+		for (auto const& sig: sinks)
+		{
+			if (auto violations = checkSinkViolation(sig, ret))
+				onViolation(sig.getCallSite(), *violations);
+		}
+		return ret;
+	}
 };
 
 }
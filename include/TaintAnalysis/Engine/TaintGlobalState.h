@@ -2,6 +2,7 @@
 
 #include "PointerAnalysis/Support/CallGraph.h"
 #include "PointerAnalysis/Support/FunctionContext.h"
+#include "TaintAnalysis/Engine/FunctionSummaryTable.h"
 #include "TaintAnalysis/Support/SinkSignature.h"
 
 #include <unordered_set>
@@ -48,8 +49,11 @@ private:
 	// Taint sinks
 	using SinkSet = std::unordered_set<SinkSignature>;
 	SinkSet sinkSet;
+
+	// Summaries of functions whose taint behavior does not depend on the calling context
+	FunctionSummaryTable summaryTable;
 public:
-	TaintGlobalState(const DefUseModule& m, const tpa::SemiSparsePointerAnalysis& p, const annotation::ExternalTaintTable& t, TaintEnv& e, TaintMemo& mm): duModule(m), ptrAnalysis(p), extTaintTable(t), env(e), memo(mm) {}
+	TaintGlobalState(const DefUseModule& m, const tpa::SemiSparsePointerAnalysis& p, const annotation::ExternalTaintTable& t, TaintEnv& e, TaintMemo& mm): duModule(m), ptrAnalysis(p), extTaintTable(t), env(e), memo(mm), summaryTable(p) {}
 
 	const DefUseModule& getDefUseModule() const { return duModule; }
 
@@ -67,6 +71,8 @@ public:
 
 	SinkSet& getSinks() { return sinkSet; }
 	const SinkSet& getSinks() const	{ return sinkSet; }
+
+	FunctionSummaryTable& getSummaryTable() { return summaryTable; }
 };
 
 }
\ No newline at end of file
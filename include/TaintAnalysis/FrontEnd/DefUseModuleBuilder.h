@@ -36,6 +36,10 @@ public:
 	{
 		modRefTable = annotation::ExternalModRefTable::loadFromFile(fileName);
 	}
+	void setExternalModRefTable(const annotation::ExternalModRefTable& table)
+	{
+		modRefTable = table;
+	}
 };
 
 }
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace llvm
+{
+	class Function;
+	class Module;
+}
+
+namespace taint
+{
+
+// Compute a digest of the body of f. Only the parts of the IR that can affect the analysis are hashed (opcodes, types and operands, but no metadata attachments), so that debug locations shifted by edits in other functions do not invalidate f. For the same reason the metadata nodes that debug intrinsics take are hashed by kind only
+std::string computeFunctionHash(const llvm::Function& f);
+
+// Compute a digest of a set of strings, independent of the order they are listed in
+std::string computeStringSetHash(std::vector<std::string> strs);
+
+// Compute a digest of everything outside function bodies that the analysis depends on: global variables, the context sensitivity, and the content of the annotation files
+std::string computeModuleHash(const llvm::Module& module, const std::vector<std::string>& configFiles);
+
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace context
+{
+	class Context;
+}
+
+namespace llvm
+{
+	class Function;
+	class Value;
+}
+
+namespace tpa
+{
+	class MemoryObject;
+	class SemiSparsePointerAnalysis;
+}
+
+namespace taint
+{
+
+class DefUseInstruction;
+class DefUseModule;
+
+// StableNameMap gives values, contexts and memory objects textual names that remain valid after the module is recompiled, as long as the functions they refer to are unchanged
+// Names that refer to any function marked as stale are never resolved
+class StableNameMap
+{
+private:
+	const DefUseModule& duModule;
+
+	std::unordered_map<const llvm::Value*, std::string> nameMap;
+	std::unordered_map<std::string, const llvm::Value*> valueMap;
+	std::unordered_map<std::string, const tpa::MemoryObject*> objMap;
+
+	std::unordered_set<const llvm::Function*> staleFuncs;
+
+	void nameFunction(const llvm::Function&);
+	void registerObject(const tpa::MemoryObject*);
+
+	bool isStaleValue(const llvm::Value*) const;
+	bool isStaleContext(const context::Context*) const;
+public:
+	StableNameMap(const DefUseModule&, const tpa::SemiSparsePointerAnalysis&);
+
+	void markStale(const llvm::Function* f) { staleFuncs.insert(f); }
+	bool isStale(const llvm::Function* f) const { return staleFuncs.count(f); }
+	size_t getNumStaleFunctions() const { return staleFuncs.size(); }
+
+	std::string getValueName(const llvm::Value*) const;
+	std::string getContextName(const context::Context*) const;
+	std::string getObjectName(const tpa::MemoryObject*) const;
+	std::string getDefUseInstructionName(const DefUseInstruction*) const;
+
+	// The lookup functions return NULL if the name cannot be resolved in the current module
+	const llvm::Value* lookupValue(const std::string&) const;
+	const llvm::Function* lookupFunction(const std::string&) const;
+	const context::Context* lookupContext(const std::string&) const;
+	const tpa::MemoryObject* lookupObject(const std::string&) const;
+	const DefUseInstruction* lookupDefUseInstruction(const std::string&) const;
+};
+
+}
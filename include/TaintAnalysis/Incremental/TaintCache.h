@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Annotation/Taint/TaintDescriptor.h"
+#include "TaintAnalysis/Lattice/TaintLattice.h"
+
+#include <llvm/ADT/StringRef.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace taint
+{
+
+// TaintCache is the on-disk form of a finished taint analysis. Every entry is keyed by the stable names produced by StableNameMap and grouped by the function it belongs to, so that the entries of a changed function can be discarded as a whole
+class TaintCache
+{
+public:
+	struct EnvEntry
+	{
+		std::string ctx, value;
+		TaintLattice taint;
+	};
+	struct MemoEntry
+	{
+		std::string ctx, inst, obj;
+		TaintLattice taint;
+	};
+	struct CallEntry
+	{
+		std::string callerCtx, callSite, calleeCtx, callee;
+	};
+	struct SinkEntry
+	{
+		std::string ctx, callSite, callee;
+	};
+	struct ViolationEntry
+	{
+		std::string ctx, callSite;
+		uint8_t argPos;
+		annotation::TClass what;
+		TaintLattice expectVal, actualVal;
+	};
+
+	struct FunctionRecord
+	{
+		std::string hash;
+		std::vector<EnvEntry> envEntries;
+		std::vector<MemoEntry> memoEntries;
+		std::vector<CallEntry> callEntries;
+		std::vector<SinkEntry> sinkEntries;
+		std::vector<ViolationEntry> violationEntries;
+	};
+private:
+	std::string moduleHash;
+
+	using RecordMap = std::unordered_map<std::string, FunctionRecord>;
+	RecordMap records;
+
+	static TaintCache parseCache(const llvm::StringRef&);
+public:
+	using const_iterator = RecordMap::const_iterator;
+
+	TaintCache() = default;
+
+	const std::string& getModuleHash() const { return moduleHash; }
+	void setModuleHash(const std::string& h) { moduleHash = h; }
+
+	// Return NULL if the function is not in the cache
+	const FunctionRecord* lookup(const std::string& funName) const;
+	FunctionRecord& getOrCreateRecord(const std::string& funName) { return records[funName]; }
+
+	const_iterator begin() const { return records.begin(); }
+	const_iterator end() const { return records.end(); }
+	size_t size() const { return records.size(); }
+
+	// Return an empty cache if the file does not exist or is malformed
+	static TaintCache loadFromFile(const char* fileName);
+	void writeToFile(const char* fileName) const;
+};
+
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "TaintAnalysis/Engine/WorkList.h"
+#include "TaintAnalysis/Incremental/StableNameMap.h"
+#include "TaintAnalysis/Incremental/TaintCache.h"
+#include "TaintAnalysis/Support/SinkViolationRecord.h"
+
+#include <unordered_set>
+
+namespace taint
+{
+
+class DefUseFunction;
+class TaintGlobalState;
+
+// TaintCacheManager implements incremental taint checking. restore() seeds the env, the memo, the call graph and the sink set with the cached results of every unchanged function and returns a worklist that re-solves the changed functions. Taint changes that flow out of them are picked up by the regular propagation, which stops as soon as a cached value is reproduced
+// A function counts as changed if its body, the points-to sets of its pointers, its mem-level def-use edges or the targets of its indirect calls differ from the cached run
+// Since cached values are only ever joined with new ones, the result over-approximates a from-scratch run: taint that disappeared from unchanged functions downstream of an edit is kept until the cache is rebuilt with a full run (see TaintAnalysis::enableIncrementalMode())
+class TaintCacheManager
+{
+private:
+	TaintGlobalState& globalState;
+	StableNameMap nameMap;
+	std::string moduleHash;
+
+	using HashMap = std::unordered_map<const llvm::Function*, std::string>;
+	HashMap funcHashes;
+
+	// Violations reported by the cached run, used to tell new violations from known ones
+	std::unordered_set<std::string> cachedViolations;
+
+	std::string computeInputHash(const DefUseFunction&) const;
+
+	void detectChangedFunctions(const TaintCache&);
+	void detectChangedCallTargets(const TaintCache&);
+	void restoreFunction(const TaintCache::FunctionRecord&);
+	void enqueueCallersOfChangedFunctions(const TaintCache&, WorkList&);
+public:
+	TaintCacheManager(TaintGlobalState&, const std::vector<std::string>& configFiles);
+
+	WorkList restore(const char* cacheFile, WorkList initList);
+	void save(const char* cacheFile, const SinkViolationRecord&);
+};
+
+}
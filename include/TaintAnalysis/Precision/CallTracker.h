@@ -28,11 +28,12 @@ private:
 	TaintVector getMemoryTaintValues(const CallerVector&, const tpa::MemoryObject*);
 
 	void trackValue(const ProgramPoint&, const CallerVector&);
-	void trackMemory(const ProgramPoint&, const CallerVector&);
+	void trackMemory(const ProgramPoint&, const CallerVector&, const tpa::MemoryObject*);
 public:
 	CallTracker(TrackerGlobalState& g, TrackerWorkList& w): trackerState(g), workList(w) {}
 
-	void trackCall(const ProgramPoint&, const CallerVector&);
+	// Track the arguments of the function entered at pp into its callers if obj is NULL, and the content of obj otherwise
+	void trackCall(const ProgramPoint& pp, const CallerVector&, const tpa::MemoryObject* obj);
 };
 
 }
@@ -43,7 +43,7 @@ public:
 				continue;
 			
 			for (auto predDuInst: mapping.second)
-				workList.enqueue(ProgramPoint(ctx, predDuInst));
+				workList.enqueue(ProgramPoint(ctx, predDuInst), mapping.first);
 		}
 	}
 };
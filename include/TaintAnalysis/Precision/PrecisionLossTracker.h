@@ -1,9 +1,9 @@
 #pragma once
 
-#include "TaintAnalysis/Support/ProgramPointSet.h"
+#include "TaintAnalysis/Support/ProgramPoint.h"
 #include "TaintAnalysis/Support/SinkViolationRecord.h"
 
-#include <unordered_set>
+#include <vector>
 
 namespace taint
 {
@@ -11,16 +11,32 @@ namespace taint
 class TaintGlobalState;
 class TrackerWorkList;
 
+// A program point where precision is lost, together with the number of imprecise sink violations it contributes to
+struct LossSite
+{
+	ProgramPoint pp;
+	size_t numViolations;
+};
+using LossSiteList = std::vector<LossSite>;
+
 class PrecisionLossTracker
 {
 private:
 	const TaintGlobalState& globalState;
 
+	// Maximum number of program points to process before giving up. 0 means no limit
+	unsigned stepBudget;
+	bool budgetExhausted;
+
 	void initializeWorkList(TrackerWorkList&, const SinkViolationRecord&);
 public:
-	PrecisionLossTracker(const TaintGlobalState& g): globalState(g) {}
+	PrecisionLossTracker(const TaintGlobalState& g, unsigned b = 0): globalState(g), stepBudget(b), budgetExhausted(false) {}
+
+	// Return the loss sites sorted so that the ones explaining the most violations come first
+	LossSiteList trackImprecision(const SinkViolationRecord&);
 
-	ProgramPointSet trackImprecision(const SinkViolationRecord&);
+	// If true, the last trackImprecision() call ran out of budget and its result may be incomplete
+	bool isBudgetExhausted() const { return budgetExhausted; }
 };
 
 }
@@ -28,15 +28,16 @@ private:
 	ReturnVector getReturnVector(const CalleeVector&);
 	TaintVector getReturnTaintValues(const ReturnVector&);
 	TaintVector getReturnTaintValues(const tpa::MemoryObject*, const ReturnVector&);
-	void processReturns(const ProgramPoint&, const ReturnVector&, const TaintVector&);
-	void propagateReturns(const ReturnVector&, const TaintVector&);
+	void processReturns(const ProgramPoint&, const ReturnVector&, const TaintVector&, const tpa::MemoryObject*);
+	void propagateReturns(const ReturnVector&, const TaintVector&, const tpa::MemoryObject*);
 
 	void trackValue(const ProgramPoint&, const ReturnVector&);
-	void trackMemory(const ProgramPoint&, const ReturnVector&);
+	void trackMemory(const ProgramPoint&, const ReturnVector&, const tpa::MemoryObject*);
 public:
 	ReturnTracker(TrackerGlobalState& g, TrackerWorkList& w): trackerState(g), workList(w) {}
 
-	void trackReturn(const ProgramPoint&, const CalleeVector&);
+	// Track the return value of the call at pp into its callees if obj is NULL, and the content of obj otherwise
+	void trackReturn(const ProgramPoint& pp, const CalleeVector&, const tpa::MemoryObject* obj);
 };
 
 }
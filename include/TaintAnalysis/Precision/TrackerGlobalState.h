@@ -2,7 +2,9 @@
 
 #include "PointerAnalysis/Support/CallGraph.h"
 #include "PointerAnalysis/Support/FunctionContext.h"
-#include "TaintAnalysis/Support/ProgramPointSet.h"
+#include "TaintAnalysis/Precision/TrackerWorkList.h"
+
+#include <unordered_map>
 
 namespace annotation
 {
@@ -23,6 +25,10 @@ class TaintMemo;
 
 class TrackerGlobalState
 {
+public:
+	using ViolationSet = TrackerWorkList::ViolationSet;
+	using TrackedObject = TrackerWorkList::TrackedObject;
+	using SourceMap = std::unordered_map<ProgramPoint, ViolationSet>;
 private:
 	// The program
 	const DefUseModule& duModule;
@@ -43,10 +49,13 @@ private:
 	using CallGraphType = tpa::CallGraph<ProgramPoint, tpa::FunctionContext>;
 	const CallGraphType& callGraph;
 
-	ProgramPointSet& imprecisionSources;
-	ProgramPointSet visited;
+	// Map each imprecision source to the violations it explains
+	SourceMap& imprecisionSources;
+
+	// The violations each program point has already been tracked for, separately for its top-level value and each memory object it defines. This is shared by all violations so that common predecessors are only walked once per violation set
+	std::unordered_map<ProgramPoint, std::unordered_map<TrackedObject, ViolationSet>> visited;
 public:
-	TrackerGlobalState(const DefUseModule& m, const tpa::SemiSparsePointerAnalysis& p, const annotation::ExternalTaintTable& t, const TaintEnv& e, const TaintMemo& mm, const CallGraphType& cg, ProgramPointSet& pps): duModule(m), ptrAnalysis(p), extTable(t), env(e), memo(mm), callGraph(cg), imprecisionSources(pps) {}
+	TrackerGlobalState(const DefUseModule& m, const tpa::SemiSparsePointerAnalysis& p, const annotation::ExternalTaintTable& t, const TaintEnv& e, const TaintMemo& mm, const CallGraphType& cg, SourceMap& srcs): duModule(m), ptrAnalysis(p), extTable(t), env(e), memo(mm), callGraph(cg), imprecisionSources(srcs) {}
 
 	const DefUseModule& getDefUseModule() const { return duModule; }
 
@@ -56,14 +65,18 @@ public:
 	const TaintMemo& getMemo() const { return memo; }
 	const CallGraphType& getCallGraph() const { return callGraph; }
 	
-	bool insertVisitedLocation(const ProgramPoint& pp)
+	// Remove from violations the ones pp has already been tracked for with respect to obj and record the rest. Return true if any violation is left
+	bool insertVisitedLocation(const ProgramPoint& pp, TrackedObject obj, ViolationSet& violations)
 	{
-		return visited.insert(pp);
+		auto& seen = visited[pp][obj];
+		violations.intersectWithComplement(seen);
+		seen |= violations;
+		return !violations.empty();
 	}
 
-	void addImprecisionSource(const ProgramPoint& pp)
+	void addImprecisionSource(const ProgramPoint& pp, const ViolationSet& violations)
 	{
-		imprecisionSources.insert(pp);
+		imprecisionSources[pp] |= violations;
 	}
 };
 
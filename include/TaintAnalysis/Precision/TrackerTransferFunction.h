@@ -32,13 +32,15 @@ private:
 	MemorySet evalPtsSet(const ProgramPoint&, tpa::PtsSet, const TaintStore&);
 	ValueSet evalStore(const ProgramPoint&);
 	MemorySet evalLoad(const ProgramPoint&, const TaintStore&);
-	void evalCallInst(const ProgramPoint&);
+	void evalCallInst(const ProgramPoint&, const tpa::MemoryObject*);
 
-	void evalEntryInst(const ProgramPoint&);
-	void evalInst(const ProgramPoint&, const TaintStore*);
+	void evalEntryInst(const ProgramPoint&, const tpa::MemoryObject*);
+	void evalInst(const ProgramPoint&, const TaintStore*, const tpa::MemoryObject*);
+	void evalTracked(const ProgramPoint&, const tpa::MemoryObject*);
 public:
 	TrackerTransferFunction(TrackerGlobalState& g, TrackerWorkList& w): trackerState(g), workList(w) {}
 
+	// Process pp for everything the worklist has tracked it for since it was last dequeued
 	void eval(const ProgramPoint&);
 };
 
@@ -7,6 +7,15 @@
 #include "Util/DataStructure/PriorityWorkList.h"
 #include "Util/DataStructure/TwoLevelWorkList.h"
 
+#include <llvm/ADT/SparseBitVector.h>
+
+#include <unordered_map>
+
+namespace tpa
+{
+	class MemoryObject;
+}
+
 namespace taint
 {
 
@@ -25,22 +34,53 @@ private:
 	using LocalWorkListType = util::PriorityWorkList<const DefUseInstruction*, NodeComparator>;
 	using WorkListType = util::TwoLevelWorkList<GlobalWorkListType, LocalWorkListType>;
 	WorkListType workList;
+public:
+	// Each imprecise sink violation is numbered, and a program point is tracked on behalf of a set of violations
+	using ViolationSet = llvm::SparseBitVector<>;
+	// A program point is tracked either for a memory object it defines, or for its top-level value, which is denoted by nullptr
+	using TrackedObject = const tpa::MemoryObject*;
+	using TrackedMap = std::unordered_map<TrackedObject, ViolationSet>;
+private:
+	// What each enqueued program point is tracked for, and the violations that have reached it that way but have not been propagated from it yet
+	std::unordered_map<ProgramPoint, TrackedMap> pendingViolations;
+	// Same as above, for the last dequeued program point
+	TrackedMap currTracked;
+	// Violations on whose behalf the program point being processed is tracked. Everything enqueued from there inherits them
+	ViolationSet currViolations;
 public:
 	using ElemType = ProgramPoint;
 
 	TrackerWorkList() = default;
 
-	void enqueue(const ProgramPoint& p)
+	void enqueue(const ProgramPoint& p, TrackedObject obj = nullptr)
 	{
+		pendingViolations[p][obj] |= currViolations;
 		workList.enqueue(std::make_pair(tpa::FunctionContext(p.getContext(), p.getDefUseInstruction()->getFunction()), p.getDefUseInstruction()));
 	}
 
 	ProgramPoint dequeue()
 	{
 		auto pair = workList.dequeue();
-		return ProgramPoint(pair.first.getContext(), pair.second);
+		auto pp = ProgramPoint(pair.first.getContext(), pair.second);
+
+		auto itr = pendingViolations.find(pp);
+		if (itr != pendingViolations.end())
+		{
+			currTracked = std::move(itr->second);
+			pendingViolations.erase(itr);
+		}
+		else
+			currTracked.clear();
+		return pp;
 	}
 
+	// Hand out what the last dequeued program point is tracked for
+	TrackedMap takeCurrentTracked() { return std::move(currTracked); }
+
+	ViolationSet& getCurrentViolations() { return currViolations; }
+	const ViolationSet& getCurrentViolations() const { return currViolations; }
+	void setCurrentViolations(ViolationSet v) { currViolations = std::move(v); }
+
 	ProgramPoint front()
 	{
 		auto pair = workList.front();
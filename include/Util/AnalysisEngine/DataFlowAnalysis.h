@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+
 namespace util
 {
 
@@ -9,8 +11,11 @@ class DataFlowAnalysis
 private:
 	GlobalState& globalState;
 	Memo& memo;
+
+	// Number of work items evaluated so far, summed over all runs
+	size_t numIterations;
 public:
-	DataFlowAnalysis(GlobalState& g, Memo& m): globalState(g), memo(m) {}
+	DataFlowAnalysis(GlobalState& g, Memo& m): globalState(g), memo(m), numIterations(0) {}
 
 	DataFlowAnalysis(const DataFlowAnalysis&) = delete;
 	DataFlowAnalysis(DataFlowAnalysis&&) noexcept = default;
@@ -23,6 +28,7 @@ public:
 		while (!workList.empty())
 		{
 			auto item = workList.dequeue();
+			++numIterations;
 			auto localState = memo.lookup(item);
 			auto evalResult = TransferFunction(globalState, localState).eval(item);
 			Propagator(memo, workList).propagate(evalResult);
@@ -35,6 +41,8 @@ public:
 		auto workList = Initializer(globalState, memo).runOnInitState(std::forward<InitialState>(initState));
 		runOnWorkList(std::move(workList));
 	}
+
+	size_t getNumIterations() const { return numIterations; }
 };
 
 }
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace util
+{
+
+// Intrusive child links for the nodes of an append-only trie, meant to be used as a public base class (Node derives from ConcurrentTrieNode<Node>)
+// The children of a node live in an open-addressing hash table keyed by a hash the caller supplies, so finding a child costs O(1) no matter how many call sites a context reaches. Lookups never lock: a slot is filled exactly once and published with a release store, and a table that gets too full is replaced by a bigger copy rather than rehashed in place. Insertions are serialized by a small array of mutexes shared by all nodes (lock striping), which is cheap since a child is only inserted once
+// Nodes are never removed one at a time, which means a pointer to a node stays valid and unique until its subtree is released as a whole
+template <typename Node>
+class ConcurrentTrieNode
+{
+private:
+	struct ChildTable
+	{
+		// The capacity is 2^numBits, and the table is replaced once it is half full
+		unsigned numBits;
+		std::size_t size;
+		std::unique_ptr<std::atomic<const Node*>[]> slots;
+		// Tables are never freed while their node is alive, since a concurrent lookup may still be probing an outgrown one
+		std::unique_ptr<ChildTable> outgrown;
+
+		explicit ChildTable(unsigned b): numBits(b), size(0), slots(new std::atomic<const Node*>[std::size_t(1) << b])
+		{
+			for (std::size_t i = 0, e = capacity(); i < e; ++i)
+				slots[i].store(nullptr, std::memory_order_relaxed);
+		}
+
+		std::size_t capacity() const { return std::size_t(1) << numBits; }
+		// Fibonacci hashing spreads keys that only differ in their low or high bits, such as pointers and small integers
+		std::size_t getSlot(std::size_t hash) const { return static_cast<std::size_t>((static_cast<std::uint64_t>(hash) * 0x9e3779b97f4a7c15ull) >> (64 - numBits)); }
+	};
+
+	mutable std::atomic<ChildTable*> children;
+	std::size_t keyHash;
+
+	static const ConcurrentTrieNode* asTrieNode(const Node* node) { return node; }
+	static ConcurrentTrieNode* asTrieNode(Node* node) { return node; }
+
+	static std::mutex& getInsertLock(const ConcurrentTrieNode* node)
+	{
+		static std::mutex stripes[64];
+		return stripes[std::hash<const void*>()(node) / alignof(Node) % 64];
+	}
+
+	template <typename MatchFunc>
+	static const Node* findInTable(const ChildTable* table, std::size_t hash, MatchFunc&& match)
+	{
+		if (table == nullptr)
+			return nullptr;
+
+		auto mask = table->capacity() - 1;
+		for (auto i = table->getSlot(hash); ; i = (i + 1) & mask)
+		{
+			auto child = table->slots[i].load(std::memory_order_acquire);
+			if (child == nullptr)
+				return nullptr;
+			if (asTrieNode(child)->keyHash == hash && match(*child))
+				return child;
+		}
+	}
+
+	// Store child in an empty slot of table. Only called with the insert lock held, or on a table nobody else sees yet
+	static void insertIntoTable(ChildTable* table, const Node* child)
+	{
+		auto mask = table->capacity() - 1;
+		auto i = table->getSlot(asTrieNode(child)->keyHash);
+		while (table->slots[i].load(std::memory_order_relaxed) != nullptr)
+			i = (i + 1) & mask;
+		table->slots[i].store(child, std::memory_order_release);
+		++table->size;
+	}
+
+	// Return a table with room for one more child. Only called with the insert lock held
+	ChildTable* reserveChildSlot() const
+	{
+		auto table = children.load(std::memory_order_relaxed);
+		if (table != nullptr && (table->size + 1) * 2 <= table->capacity())
+			return table;
+
+		auto newTable = new ChildTable(table == nullptr ? 2 : table->numBits + 1);
+		if (table != nullptr)
+		{
+			for (std::size_t i = 0, e = table->capacity(); i < e; ++i)
+				if (auto child = table->slots[i].load(std::memory_order_relaxed))
+					insertIntoTable(newTable, child);
+			newTable->outgrown.reset(table);
+		}
+		children.store(newTable, std::memory_order_release);
+		return newTable;
+	}
+protected:
+	constexpr ConcurrentTrieNode(): children(nullptr), keyHash(0) {}
+	~ConcurrentTrieNode()
+	{
+		delete children.load(std::memory_order_relaxed);
+	}
+public:
+	ConcurrentTrieNode(const ConcurrentTrieNode&) = delete;
+	ConcurrentTrieNode& operator=(const ConcurrentTrieNode&) = delete;
+
+	// Return the child for which match() holds. If there is none, insert the node returned by create(), which must be allocated with new and satisfy match()
+	// hash must be a hash of the key that match() compares, so equal keys must have equal hashes. create() runs with an insert lock held and must not touch the trie
+	template <typename MatchFunc, typename CreateFunc>
+	const Node* getOrInsertChild(std::size_t hash, MatchFunc&& match, CreateFunc&& create) const
+	{
+		if (auto child = findInTable(children.load(std::memory_order_acquire), hash, match))
+			return child;
+
+		std::lock_guard<std::mutex> lock(getInsertLock(this));
+		// Someone else may have inserted the child since we looked
+		if (auto child = findInTable(children.load(std::memory_order_acquire), hash, match))
+			return child;
+
+		Node* newNode = create();
+		asTrieNode(newNode)->keyHash = hash;
+		insertIntoTable(reserveChildSlot(), newNode);
+		return newNode;
+	}
+
+	// Delete all descendants of this node. Nothing may use the subtree while this runs, and every pointer into it dangles afterwards
+	void releaseChildren()
+	{
+		// Subtrees can be as deep as the call stack they represent, so they are collected breadth-first rather than deleted recursively
+		std::vector<const Node*> nodes;
+		auto collect = [&nodes] (const Node* child) { nodes.push_back(child); };
+		forEachChild(collect);
+		for (std::size_t i = 0; i < nodes.size(); ++i)
+			nodes[i]->forEachChild(collect);
+
+		delete children.exchange(nullptr, std::memory_order_relaxed);
+		for (auto node: nodes)
+			delete node;
+	}
+
+	// The children are visited in no particular order
+	template <typename Callback>
+	void forEachChild(Callback&& cb) const
+	{
+		auto table = children.load(std::memory_order_acquire);
+		if (table == nullptr)
+			return;
+		for (std::size_t i = 0, e = table->capacity(); i < e; ++i)
+			if (auto child = table->slots[i].load(std::memory_order_acquire))
+				cb(child);
+	}
+};
+
+}
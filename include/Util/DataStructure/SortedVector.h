@@ -262,6 +262,40 @@ public:
 		return ret;
 	}
 
+	// Same as !intersects(lhs, rhs).empty(), but stops at the first common element and allocates nothing. Sets whose ranges do not meet are rejected without looking inside
+	static bool overlaps(const SortedVector& lhs, const SortedVector& rhs)
+	{
+		if (lhs.empty() || rhs.empty())
+			return false;
+
+		Comparator cmp;
+		if (cmp(lhs.vec.back(), rhs.vec.front()) || cmp(rhs.vec.back(), lhs.vec.front()))
+			return false;
+
+		// Binary search the elements of a much smaller set in the larger one instead of walking both
+		auto const& small = lhs.size() <= rhs.size() ? lhs : rhs;
+		auto const& large = lhs.size() <= rhs.size() ? rhs : lhs;
+		if (small.size() * 8 < large.size())
+		{
+			for (auto const& elem: small.vec)
+				if (std::binary_search(large.vec.begin(), large.vec.end(), elem, cmp))
+					return true;
+			return false;
+		}
+
+		auto i = lhs.vec.begin(), j = rhs.vec.begin();
+		while (i != lhs.vec.end() && j != rhs.vec.end())
+		{
+			if (cmp(*i, *j))
+				++i;
+			else if (cmp(*j, *i))
+				++j;
+			else
+				return true;
+		}
+		return false;
+	}
+
 	// Iterators
 	iterator begin() { return vec.begin(); }
 	iterator end() { return vec.end(); }
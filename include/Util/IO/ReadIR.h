@@ -4,6 +4,7 @@
 
 namespace llvm
 {
+	class LLVMContext;
 	class Module;
 }
 
@@ -13,7 +14,11 @@ namespace io
 {
 
 std::unique_ptr<llvm::Module> readModuleFromFile(const char* fileName);
+// Parse the module into the given context. Print the error and return nullptr if the file cannot be parsed
+std::unique_ptr<llvm::Module> readModuleFromFile(const char* fileName, llvm::LLVMContext& context);
 std::unique_ptr<llvm::Module> readModuleFromString(const char *assembly);
+// Same as above, for assembly that is not known to be well-formed
+std::unique_ptr<llvm::Module> readModuleFromString(const char *assembly, llvm::LLVMContext& context);
 
 }
 }
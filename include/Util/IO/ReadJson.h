@@ -0,0 +1,142 @@
+#pragma once
+
+#include <llvm/ADT/StringRef.h>
+
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace util
+{
+namespace io
+{
+
+// A parsed JSON value. A number without a fraction or an exponent is an integer, and any other number a double
+class JsonValue
+{
+public:
+	enum class Kind: std::uint8_t
+	{
+		Null,
+		Bool,
+		Integer,
+		Double,
+		String,
+		Array,
+		Object,
+	};
+
+	using ArrayType = std::vector<JsonValue>;
+	// Members are kept in input order. Objects in requests are small enough that a linear search beats a map
+	using ObjectType = std::vector<std::pair<std::string, JsonValue>>;
+private:
+	Kind kind;
+	std::int64_t intVal;
+	double doubleVal;
+	std::string strVal;
+	ArrayType elems;
+	ObjectType members;
+
+	JsonValue(Kind k): kind(k), intVal(0), doubleVal(0) {}
+public:
+	JsonValue(): kind(Kind::Null), intVal(0), doubleVal(0) {}
+
+	static JsonValue getBool(bool b)
+	{
+		JsonValue ret(Kind::Bool);
+		ret.intVal = b;
+		return ret;
+	}
+	static JsonValue getInteger(std::int64_t i)
+	{
+		JsonValue ret(Kind::Integer);
+		ret.intVal = i;
+		return ret;
+	}
+	static JsonValue getDouble(double d)
+	{
+		JsonValue ret(Kind::Double);
+		ret.doubleVal = d;
+		return ret;
+	}
+	static JsonValue getString(std::string s)
+	{
+		JsonValue ret(Kind::String);
+		ret.strVal = std::move(s);
+		return ret;
+	}
+	static JsonValue getArray(ArrayType a)
+	{
+		JsonValue ret(Kind::Array);
+		ret.elems = std::move(a);
+		return ret;
+	}
+	static JsonValue getObject(ObjectType o)
+	{
+		JsonValue ret(Kind::Object);
+		ret.members = std::move(o);
+		return ret;
+	}
+
+	Kind getKind() const { return kind; }
+	bool isNull() const { return kind == Kind::Null; }
+	bool isBool() const { return kind == Kind::Bool; }
+	bool isInteger() const { return kind == Kind::Integer; }
+	bool isDouble() const { return kind == Kind::Double; }
+	bool isString() const { return kind == Kind::String; }
+	bool isArray() const { return kind == Kind::Array; }
+	bool isObject() const { return kind == Kind::Object; }
+
+	bool getAsBool() const
+	{
+		assert(isBool());
+		return intVal != 0;
+	}
+	std::int64_t getAsInteger() const
+	{
+		assert(isInteger());
+		return intVal;
+	}
+	double getAsDouble() const
+	{
+		assert(isDouble());
+		return doubleVal;
+	}
+	const std::string& getAsString() const
+	{
+		assert(isString());
+		return strVal;
+	}
+	const ArrayType& getAsArray() const
+	{
+		assert(isArray());
+		return elems;
+	}
+	const ObjectType& getAsObject() const
+	{
+		assert(isObject());
+		return members;
+	}
+
+	// Return the member with the given key, or nullptr if this is not an object or has no such member
+	const JsonValue* getMember(const llvm::StringRef& key) const
+	{
+		if (!isObject())
+			return nullptr;
+		for (auto const& member: members)
+			if (member.first == key)
+				return &member.second;
+		return nullptr;
+	}
+};
+
+// Arrays and objects nested deeper than this are rejected
+constexpr unsigned maxJsonDepth = 256;
+
+// Parse str, which must hold exactly one JSON value with optional surrounding whitespace. Return false if it is malformed or nested too deep
+bool parseJson(const llvm::StringRef& str, JsonValue& value);
+
+}
+}
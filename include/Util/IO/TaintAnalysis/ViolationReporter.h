@@ -0,0 +1,45 @@
+#pragma once
+
+#include "TaintAnalysis/Support/SinkViolationRecord.h"
+
+#include <tuple>
+#include <unordered_set>
+
+namespace llvm
+{
+	class Instruction;
+	class raw_ostream;
+}
+
+namespace util
+{
+namespace io
+{
+
+// Write sink violations to os as JSON Lines, one object per violation, as soon as they are handed over. The same violation (sink instruction, argument, taint class and actual value) reached under different calling contexts is only written once
+class JsonViolationReporter
+{
+private:
+	llvm::raw_ostream& os;
+
+	using ViolationKey = std::tuple<const llvm::Instruction*, uint8_t, annotation::TClass, taint::TaintLattice>;
+	struct ViolationKeyHash
+	{
+		size_t operator()(const ViolationKey& key) const;
+	};
+	std::unordered_set<ViolationKey, ViolationKeyHash> reported;
+
+	size_t numDuplicates;
+
+	void writeViolation(const taint::ProgramPoint&, const taint::SinkViolation&);
+public:
+	JsonViolationReporter(llvm::raw_ostream& o): os(o), numDuplicates(0) {}
+
+	void report(const taint::ProgramPoint&, const taint::SinkViolationList&);
+
+	size_t getNumReported() const { return reported.size(); }
+	size_t getNumDuplicates() const { return numDuplicates; }
+};
+
+}
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+namespace llvm
+{
+	class raw_ostream;
+	class StringRef;
+}
+
+namespace util
+{
+namespace io
+{
+
+class JsonValue;
+
+// Write str to os as a quoted JSON string literal, escaping quotes, backslashes and control characters
+void writeJsonString(llvm::raw_ostream& os, llvm::StringRef str);
+// Write value to os on a single line
+void writeJsonValue(llvm::raw_ostream& os, const JsonValue& value);
+
+}
+}
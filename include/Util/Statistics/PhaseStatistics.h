@@ -0,0 +1,87 @@
+#pragma once
+
+#include <llvm/ADT/StringRef.h>
+
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace llvm
+{
+	class raw_ostream;
+}
+
+namespace util
+{
+
+// Wall time, memory usage and object counts of the phases of one run of a tool, in the order in which the phases ran. Phases do not nest
+// Memory is sampled from the OS, so it covers every allocation of the process, including LLVM's
+//   - peakRSS is the highest resident set size during the phase. It is unknown where the kernel does not let us reset the high-water mark (anything but Linux 4.0 and later), since all we could report then is the peak of the whole process so far
+//   - rssDelta is how much the resident set grew from the beginning to the end of the phase, which is roughly what the phase left allocated for the phases after it
+class PhaseStatistics
+{
+public:
+	struct Phase
+	{
+		std::string name;
+		// In milliseconds
+		double wallTime;
+		// In kilobytes. peakRSS is -1 if it is unknown
+		long peakRSS;
+		long rssDelta;
+		std::vector<std::pair<std::string, size_t>> counters;
+	};
+private:
+	using Clock = std::chrono::steady_clock;
+
+	std::vector<Phase> phases;
+
+	bool inPhase;
+	Clock::time_point phaseStart;
+	long phaseStartRSS;
+	bool peakWasReset;
+	long processPeakRSS;
+public:
+	PhaseStatistics(): inPhase(false), phaseStartRSS(0), peakWasReset(false), processPeakRSS(0) {}
+
+	void beginPhase(const llvm::StringRef& name);
+	void endPhase();
+	// Attach a count, e.g. the number of objects a phase created, to the current phase, or to the last one if none is running
+	void addCounter(const llvm::StringRef& name, size_t value);
+
+	const std::vector<Phase>& getPhases() const { return phases; }
+	double getTotalWallTime() const;
+	// The highest resident set size seen at the end of any phase, in kilobytes. Unlike the peaks of the phases it is always known
+	long getPeakRSS() const { return processPeakRSS; }
+
+	// Print a table for humans
+	void print(llvm::raw_ostream&) const;
+	// Write everything as a single JSON object. The keys always come in the same order, so the output of two runs can be diffed
+	void writeJson(llvm::raw_ostream&) const;
+	// Same as above. "-" stands for stdout. Exit with an error message if the file cannot be written
+	void writeJsonToFile(const char* fileName) const;
+};
+
+// Make the enclosing scope one phase. A null PhaseStatistics turns it into a no-op, so that the analyses can be instrumented whether or not the caller collects statistics
+class ScopedPhase
+{
+private:
+	PhaseStatistics* stats;
+public:
+	ScopedPhase(PhaseStatistics* s, const llvm::StringRef& name): stats(s)
+	{
+		if (stats != nullptr)
+			stats->beginPhase(name);
+	}
+	~ScopedPhase()
+	{
+		if (stats != nullptr)
+			stats->endPhase();
+	}
+
+	ScopedPhase(const ScopedPhase&) = delete;
+	ScopedPhase& operator=(const ScopedPhase&) = delete;
+};
+
+}
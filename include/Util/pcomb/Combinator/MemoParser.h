@@ -0,0 +1,60 @@
+#ifndef PCOMB_MEMO_PARSER_H
+#define PCOMB_MEMO_PARSER_H
+
+#include "Util/pcomb/Parser/Parser.h"
+
+#include <experimental/optional>
+#include <memory>
+
+namespace pcomb
+{
+
+// The MemoParser combinator remembers the result of a parser p at the last input position it was applied to, so that the alternatives of an AltParser that share a prefix (e.g. several kinds of annotation entries start with the function name) parse that prefix only once
+// This is packrat memoization restricted to one position: an AltParser retries its alternatives at the same position one after another, and a full table keyed by position costs more than it saves on the annotation grammars
+// Copies of a MemoParser share the memo entry, which is how the alternatives see each other's results
+template <typename ParserA>
+class MemoParser: public Parser<typename ParserA::OutputType>
+{
+public:
+	using OutputType = typename ParserA::OutputType;
+	using ResultType = typename Parser<OutputType>::ResultType;
+private:
+	static_assert(std::is_base_of<Parser<OutputType>, ParserA>::value, "MemoParser only accepts parser type");
+
+	struct MemoEntry
+	{
+		const char* pos;
+		size_t size;
+		std::experimental::optional<ResultType> result;
+	};
+
+	ParserA pa;
+	std::shared_ptr<MemoEntry> lastEntry;
+public:
+	MemoParser(const ParserA& p): pa(p), lastEntry(std::make_shared<MemoEntry>()) {}
+	MemoParser(ParserA&& p): pa(std::move(p)), lastEntry(std::make_shared<MemoEntry>()) {}
+
+	ResultType parse(const InputStream& input) const override
+	{
+		auto& entry = *lastEntry;
+		if (entry.result && entry.pos == input.getRawBuffer() && entry.size == input.size())
+			return *entry.result;
+
+		auto res = pa.parse(input);
+		entry.pos = input.getRawBuffer();
+		entry.size = input.size();
+		entry.result = res;
+		return res;
+	}
+};
+
+template <typename ParserA>
+auto memo(ParserA&& p)
+{
+	using ParserType = std::remove_reference_t<ParserA>;
+	return MemoParser<ParserType>(std::forward<ParserA>(p));
+}
+
+}
+
+#endif
@@ -40,17 +40,11 @@ public:
 
 	ResultType parse(const InputStream& input) const override
 	{
-		auto resStream = input;
-
-		while (!resStream.isEOF())
-		{
-			auto firstChar = resStream.getRawBuffer()[0];
-			if (charBits.test(static_cast<unsigned char>(firstChar)))
-				resStream = resStream.consume(1);
-			else
-				break;
-		}
-		return pa.parse(resStream);
+		auto str = input.getRemainingString();
+		size_t len = 0;
+		while (len < str.size() && charBits.test(static_cast<unsigned char>(str[len])))
+			++len;
+		return pa.parse(input.consume(len));
 	}
 };
 
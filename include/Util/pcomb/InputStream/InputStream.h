@@ -8,20 +8,23 @@
 namespace pcomb
 {
 
+// InputStream is a view of the unconsumed part of the input. Consuming is O(1): the line and column numbers are only computed on demand, by counting from the start of the input, which is meant for error reporting
 class InputStream
 {
 private:
-	struct Position
-	{
-		size_t row, col;
-	};
-
+	const char* bufBegin;
 	llvm::StringRef str;
-	Position pos;
 
-	InputStream(const llvm::StringRef& s, const Position& p): str(s), pos(p) {}
+	InputStream(const char* b, const llvm::StringRef& s): bufBegin(b), str(s) {}
+
+	size_t getLineStart() const
+	{
+		auto consumed = llvm::StringRef(bufBegin, str.data() - bufBegin);
+		auto pos = consumed.rfind('\n');
+		return pos == llvm::StringRef::npos ? 0 : pos + 1;
+	}
 public:
-	InputStream(llvm::StringRef s): str(s), pos({1, 1}) {}
+	InputStream(llvm::StringRef s): bufBegin(s.data()), str(s) {}
 
 	bool isEOF() const
 	{
@@ -33,28 +36,31 @@ public:
 		return str.data();
 	}
 
+	size_t size() const
+	{
+		return str.size();
+	}
+
+	llvm::StringRef getRemainingString() const
+	{
+		return str;
+	}
+
 	InputStream consume(size_t n) const
 	{
 		assert(n <= str.size());
-		auto newPos = pos;
-		for (auto i = 0u; i < n; ++i)
-		{
-			auto ch = str[i];
-			if (ch == '\n')
-			{
-				++newPos.row;
-				newPos.col = 1;
-			}
-			else
-				++newPos.col;
-		}
-		return InputStream(str.substr(n), newPos);
-	}
-
-	size_t getLineNumber() const { return pos.row; }
-	size_t getColumnNumber() const { return pos.col; }
-};
+		return InputStream(bufBegin, str.substr(n));
+	}
 
+	size_t getLineNumber() const
+	{
+		return llvm::StringRef(bufBegin, str.data() - bufBegin).count('\n') + 1;
+	}
+	size_t getColumnNumber() const
+	{
+		return (str.data() - bufBegin) - getLineStart() + 1;
+	}
+};
 }
 
 #endif
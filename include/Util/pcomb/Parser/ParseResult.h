@@ -5,6 +5,7 @@
 
 #include <cassert>
 #include <experimental/optional>
+#include <type_traits>
 
 namespace pcomb
 {
@@ -18,7 +19,8 @@ private:
 	InputStream input;
 	std::experimental::optional<OutputType> attr;
 public:
-	template <typename I>
+	// Excluding ParseResult itself keeps copies of non-const results from picking this constructor over the copy constructor
+	template <typename I, typename = std::enable_if_t<!std::is_same<std::decay_t<I>, ParseResult>::value>>
 	ParseResult(I&& i): input(std::forward<I>(i)) {}
 
 	template <typename I, typename O>
@@ -0,0 +1,199 @@
+#ifndef PCOMB_SCAN_PARSER_H
+#define PCOMB_SCAN_PARSER_H
+
+#include "Util/pcomb/Parser/Parser.h"
+
+#include <llvm/ADT/StringRef.h>
+
+#include <bitset>
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace pcomb
+{
+
+namespace detail
+{
+
+// A set of chars, tested with a single table lookup
+class CharClass
+{
+private:
+	std::bitset<256> charBits;
+public:
+	CharClass() = default;
+	CharClass(const llvm::StringRef& chars) { addChars(chars); }
+
+	CharClass& addChars(const llvm::StringRef& chars)
+	{
+		for (auto c: chars)
+			charBits.set(static_cast<unsigned char>(c));
+		return *this;
+	}
+	CharClass& addRange(char lo, char hi)
+	{
+		// Count with unsigned rather than unsigned char, which would wrap around and never stop when hi is '\xff'
+		for (auto c = static_cast<unsigned>(static_cast<unsigned char>(lo)); c <= static_cast<unsigned char>(hi); ++c)
+			charBits.set(c);
+		return *this;
+	}
+
+	bool contains(char c) const { return charBits.test(static_cast<unsigned char>(c)); }
+
+	// Return the length of the longest prefix of s whose chars are all in this class
+	size_t scan(const llvm::StringRef& s) const
+	{
+		size_t i = 0;
+		while (i < s.size() && contains(s[i]))
+			++i;
+		return i;
+	}
+};
+
+inline CharClass getWordCharClass()
+{
+	return CharClass().addRange('a', 'z').addRange('A', 'Z').addRange('0', '9').addChars("_");
+}
+
+// Same as CharClass::scan() on the word chars [A-Za-z0-9_] plus extra, but checks 16 bytes at a time where SSE2 is available. Identifiers are the longest tokens of a typical annotation file
+inline size_t scanWord(const llvm::StringRef& s, const CharClass& wordClass, const CharClass& extra)
+{
+	size_t i = 0;
+#ifdef __SSE2__
+	auto inRange = [] (__m128i v, char lo, char hi)
+	{
+		// Bytes at or above 0x80 compare as negative, so they never fall into an ASCII range
+		return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(lo - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8(hi + 1)));
+	};
+	while (i + 16 <= s.size())
+	{
+		auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s.data() + i));
+		auto lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+		auto isWord = _mm_or_si128(
+			_mm_or_si128(inRange(lower, 'a', 'z'), inRange(v, '0', '9')),
+			_mm_cmpeq_epi8(v, _mm_set1_epi8('_'))
+		);
+		auto mask = static_cast<unsigned>(_mm_movemask_epi8(isWord));
+		if (mask != 0xffff)
+		{
+			i += __builtin_ctz(~mask);
+			// The block scan only knows the word chars. Continue with the table if we stopped at an extra char
+			if (!extra.contains(s[i]))
+				return i;
+			++i;
+		}
+		else
+			i += 16;
+	}
+#endif
+	while (i < s.size() && (wordClass.contains(s[i]) || extra.contains(s[i])))
+		++i;
+	return i;
+}
+
+}	// end of namespace detail
+
+// IdentifierParser matches one or more chars of [A-Za-z0-9_] plus the given extra chars, which is the same as regex("[\\w<extra>]+") without going through std::regex
+class IdentifierParser: public Parser<llvm::StringRef>
+{
+private:
+	detail::CharClass wordClass;
+	detail::CharClass extraClass;
+public:
+	using OutputType = llvm::StringRef;
+	using ResultType = typename Parser<llvm::StringRef>::ResultType;
+
+	IdentifierParser(const llvm::StringRef& extraChars): wordClass(detail::getWordCharClass()), extraClass(extraChars) {}
+
+	ResultType parse(const InputStream& input) const override
+	{
+		auto ret = ResultType(input);
+
+		auto str = input.getRemainingString();
+		auto len = detail::scanWord(str, wordClass, extraClass);
+		if (len > 0)
+			ret = ResultType(input.consume(len), str.substr(0, len));
+
+		return ret;
+	}
+};
+
+inline IdentifierParser ident(const llvm::StringRef& extraChars = "")
+{
+	return IdentifierParser(extraChars);
+}
+
+// CharClassParser matches one or more chars in a char class
+class CharClassParser: public Parser<llvm::StringRef>
+{
+private:
+	detail::CharClass charClass;
+public:
+	using OutputType = llvm::StringRef;
+	using ResultType = typename Parser<llvm::StringRef>::ResultType;
+
+	CharClassParser(const detail::CharClass& c): charClass(c) {}
+
+	ResultType parse(const InputStream& input) const override
+	{
+		auto ret = ResultType(input);
+
+		auto str = input.getRemainingString();
+		auto len = charClass.scan(str);
+		if (len > 0)
+			ret = ResultType(input.consume(len), str.substr(0, len));
+
+		return ret;
+	}
+};
+
+// Same as regex("\\d+")
+inline CharClassParser integer()
+{
+	return CharClassParser(detail::CharClass().addRange('0', '9'));
+}
+
+inline CharClassParser whitespace(const llvm::StringRef& chars = " \t\n\v\f\r")
+{
+	return CharClassParser(detail::CharClass(chars));
+}
+
+// LineCommentParser matches a comment that starts with the given char and runs up to and including the end of the line, or up to the end of the input if the last line has no newline
+// It is the same as regex("#.*\\n"), but finds the newline with memchr
+class LineCommentParser: public Parser<llvm::StringRef>
+{
+private:
+	char start;
+public:
+	using OutputType = llvm::StringRef;
+	using ResultType = typename Parser<llvm::StringRef>::ResultType;
+
+	LineCommentParser(char c): start(c) {}
+
+	ResultType parse(const InputStream& input) const override
+	{
+		auto ret = ResultType(input);
+
+		auto str = input.getRemainingString();
+		if (!str.empty() && str[0] == start)
+		{
+			auto newline = static_cast<const char*>(std::memchr(str.data(), '\n', str.size()));
+			auto len = newline == nullptr ? str.size() : newline - str.data() + 1;
+			ret = ResultType(input.consume(len), str.substr(0, len));
+		}
+
+		return ret;
+	}
+};
+
+inline LineCommentParser lineComment(char start = '#')
+{
+	return LineCommentParser(start);
+}
+
+}
+
+#endif
@@ -24,9 +24,8 @@ public:
 	{
 		auto ret = ResultType(input);
 
-		auto inputView = llvm::StringRef(input.getRawBuffer(), pattern.size());
-		if (pattern.compare(inputView) == 0)
-			ret = ResultType(input.consume(pattern.size()), inputView);
+		if (input.getRemainingString().startswith(pattern))
+			ret = ResultType(input.consume(pattern.size()), llvm::StringRef(input.getRawBuffer(), pattern.size()));
 		
 		return ret;
 	}
@@ -4,6 +4,7 @@
 // This is a header that pulls in all the headers for parsers and combinators
 #include "Util/pcomb/Parser/PredicateCharParser.h"
 #include "Util/pcomb/Parser/RegexParser.h"
+#include "Util/pcomb/Parser/ScanParser.h"
 #include "Util/pcomb/Parser/StringParser.h"
 
 #include "Util/pcomb/Combinator/AltParser.h"
@@ -13,5 +14,6 @@
 #include "Util/pcomb/Combinator/ParserAdapter.h"
 #include "Util/pcomb/Combinator/LazyParser.h"
 #include "Util/pcomb/Combinator/LexemeParser.h"
+#include "Util/pcomb/Combinator/MemoParser.h"
 
 #endif
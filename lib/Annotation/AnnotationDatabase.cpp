@@ -0,0 +1,235 @@
+#include "Annotation/AnnotationDatabase.h"
+#include "Util/IO/ReadFile.h"
+
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/ToolOutputFile.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace llvm;
+
+namespace annotation
+{
+
+namespace
+{
+
+const char dbMagic[] = "TPAANNO\x01";
+const size_t dbMagicSize = 8;
+const size_t dbHeaderSize = dbMagicSize + 4 + 4 + 4 + 4;
+const size_t dbEntrySize = 16;
+
+enum class PositionTag: std::uint8_t
+{
+	Arg,
+	AfterArg,
+	Ret,
+};
+
+void writeU32(raw_ostream& os, std::uint32_t val)
+{
+	char bytes[4] = { static_cast<char>(val), static_cast<char>(val >> 8), static_cast<char>(val >> 16), static_cast<char>(val >> 24) };
+	os.write(bytes, 4);
+}
+
+std::uint32_t readU32(const std::uint8_t* in)
+{
+	return static_cast<std::uint32_t>(in[0]) | (static_cast<std::uint32_t>(in[1]) << 8) | (static_cast<std::uint32_t>(in[2]) << 16) | (static_cast<std::uint32_t>(in[3]) << 24);
+}
+
+}
+
+void reportMalformedDatabase(const char* reason)
+{
+	errs() << "Malformed annotation database: " << reason << "\n";
+	std::exit(-1);
+}
+
+void AnnotationDatabaseWriter::addEntry(const StringRef& name, std::vector<AnnotationRecord> records)
+{
+	entries.push_back(Entry{ name.str(), std::move(records) });
+}
+
+void AnnotationDatabaseWriter::write(raw_ostream& os)
+{
+	// Sorting makes the output independent of the hash order of the source table
+	std::sort(
+		entries.begin(),
+		entries.end(),
+		[] (const Entry& lhs, const Entry& rhs)
+		{
+			return lhs.name < rhs.name;
+		}
+	);
+
+	std::uint32_t strTableSize = 0, numRecords = 0;
+	for (auto const& entry: entries)
+	{
+		strTableSize += entry.name.size();
+		numRecords += entry.records.size();
+	}
+
+	os.write(dbMagic, dbMagicSize);
+	char kindBytes[4] = { static_cast<char>(kind), static_cast<char>(sizeof(AnnotationRecord)), 0, 0 };
+	os.write(kindBytes, 4);
+	writeU32(os, entries.size());
+	writeU32(os, strTableSize);
+	writeU32(os, numRecords);
+
+	std::uint32_t nameOffset = 0, recordIndex = 0;
+	for (auto const& entry: entries)
+	{
+		writeU32(os, nameOffset);
+		writeU32(os, entry.name.size());
+		writeU32(os, recordIndex);
+		writeU32(os, entry.records.size());
+		nameOffset += entry.name.size();
+		recordIndex += entry.records.size();
+	}
+
+	for (auto const& entry: entries)
+		os << entry.name;
+	for (auto const& entry: entries)
+		for (auto const& record: entry.records)
+			os.write(reinterpret_cast<const char*>(record.data()), record.size());
+}
+
+void AnnotationDatabaseWriter::writeToFile(const char* fileName)
+{
+	std::error_code ec;
+	tool_output_file out(fileName, ec, sys::fs::F_None);
+	if (ec)
+	{
+		errs() << "Failed to write annotation database " << fileName << ": " << ec.message() << "\n";
+		std::exit(-1);
+	}
+
+	write(out.os());
+	out.keep();
+}
+
+bool AnnotationDatabaseReader::isDatabase(const StringRef& buffer)
+{
+	return buffer.size() >= dbMagicSize && std::memcmp(buffer.data(), dbMagic, dbMagicSize) == 0;
+}
+
+AnnotationDatabaseReader::AnnotationDatabaseReader(const StringRef& buffer, AnnotationKind kind)
+{
+	if (!isDatabase(buffer) || buffer.size() < dbHeaderSize)
+		reportMalformedDatabase("bad header");
+
+	auto header = reinterpret_cast<const std::uint8_t*>(buffer.data()) + dbMagicSize;
+	if (header[0] != static_cast<std::uint8_t>(kind))
+		reportMalformedDatabase("wrong annotation kind");
+	if (header[1] != sizeof(AnnotationRecord))
+		reportMalformedDatabase("unsupported record size");
+
+	numEntries = readU32(header + 4);
+	auto strTableSize = readU32(header + 8);
+	auto numRecords = readU32(header + 12);
+
+	std::uint64_t expectedSize = dbHeaderSize + static_cast<std::uint64_t>(numEntries) * dbEntrySize + strTableSize + static_cast<std::uint64_t>(numRecords) * sizeof(AnnotationRecord);
+	if (expectedSize != buffer.size())
+		reportMalformedDatabase("size mismatch");
+
+	entryTable = reinterpret_cast<const std::uint8_t*>(buffer.data()) + dbHeaderSize;
+	stringTable = reinterpret_cast<const char*>(entryTable + numEntries * dbEntrySize);
+	records = reinterpret_cast<const AnnotationRecord*>(stringTable + strTableSize);
+
+	for (std::uint32_t i = 0; i < numEntries; ++i)
+	{
+		auto entry = entryTable + i * dbEntrySize;
+		if (static_cast<std::uint64_t>(readU32(entry)) + readU32(entry + 4) > strTableSize)
+			reportMalformedDatabase("name out of range");
+		if (static_cast<std::uint64_t>(readU32(entry + 8)) + readU32(entry + 12) > numRecords)
+			reportMalformedDatabase("record out of range");
+		// Lookups binary search the names
+		if (i > 0 && getName(i - 1) >= getName(i))
+			reportMalformedDatabase("entries not sorted by name");
+	}
+}
+
+StringRef AnnotationDatabaseReader::getName(std::uint32_t i) const
+{
+	assert(i < numEntries);
+	auto entry = entryTable + i * dbEntrySize;
+	return StringRef(stringTable + readU32(entry), readU32(entry + 4));
+}
+
+ArrayRef<AnnotationRecord> AnnotationDatabaseReader::getRecords(std::uint32_t i) const
+{
+	assert(i < numEntries);
+	auto entry = entryTable + i * dbEntrySize;
+	return ArrayRef<AnnotationRecord>(records + readU32(entry + 8), readU32(entry + 12));
+}
+
+std::uint32_t AnnotationDatabaseReader::findEntry(const StringRef& name) const
+{
+	std::uint32_t lo = 0, hi = numEntries;
+	while (lo < hi)
+	{
+		auto mid = lo + (hi - lo) / 2;
+		auto cmp = getName(mid).compare(name);
+		if (cmp == 0)
+			return mid;
+		if (cmp < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return numEntries;
+}
+
+std::string getAnnotationDatabaseName(const StringRef& fileName)
+{
+	return (fileName + ".db").str();
+}
+
+std::unique_ptr<MemoryBuffer> readAnnotationFile(const char* fileName)
+{
+	auto dbName = getAnnotationDatabaseName(fileName);
+
+	sys::fs::file_status dbStatus, textStatus;
+	if (!sys::fs::status(dbName, dbStatus) && sys::fs::is_regular_file(dbStatus))
+	{
+		if (sys::fs::status(fileName, textStatus) || dbStatus.getLastModificationTime() >= textStatus.getLastModificationTime())
+			return util::io::readFileIntoBuffer(dbName.data());
+	}
+
+	return util::io::readFileIntoBuffer(fileName);
+}
+
+void encodePosition(const APosition& pos, std::uint8_t* out)
+{
+	if (pos.isReturnPosition())
+	{
+		out[0] = static_cast<std::uint8_t>(PositionTag::Ret);
+		out[1] = 0;
+	}
+	else
+	{
+		auto const& argPos = pos.getAsArgPosition();
+		out[0] = static_cast<std::uint8_t>(argPos.isAfterArgPosition() ? PositionTag::AfterArg : PositionTag::Arg);
+		static_assert(sizeof(argPos.getArgIndex()) == 1, "Argument indices no longer fit in one byte of a record");
+		out[1] = argPos.getArgIndex();
+	}
+}
+
+APosition decodePosition(const std::uint8_t* in)
+{
+	switch (static_cast<PositionTag>(in[0]))
+	{
+		case PositionTag::Arg:
+			return APosition::getArgPosition(in[1]);
+		case PositionTag::AfterArg:
+			return APosition::getAfterArgPosition(in[1]);
+		case PositionTag::Ret:
+			return APosition::getReturnPosition();
+	}
+	reportMalformedDatabase("bad position");
+	return APosition::getReturnPosition();
+}
+
+}
@@ -1,5 +1,5 @@
+#include "Annotation/AnnotationDatabase.h"
 #include "Annotation/ModRef/ExternalModRefTable.h"
-#include "Util/IO/ReadFile.h"
 #include "Util/pcomb/pcomb.h"
 
 #include <llvm/ADT/StringRef.h>
@@ -13,28 +13,51 @@ namespace annotation
 
 const ModRefEffectSummary* ExternalModRefTable::lookup(const StringRef& name) const
 {
-	auto itr = table.find(name);
-	if (itr == table.end())
-		return nullptr;
-	else
-		return &itr->second;
+	if (table)
+	{
+		auto itr = table->find(name);
+		if (itr != table->end())
+			return &itr->second;
+	}
+	if (database)
+		return database->lookup(name);
+	return nullptr;
+}
+
+const ModRefEffectSummary* ExternalModRefTable::lookup(const Function* f) const
+{
+	const ModRefEffectSummary* summary;
+	if (binding.lookup(f, summary))
+		return summary;
+	return lookup(f->getName());
+}
+
+void ExternalModRefTable::bindModule(const Module& module)
+{
+	binding.bind(module, *this);
 }
 
 ExternalModRefTable ExternalModRefTable::buildTable(const StringRef& fileContent)
 {
 	ExternalModRefTable table;
+	MapType entries;
 
 	auto idx = rule(
-		regex("\\d+"),
+		integer(),
 		[] (auto const& digits) -> uint8_t
 		{
 			auto num = std::stoul(digits);
-			assert(num < 256);
+			// Positions store the index in one byte
+			if (num > 255)
+			{
+				errs() << "Argument index " << num << " is out of range. At most 256 arguments can be annotated\n";
+				std::exit(-1);
+			}
 			return num;
 		}
 	);
 
-	auto id = regex("[\\w\\.]+");
+	auto id = ident(".");
 
 	auto marg = rule(
 		seq(str("Arg"), idx),
@@ -103,10 +126,10 @@ ExternalModRefTable ExternalModRefTable::buildTable(const StringRef& fileContent
 			token(mpos),
 			token(mclass)
 		),
-		[&table] (auto const& tuple)
+		[&entries] (auto const& tuple)
 		{
 			auto entry = ModRefEffect(std::get<1>(tuple), std::get<3>(tuple), std::get<2>(tuple));
-			table.table[std::get<0>(tuple)].addEffect(std::move(entry));
+			entries[std::get<0>(tuple)].addEffect(std::move(entry));
 			return true;
 		}
 	);
@@ -116,16 +139,16 @@ ExternalModRefTable ExternalModRefTable::buildTable(const StringRef& fileContent
 			token(str("IGNORE")),
 			token(id)
 		),
-		[&table] (auto const& pair)
+		[&entries] (auto const& pair)
 		{
-			assert(table.lookup(std::get<1>(pair)) == nullptr && "Ignore entry should not co-exist with other entries");
-			table.table.insert(std::make_pair(std::get<1>(pair), ModRefEffectSummary()));
+			assert(entries.count(std::get<1>(pair)) == 0 && "Ignore entry should not co-exist with other entries");
+			entries.insert(std::make_pair(std::get<1>(pair), ModRefEffectSummary()));
 			return false;
 		}
 	);
 
 	auto commentEntry = rule(
-		token(regex("#.*\\n")),
+		token(lineComment('#')),
 		[] (auto const&)
 		{
 			return false;
@@ -143,13 +166,53 @@ ExternalModRefTable ExternalModRefTable::buildTable(const StringRef& fileContent
 		std::exit(-1);
 	}
 
+	table.table = std::make_shared<const MapType>(std::move(entries));
 	return table;
 }
 
 ExternalModRefTable ExternalModRefTable::loadFromFile(const char* fileName)
 {
-	auto memBuf = util::io::readFileIntoBuffer(fileName);
+	auto memBuf = readAnnotationFile(fileName);
+	if (AnnotationDatabaseReader::isDatabase(memBuf->getBuffer()))
+		return loadFromDatabase(std::move(memBuf));
 	return buildTable(memBuf->getBuffer());
 }
 
+ExternalModRefTable ExternalModRefTable::loadFromDatabase(std::unique_ptr<MemoryBuffer> memBuf)
+{
+	ExternalModRefTable table;
+	table.database = std::make_shared<const AnnotationDatabaseTable<ModRefEffectSummary>>(
+		std::move(memBuf),
+		AnnotationKind::ModRef,
+		[] (const AnnotationRecord& record, ModRefEffectSummary& summary)
+		{
+			auto type = decodeEnum(record[0], ModRefType::Ref, "bad mod/ref type");
+			auto mClass = decodeEnum(record[1], ModRefClass::ReachableMemory, "bad mod/ref class");
+			summary.addEffect(ModRefEffect(type, mClass, decodePosition(&record[2])));
+		}
+	);
+	return table;
+}
+
+void ExternalModRefTable::writeDatabase(const char* fileName) const
+{
+	AnnotationDatabaseWriter writer(AnnotationKind::ModRef);
+	forEachSummary(
+		[&writer] (const StringRef& name, const ModRefEffectSummary& summary)
+		{
+			std::vector<AnnotationRecord> records;
+			for (auto const& effect: summary)
+			{
+				AnnotationRecord record = {};
+				record[0] = static_cast<std::uint8_t>(effect.getType());
+				record[1] = static_cast<std::uint8_t>(effect.getClass());
+				encodePosition(effect.getPosition(), &record[2]);
+				records.push_back(record);
+			}
+			writer.addEntry(name, std::move(records));
+		}
+	);
+	writer.writeToFile(fileName);
 }
+
+}
\ No newline at end of file
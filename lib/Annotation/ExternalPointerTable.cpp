@@ -1,5 +1,5 @@
+#include "Annotation/AnnotationDatabase.h"
 #include "Annotation/Pointer/ExternalPointerTable.h"
-#include "Util/IO/ReadFile.h"
 #include "Util/pcomb/pcomb.h"
 
 #include <llvm/Support/raw_ostream.h>
@@ -12,28 +12,52 @@ namespace annotation
 
 const PointerEffectSummary* ExternalPointerTable::lookup(const StringRef& name) const
 {
-	auto itr = table.find(name);
-	if (itr == table.end())
-		return nullptr;
-	else
-		return &itr->second;
+	if (table)
+	{
+		auto itr = table->find(name);
+		if (itr != table->end())
+			return &itr->second;
+	}
+	if (database)
+		return database->lookup(name);
+	return nullptr;
+}
+
+const PointerEffectSummary* ExternalPointerTable::lookup(const Function* f) const
+{
+	const PointerEffectSummary* summary;
+	if (binding.lookup(f, summary))
+		return summary;
+	return lookup(f->getName());
+}
+
+void ExternalPointerTable::bindModule(const Module& module)
+{
+	binding.bind(module, *this);
 }
 
 ExternalPointerTable ExternalPointerTable::buildTable(const StringRef& fileContent)
 {
 	ExternalPointerTable extTable;
+	MapType entries;
 
 	auto idx = rule(
-		regex("\\d+"),
+		integer(),
 		[] (auto const& digits) -> uint8_t
 		{
 			auto num = std::stoul(digits);
-			assert(num < 256);
+			// Positions store the index in one byte
+			if (num > 255)
+			{
+				errs() << "Argument index " << num << " is out of range. At most 256 arguments can be annotated\n";
+				std::exit(-1);
+			}
 			return num;
 		}
 	);
 
-	auto id = regex("[\\w\\.]+");
+	// The alloc, copy and exit entries all start with the function name. Memoizing it saves re-scanning the name for every alternative that fails after it
+	auto id = memo(ident("."));
 
 	auto pret = rule(
 		str("Ret"),
@@ -118,7 +142,7 @@ ExternalPointerTable ExternalPointerTable::buildTable(const StringRef& fileConte
 	);
 
 	auto commentEntry = rule(
-		token(regex("#.*\\n")),
+		token(lineComment('#')),
 		[] (auto const&)
 		{
 			return false;
@@ -130,10 +154,10 @@ ExternalPointerTable ExternalPointerTable::buildTable(const StringRef& fileConte
 			token(str("IGNORE")),
 			token(id)
 		),
-		[&extTable] (auto const& pair)
+		[&entries] (auto const& pair)
 		{
-			assert(extTable.lookup(std::get<1>(pair)) == nullptr && "Ignore entry should not co-exist with other entries");
-			extTable.table.insert(std::make_pair(std::get<1>(pair), PointerEffectSummary()));
+			assert(entries.count(std::get<1>(pair)) == 0 && "Ignore entry should not co-exist with other entries");
+			entries.insert(std::make_pair(std::get<1>(pair), PointerEffectSummary()));
 			return false;
 		}
 	);
@@ -143,7 +167,7 @@ ExternalPointerTable ExternalPointerTable::buildTable(const StringRef& fileConte
 			str("ALLOC"),
 			token(parg)
 		),
-		[&extTable] (auto const& pair)
+		[] (auto const& pair)
 		{
 			return PointerEffect::getAllocEffect(std::get<1>(pair));
 		}
@@ -162,9 +186,9 @@ ExternalPointerTable ExternalPointerTable::buildTable(const StringRef& fileConte
 			token(id),
 			token(alt(allocWithSize, allocWithoutSize))
 		),
-		[&extTable] (auto&& pair)
+		[&entries] (auto&& pair)
 		{
-			extTable.table[std::get<0>(pair)].addEffect(std::move(std::get<1>(pair)));
+			entries[std::get<0>(pair)].addEffect(std::move(std::get<1>(pair)));
 			return true;
 		}
 	);
@@ -176,10 +200,10 @@ ExternalPointerTable ExternalPointerTable::buildTable(const StringRef& fileConte
 			token(copydest),
 			token(copysrc)
 		),
-		[&extTable] (auto const& tuple)
+		[&entries] (auto const& tuple)
 		{
 			auto entry = PointerEffect::getCopyEffect(std::get<2>(tuple), std::get<3>(tuple));
-			extTable.table[std::get<0>(tuple)].addEffect(std::move(entry));
+			entries[std::get<0>(tuple)].addEffect(std::move(entry));
 			return true;
 		}
 	);
@@ -189,10 +213,10 @@ ExternalPointerTable ExternalPointerTable::buildTable(const StringRef& fileConte
 			token(id),
 			token(str("EXIT"))
 		),
-		[&extTable] (auto const& tuple)
+		[&entries] (auto const& tuple)
 		{
 			auto entry = PointerEffect::getExitEffect();
-			extTable.table[std::get<0>(tuple)].addEffect(std::move(entry));
+			entries[std::get<0>(tuple)].addEffect(std::move(entry));
 			return true;
 		}
 	);
@@ -208,13 +232,135 @@ ExternalPointerTable ExternalPointerTable::buildTable(const StringRef& fileConte
 		std::exit(-1);
 	}
 
+	extTable.table = std::make_shared<const MapType>(std::move(entries));
 	return extTable;
 }
 
 ExternalPointerTable ExternalPointerTable::loadFromFile(const char* fileName)
 {
-	auto memBuf = util::io::readFileIntoBuffer(fileName);
+	auto memBuf = readAnnotationFile(fileName);
+	if (AnnotationDatabaseReader::isDatabase(memBuf->getBuffer()))
+		return loadFromDatabase(std::move(memBuf));
 	return buildTable(memBuf->getBuffer());
 }
 
+namespace
+{
+
+AnnotationRecord encodeEffect(const PointerEffect& effect)
+{
+	AnnotationRecord record = {};
+	record[0] = static_cast<std::uint8_t>(effect.getType());
+	switch (effect.getType())
+	{
+		case PointerEffectType::Alloc:
+		{
+			auto const& allocEffect = effect.getAsAllocEffect();
+			record[1] = allocEffect.hasSizePosition();
+			if (allocEffect.hasSizePosition())
+				encodePosition(allocEffect.getSizePosition(), &record[2]);
+			break;
+		}
+		case PointerEffectType::Copy:
+		{
+			auto const& copyEffect = effect.getAsCopyEffect();
+			auto const& src = copyEffect.getSource();
+			record[1] = static_cast<std::uint8_t>(copyEffect.getDest().getType());
+			encodePosition(copyEffect.getDest().getPosition(), &record[2]);
+			record[4] = static_cast<std::uint8_t>(src.getType());
+			if (src.getType() == CopySource::SourceType::Value || src.getType() == CopySource::SourceType::DirectMemory || src.getType() == CopySource::SourceType::ReachableMemory)
+				encodePosition(src.getPosition(), &record[5]);
+			break;
+		}
+		case PointerEffectType::Exit:
+			break;
+	}
+	return record;
+}
+
+CopyDest decodeCopyDest(const AnnotationRecord& record)
+{
+	auto pos = decodePosition(&record[2]);
+	switch (decodeEnum(record[1], CopyDest::DestType::ReachableMemory, "bad copy dest type"))
+	{
+		case CopyDest::DestType::Value:
+			return CopyDest::getValue(pos);
+		case CopyDest::DestType::DirectMemory:
+			return CopyDest::getDirectMemory(pos);
+		case CopyDest::DestType::ReachableMemory:
+			return CopyDest::getReachableMemory(pos);
+	}
+	llvm_unreachable("decodeEnum() rejects every other copy dest type");
+}
+
+CopySource decodeCopySource(const AnnotationRecord& record)
+{
+	switch (decodeEnum(record[4], CopySource::SourceType::Static, "bad copy source type"))
+	{
+		case CopySource::SourceType::Value:
+			return CopySource::getValue(decodePosition(&record[5]));
+		case CopySource::SourceType::DirectMemory:
+			return CopySource::getDirectMemory(decodePosition(&record[5]));
+		case CopySource::SourceType::ReachableMemory:
+			return CopySource::getReachableMemory(decodePosition(&record[5]));
+		case CopySource::SourceType::Null:
+			return CopySource::getNullPointer();
+		case CopySource::SourceType::Universal:
+			return CopySource::getUniversalPointer();
+		case CopySource::SourceType::Static:
+			return CopySource::getStaticPointer();
+	}
+	llvm_unreachable("decodeEnum() rejects every other copy source type");
+}
+
+PointerEffect decodeEffect(const AnnotationRecord& record)
+{
+	switch (decodeEnum(record[0], PointerEffectType::Exit, "bad pointer effect type"))
+	{
+		case PointerEffectType::Alloc:
+			if (record[1] > 1)
+				reportMalformedDatabase("bad alloc size flag");
+			if (record[1])
+				return PointerEffect::getAllocEffect(decodePosition(&record[2]));
+			else
+				return PointerEffect::getAllocEffect();
+		case PointerEffectType::Copy:
+			return PointerEffect::getCopyEffect(decodeCopyDest(record), decodeCopySource(record));
+		case PointerEffectType::Exit:
+			return PointerEffect::getExitEffect();
+	}
+	llvm_unreachable("decodeEnum() rejects every other pointer effect type");
+}
+
+}
+
+ExternalPointerTable ExternalPointerTable::loadFromDatabase(std::unique_ptr<MemoryBuffer> memBuf)
+{
+	ExternalPointerTable extTable;
+	extTable.database = std::make_shared<const AnnotationDatabaseTable<PointerEffectSummary>>(
+		std::move(memBuf),
+		AnnotationKind::Pointer,
+		[] (const AnnotationRecord& record, PointerEffectSummary& summary)
+		{
+			summary.addEffect(decodeEffect(record));
+		}
+	);
+	return extTable;
+}
+
+void ExternalPointerTable::writeDatabase(const char* fileName) const
+{
+	AnnotationDatabaseWriter writer(AnnotationKind::Pointer);
+	forEachSummary(
+		[&writer] (const StringRef& name, const PointerEffectSummary& summary)
+		{
+			std::vector<AnnotationRecord> records;
+			for (auto const& effect: summary)
+				records.push_back(encodeEffect(effect));
+			writer.addEntry(name, std::move(records));
+		}
+	);
+	writer.writeToFile(fileName);
+}
+
 }
\ No newline at end of file
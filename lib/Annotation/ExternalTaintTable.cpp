@@ -1,5 +1,5 @@
+#include "Annotation/AnnotationDatabase.h"
 #include "Annotation/Taint/ExternalTaintTable.h"
-#include "Util/IO/ReadFile.h"
 #include "Util/pcomb/pcomb.h"
 
 #include <llvm/Support/raw_ostream.h>
@@ -13,18 +13,24 @@ namespace annotation
 ExternalTaintTable ExternalTaintTable::buildTable(const llvm::StringRef& fileContent)
 {
 	ExternalTaintTable table;
+	MapType entries;
 
 	auto idx = rule(
-		regex("\\d+"),
+		integer(),
 		[] (auto const& digits) -> uint8_t
 		{
 			auto num = std::stoul(digits.data());
-			assert(num < 256);
+			// Positions store the index in one byte
+			if (num > 255)
+			{
+				errs() << "Argument index " << num << " is out of range. At most 256 arguments can be annotated\n";
+				std::exit(-1);
+			}
 			return num;
 		}
 	);
 
-	auto id = regex("[\\w\\.]+");
+	auto id = ident(".");
 
 	auto tret = rule(
 		str("Ret"),
@@ -103,10 +109,10 @@ ExternalTaintTable ExternalTaintTable::buildTable(const llvm::StringRef& fileCon
 			token(alt(vclass, dclass, rclass)),
 			token(tval)
 		),
-		[&table] (auto const& tuple)
+		[&entries] (auto const& tuple)
 		{
 			auto entry = TaintEntry::getSourceEntry(std::get<2>(tuple), std::get<3>(tuple), std::get<4>(tuple));
-			table.summaryMap[std::get<1>(tuple)].addEntry(std::move(entry));
+			entries[std::get<1>(tuple)].addEntry(std::move(entry));
 			return true;
 		}
 	);
@@ -120,10 +126,10 @@ ExternalTaintTable ExternalTaintTable::buildTable(const llvm::StringRef& fileCon
 			token(targ),
 			token(alt(vclass, dclass, rclass))
 		),
-		[&table] (auto const& tuple)
+		[&entries] (auto const& tuple)
 		{
 			auto entry = TaintEntry::getPipeEntry(std::get<2>(tuple), std::get<3>(tuple), std::get<4>(tuple), std::get<5>(tuple));
-			table.summaryMap[std::get<1>(tuple)].addEntry(std::move(entry));
+			entries[std::get<1>(tuple)].addEntry(std::move(entry));
 			return true;
 		}
 	);
@@ -135,10 +141,10 @@ ExternalTaintTable ExternalTaintTable::buildTable(const llvm::StringRef& fileCon
 			token(alt(targ, tafterarg)),
 			token(alt(vclass, dclass))
 		),
-		[&table] (auto const& tuple)
+		[&entries] (auto const& tuple)
 		{
 			auto entry = TaintEntry::getSinkEntry(std::get<2>(tuple), std::get<3>(tuple));
-			table.summaryMap[std::get<1>(tuple)].addEntry(std::move(entry));
+			entries[std::get<1>(tuple)].addEntry(std::move(entry));
 			return true;
 		}
 	);
@@ -149,15 +155,15 @@ ExternalTaintTable ExternalTaintTable::buildTable(const llvm::StringRef& fileCon
 			token(str("IGNORE")),
 			token(id)
 		),
-		[&table] (auto const& tuple)
+		[&entries] (auto const& tuple)
 		{
-			table.summaryMap.insert(std::make_pair(std::get<1>(tuple), TaintSummary()));
+			entries.insert(std::make_pair(std::get<1>(tuple), TaintSummary()));
 			return false;
 		}
 	);
 
 	auto commentEntry = rule(
-		token(regex("#.*\\n")),
+		token(lineComment('#')),
 		[] (auto const&)
 		{
 			return false;
@@ -175,22 +181,134 @@ ExternalTaintTable ExternalTaintTable::buildTable(const llvm::StringRef& fileCon
 		std::exit(-1);
 	}
 
+	table.summaryMap = std::make_shared<const MapType>(std::move(entries));
 	return table;
 }
 
 ExternalTaintTable ExternalTaintTable::loadFromFile(const char* fileName)
 {
-	auto memBuf = util::io::readFileIntoBuffer(fileName);
+	auto memBuf = readAnnotationFile(fileName);
+	if (AnnotationDatabaseReader::isDatabase(memBuf->getBuffer()))
+		return loadFromDatabase(std::move(memBuf));
 	return buildTable(memBuf->getBuffer());
 }
 
+namespace
+{
+
+AnnotationRecord encodeEntry(const TaintEntry& entry)
+{
+	AnnotationRecord record = {};
+	record[0] = static_cast<std::uint8_t>(entry.getEntryEnd());
+	switch (entry.getEntryEnd())
+	{
+		case TEnd::Source:
+		{
+			auto const& srcEntry = entry.getAsSourceEntry();
+			encodePosition(srcEntry.getTaintPosition(), &record[1]);
+			record[3] = static_cast<std::uint8_t>(srcEntry.getTaintClass());
+			record[4] = static_cast<std::uint8_t>(srcEntry.getTaintValue());
+			break;
+		}
+		case TEnd::Pipe:
+		{
+			auto const& pipeEntry = entry.getAsPipeEntry();
+			encodePosition(pipeEntry.getDstPosition(), &record[1]);
+			record[3] = static_cast<std::uint8_t>(pipeEntry.getDstClass());
+			encodePosition(pipeEntry.getSrcPosition(), &record[4]);
+			record[6] = static_cast<std::uint8_t>(pipeEntry.getSrcClass());
+			break;
+		}
+		case TEnd::Sink:
+		{
+			auto const& sinkEntry = entry.getAsSinkEntry();
+			encodePosition(sinkEntry.getArgPosition(), &record[1]);
+			record[3] = static_cast<std::uint8_t>(sinkEntry.getTaintClass());
+			break;
+		}
+	}
+	return record;
+}
+
+TClass decodeTClass(std::uint8_t byte)
+{
+	return decodeEnum(byte, TClass::ReachableMemory, "bad taint class");
+}
+
+TaintEntry decodeEntry(const AnnotationRecord& record)
+{
+	switch (decodeEnum(record[0], TEnd::Pipe, "bad taint entry type"))
+	{
+		case TEnd::Source:
+			return TaintEntry::getSourceEntry(decodePosition(&record[1]), decodeTClass(record[3]), decodeEnum(record[4], taint::TaintLattice::Either, "bad taint value"));
+		case TEnd::Pipe:
+			return TaintEntry::getPipeEntry(decodePosition(&record[1]), decodeTClass(record[3]), decodePosition(&record[4]), decodeTClass(record[6]));
+		case TEnd::Sink:
+		{
+			auto pos = decodePosition(&record[1]);
+			if (pos.isReturnPosition())
+				reportMalformedDatabase("taint sink on a return value");
+			return TaintEntry::getSinkEntry(pos, decodeTClass(record[3]));
+		}
+	}
+	llvm_unreachable("decodeEnum() rejects every other taint entry type");
+}
+
+}
+
+ExternalTaintTable ExternalTaintTable::loadFromDatabase(std::unique_ptr<MemoryBuffer> memBuf)
+{
+	ExternalTaintTable table;
+	table.database = std::make_shared<const AnnotationDatabaseTable<TaintSummary>>(
+		std::move(memBuf),
+		AnnotationKind::Taint,
+		[] (const AnnotationRecord& record, TaintSummary& summary)
+		{
+			summary.addEntry(decodeEntry(record));
+		}
+	);
+	return table;
+}
+
+void ExternalTaintTable::writeDatabase(const char* fileName) const
+{
+	AnnotationDatabaseWriter writer(AnnotationKind::Taint);
+	forEachSummary(
+		[&writer] (const StringRef& name, const TaintSummary& summary)
+		{
+			std::vector<AnnotationRecord> records;
+			for (auto const& entry: summary)
+				records.push_back(encodeEntry(entry));
+			writer.addEntry(name, std::move(records));
+		}
+	);
+	writer.writeToFile(fileName);
+}
+
 const TaintSummary* ExternalTaintTable::lookup(const std::string& name) const
 {
-	auto itr = summaryMap.find(name);
-	if (itr == summaryMap.end())
-		return nullptr;
-	else
-		return &itr->second;
+	if (summaryMap)
+	{
+		auto itr = summaryMap->find(name);
+		if (itr != summaryMap->end())
+			return &itr->second;
+	}
+	if (database)
+		return database->lookup(name);
+	return nullptr;
+}
+
+const TaintSummary* ExternalTaintTable::lookup(const Function* f) const
+{
+	const TaintSummary* summary;
+	if (binding.lookup(f, summary))
+		return summary;
+	return lookup(f->getName().str());
+}
+
+void ExternalTaintTable::bindModule(const Module& module)
+{
+	binding.bind(module, *this);
 }
 
 }
\ No newline at end of file
@@ -0,0 +1,73 @@
+#include "Dynamic/Analysis/AddressIndex.h"
+
+#include <limits>
+
+namespace dynamic
+{
+
+void AddressIndex::insert(const void* addr, std::uint64_t size, const DynamicPointer& ptr)
+{
+	auto key = toInt(addr);
+	auto itr = addrMap.lower_bound(key);
+	if (itr != addrMap.end() && itr->first == key)
+	{
+		// The cached range was computed from the old size
+		if (cacheValid && key == cacheBegin)
+			cacheValid = false;
+		itr->second = { ptr, size };
+		return;
+	}
+	addrMap.insert(itr, std::make_pair(key, Allocation{ ptr, size }));
+
+	if (cacheValid && cacheBegin < key && key < cacheEnd)
+		cacheEnd = key;
+}
+
+bool AddressIndex::erase(const void* addr)
+{
+	auto key = toInt(addr);
+	auto itr = addrMap.find(key);
+	if (itr == addrMap.end())
+		return false;
+
+	if (cacheValid && (key == cacheBegin || key == cacheEnd))
+		cacheValid = false;
+	addrMap.erase(itr);
+	return true;
+}
+
+const AddressIndex::value_type* AddressIndex::find(const void* addr) const
+{
+	auto itr = addrMap.find(toInt(addr));
+	if (itr == addrMap.end())
+		return nullptr;
+	return &*itr;
+}
+
+const AddressIndex::value_type* AddressIndex::lookup(const void* addr)
+{
+	auto key = toInt(addr);
+	if (cacheValid && cacheBegin <= key && key < cacheEnd)
+		return &*cacheItr;
+
+	auto itr = addrMap.upper_bound(key);
+	if (itr == addrMap.begin())
+		return nullptr;
+
+	auto end = (itr == addrMap.end()) ? std::numeric_limits<std::uintptr_t>::max() : itr->first;
+	--itr;
+	auto size = itr->second.size;
+	if (size != 0 && size < end - itr->first)
+		end = itr->first + size;
+	// Past the end of the closest allocation below
+	if (key >= end)
+		return nullptr;
+
+	cacheBegin = itr->first;
+	cacheEnd = end;
+	cacheItr = itr;
+	cacheValid = true;
+	return &*itr;
+}
+
+}
@@ -5,14 +5,15 @@
 namespace dynamic
 {
 
-std::unordered_set<DynamicContext> DynamicContext::ctxSet;
-const DynamicContext* DynamicContext::globalCtx = &*(ctxSet.insert(DynamicContext()).first);
+DynamicContext DynamicContext::globalCtx;
 
 const DynamicContext* DynamicContext::pushContext(const DynamicContext* ctx, CallSiteType cs)
 {
-	auto newCtx = DynamicContext(cs, ctx);
-	auto itr = ctxSet.insert(newCtx).first;
-	return &(*itr);
+	return ctx->getOrInsertChild(
+		std::hash<CallSiteType>()(cs),
+		[cs] (const DynamicContext& child) { return child.callSite == cs; },
+		[ctx, cs] { return new DynamicContext(cs, ctx); }
+	);
 }
 
 const DynamicContext* DynamicContext::popContext(const DynamicContext* ctx)
@@ -23,7 +24,7 @@ const DynamicContext* DynamicContext::popContext(const DynamicContext* ctx)
 
 const DynamicContext* DynamicContext::getGlobalContext()
 {
-	return globalCtx;
+	return &globalCtx;
 }
 
-}
+}
\ No newline at end of file
@@ -1,8 +1,6 @@
 #include "Dynamic/Analysis/DynamicContext.h"
 #include "Dynamic/Analysis/DynamicMemory.h"
 
-#include <cassert>
-
 namespace dynamic
 {
 
@@ -11,40 +9,39 @@ DynamicMemoryObject DynamicMemoryObject::getNullObject()
 	return DynamicMemoryObject(DynamicPointer(DynamicContext::getGlobalContext(), 0), 0);
 }
 
-DynamicMemoryObject DynamicMemory::insertAllocMap(const DynamicPointer& ptr, const void* addr)
+DynamicMemoryObject DynamicMemory::insertAllocMap(const DynamicPointer& ptr, const void* addr, std::uint64_t size)
 {
-	auto itr = allocMap.find(addr);
-	assert(itr == allocMap.end() && "Duplicate allocation!");
-	allocMap.insert(itr, std::make_pair(addr, ptr));
+	// A live allocation at the same address must have been freed by uninstrumented code
+	allocMap.insert(addr, size, ptr);
 	return DynamicMemoryObject(ptr, 0);
 }
 
-DynamicMemoryObject DynamicMemory::allocateGlobal(const DynamicPointer& ptr, const void* addr)
+DynamicMemoryObject DynamicMemory::allocateGlobal(const DynamicPointer& ptr, const void* addr, std::uint64_t size)
 {
-	return insertAllocMap(ptr, addr);
+	return insertAllocMap(ptr, addr, size);
 }
 
-DynamicMemoryObject DynamicMemory::allocateStack(const DynamicPointer& ptr, const void* addr)
+DynamicMemoryObject DynamicMemory::allocateStack(const DynamicPointer& ptr, const void* addr, std::uint64_t size, unsigned threadId)
 {
-	stackCtxMap[ptr.getContext()].push_back(addr);
-	return insertAllocMap(ptr, addr);
+	stackCtxMap[std::make_pair(threadId, ptr.getContext())].push_back(addr);
+	return insertAllocMap(ptr, addr, size);
 }
 
-DynamicMemoryObject DynamicMemory::allocateHeap(const DynamicPointer& ptr, const void* addr)
+DynamicMemoryObject DynamicMemory::allocateHeap(const DynamicPointer& ptr, const void* addr, std::uint64_t size)
 {
-	return insertAllocMap(ptr, addr);
+	return insertAllocMap(ptr, addr, size);
 }
 
-DynamicMemoryObject DynamicMemory::allocate(AllocType type, const DynamicPointer& ptr, const void* addr)
+DynamicMemoryObject DynamicMemory::allocate(AllocType type, const DynamicPointer& ptr, const void* addr, std::uint64_t size, unsigned threadId)
 {
 	switch (type)
 	{
 		case AllocType::Global:
-			return allocateGlobal(ptr, addr);
+			return allocateGlobal(ptr, addr, size);
 		case AllocType::Stack:
-			return allocateStack(ptr, addr);
+			return allocateStack(ptr, addr, size, threadId);
 		case AllocType::Heap:
-			return allocateHeap(ptr, addr);
+			return allocateHeap(ptr, addr, size);
 	}
 }
 
@@ -53,17 +50,18 @@ DynamicMemoryObject DynamicMemory::getMemoryObject(const void* addr)
 	if (addr == nullptr)
 		return DynamicMemoryObject::getNullObject();
 
-	auto itr = allocMap.lower_bound(addr);
-	if (itr == allocMap.end() || itr->first != addr)
-		--itr;
+	auto alloc = allocMap.lookup(addr);
+	// The address does not belong to any memory we know of
+	if (alloc == nullptr)
+		return DynamicMemoryObject::getNullObject();
 
-	auto offset = static_cast<const char*>(addr) - static_cast<const char*>(itr->first);
-	return DynamicMemoryObject(itr->second, offset);
+	auto offset = static_cast<const char*>(addr) - reinterpret_cast<const char*>(alloc->first);
+	return DynamicMemoryObject(alloc->second.ptr, offset);
 }
 
-void DynamicMemory::deallocateStack(const DynamicContext* ctx)
+void DynamicMemory::deallocateStack(const DynamicContext* ctx, unsigned threadId)
 {
-	auto itr = stackCtxMap.find(ctx);
+	auto itr = stackCtxMap.find(std::make_pair(threadId, ctx));
 	if (itr == stackCtxMap.end())
 		return;
 	for (auto addr: itr->second)
@@ -71,5 +69,39 @@ void DynamicMemory::deallocateStack(const DynamicContext* ctx)
 	stackCtxMap.erase(itr);
 }
 
+void DynamicMemory::deallocateHeap(const void* addr)
+{
+	allocMap.erase(addr);
+}
+
+void DynamicMemory::reallocateHeap(const void* oldAddr, const void* newAddr, std::uint64_t newSize)
+{
+	// The moved block keeps its allocation site
+	auto alloc = allocMap.find(oldAddr);
+	if (alloc == nullptr)
+		return;
+	auto ptr = alloc->second.ptr;
+	allocMap.erase(oldAddr);
+	allocMap.insert(newAddr, newSize, ptr);
+}
+
+void DynamicMemory::apply(const MemoryDelta& delta)
+{
+	switch (delta.kind)
+	{
+		case MemoryDelta::Kind::Allocate:
+			allocate(delta.allocType, DynamicPointer(delta.ctx, delta.id), delta.addr, delta.size, delta.threadId);
+			break;
+		case MemoryDelta::Kind::DeallocateStack:
+			deallocateStack(delta.ctx, delta.threadId);
+			break;
+		case MemoryDelta::Kind::DeallocateHeap:
+			deallocateHeap(delta.addr);
+			break;
+		case MemoryDelta::Kind::Reallocate:
+			reallocateHeap(delta.addr, delta.newAddr, delta.size);
+			break;
+	}
+}
 
 }
\ No newline at end of file
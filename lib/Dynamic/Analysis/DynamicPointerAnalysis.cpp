@@ -1,53 +1,98 @@
-#include "Dynamic/Analysis/DynamicContext.h"
 #include "Dynamic/Analysis/DynamicPointerAnalysis.h"
 
-#include <cassert>
+#include <atomic>
+#include <thread>
+#include <vector>
 
 namespace dynamic
 {
 
-DynamicPointerAnalysis::DynamicPointerAnalysis(const char* fileName): LogProcessor(fileName), currCtx(DynamicContext::getGlobalContext()), callerId(0) {}
-
-void DynamicPointerAnalysis::setPointsTo(const DynamicPointer& ptr, const DynamicMemoryObject& obj)
+namespace
 {
-	auto itr = ptsMap.find(ptr);
-	if (itr == ptsMap.end())
-		ptsMap.insert(std::make_pair(ptr, obj));
-	else
-		itr->second = obj;
-}
 
-void DynamicPointerAnalysis::visitAllocRecord(const AllocRecord& allocRecord)
+// The replay state right before the record pointed to by pos. The state carries no memory. The memory at the checkpoint is what the first numDeltas journal entries build from an empty one
+struct Checkpoint
 {
-	auto ptr = DynamicPointer(currCtx, allocRecord.id);
-	auto obj = memory.allocate(static_cast<AllocType>(allocRecord.type), ptr, allocRecord.address);
-	setPointsTo(ptr, obj);
-}
+	ThreadedLogReader::const_iterator pos;
+	DynamicReplayer state;
+	std::size_t numDeltas;
+};
 
-void DynamicPointerAnalysis::visitPointerRecord(const PointerRecord& ptrRecord)
-{
-	auto ptr = DynamicPointer(currCtx, ptrRecord.id);
-	auto obj = memory.getMemoryObject(ptrRecord.address);
-	setPointsTo(ptr, obj);
 }
 
-void DynamicPointerAnalysis::visitEnterRecord(const EnterRecord& enterRecord)
-{
-	assert(callerId != 0);
-	currCtx = DynamicContext::pushContext(currCtx, callerId);
-	callerId = 0;
-}
+DynamicPointerAnalysis::DynamicPointerAnalysis(const char* fileName): LogProcessor(fileName) {}
 
-void DynamicPointerAnalysis::visitExitRecord(const ExitRecord& exitRecord)
+void DynamicPointerAnalysis::processParallel(unsigned numThreads, std::size_t segmentSize)
 {
-	memory.deallocateStack(currCtx);
-	currCtx = DynamicContext::popContext(currCtx);
-}
+	if (numThreads <= 1 || segmentSize == 0)
+	{
+		process();
+		return;
+	}
 
-void DynamicPointerAnalysis::visitCallRecord(const CallRecord& callRecord)
-{
-	callerId = callRecord.id;
-}
+	// Phase 1: take checkpoints sequentially. Pointer records, which make up most of a log, are skipped here, and changes to the memory go to a journal so that the checkpoints do not have to copy it
+	std::vector<Checkpoint> checkpoints;
+	std::vector<MemoryDelta> journal;
+	auto scout = DynamicReplayer(false);
+	scout.setJournal(&journal);
+	std::size_t numRecords = 0;
+	for (auto itr = getReader().begin(), ite = getReader().end(); itr != ite; ++itr, ++numRecords)
+	{
+		if (numRecords % segmentSize == 0)
+			checkpoints.push_back({ itr, scout, journal.size() });
+		scout.visit(*itr);
+	}
+	if (checkpoints.empty())
+		return;
 
+	// Phase 2: replay the segments in parallel. Segments are handed out in order, so each worker only moves its memory forward: it applies the journal entries up to the checkpoint of its next segment, lends the memory to the checkpoint state for the replay, and takes it back afterwards. Replaying segment i leaves the memory at checkpoint i + 1
+	std::atomic<std::size_t> nextSegment(0);
+	auto replaySegments = [this, &checkpoints, &journal, &nextSegment, segmentSize] ()
+	{
+		auto memory = DynamicMemory();
+		std::size_t numApplied = 0;
 
-}
\ No newline at end of file
+		std::size_t i;
+		while ((i = nextSegment++) < checkpoints.size())
+		{
+			for (; numApplied < checkpoints[i].numDeltas; ++numApplied)
+				memory.apply(journal[numApplied]);
+
+			auto& state = checkpoints[i].state;
+			state.setJournal(nullptr);
+			state.getMemory() = std::move(memory);
+			state.setTrackPointsTo(true);
+
+			auto itr = checkpoints[i].pos;
+			auto ite = getReader().end();
+			for (std::size_t j = 0; j < segmentSize && itr != ite; ++j, ++itr)
+				state.visit(*itr);
+
+			// The last segment keeps the final memory
+			if (i + 1 < checkpoints.size())
+			{
+				memory = std::move(state.getMemory());
+				state.getMemory() = DynamicMemory();
+				numApplied = checkpoints[i + 1].numDeltas;
+			}
+		}
+	};
+
+	if (numThreads > checkpoints.size())
+		numThreads = checkpoints.size();
+	std::vector<std::thread> workers;
+	workers.reserve(numThreads - 1);
+	for (auto i = 1u; i < numThreads; ++i)
+		workers.emplace_back(replaySegments);
+	replaySegments();
+	for (auto& worker: workers)
+		worker.join();
+
+	// Phase 3: merge the facts of all segments. The last segment already holds the final context and memory state
+	auto& result = checkpoints.back().state.getPointsToFacts();
+	for (auto i = 0u; i + 1 < checkpoints.size(); ++i)
+		result.merge(checkpoints[i].state.getPointsToFacts());
+	replayer = std::move(checkpoints.back().state);
+}
+
+}
@@ -0,0 +1,92 @@
+#include "Dynamic/Analysis/DynamicContext.h"
+#include "Dynamic/Analysis/DynamicReplayer.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace dynamic
+{
+
+DynamicReplayer::DynamicReplayer(bool t): currCtx(DynamicContext::getGlobalContext()), callerId(0), currThread(0), trackPointsTo(t), journal(nullptr) {}
+
+void DynamicReplayer::setPointsTo(const DynamicPointer& ptr, const DynamicMemoryObject& obj)
+{
+	facts.insert(ptr, obj.getAllocSite());
+}
+
+void DynamicReplayer::visitAllocRecord(const AllocRecord& allocRecord)
+{
+	if (journal != nullptr)
+	{
+		assert(!trackPointsTo);
+		journal->push_back({ MemoryDelta::Kind::Allocate, static_cast<AllocType>(allocRecord.type), currThread, currCtx, allocRecord.id, allocRecord.address, nullptr, allocRecord.size });
+		return;
+	}
+
+	auto ptr = DynamicPointer(currCtx, allocRecord.id);
+	auto obj = memory.allocate(static_cast<AllocType>(allocRecord.type), ptr, allocRecord.address, allocRecord.size, currThread);
+	if (trackPointsTo)
+		setPointsTo(ptr, obj);
+}
+
+void DynamicReplayer::visitPointerRecord(const PointerRecord& ptrRecord)
+{
+	if (!trackPointsTo)
+		return;
+
+	auto ptr = DynamicPointer(currCtx, ptrRecord.id);
+	auto obj = memory.getMemoryObject(ptrRecord.address);
+	setPointsTo(ptr, obj);
+}
+
+void DynamicReplayer::visitEnterRecord(const EnterRecord& enterRecord)
+{
+	// The start routine of a thread is called by the thread library, so no call record precedes its entry. It is entered with call site 0
+	assert(callerId != 0 || currThread != 0);
+	currCtx = DynamicContext::pushContext(currCtx, callerId);
+	callerId = 0;
+}
+
+void DynamicReplayer::visitExitRecord(const ExitRecord& exitRecord)
+{
+	if (journal != nullptr)
+		journal->push_back({ MemoryDelta::Kind::DeallocateStack, AllocType::Stack, currThread, currCtx, 0, nullptr, nullptr, 0 });
+	else
+		memory.deallocateStack(currCtx, currThread);
+	currCtx = DynamicContext::popContext(currCtx);
+}
+
+void DynamicReplayer::visitCallRecord(const CallRecord& callRecord)
+{
+	callerId = callRecord.id;
+}
+
+void DynamicReplayer::visitFreeRecord(const FreeRecord& freeRecord)
+{
+	if (journal != nullptr)
+		journal->push_back({ MemoryDelta::Kind::DeallocateHeap, AllocType::Heap, currThread, nullptr, 0, freeRecord.address, nullptr, 0 });
+	else
+		memory.deallocateHeap(freeRecord.address);
+}
+
+void DynamicReplayer::visitReallocRecord(const ReallocRecord& reallocRecord)
+{
+	if (journal != nullptr)
+		journal->push_back({ MemoryDelta::Kind::Reallocate, AllocType::Heap, currThread, nullptr, 0, reallocRecord.oldAddress, reallocRecord.newAddress, reallocRecord.newSize });
+	else
+		memory.reallocateHeap(reallocRecord.oldAddress, reallocRecord.newAddress, reallocRecord.newSize);
+}
+
+void DynamicReplayer::visitThreadRecord(const ThreadRecord& threadRecord)
+{
+	auto numThreads = std::max(currThread, threadRecord.id) + 1;
+	if (threadStates.size() < numThreads)
+		threadStates.resize(numThreads, { DynamicContext::getGlobalContext(), 0 });
+
+	threadStates[currThread] = { currCtx, callerId };
+	currThread = threadRecord.id;
+	currCtx = threadStates[currThread].ctx;
+	callerId = threadStates[currThread].callerId;
+}
+
+}
@@ -0,0 +1,93 @@
+#include "Dynamic/Analysis/PointsToFactSet.h"
+
+#include <iostream>
+#include <limits>
+
+namespace dynamic
+{
+
+static const std::uint64_t emptyKey = ~std::uint64_t(0);
+
+static std::size_t hashKey(std::uint64_t key)
+{
+	// The high half of the product mixes all bits of the key
+	key *= 0x9e3779b97f4a7c15ull;
+	return key ^ (key >> 32);
+}
+
+std::uint32_t PointsToFactSet::intern(const DynamicPointer& ptr)
+{
+	auto itr = ptrIds.find(ptr);
+	if (itr != ptrIds.end())
+		return itr->second;
+
+	// The all-ones key is reserved for empty slots
+	if (ptrs.size() >= std::numeric_limits<std::uint32_t>::max())
+	{
+		std::cerr << "Too many distinct dynamic pointers\n";
+		std::exit(-1);
+	}
+	auto id = static_cast<std::uint32_t>(ptrs.size());
+	ptrs.push_back(ptr);
+	ptrIds.insert(itr, std::make_pair(ptr, id));
+	return id;
+}
+
+bool PointsToFactSet::insertKey(std::uint64_t key)
+{
+	if ((numFacts + 1) * 2 > table.size())
+		grow();
+
+	auto mask = table.size() - 1;
+	for (auto slot = hashKey(key) & mask; ; slot = (slot + 1) & mask)
+	{
+		if (table[slot] == key)
+			return false;
+		if (table[slot] == emptyKey)
+		{
+			table[slot] = key;
+			++numFacts;
+			return true;
+		}
+	}
+}
+
+void PointsToFactSet::grow()
+{
+	std::vector<std::uint64_t> newTable(table.empty() ? 1024 : table.size() * 2, emptyKey);
+	auto mask = newTable.size() - 1;
+	for (auto key: table)
+	{
+		if (key == emptyKey)
+			continue;
+		auto slot = hashKey(key) & mask;
+		while (newTable[slot] != emptyKey)
+			slot = (slot + 1) & mask;
+		newTable[slot] = key;
+	}
+	table.swap(newTable);
+}
+
+bool PointsToFactSet::insert(const DynamicPointer& ptr, const DynamicPointer& allocSite)
+{
+	auto key = (static_cast<std::uint64_t>(intern(ptr)) << 32) | intern(allocSite);
+	return insertKey(key);
+}
+
+void PointsToFactSet::merge(const PointsToFactSet& other)
+{
+	// IDs are local to each set, so the facts of the other set have to be interned again
+	std::vector<std::uint32_t> idMap;
+	idMap.reserve(other.ptrs.size());
+	for (auto const& ptr: other.ptrs)
+		idMap.push_back(intern(ptr));
+
+	for (auto key: other.table)
+	{
+		if (key == emptyKey)
+			continue;
+		insertKey((static_cast<std::uint64_t>(idMap[key >> 32]) << 32) | idMap[key & 0xffffffffu]);
+	}
+}
+
+}
@@ -27,6 +27,11 @@ Type* getIntType(const Module& m)
 	return Type::getIntNTy(m.getContext(), sizeof(int) * 8);
 }
 
+Type* getLongType(const Module& m)
+{
+	return Type::getIntNTy(m.getContext(), sizeof(size_t) * 8);
+}
+
 Type* getCharPtrType(const Module& m)
 {
 	return PointerType::getUnqual(getCharType(m));
@@ -48,13 +53,15 @@ Function* createFunctionWithArgType(const StringRef& name, ArrayRef<Type*> argTy
 DynamicHooks::DynamicHooks(Module& module)
 {
 	initHook = createFunctionWithArgType("HookInit", {}, module);
-	allocHook = createFunctionWithArgType("HookAlloc", { getCharType(module), getIntType(module), getCharPtrType(module) }, module);
+	allocHook = createFunctionWithArgType("HookAlloc", { getCharType(module), getIntType(module), getCharPtrType(module), getLongType(module) }, module);
 	pointerHook = createFunctionWithArgType("HookPointer", { getIntType(module), getCharPtrType(module) }, module);
 	callHook = createFunctionWithArgType("HookCall", { getIntType(module) }, module);
 	enterHook = createFunctionWithArgType("HookEnter", { getIntType(module) }, module);
 	exitHook = createFunctionWithArgType("HookExit", { getIntType(module) }, module);
 	globalHook = createFunctionWithArgType("HookGlobal", {}, module);
 	mainHook = createFunctionWithArgType("HookMain", { getIntType(module), getCharPtrPtrType(module), getIntType(module), getCharPtrPtrType(module) }, module);
+	freeHook = createFunctionWithArgType("HookFree", { getCharPtrType(module) }, module);
+	reallocHook = createFunctionWithArgType("HookRealloc", { getIntType(module), getCharPtrType(module), getCharPtrType(module), getLongType(module) }, module);
 }
 
 bool DynamicHooks::isHook(const llvm::Function* f) const
@@ -67,7 +74,9 @@ bool DynamicHooks::isHook(const llvm::Function* f) const
 		f == enterHook ||
 		f == exitHook ||
 		f == globalHook ||
-		f == mainHook
+		f == mainHook ||
+		f == freeHook ||
+		f == reallocHook
 	;
 }
 
@@ -0,0 +1,77 @@
+#include "Dynamic/Instrument/HookPruner.h"
+
+#include <llvm/IR/Dominators.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Operator.h>
+
+using namespace llvm;
+
+namespace dynamic
+{
+
+namespace
+{
+
+// Return the pointer inst copies if it is a trivial copy, or nullptr otherwise
+const Value* getCopySource(const Instruction& inst)
+{
+	if (!inst.getType()->isPointerTy())
+		return nullptr;
+
+	if (auto bcInst = dyn_cast<BitCastInst>(&inst))
+		return bcInst->getOperand(0);
+	if (auto gepInst = dyn_cast<GetElementPtrInst>(&inst))
+	{
+		if (gepInst->hasAllZeroIndices())
+			return gepInst->getPointerOperand();
+	}
+	return nullptr;
+}
+
+// Only instructions and arguments have hooks of their own. Globals and constants are logged as allocations, if at all
+bool isHookedInFunction(const Value* v)
+{
+	return isa<Instruction>(v) || isa<Argument>(v);
+}
+
+}
+
+void HookPruner::pruneTrivialCopies(Module& module)
+{
+	for (auto& f: module)
+	{
+		if (f.isDeclaration())
+			continue;
+
+		DominatorTree domTree(f);
+		for (auto& bb: f)
+		{
+			for (auto& inst: bb)
+			{
+				auto src = getCopySource(inst);
+				if (src == nullptr || !isHookedInFunction(src))
+					continue;
+
+				// The hook of an argument sits at function entry and dominates everything. The hook of an instruction sits right after it
+				if (auto srcInst = dyn_cast<Instruction>(src))
+				{
+					// An invoke result is not hooked on the normal path
+					if (isa<InvokeInst>(srcInst) || !domTree.dominates(srcInst, &inst))
+						continue;
+				}
+
+				if (prunedValues.insert(&inst).second)
+					++numCopies;
+			}
+		}
+	}
+}
+
+void HookPruner::prunePreciseValue(const Value* v)
+{
+	if (prunedValues.insert(v).second)
+		++numPrecise;
+}
+
+}
@@ -76,7 +76,7 @@ const IDAssigner::IDType* IDAssigner::getID(const llvm::Value* v) const
 
 const llvm::Value* IDAssigner::getValue(IDType id) const
 {
-	if (id >= revIdMap.size())
+	if (id < startID || id - startID >= revIdMap.size())
 		return nullptr;
 	else
 		return revIdMap[id - startID];
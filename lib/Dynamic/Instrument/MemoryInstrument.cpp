@@ -6,9 +6,15 @@
 
 #include <llvm/IR/CallSite.h>
 #include <llvm/IR/Constants.h>
+#include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/Instructions.h>
 #include <llvm/IR/Module.h>
+#include <llvm/Support/ErrorHandling.h>
+#include <llvm/Support/MathExtras.h>
 #include <llvm/Support/raw_ostream.h>
+#include <llvm/Transforms/Utils/BasicBlockUtils.h>
+
+#include <vector>
 
 using namespace annotation;
 using namespace llvm;
@@ -28,8 +34,7 @@ BasicBlock::iterator nextInsertionPos(Instruction& inst)
 
 bool isMalloc(const Function* f, const ExternalPointerTable& extTable)
 {
-	auto fName = f->getName();
-	if (auto summary = extTable.lookup(fName.data()))
+	if (auto summary = extTable.lookup(f))
 	{
 		for (auto const& effect: *summary)
 			if (effect.getType() == PointerEffectType::Alloc)
@@ -38,14 +43,33 @@ bool isMalloc(const Function* f, const ExternalPointerTable& extTable)
 	return false;
 }
 
+// The external pointer table has no notion of deallocation, so free() and realloc() are recognized by name
+bool isFree(const Function* f)
+{
+	return f->getName() == "free";
+}
+
+bool isRealloc(const Function* f)
+{
+	return f->getName() == "realloc";
+}
+
 class Instrumenter
 {
 private:
 	DynamicHooks& hooks;
 	const IDAssigner& idMap;
 	const ExternalPointerTable& extTable;
+	const SamplingPolicy& samplingPolicy;
+	const HookPruner& pruner;
 	Module& module;
 
+	unsigned numPointerHooks;
+	unsigned numPrunedHooks;
+
+	// Pointer hooks to be guarded by a sampling check once the whole module is instrumented. Guarding splits basic blocks, which must not happen while we are still walking them
+	std::vector<CallInst*> sampledHooks;
+
 	size_t getID(const Value* v) const
 	{
 		auto id = idMap.getID(v);
@@ -68,9 +92,28 @@ private:
 	{
 		return PointerType::getUnqual(getCharType());
 	}
+	Value* castToCharPtr(Value* val, Instruction* pos)
+	{
+		if (val->getType() != getCharPtrType())
+			val = new BitCastInst(val, getCharPtrType(), "ptr", pos);
+		return val;
+	}
+	Value* castToLong(Value* val, Instruction* pos)
+	{
+		if (val->getType() != getLongType())
+			val = CastInst::CreateIntegerCast(val, getLongType(), false, "size", pos);
+		return val;
+	}
+	// A size of 0 tells the runtime that the size is unknown, in which case only the start address is attributed to the allocation
+	Value* getTypeSize(Type* type)
+	{
+		auto size = type->isSized() ? module.getDataLayout().getTypeAllocSize(type) : 0;
+		return ConstantInt::get(getLongType(), size);
+	}
+	Value* getMallocSize(CallSite cs, Instruction* pos);
 
 	void instrumentPointer(Value*, Instruction*);
-	void instrumentAllocation(AllocType, Value*, Instruction*);
+	void instrumentAllocation(AllocType, Value*, Value*, Instruction*);
 	void instrumentGlobals();
 	void instrumentFunction(Function&);
 	void instrumentFunctionParams(Function&);
@@ -83,33 +126,49 @@ private:
 	void instrumentCall(CallSite cs);
 	void instrumentPointerInst(Instruction&);
 	void instrumentMalloc(CallSite cs);
+	void instrumentFree(CallSite cs);
+	void instrumentRealloc(CallSite cs);
+
+	void sampleHook(CallInst*);
 public:
-	Instrumenter(DynamicHooks& d, const IDAssigner& i, const ExternalPointerTable& t, Module& m): hooks(d), idMap(i), extTable(t), module(m) {}
+	Instrumenter(DynamicHooks& d, const IDAssigner& i, const ExternalPointerTable& t, const SamplingPolicy& s, const HookPruner& p, Module& m): hooks(d), idMap(i), extTable(t), samplingPolicy(s), pruner(p), module(m), numPointerHooks(0), numPrunedHooks(0) {}
 
 	void instrument();
+
+	unsigned getNumPointerHooks() const { return numPointerHooks; }
+	unsigned getNumPrunedHooks() const { return numPrunedHooks; }
 };
 
 void Instrumenter::instrumentPointer(Value* val, Instruction* pos)
 {
 	assert(val != nullptr && pos != nullptr && val->getType()->isPointerTy());
+	if (pruner.isPruned(val))
+	{
+		++numPrunedHooks;
+		return;
+	}
+	++numPointerHooks;
 	auto id = getID(val);
 
 	auto idArg = ConstantInt::get(getIntType(), id);
 	if (val->getType() != getCharPtrType())
 		val = new BitCastInst(val, getCharPtrType(), "ptr", pos);
-	CallInst::Create(hooks.getPointerHook(), { idArg, val }, "", pos);
+	auto hook = CallInst::Create(hooks.getPointerHook(), { idArg, val }, "", pos);
+	if (!samplingPolicy.isSamplingAll())
+		sampledHooks.push_back(hook);
 }
 
-void Instrumenter::instrumentAllocation(AllocType allocType, Value* ptr, Instruction* pos)
+void Instrumenter::instrumentAllocation(AllocType allocType, Value* ptr, Value* size, Instruction* pos)
 {
 	assert(ptr != nullptr && pos != nullptr && ptr->getType()->isPointerTy());
+	assert(size != nullptr && size->getType() == getLongType());
 
 	auto allocTypeArg = ConstantInt::get(getCharType(), allocType);
 	auto ptrId = getID(ptr);
 	if (ptr->getType() != getCharPtrType())
 		ptr = new BitCastInst(ptr, getCharPtrType(), "alloc_ptr", pos);
 	auto idArg = ConstantInt::get(getIntType(), ptrId);
-	CallInst::Create(hooks.getAllocHook(), { allocTypeArg, idArg, ptr }, "", pos);
+	CallInst::Create(hooks.getAllocHook(), { allocTypeArg, idArg, ptr, size }, "", pos);
 }
 
 void Instrumenter::instrumentGlobals()
@@ -124,7 +183,7 @@ void Instrumenter::instrumentGlobals()
 		if (global.hasUnnamedAddr())
 			global.setUnnamedAddr(false);
 
-		instrumentAllocation(AllocType::Global, &global, retInst);
+		instrumentAllocation(AllocType::Global, &global, getTypeSize(global.getValueType()), retInst);
 	}
 
 	// Functions
@@ -138,7 +197,8 @@ void Instrumenter::instrumentGlobals()
 		if (f.hasUnnamedAddr())
 			f.setUnnamedAddr(false);
 
-		instrumentAllocation(AllocType::Global, &f, retInst);
+		// Functions have no size. Only their address belongs to them
+		instrumentAllocation(AllocType::Global, &f, ConstantInt::get(getLongType(), 0), retInst);
 	}
 }
 
@@ -151,7 +211,7 @@ void Instrumenter::instrumentFunctionParams(Function& f)
 		{
 			if (arg.hasByValAttr())
 			{
-				instrumentAllocation(AllocType::Stack, &arg, entry);
+				instrumentAllocation(AllocType::Stack, &arg, getTypeSize(arg.getType()->getPointerElementType()), entry);
 			}
 
 			instrumentPointer(&arg, entry);
@@ -180,7 +240,10 @@ void Instrumenter::instrumentExit(Instruction& inst)
 void Instrumenter::instrumentAlloca(AllocaInst& allocInst)
 {
 	auto pos = nextInsertionPos(allocInst);
-	instrumentAllocation(AllocType::Stack, &allocInst, pos);
+	auto size = getTypeSize(allocInst.getAllocatedType());
+	if (allocInst.isArrayAllocation())
+		size = BinaryOperator::CreateMul(size, castToLong(allocInst.getArraySize(), pos), "alloca_size", pos);
+	instrumentAllocation(AllocType::Stack, &allocInst, size, pos);
 }
 
 void Instrumenter::instrumentMalloc(CallSite cs)
@@ -189,7 +252,51 @@ void Instrumenter::instrumentMalloc(CallSite cs)
 	assert(!cs.isInvoke() && "Not supported yet");
 
 	auto pos = nextInsertionPos(*cs.getInstruction());
-	instrumentAllocation(AllocType::Heap, cs.getInstruction(), pos);
+	instrumentAllocation(AllocType::Heap, cs.getInstruction(), getMallocSize(cs, pos), pos);
+}
+
+Value* Instrumenter::getMallocSize(CallSite cs, Instruction* pos)
+{
+	// The annotation of calloc() names the element size, which is what the static analysis cares about
+	auto callee = cs.getCalledFunction();
+	if (callee->getName() == "calloc")
+		return BinaryOperator::CreateMul(castToLong(cs.getArgument(0), pos), castToLong(cs.getArgument(1), pos), "calloc_size", pos);
+
+	if (auto summary = extTable.lookup(callee))
+	{
+		for (auto const& effect: *summary)
+		{
+			if (effect.getType() != PointerEffectType::Alloc || !effect.getAsAllocEffect().hasSizePosition())
+				continue;
+			auto sizePos = effect.getAsAllocEffect().getSizePosition();
+			if (sizePos.isArgPosition() && sizePos.getAsArgPosition().getArgIndex() < cs.arg_size())
+				return castToLong(cs.getArgument(sizePos.getAsArgPosition().getArgIndex()), pos);
+		}
+	}
+
+	// E.g. strdup() or fopen()
+	return ConstantInt::get(getLongType(), 0);
+}
+
+void Instrumenter::instrumentFree(CallSite cs)
+{
+	// Log the free before the call, since the address may be handed out again as soon as free() returns
+	auto inst = cs.getInstruction();
+	CallInst::Create(hooks.getFreeHook(), { castToCharPtr(cs.getArgument(0), inst) }, "", inst);
+}
+
+void Instrumenter::instrumentRealloc(CallSite cs)
+{
+	// We don't handle invoke for now
+	assert(!cs.isInvoke() && "Not supported yet");
+
+	// The realloc record must precede the pointer record of the returned value, so that the pointer resolves to the moved block. See instrumentCall()
+	// realloc(NULL, n) allocates a fresh block, which is attributed to the realloc call like any other allocation
+	auto inst = cs.getInstruction();
+	auto pos = nextInsertionPos(*inst);
+	auto idArg = ConstantInt::get(getIntType(), getID(inst));
+	auto size = castToLong(cs.getArgument(1), pos);
+	CallInst::Create(hooks.getReallocHook(), { idArg, castToCharPtr(cs.getArgument(0), inst), castToCharPtr(inst, pos), size }, "", pos);
 }
 
 void Instrumenter::instrumentCall(CallSite cs)
@@ -199,7 +306,8 @@ void Instrumenter::instrumentCall(CallSite cs)
 	auto callee = cs.getCalledFunction();
 	auto inst = cs.getInstruction();
 
-	if (callee && isMalloc(callee, extTable))
+	// realloc() is annotated as an allocation as well, for the case of a null input. Its hook takes care of that
+	if (callee && isMalloc(callee, extTable) && !isRealloc(callee))
 		instrumentMalloc(cs);
 	else
 	{
@@ -208,9 +316,16 @@ void Instrumenter::instrumentCall(CallSite cs)
 		auto idArg = ConstantInt::get(getIntType(), id);
 		CallInst::Create(hooks.getCallHook(), { idArg }, "", inst);
 
+		if (callee && isFree(callee))
+			instrumentFree(cs);
+
 		// If the call returns a pointer, record it
 		if (inst->getType()->isPointerTy())
 			instrumentPointer(inst, nextInsertionPos(*inst));
+
+		// This goes right after the call, and hence before the pointer hook above
+		if (callee && isRealloc(callee))
+			instrumentRealloc(cs);
 	}
 }
 
@@ -302,12 +417,60 @@ void Instrumenter::instrumentFunction(Function& f)
 	}
 }
 
+void Instrumenter::sampleHook(CallInst* hook)
+{
+	auto counterType = Type::getInt32Ty(module.getContext());
+	auto counter = new GlobalVariable(module, counterType, false, GlobalValue::InternalLinkage, ConstantInt::get(counterType, 0), "pts.sample.counter");
+
+	// The counters are not updated atomically. A lost update in a multithreaded program only shifts the sampling pattern a bit
+	IRBuilder<> builder(hook);
+	auto count = builder.CreateLoad(counter);
+	Value* cond = nullptr;
+	switch (samplingPolicy.getMode())
+	{
+		case SamplingPolicy::Mode::Window:
+		{
+			auto period = samplingPolicy.getPeriod();
+			auto next = builder.CreateAdd(count, ConstantInt::get(counterType, 1));
+			Value* phase = count;
+			if (isPowerOf2_32(period))
+				phase = builder.CreateAnd(count, period - 1);
+			else
+			{
+				// 2^32 is not a multiple of the period, so a counter that wraps around would give the window that straddles the wrap a short period. Keep the counter below the period instead
+				auto isLast = builder.CreateICmpEQ(next, ConstantInt::get(counterType, period));
+				next = builder.CreateSelect(isLast, ConstantInt::get(counterType, 0), next);
+			}
+			builder.CreateStore(next, counter);
+			cond = builder.CreateICmpULT(phase, ConstantInt::get(counterType, samplingPolicy.getLength()));
+			break;
+		}
+		case SamplingPolicy::Mode::FirstN:
+			// The counter only moves on the slow path, so it never wraps around
+			cond = builder.CreateICmpULT(count, ConstantInt::get(counterType, samplingPolicy.getLength()));
+			break;
+		case SamplingPolicy::Mode::All:
+			llvm_unreachable("Hooks are not sampled when logging everything");
+	}
+
+	auto thenTerm = SplitBlockAndInsertIfThen(cond, hook, false);
+	hook->moveBefore(thenTerm);
+	if (samplingPolicy.getMode() == SamplingPolicy::Mode::FirstN)
+	{
+		IRBuilder<> thenBuilder(hook);
+		thenBuilder.CreateStore(thenBuilder.CreateAdd(count, ConstantInt::get(counterType, 1)), counter);
+	}
+}
+
 void Instrumenter::instrument()
 {
 	instrumentGlobals();
 
 	for (auto& f: module)
 		instrumentFunction(f);
+
+	for (auto hook: sampledHooks)
+		sampleHook(hook);
 }
 
 }
@@ -318,9 +481,13 @@ void MemoryInstrument::runOnModule(Module& module)
 	FeatureCheck().runOnModule(module);
 
 	IDAssigner idMap(module);
+	extTable.bindModule(module);
 	DynamicHooks hooks(module);
 
-	Instrumenter(hooks, idMap, extTable, module).instrument();
+	Instrumenter instrumenter(hooks, idMap, extTable, samplingPolicy, pruner, module);
+	instrumenter.instrument();
+	numPointerHooks = instrumenter.getNumPointerHooks();
+	numPrunedHooks = instrumenter.getNumPrunedHooks();
 }
 
 }
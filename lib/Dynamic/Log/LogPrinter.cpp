@@ -26,7 +26,10 @@ void LogPrinter::visitAllocRecord(const AllocRecord& allocRecord)
 			std::cerr << "Illegal alloc type. Log file must be broken\n";
 			std::exit(-1);
 	}
-	os << "Ptr# " << allocRecord.id << " = " << allocRecord.address << '\n';
+	os << "Ptr# " << allocRecord.id << " = " << allocRecord.address;
+	if (allocRecord.size != 0)
+		os << " (" << allocRecord.size << " bytes)";
+	os << '\n';
 }
 
 void LogPrinter::visitPointerRecord(const PointerRecord& ptrRecord)
@@ -49,4 +52,22 @@ void LogPrinter::visitCallRecord(const CallRecord& callRecord)
 	os << "[CALL] Inst# " << callRecord.id << '\n';
 }
 
+void LogPrinter::visitFreeRecord(const FreeRecord& freeRecord)
+{
+	os << "[FREE] " << freeRecord.address << '\n';
+}
+
+void LogPrinter::visitReallocRecord(const ReallocRecord& reallocRecord)
+{
+	os << "[REALLOC] " << reallocRecord.oldAddress << " -> " << reallocRecord.newAddress;
+	if (reallocRecord.newSize != 0)
+		os << " (" << reallocRecord.newSize << " bytes)";
+	os << '\n';
+}
+
+void LogPrinter::visitThreadRecord(const ThreadRecord& threadRecord)
+{
+	os << "[THREAD] Thread# " << threadRecord.id << '\n';
+}
+
 }
@@ -1,6 +1,8 @@
+#include "Dynamic/Log/LogFormat.h"
 #include "Dynamic/Log/LogReader.h"
 
 #include <cassert>
+#include <cstring>
 #include <iostream>
 
 namespace dynamic
@@ -18,15 +20,18 @@ static std::experimental::optional<LogRecord> readRecord(std::istream& is)
 {
 	LogRecord rec;
 
-	bool succ = true;
 	char type;
-	succ &= readData(is, &type);
+	if (!readData(is, &type))
+		return std::experimental::optional<LogRecord>();
+
+	bool succ = true;
 	switch (type)
 	{
 		case TAllocRec:
 			succ &= readData(is, &rec.allocRecord.type);
 			succ &= readData(is, &rec.allocRecord.id);
 			succ &= readData(is, &rec.allocRecord.address);
+			rec.allocRecord.size = 0;
 			break;
 		case TPointerRec:
 			succ &= readData(is, &rec.ptrRecord.id);
@@ -41,9 +46,20 @@ static std::experimental::optional<LogRecord> readRecord(std::istream& is)
 		case TCallRec:
 			succ &= readData(is, &rec.callRecord.id);
 			break;
+		case TFreeRec:
+			succ &= readData(is, &rec.freeRecord.address);
+			break;
+		case TReallocRec:
+			succ &= readData(is, &rec.reallocRecord.oldAddress);
+			succ &= readData(is, &rec.reallocRecord.newAddress);
+			rec.reallocRecord.newSize = 0;
+			break;
+		case TSyncRec:
+			succ &= readData(is, &rec.syncRecord.seq);
+			break;
 		default:
 		{
-			std::cerr << static_cast<unsigned>(rec.type) << std::endl;
+			std::cerr << static_cast<unsigned>(type) << std::endl;
 			std::cerr << "Illegal record type. Log file must be broken.\n";
 			std::exit(-1);
 		}
@@ -56,41 +72,203 @@ static std::experimental::optional<LogRecord> readRecord(std::istream& is)
 		return std::experimental::make_optional(std::move(rec));
 }
 
-std::vector<LogRecord> EagerLogReader::readLogFromFile(const char* fileName)
+static bool decodeID(const std::uint8_t*& pos, const std::uint8_t* end, unsigned& id)
 {
-	std::vector<LogRecord> ret;
+	std::uint64_t val;
+	auto len = logDecodeVarint(pos, end, &val);
+	if (len == 0)
+		return false;
+	pos += len;
+	id = static_cast<unsigned>(val);
+	return true;
+}
 
-	std::ifstream file(fileName, std::ios::in|std::ios::binary|std::ios::ate);
-	if (file.is_open())
-	{
-		auto size = file.tellg();
-		auto numEntry = size / sizeof(LogRecord);
-		ret.reserve(numEntry);
+static bool decodeAddress(const std::uint8_t*& pos, const std::uint8_t* end, std::uint64_t& prevAddress, void*& addr)
+{
+	std::uint64_t val;
+	auto len = logDecodeVarint(pos, end, &val);
+	if (len == 0)
+		return false;
+	pos += len;
+	prevAddress += static_cast<std::uint64_t>(logZigzagDecode(val));
+	addr = reinterpret_cast<void*>(static_cast<std::uintptr_t>(prevAddress));
+	return true;
+}
 
-		file.seekg(0, std::ios::beg);
-		for (auto i = 0; i < numEntry; ++i)
+static bool decodeSize(const std::uint8_t*& pos, const std::uint8_t* end, std::uint64_t& size)
+{
+	auto len = logDecodeVarint(pos, end, &size);
+	pos += len;
+	return len != 0;
+}
+
+bool decodeV2Record(const std::uint8_t*& pos, const std::uint8_t* end, std::uint64_t& prevAddress, LogRecord& rec)
+{
+	if (pos >= end)
+		return false;
+
+	auto type = *pos++;
+	rec.type = static_cast<LogRecordType>(type);
+	switch (type)
+	{
+		case TAllocRec:
+			if (pos >= end)
+				return false;
+			rec.allocRecord.type = static_cast<char>(*pos++);
+			return decodeID(pos, end, rec.allocRecord.id) && decodeAddress(pos, end, prevAddress, rec.allocRecord.address) && decodeSize(pos, end, rec.allocRecord.size);
+		case TPointerRec:
+			return decodeID(pos, end, rec.ptrRecord.id) && decodeAddress(pos, end, prevAddress, rec.ptrRecord.address);
+		case TEnterRec:
+			return decodeID(pos, end, rec.enterRecord.id);
+		case TExitRec:
+			return decodeID(pos, end, rec.exitRecord.id);
+		case TCallRec:
+			return decodeID(pos, end, rec.callRecord.id);
+		case TFreeRec:
+			return decodeAddress(pos, end, prevAddress, rec.freeRecord.address);
+		case TReallocRec:
+			return decodeAddress(pos, end, prevAddress, rec.reallocRecord.oldAddress) && decodeAddress(pos, end, prevAddress, rec.reallocRecord.newAddress) && decodeSize(pos, end, rec.reallocRecord.newSize);
+		case TSyncRec:
 		{
-			auto rec = readRecord(file);
-			assert(rec && "Log read failure");
-			ret.emplace_back(std::move(*rec));
+			auto len = logDecodeVarint(pos, end, &rec.syncRecord.seq);
+			pos += len;
+			return len != 0;
 		}
+		default:
+			return false;
 	}
+}
+
+std::vector<LogRecord> EagerLogReader::readLogFromFile(const char* fileName)
+{
+	std::vector<LogRecord> ret;
+
+	// A log that cannot be opened reads as an empty one
+	if (!std::ifstream(fileName, std::ios::in|std::ios::binary).is_open())
+		return ret;
+
+	LazyLogReader reader(fileName);
+	while (auto rec = reader.readLogRecord())
+		ret.emplace_back(std::move(*rec));
 
 	return ret;
 }
 
-LazyLogReader::LazyLogReader(const char* fileName): ifs(fileName, std::ios::in|std::ios::binary)
+LazyLogReader::LazyLogReader(const char* fileName): ifs(fileName, std::ios::in|std::ios::binary), isV2(false), blockPos(0), prevAddress(0)
 {
 	if (!ifs.is_open())
 	{
 		std::cerr << "Open log file " << fileName << " failed\n";
 		std::exit(-1);
 	}
+
+	char magic[LOG_V2_MAGIC_SIZE];
+	ifs.read(magic, LOG_V2_MAGIC_SIZE);
+	if (ifs.gcount() == LOG_V2_MAGIC_SIZE && std::memcmp(magic, LOG_V2_MAGIC, LOG_V2_MAGIC_SIZE) == 0)
+		isV2 = true;
+	else
+	{
+		// A v1 log has no header
+		ifs.clear();
+		ifs.seekg(0, std::ios::beg);
+	}
+}
+
+// Skip bytes until the next block sync marker. Return false at the end of the file
+bool LazyLogReader::findNextBlock()
+{
+	std::size_t matched = 0;
+	char c;
+	while (ifs.get(c))
+	{
+		if (c == LOG_BLOCK_SYNC[matched])
+		{
+			if (++matched == LOG_BLOCK_SYNC_SIZE)
+				return true;
+		}
+		else
+			matched = (c == LOG_BLOCK_SYNC[0]) ? 1 : 0;
+	}
+	return false;
+}
+
+bool LazyLogReader::readBlock()
+{
+	while (true)
+	{
+		std::uint8_t header[LOG_BLOCK_HEADER_SIZE];
+		ifs.read(reinterpret_cast<char*>(header), LOG_BLOCK_HEADER_SIZE);
+		auto numRead = ifs.gcount();
+		if (numRead == 0)
+			return false;
+
+		if (numRead != LOG_BLOCK_HEADER_SIZE || std::memcmp(header, LOG_BLOCK_SYNC, LOG_BLOCK_SYNC_SIZE) != 0)
+		{
+			std::cerr << "Log block header is broken. Skipping to the next block.\n";
+			ifs.clear();
+			ifs.seekg(-static_cast<std::streamoff>(numRead) + 1, std::ios::cur);
+			if (!findNextBlock())
+				return false;
+			ifs.seekg(-static_cast<std::streamoff>(LOG_BLOCK_SYNC_SIZE), std::ios::cur);
+			continue;
+		}
+
+		auto flags = header[LOG_BLOCK_SYNC_SIZE];
+		auto rawSize = logReadU32(header + LOG_BLOCK_SYNC_SIZE + 1);
+		auto storedSize = logReadU32(header + LOG_BLOCK_SYNC_SIZE + 5);
+
+		auto& target = (flags & LOG_BLOCK_COMPRESSED) ? storedBlock : block;
+		target.resize(storedSize);
+		ifs.read(reinterpret_cast<char*>(target.data()), storedSize);
+		if (static_cast<std::size_t>(ifs.gcount()) != storedSize)
+		{
+			std::cerr << "Log file ends in the middle of a block. The last " << ifs.gcount() << " bytes are dropped.\n";
+			return false;
+		}
+
+		if (flags & LOG_BLOCK_COMPRESSED)
+		{
+			block.resize(rawSize);
+			if (!logDecompressBlock(storedBlock.data(), storedSize, block.data(), rawSize))
+			{
+				std::cerr << "Log block decompression failed. Skipping to the next block.\n";
+				continue;
+			}
+		}
+
+		blockPos = 0;
+		prevAddress = 0;
+		return true;
+	}
+}
+
+std::experimental::optional<LogRecord> LazyLogReader::readV2Record()
+{
+	while (blockPos >= block.size())
+	{
+		if (!readBlock())
+			return std::experimental::optional<LogRecord>();
+	}
+
+	LogRecord rec;
+	const std::uint8_t* pos = block.data() + blockPos;
+	const std::uint8_t* end = block.data() + block.size();
+	if (!decodeV2Record(pos, end, prevAddress, rec))
+	{
+		std::cerr << "Illegal record in log block. Log file must be broken.\n";
+		std::exit(-1);
+	}
+	blockPos = pos - block.data();
+
+	return std::experimental::make_optional(std::move(rec));
 }
 
 std::experimental::optional<LogRecord> LazyLogReader::readLogRecord()
 {
-	return readRecord(ifs);
+	if (isV2)
+		return readV2Record();
+	else
+		return readRecord(ifs);
 }
 
-}
\ No newline at end of file
+}
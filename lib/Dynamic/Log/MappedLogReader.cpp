@@ -0,0 +1,238 @@
+#include "Dynamic/Log/LogFormat.h"
+#include "Dynamic/Log/LogReader.h"
+#include "Dynamic/Log/MappedLogReader.h"
+
+#include <cstring>
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace dynamic
+{
+
+MappedLogReader::MappedLogReader(const char* fileName): data(nullptr), size(0), isV2(false)
+{
+	auto fd = ::open(fileName, O_RDONLY);
+	if (fd == -1)
+	{
+		std::cerr << "Open log file " << fileName << " failed\n";
+		std::exit(-1);
+	}
+
+	struct stat st;
+	if (::fstat(fd, &st) == -1)
+	{
+		std::cerr << "Cannot stat log file " << fileName << "\n";
+		std::exit(-1);
+	}
+
+	size = st.st_size;
+	if (size > 0)
+	{
+		auto addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (addr == MAP_FAILED)
+		{
+			std::cerr << "Cannot map log file " << fileName << " into memory\n";
+			std::exit(-1);
+		}
+		// Records are only ever read front to back
+		::madvise(addr, size, MADV_SEQUENTIAL);
+		data = static_cast<const std::uint8_t*>(addr);
+	}
+	// The mapping stays valid after the descriptor is closed
+	::close(fd);
+
+	isV2 = size >= LOG_V2_MAGIC_SIZE && std::memcmp(data, LOG_V2_MAGIC, LOG_V2_MAGIC_SIZE) == 0;
+}
+
+MappedLogReader::MappedLogReader(MappedLogReader&& other) noexcept: data(other.data), size(other.size), isV2(other.isV2)
+{
+	other.data = nullptr;
+	other.size = 0;
+}
+
+MappedLogReader::~MappedLogReader()
+{
+	if (data != nullptr)
+		::munmap(const_cast<std::uint8_t*>(data), size);
+}
+
+MappedLogReader::const_iterator::const_iterator(const MappedLogReader* r): reader(r), pos(nullptr), end(nullptr), nextBlock(nullptr), prevAddress(0), currRecord()
+{
+	if (reader->isV2)
+	{
+		pos = end = nextBlock = reader->data + LOG_V2_MAGIC_SIZE;
+	}
+	else
+	{
+		pos = reader->data;
+		end = reader->data + reader->size;
+	}
+	advance();
+}
+
+bool MappedLogReader::const_iterator::readBlock()
+{
+	auto fileEnd = reader->data + reader->size;
+	while (true)
+	{
+		if (fileEnd - nextBlock < LOG_BLOCK_HEADER_SIZE)
+		{
+			if (nextBlock != fileEnd)
+				std::cerr << "Log file ends in the middle of a block header. The last " << fileEnd - nextBlock << " bytes are dropped.\n";
+			return false;
+		}
+
+		if (std::memcmp(nextBlock, LOG_BLOCK_SYNC, LOG_BLOCK_SYNC_SIZE) != 0)
+		{
+			std::cerr << "Log block header is broken. Skipping to the next block.\n";
+			auto found = static_cast<const std::uint8_t*>(::memmem(nextBlock + 1, fileEnd - nextBlock - 1, LOG_BLOCK_SYNC, LOG_BLOCK_SYNC_SIZE));
+			if (found == nullptr)
+				return false;
+			nextBlock = found;
+			continue;
+		}
+
+		auto flags = nextBlock[LOG_BLOCK_SYNC_SIZE];
+		auto rawSize = logReadU32(nextBlock + LOG_BLOCK_SYNC_SIZE + 1);
+		auto storedSize = logReadU32(nextBlock + LOG_BLOCK_SYNC_SIZE + 5);
+		auto payload = nextBlock + LOG_BLOCK_HEADER_SIZE;
+		if (static_cast<std::size_t>(fileEnd - payload) < storedSize)
+		{
+			std::cerr << "Log file ends in the middle of a block. The last " << fileEnd - nextBlock << " bytes are dropped.\n";
+			return false;
+		}
+		nextBlock = payload + storedSize;
+		prevAddress = 0;
+
+		if (flags & LOG_BLOCK_COMPRESSED)
+		{
+			blockBuffer = std::make_shared<std::vector<std::uint8_t>>(rawSize);
+			if (!logDecompressBlock(payload, storedSize, blockBuffer->data(), rawSize))
+			{
+				std::cerr << "Log block decompression failed. Skipping to the next block.\n";
+				continue;
+			}
+			pos = blockBuffer->data();
+			end = pos + rawSize;
+		}
+		else
+		{
+			blockBuffer.reset();
+			pos = payload;
+			end = payload + storedSize;
+		}
+		return true;
+	}
+}
+
+template <typename T>
+static void readField(const std::uint8_t*& pos, T* field)
+{
+	std::memcpy(field, pos, sizeof(T));
+	pos += sizeof(T);
+}
+
+static std::size_t getV1RecordSize(char type)
+{
+	switch (type)
+	{
+		case TAllocRec:
+			return 1 + sizeof(char) + sizeof(unsigned) + sizeof(void*);
+		case TPointerRec:
+			return 1 + sizeof(unsigned) + sizeof(void*);
+		case TEnterRec:
+		case TExitRec:
+		case TCallRec:
+			return 1 + sizeof(unsigned);
+		case TFreeRec:
+			return 1 + sizeof(void*);
+		case TReallocRec:
+			return 1 + 2 * sizeof(void*);
+		case TSyncRec:
+			return 1 + sizeof(std::uint64_t);
+		default:
+		{
+			std::cerr << static_cast<unsigned>(type) << std::endl;
+			std::cerr << "Illegal record type. Log file must be broken.\n";
+			std::exit(-1);
+		}
+	}
+}
+
+void MappedLogReader::const_iterator::advance()
+{
+	if (reader->isV2)
+	{
+		while (pos == end)
+		{
+			if (!readBlock())
+			{
+				*this = const_iterator();
+				return;
+			}
+		}
+
+		if (!decodeV2Record(pos, end, prevAddress, currRecord))
+		{
+			std::cerr << "Illegal record in log block. Log file must be broken.\n";
+			std::exit(-1);
+		}
+		return;
+	}
+
+	if (pos == end)
+	{
+		*this = const_iterator();
+		return;
+	}
+
+	auto type = static_cast<char>(*pos);
+	if (static_cast<std::size_t>(end - pos) < getV1RecordSize(type))
+	{
+		std::cerr << "Log file ends in the middle of a record. The last " << end - pos << " bytes are dropped.\n";
+		*this = const_iterator();
+		return;
+	}
+
+	++pos;
+	currRecord.type = static_cast<LogRecordType>(type);
+	switch (type)
+	{
+		case TAllocRec:
+			readField(pos, &currRecord.allocRecord.type);
+			readField(pos, &currRecord.allocRecord.id);
+			readField(pos, &currRecord.allocRecord.address);
+			currRecord.allocRecord.size = 0;
+			break;
+		case TPointerRec:
+			readField(pos, &currRecord.ptrRecord.id);
+			readField(pos, &currRecord.ptrRecord.address);
+			break;
+		case TEnterRec:
+			readField(pos, &currRecord.enterRecord.id);
+			break;
+		case TExitRec:
+			readField(pos, &currRecord.exitRecord.id);
+			break;
+		case TCallRec:
+			readField(pos, &currRecord.callRecord.id);
+			break;
+		case TFreeRec:
+			readField(pos, &currRecord.freeRecord.address);
+			break;
+		case TReallocRec:
+			readField(pos, &currRecord.reallocRecord.oldAddress);
+			readField(pos, &currRecord.reallocRecord.newAddress);
+			currRecord.reallocRecord.newSize = 0;
+			break;
+		case TSyncRec:
+			readField(pos, &currRecord.syncRecord.seq);
+			break;
+	}
+}
+
+}
@@ -0,0 +1,123 @@
+#include "Dynamic/Log/ThreadedLogReader.h"
+
+#include <iostream>
+#include <limits>
+#include <string>
+
+#include <unistd.h>
+
+namespace dynamic
+{
+
+static bool isAllocationEvent(LogRecordType type)
+{
+	return type == TAllocRec || type == TFreeRec || type == TReallocRec;
+}
+
+ThreadedLogReader::ThreadedLogReader(const char* fileName)
+{
+	streams.emplace_back(fileName);
+
+	// The runtime numbers the streams without gaps, so the first missing one ends the search
+	for (auto i = 1u; ; ++i)
+	{
+		auto streamName = std::string(fileName) + "." + std::to_string(i);
+		if (::access(streamName.c_str(), R_OK) != 0)
+			break;
+		streams.emplace_back(streamName.c_str());
+	}
+}
+
+ThreadedLogReader::const_iterator::const_iterator(const ThreadedLogReader* r): reader(r), numEvents(0), currThread(0), index(0), currRecord()
+{
+	for (auto const& stream: reader->streams)
+		heads.push_back(stream.begin());
+	seen.assign(heads.size(), 0);
+	for (auto i = 0u; i < heads.size(); ++i)
+		skipSyncRecords(i);
+
+	advance();
+	if (reader != nullptr)
+		index = 0;
+}
+
+void ThreadedLogReader::const_iterator::skipSyncRecords(unsigned stream)
+{
+	auto ite = reader->streams[stream].end();
+	auto& head = heads[stream];
+	while (head != ite && head->type == TSyncRec)
+	{
+		seen[stream] = head->syncRecord.seq;
+		++head;
+	}
+}
+
+// Return the stream whose next record can be merged now and is an allocation event or not as requested, or the number of streams if there is none. The current thread is tried first to keep thread switches rare
+unsigned ThreadedLogReader::const_iterator::pickStream(bool isEvent) const
+{
+	auto isReady = [this, isEvent] (unsigned stream)
+	{
+		return heads[stream] != reader->streams[stream].end() && isAllocationEvent(heads[stream]->type) == isEvent && seen[stream] <= numEvents;
+	};
+
+	if (isReady(currThread))
+		return currThread;
+	for (auto i = 0u; i < heads.size(); ++i)
+	{
+		if (isReady(i))
+			return i;
+	}
+	return heads.size();
+}
+
+void ThreadedLogReader::const_iterator::advance()
+{
+	while (true)
+	{
+		// Records that do not allocate go first: they were written before the next allocation event got its number
+		auto next = pickStream(false);
+		if (next == heads.size())
+			next = pickStream(true);
+
+		if (next != heads.size())
+		{
+			++index;
+			if (next != currThread)
+			{
+				currThread = next;
+				currRecord.type = TThreadRec;
+				currRecord.threadRecord.id = next;
+				return;
+			}
+
+			currRecord = *heads[next];
+			if (isAllocationEvent(currRecord.type))
+			{
+				if (seen[next] == numEvents)
+					++numEvents;
+				++seen[next];
+			}
+			++heads[next];
+			skipSyncRecords(next);
+			return;
+		}
+
+		// Every stream is either exhausted or waits for an event that no stream holds. The latter happens when a thread was still running at exit and its last records were dropped
+		auto minSeen = std::numeric_limits<std::uint64_t>::max();
+		for (auto i = 0u; i < heads.size(); ++i)
+		{
+			if (heads[i] != reader->streams[i].end() && seen[i] < minSeen)
+				minSeen = seen[i];
+		}
+		if (minSeen == std::numeric_limits<std::uint64_t>::max())
+		{
+			*this = const_iterator();
+			return;
+		}
+
+		std::cerr << "Log streams miss allocation events " << numEvents << " to " << minSeen - 1 << ". Skipping them.\n";
+		numEvents = minSeen;
+	}
+}
+
+}
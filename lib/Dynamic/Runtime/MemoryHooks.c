@@ -1,7 +1,9 @@
+#include "Dynamic/Log/LogFormat.h"
 #include "Dynamic/Log/LogRecord.h"
 
 #include <assert.h>
 #include <errno.h>
+#include <pthread.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -9,16 +11,58 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 
-static FILE* logFile = NULL;
+// Records are staged in a per-thread buffer and written out in large blocks, so the common path of a hook is a memcpy plus an uncontended lock
+// The thread that calls HookInit writes to pts.log. Every other thread gets its own stream pts.log.<n>, where n numbers the threads in the order they first hit a hook
+// The streams only make sense together: a pointer record may refer to memory another thread allocated. Alloc, free and realloc records are therefore numbered across all threads, and before a pointer or allocation record a thread writes a sync record carrying the number of such events so far whenever other threads have logged one since its last record. A single-threaded run never needs a sync record. ThreadedLogReader merges the streams back into one log along these numbers
+// The LOG_FORMAT environment variable selects the encoding: "v1" for fixed-width records, "v2" (the default) for varint/delta encoded records, or "v2z" for v2 with compressed blocks. See LogFormat.h
+#define LOG_BUFFER_SIZE (1 << 20)
 
-static char* getLogFileName(const char* dirName)
+struct ThreadLog
+{
+	FILE* file;
+	size_t size;
+	struct ThreadLog* next;
+
+	// Held by the owning thread while it writes a record, so that HookFinalize can wait for it before closing the file
+	volatile int lock;
+	// The number of allocation events this stream is known to come after. See writeLogRecord()
+	uint64_t lastSeq;
+
+	// v2 only: addresses are encoded relative to the previous one in the same block
+	uint64_t prevAddress;
+	// v2z only: scratch space for the compressor
+	uint8_t* compressBuffer;
+	uint32_t* hashTable;
+
+	char buffer[LOG_BUFFER_SIZE];
+};
+
+static const char* logDirName = NULL;
+static int logVersion = 2;
+static int compressLog = 0;
+static __thread struct ThreadLog* currThreadLog = NULL;
+
+// The logs of all threads that have not exited yet, so that the ones still holding data can be flushed at exit
+static struct ThreadLog* threadLogList = NULL;
+static volatile int threadLogListLock = 0;
+static unsigned numThreads = 0;
+static volatile int finalized = 0;
+
+static pthread_key_t threadLogKey;
+static pthread_once_t threadLogKeyOnce = PTHREAD_ONCE_INIT;
+
+// The number of alloc, free and realloc records logged by all threads so far
+static uint64_t numAllocEvents = 0;
+
+static char* getLogFileName(const char* dirName, unsigned threadId)
 {
 	const char* logName = "pts.log";
-	int size = strlen(logName) + strlen(dirName) + 2;
+	int size = strlen(logName) + strlen(dirName) + 16;
 	char* fileNameStr = malloc(size);
-	strcpy(fileNameStr, dirName);
-	strcat(fileNameStr, "/");
-	strcat(fileNameStr, logName);
+	if (threadId == 0)
+		snprintf(fileNameStr, size, "%s/%s", dirName, logName);
+	else
+		snprintf(fileNameStr, size, "%s/%s.%u", dirName, logName, threadId);
 	return fileNameStr;
 }
 
@@ -29,95 +73,393 @@ static void panic(const char* fmt, ...)
 	vfprintf(stderr, fmt, args);
 	va_end(args);
 
-	if (logFile != NULL)
-		fclose(logFile);
+	// The log is broken anyway. Don't let HookFinalize touch it again
+	finalized = 1;
 	exit(-1);
 }
 
-static void openLogFile(const char* dirName)
+static void lockThreadLogList()
+{
+	while (__sync_lock_test_and_set(&threadLogListLock, 1))
+		;
+}
+
+static void unlockThreadLogList()
+{
+	__sync_lock_release(&threadLogListLock);
+}
+
+static void lockThreadLog(struct ThreadLog* threadLog)
+{
+	while (__sync_lock_test_and_set(&threadLog->lock, 1))
+		;
+}
+
+static void unlockThreadLog(struct ThreadLog* threadLog)
 {
-	assert(logFile == NULL);
-	char* logFileName = getLogFileName(dirName);
-	logFile = fopen(logFileName, "wb");
-	if (logFile == NULL)
+	__sync_lock_release(&threadLog->lock);
+}
+
+static FILE* openLogFile(const char* dirName, unsigned threadId)
+{
+	char* logFileName = getLogFileName(dirName, threadId);
+	FILE* file = fopen(logFileName, "wb");
+	if (file == NULL)
 		panic("Log file \'%s\' open failed.\n", logFileName);
 	free(logFileName);
+	return file;
 }
 
-static void writeData(void* data, size_t size)
+static struct ThreadLog* createThreadLog()
 {
-	size_t numBytesWritten = fwrite(data, size, 1, logFile);
-	if (numBytesWritten != 1)
+	assert(logDirName != NULL && "HookInit() must be called before any other hook");
+
+	struct ThreadLog* threadLog = malloc(sizeof(struct ThreadLog));
+	if (threadLog == NULL)
+		panic("Log buffer allocation failed\n");
+	threadLog->file = openLogFile(logDirName, __sync_fetch_and_add(&numThreads, 1));
+	threadLog->size = 0;
+	threadLog->lock = 0;
+	threadLog->lastSeq = 0;
+	threadLog->prevAddress = 0;
+	threadLog->compressBuffer = NULL;
+	threadLog->hashTable = NULL;
+	if (compressLog)
+	{
+		threadLog->compressBuffer = malloc(LOG_COMPRESS_BOUND(LOG_BUFFER_SIZE));
+		threadLog->hashTable = malloc(sizeof(uint32_t) * LOG_COMPRESS_HASH_SIZE);
+		if (threadLog->compressBuffer == NULL || threadLog->hashTable == NULL)
+			panic("Log buffer allocation failed\n");
+	}
+
+	if (logVersion == 2 && fwrite(LOG_V2_MAGIC, LOG_V2_MAGIC_SIZE, 1, threadLog->file) != 1)
 		panic("Log write error\n");
+
+	lockThreadLogList();
+	threadLog->next = threadLogList;
+	threadLogList = threadLog;
+	unlockThreadLogList();
+
+	return threadLog;
 }
 
-static void writeLogRecord(struct LogRecord* rec)
+static void flushThreadLog(struct ThreadLog* threadLog);
+
+// Runs when a thread exits. The main thread never gets here: exit() does not run key destructors, and HookFinalize takes care of its log
+static void destroyThreadLog(void* arg)
+{
+	struct ThreadLog* threadLog = arg;
+
+	lockThreadLogList();
+	for (struct ThreadLog** link = &threadLogList; *link != NULL; link = &(*link)->next)
+	{
+		if (*link == threadLog)
+		{
+			*link = threadLog->next;
+			break;
+		}
+	}
+	unlockThreadLogList();
+
+	// HookFinalize closes the file of every log still on the list. If it got to this one first, there is nothing left to write
+	lockThreadLog(threadLog);
+	if (threadLog->file != NULL)
+	{
+		flushThreadLog(threadLog);
+		fclose(threadLog->file);
+		threadLog->file = NULL;
+	}
+	unlockThreadLog(threadLog);
+
+	free(threadLog->compressBuffer);
+	free(threadLog->hashTable);
+	free(threadLog);
+	currThreadLog = NULL;
+}
+
+static void createThreadLogKey()
+{
+	if (pthread_key_create(&threadLogKey, destroyThreadLog) != 0)
+		panic("Thread log key creation failed\n");
+}
+
+static struct ThreadLog* getThreadLog()
+{
+	if (currThreadLog == NULL)
+	{
+		currThreadLog = createThreadLog();
+		pthread_once(&threadLogKeyOnce, createThreadLogKey);
+		pthread_setspecific(threadLogKey, currThreadLog);
+	}
+	return currThreadLog;
+}
+
+static void writeBytes(FILE* file, const void* data, size_t size)
+{
+	size_t numBytesWritten = fwrite(data, 1, size, file);
+	if (numBytesWritten != size)
+		panic("Log write error\n");
+}
+
+static void flushThreadLog(struct ThreadLog* threadLog)
+{
+	if (threadLog->size == 0)
+		return;
+
+	if (logVersion == 1)
+		writeBytes(threadLog->file, threadLog->buffer, threadLog->size);
+	else
+	{
+		const uint8_t* payload = (const uint8_t*)threadLog->buffer;
+		size_t storedSize = threadLog->size;
+		uint8_t flags = 0;
+		if (compressLog)
+		{
+			size_t compressedSize = logCompressBlock(payload, threadLog->size, threadLog->compressBuffer, threadLog->hashTable);
+			// Incompressible blocks are stored as they are
+			if (compressedSize < threadLog->size)
+			{
+				payload = threadLog->compressBuffer;
+				storedSize = compressedSize;
+				flags |= LOG_BLOCK_COMPRESSED;
+			}
+		}
+
+		uint8_t header[LOG_BLOCK_HEADER_SIZE];
+		memcpy(header, LOG_BLOCK_SYNC, LOG_BLOCK_SYNC_SIZE);
+		header[LOG_BLOCK_SYNC_SIZE] = flags;
+		logWriteU32(header + LOG_BLOCK_SYNC_SIZE + 1, threadLog->size);
+		logWriteU32(header + LOG_BLOCK_SYNC_SIZE + 5, storedSize);
+		writeBytes(threadLog->file, header, LOG_BLOCK_HEADER_SIZE);
+		writeBytes(threadLog->file, payload, storedSize);
+
+		threadLog->prevAddress = 0;
+	}
+	threadLog->size = 0;
+}
+
+static void writeData(struct ThreadLog* threadLog, const void* data, size_t size)
+{
+	memcpy(threadLog->buffer + threadLog->size, data, size);
+	threadLog->size += size;
+}
+
+static void writeVarint(struct ThreadLog* threadLog, uint64_t val)
+{
+	threadLog->size += logEncodeVarint((uint8_t*)threadLog->buffer + threadLog->size, val);
+}
+
+static void writeAddress(struct ThreadLog* threadLog, void* addr)
+{
+	uint64_t currAddress = (uint64_t)(uintptr_t)addr;
+	writeVarint(threadLog, logZigzagEncode((int64_t)(currAddress - threadLog->prevAddress)));
+	threadLog->prevAddress = currAddress;
+}
+
+static void writeLogRecordV2(struct ThreadLog* threadLog, struct LogRecord* rec)
 {
-	assert(logFile != NULL && rec != NULL);
 	char type = rec->type;
-	writeData(&type, sizeof(char));
+	writeData(threadLog, &type, sizeof(char));
 	switch (rec->type)
 	{
 		case TAllocRec:
-			writeData(&rec->allocRecord.type, sizeof(char));
-			writeData(&rec->allocRecord.id, sizeof(unsigned));
-			writeData(&rec->allocRecord.address, sizeof(void*));
+			writeData(threadLog, &rec->allocRecord.type, sizeof(char));
+			writeVarint(threadLog, rec->allocRecord.id);
+			writeAddress(threadLog, rec->allocRecord.address);
+			writeVarint(threadLog, rec->allocRecord.size);
 			break;
 		case TPointerRec:
-			writeData(&rec->ptrRecord.id, sizeof(unsigned));
-			writeData(&rec->ptrRecord.address, sizeof(void*));
+			writeVarint(threadLog, rec->ptrRecord.id);
+			writeAddress(threadLog, rec->ptrRecord.address);
 			break;
 		case TEnterRec:
-			writeData(&rec->enterRecord.id, sizeof(unsigned));
+			writeVarint(threadLog, rec->enterRecord.id);
 			break;
 		case TExitRec:
-			writeData(&rec->exitRecord.id, sizeof(unsigned));
+			writeVarint(threadLog, rec->exitRecord.id);
 			break;
 		case TCallRec:
-			writeData(&rec->callRecord.id, sizeof(unsigned));
+			writeVarint(threadLog, rec->callRecord.id);
+			break;
+		case TFreeRec:
+			writeAddress(threadLog, rec->freeRecord.address);
+			break;
+		case TReallocRec:
+			writeAddress(threadLog, rec->reallocRecord.oldAddress);
+			writeAddress(threadLog, rec->reallocRecord.newAddress);
+			writeVarint(threadLog, rec->reallocRecord.newSize);
+			break;
+		case TSyncRec:
+			writeVarint(threadLog, rec->syncRecord.seq);
 			break;
 		default:
 			panic("Illegal record type\n");
 	}
 }
 
+static void writeLogRecordV1(struct ThreadLog* threadLog, struct LogRecord* rec)
+{
+	char type = rec->type;
+	writeData(threadLog, &type, sizeof(char));
+	switch (rec->type)
+	{
+		case TAllocRec:
+			writeData(threadLog, &rec->allocRecord.type, sizeof(char));
+			writeData(threadLog, &rec->allocRecord.id, sizeof(unsigned));
+			writeData(threadLog, &rec->allocRecord.address, sizeof(void*));
+			break;
+		case TPointerRec:
+			writeData(threadLog, &rec->ptrRecord.id, sizeof(unsigned));
+			writeData(threadLog, &rec->ptrRecord.address, sizeof(void*));
+			break;
+		case TEnterRec:
+			writeData(threadLog, &rec->enterRecord.id, sizeof(unsigned));
+			break;
+		case TExitRec:
+			writeData(threadLog, &rec->exitRecord.id, sizeof(unsigned));
+			break;
+		case TCallRec:
+			writeData(threadLog, &rec->callRecord.id, sizeof(unsigned));
+			break;
+		case TFreeRec:
+			writeData(threadLog, &rec->freeRecord.address, sizeof(void*));
+			break;
+		case TReallocRec:
+			writeData(threadLog, &rec->reallocRecord.oldAddress, sizeof(void*));
+			writeData(threadLog, &rec->reallocRecord.newAddress, sizeof(void*));
+			break;
+		case TSyncRec:
+			writeData(threadLog, &rec->syncRecord.seq, sizeof(uint64_t));
+			break;
+		default:
+			panic("Illegal record type\n");
+	}
+}
+
+static void encodeLogRecord(struct ThreadLog* threadLog, struct LogRecord* rec)
+{
+	if (logVersion == 2)
+		writeLogRecordV2(threadLog, rec);
+	else
+		writeLogRecordV1(threadLog, rec);
+}
+
+static int isAllocEvent(enum LogRecordType type)
+{
+	return type == TAllocRec || type == TFreeRec || type == TReallocRec;
+}
+
+static void writeLogRecord(struct LogRecord* rec)
+{
+	assert(rec != NULL);
+	if (finalized)
+		return;
+
+	struct ThreadLog* threadLog = getThreadLog();
+	lockThreadLog(threadLog);
+	// HookFinalize may have closed the log while we were waiting for it
+	if (finalized)
+	{
+		unlockThreadLog(threadLog);
+		return;
+	}
+
+	// Leave room for a sync record in front of the record
+	if (threadLog->size + 2 * LOG_V2_MAX_RECORD_SIZE > LOG_BUFFER_SIZE)
+		flushThreadLog(threadLog);
+
+	// Only the placement of pointer records relative to allocation events matters across threads. Context records are left alone, which spares them the shared counter
+	int isEvent = isAllocEvent(rec->type);
+	if (isEvent || rec->type == TPointerRec)
+	{
+		uint64_t seq = isEvent ? __sync_fetch_and_add(&numAllocEvents, 1) : __atomic_load_n(&numAllocEvents, __ATOMIC_RELAXED);
+		if (seq != threadLog->lastSeq)
+		{
+			struct LogRecord syncRecord;
+			syncRecord.type = TSyncRec;
+			syncRecord.syncRecord.seq = seq;
+			encodeLogRecord(threadLog, &syncRecord);
+		}
+		threadLog->lastSeq = isEvent ? seq + 1 : seq;
+	}
+
+	encodeLogRecord(threadLog, rec);
+	unlockThreadLog(threadLog);
+}
+
+// Threads that are still running at this point lose the records they write afterwards. Each log is locked before it is flushed and closed, so a thread in the middle of a record finishes it first, and every later record sees finalized set and is dropped
 extern void HookFinalize()
 {
-	assert(logFile != NULL);
-	fclose(logFile);
+	if (finalized)
+		return;
+	finalized = 1;
+
+	lockThreadLogList();
+	for (struct ThreadLog* threadLog = threadLogList; threadLog != NULL; threadLog = threadLog->next)
+	{
+		lockThreadLog(threadLog);
+		flushThreadLog(threadLog);
+		fclose(threadLog->file);
+		threadLog->file = NULL;
+		unlockThreadLog(threadLog);
+	}
+	unlockThreadLogList();
 }
 
 extern void HookInit()
 {
-	const char* logDirName = "log";
+	logDirName = "log";
 	const char* logDirEnv = getenv("LOG_DIR");
 	if (logDirEnv != NULL)
 		logDirName = logDirEnv;
 
+	const char* logFormatEnv = getenv("LOG_FORMAT");
+	if (logFormatEnv != NULL)
+	{
+		if (strcmp(logFormatEnv, "v1") == 0)
+			logVersion = 1;
+		else if (strcmp(logFormatEnv, "v2z") == 0)
+			compressLog = 1;
+		else if (strcmp(logFormatEnv, "v2") != 0)
+			panic("Unknown log format \'%s\'. Use v1, v2 or v2z.\n", logFormatEnv);
+	}
+
 	int r = mkdir(logDirName, 0755);
 	if (r == -1 && errno != EEXIST)
 		panic("Log directory \'%s\' creation failed.\n", logDirName);
-	openLogFile(logDirName);
+
+	// Claim stream 0 for the main thread
+	getThreadLog();
 	atexit(HookFinalize);
 }
-
-extern void HookAlloc(char ty, unsigned id, void* addr)
+extern void HookAlloc(char ty, unsigned id, void* addr, size_t size)
 {
+	// v1 logs drop the size
 	struct LogRecord record;
 	memset(&record, 0, sizeof(record));
 	record.type = TAllocRec;
 	record.allocRecord.type = ty;
 	record.allocRecord.id = id;
 	record.allocRecord.address = addr;
+	record.allocRecord.size = size;
 	//printf("[ALLOC] %d %p\n", ty, addr);
 	writeLogRecord(&record);
 }
 
+// The size of a null-terminated array of strings, including the terminator
+static size_t getStringArraySize(char** strs)
+{
+	size_t n = 0;
+	while (strs[n] != NULL)
+		++n;
+	return (n + 1) * sizeof(char*);
+}
+
 extern void HookMain(int argvId, char** argv, int envpId, char** envp)
 {
-	HookAlloc(1, argvId, argv);
+	HookAlloc(1, argvId, argv, getStringArraySize(argv));
 	if (envp != NULL && envpId != 0)
-		HookAlloc(1, envpId, envp);
+		HookAlloc(1, envpId, envp, getStringArraySize(envp));
 }
 
 extern void HookPointer(unsigned id, void* addr)
@@ -156,3 +498,36 @@ extern void HookCall(unsigned id)
 	//printf("[CALL] %d\n", id);
 	writeLogRecord(&record);
 }
+
+extern void HookFree(void* addr)
+{
+	// free(NULL) is a no-op
+	if (addr == NULL)
+		return;
+
+	struct LogRecord record;
+	record.type = TFreeRec;
+	record.freeRecord.address = addr;
+	writeLogRecord(&record);
+}
+
+extern void HookRealloc(unsigned id, void* oldAddr, void* newAddr, size_t size)
+{
+	// A null result means that the old block is left untouched
+	if (newAddr == NULL)
+		return;
+
+	// realloc(NULL, n) behaves like malloc(n)
+	if (oldAddr == NULL)
+	{
+		HookAlloc(2, id, newAddr, size);
+		return;
+	}
+
+	struct LogRecord record;
+	record.type = TReallocRec;
+	record.reallocRecord.oldAddress = oldAddr;
+	record.reallocRecord.newAddress = newAddr;
+	record.reallocRecord.newSize = size;
+	writeLogRecord(&record);
+}
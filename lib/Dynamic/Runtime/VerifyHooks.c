@@ -0,0 +1,666 @@
+// For pthread_getattr_np
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+// An alternative to MemoryHooks.c that checks the program against its static points-to sets as it runs, instead of logging every hook for pts-verify
+// pts-inst -online-verify embeds the static points-to sets into the program and hands them over through HookVerifyInit. The runtime keeps a shadow map of live allocations, resolves every address seen by HookPointer to its allocation site, and reports a violation if the static set of the hook site does not contain that site. Only the first occurrence of each (pointer, allocation site) violation is written to <LOG_DIR>/pts.violations
+// Static sets are merged across contexts, so this check is weaker than the context-sensitive one of pts-verify. An address is only attributed to an allocation whose bounds contain it, and addresses outside every known allocation (freed memory, memory of uninstrumented code, one past the end of a block) are not checked at all. A violation can therefore only be spurious if uninstrumented code freed a block and its memory was handed out again without the runtime seeing it
+// Each thread keeps the stack allocations that lie on its own stack in a shadow stack of its own, which only the thread itself modifies. Global and heap allocations share one tree behind a reader-writer lock, so concurrent checks only contend with heap allocation and deallocation. The rare pointer into the stack of another thread is resolved through the list of threads, which the same lock guards
+
+#define NO_INDEX 0xffffffffu
+
+// Tables built by pts-inst, all indexed by value ID. See StaticPtsTable.h
+static const uint32_t* siteSetTable = NULL;
+static const uint32_t* allocIndexTable = NULL;
+static const uint32_t* setBitTable = NULL;
+static uint32_t numIds = 0;
+static uint32_t wordsPerSet = 0;
+
+static const char* logDirName = NULL;
+static FILE* violationFile = NULL;
+static volatile int finalized = 0;
+
+static unsigned long long numViolations = 0;
+static unsigned long long numDistinctViolations = 0;
+
+// Runs with locks possibly held, so it must not go through exit() and the atexit HookFinalize. stderr is unbuffered and loses nothing
+static void panic(const char* fmt, ...)
+{
+	va_list args;
+	va_start(args, fmt);
+	vfprintf(stderr, fmt, args);
+	va_end(args);
+
+	finalized = 1;
+	_exit(-1);
+}
+
+static void lockSpin(volatile int* lock)
+{
+	while (__sync_lock_test_and_set(lock, 1))
+		;
+}
+
+static void unlockSpin(volatile int* lock)
+{
+	__sync_lock_release(lock);
+}
+
+// Guards the shared allocation tree and the thread list. Bit 0 is set by a writer, and the other bits count readers in steps of 2. A writer sets bit 0 before it waits for the readers to leave, which keeps new readers out
+static volatile unsigned shadowLock = 0;
+
+static void readLockShadow()
+{
+	while (1)
+	{
+		unsigned state = shadowLock;
+		if ((state & 1) == 0 && __sync_bool_compare_and_swap(&shadowLock, state, state + 2))
+			return;
+	}
+}
+
+static void readUnlockShadow()
+{
+	__sync_fetch_and_sub(&shadowLock, 2);
+}
+
+static void writeLockShadow()
+{
+	while (__sync_fetch_and_or(&shadowLock, 1) & 1)
+		;
+	while (shadowLock != 1)
+		;
+}
+
+static void writeUnlockShadow()
+{
+	__sync_lock_release(&shadowLock);
+}
+
+/* Shadow memory: treaps keyed by the start address of each live allocation */
+
+struct AllocNode
+{
+	// The allocation covers [addr, end)
+	uintptr_t addr;
+	uintptr_t end;
+	unsigned id;
+	unsigned priority;
+	struct AllocNode* left;
+	struct AllocNode* right;
+};
+
+struct AllocTree
+{
+	struct AllocNode* root;
+	unsigned seed;
+};
+
+static unsigned nextPriority(struct AllocTree* tree)
+{
+	// xorshift32
+	tree->seed ^= tree->seed << 13;
+	tree->seed ^= tree->seed >> 17;
+	tree->seed ^= tree->seed << 5;
+	return tree->seed;
+}
+
+// Split the treap into the nodes with an address below addr and the rest
+static void splitTreap(struct AllocNode* node, uintptr_t addr, struct AllocNode** lhs, struct AllocNode** rhs)
+{
+	if (node == NULL)
+	{
+		*lhs = *rhs = NULL;
+		return;
+	}
+	if (node->addr < addr)
+	{
+		splitTreap(node->right, addr, &node->right, rhs);
+		*lhs = node;
+	}
+	else
+	{
+		splitTreap(node->left, addr, lhs, &node->left);
+		*rhs = node;
+	}
+}
+
+// All addresses in lhs must be below the ones in rhs
+static struct AllocNode* mergeTreap(struct AllocNode* lhs, struct AllocNode* rhs)
+{
+	if (lhs == NULL)
+		return rhs;
+	if (rhs == NULL)
+		return lhs;
+	if (lhs->priority > rhs->priority)
+	{
+		lhs->right = mergeTreap(lhs->right, rhs);
+		return lhs;
+	}
+	else
+	{
+		rhs->left = mergeTreap(lhs, rhs->left);
+		return rhs;
+	}
+}
+
+static void freeTreap(struct AllocNode* node)
+{
+	if (node == NULL)
+		return;
+	freeTreap(node->left);
+	freeTreap(node->right);
+	free(node);
+}
+
+static struct AllocNode* findAlloc(const struct AllocTree* tree, uintptr_t addr)
+{
+	struct AllocNode* node = tree->root;
+	while (node != NULL && node->addr != addr)
+		node = addr < node->addr ? node->left : node->right;
+	return node;
+}
+
+// Return the allocation that contains addr, or NULL if there is none. Allocations do not overlap, so the only candidate is the one with the greatest start address not above addr
+static struct AllocNode* lookupAlloc(const struct AllocTree* tree, uintptr_t addr)
+{
+	struct AllocNode* ret = NULL;
+	struct AllocNode* node = tree->root;
+	while (node != NULL)
+	{
+		if (node->addr <= addr)
+		{
+			ret = node;
+			node = node->right;
+		}
+		else
+			node = node->left;
+	}
+	if (ret != NULL && addr >= ret->end)
+		return NULL;
+	return ret;
+}
+
+// A size of 0 means that the instrumenter could not tell the size. Such an allocation is known to cover its first byte only
+static uintptr_t getAllocEnd(uintptr_t addr, size_t size)
+{
+	return addr + (size == 0 ? 1 : size);
+}
+
+// A live allocation at the same address must have been freed by uninstrumented code, so it is replaced
+static void insertAlloc(struct AllocTree* tree, uintptr_t addr, size_t size, unsigned id)
+{
+	struct AllocNode* existing = findAlloc(tree, addr);
+	if (existing != NULL)
+	{
+		existing->end = getAllocEnd(addr, size);
+		existing->id = id;
+		return;
+	}
+
+	struct AllocNode* node = malloc(sizeof(struct AllocNode));
+	if (node == NULL)
+		panic("Shadow memory allocation failed\n");
+	node->addr = addr;
+	node->end = getAllocEnd(addr, size);
+	node->id = id;
+	node->priority = nextPriority(tree);
+	node->left = node->right = NULL;
+
+	struct AllocNode *lhs, *rhs;
+	splitTreap(tree->root, addr, &lhs, &rhs);
+	tree->root = mergeTreap(mergeTreap(lhs, node), rhs);
+}
+
+// Return the allocation site of the removed allocation, or 0 if there was none
+static unsigned eraseAlloc(struct AllocTree* tree, uintptr_t addr)
+{
+	struct AllocNode** link = &tree->root;
+	while (*link != NULL && (*link)->addr != addr)
+		link = addr < (*link)->addr ? &(*link)->left : &(*link)->right;
+
+	struct AllocNode* node = *link;
+	if (node == NULL)
+		return 0;
+	unsigned id = node->id;
+	*link = mergeTreap(node->left, node->right);
+	free(node);
+	return id;
+}
+
+// Global and heap allocations, plus stack allocations outside the stack bounds of their thread. Guarded by shadowLock
+static struct AllocTree sharedAllocs = { NULL, 2463534242u };
+
+/* Per-thread state */
+
+struct ThreadState
+{
+	// Stack allocations of the thread in the order they were made, grouped by frame
+	uintptr_t* addrs;
+	size_t numAddrs, addrCap;
+	size_t* frameStarts;
+	size_t numFrames, frameCap;
+
+	// The stack allocations within [stackLow, stackHigh), the stack of the thread. The thread reads the tree without locking, and takes the lock only to modify it, since other threads may be reading it. Both bounds are 0 if the stack could not be determined
+	struct AllocTree stackAllocs;
+	volatile int lock;
+	uintptr_t stackLow, stackHigh;
+
+	// Only written by the thread itself
+	unsigned long long numChecks;
+
+	struct ThreadState* next;
+};
+
+static __thread struct ThreadState* currThreadState = NULL;
+
+// All live threads. Guarded by shadowLock
+static struct ThreadState* threadList = NULL;
+// The checks of the threads that have exited
+static unsigned long long numRetiredChecks = 0;
+
+static pthread_key_t threadStateKey;
+static pthread_once_t threadStateKeyOnce = PTHREAD_ONCE_INIT;
+
+static void* growArray(void* array, size_t* cap, size_t elemSize)
+{
+	*cap = *cap == 0 ? 64 : *cap * 2;
+	array = realloc(array, *cap * elemSize);
+	if (array == NULL)
+		panic("Shadow stack allocation failed\n");
+	return array;
+}
+
+static int isOnStack(const struct ThreadState* state, uintptr_t addr)
+{
+	return addr >= state->stackLow && addr < state->stackHigh;
+}
+
+// Runs when a thread exits. Whatever is left on its shadow stack died with its stack
+static void destroyThreadState(void* arg)
+{
+	struct ThreadState* state = arg;
+
+	writeLockShadow();
+	for (struct ThreadState** link = &threadList; *link != NULL; link = &(*link)->next)
+	{
+		if (*link == state)
+		{
+			*link = state->next;
+			break;
+		}
+	}
+	numRetiredChecks += state->numChecks;
+	for (size_t i = 0; i < state->numAddrs; ++i)
+	{
+		if (!isOnStack(state, state->addrs[i]))
+			eraseAlloc(&sharedAllocs, state->addrs[i]);
+	}
+	writeUnlockShadow();
+
+	freeTreap(state->stackAllocs.root);
+	free(state->addrs);
+	free(state->frameStarts);
+	free(state);
+	currThreadState = NULL;
+}
+
+static void createThreadStateKey()
+{
+	if (pthread_key_create(&threadStateKey, destroyThreadState) != 0)
+		panic("Thread state key creation failed\n");
+}
+
+static struct ThreadState* getThreadState()
+{
+	if (currThreadState != NULL)
+		return currThreadState;
+
+	struct ThreadState* state = calloc(1, sizeof(struct ThreadState));
+	if (state == NULL)
+		panic("Thread state allocation failed\n");
+	state->stackAllocs.seed = 2463534242u;
+
+	pthread_attr_t attr;
+	if (pthread_getattr_np(pthread_self(), &attr) == 0)
+	{
+		void* stackAddr;
+		size_t stackSize;
+		if (pthread_attr_getstack(&attr, &stackAddr, &stackSize) == 0)
+		{
+			state->stackLow = (uintptr_t)stackAddr;
+			state->stackHigh = state->stackLow + stackSize;
+		}
+		pthread_attr_destroy(&attr);
+	}
+
+	writeLockShadow();
+	state->next = threadList;
+	threadList = state;
+	writeUnlockShadow();
+
+	pthread_once(&threadStateKeyOnce, createThreadStateKey);
+	pthread_setspecific(threadStateKey, state);
+
+	currThreadState = state;
+	return state;
+}
+
+static void insertStackAlloc(struct ThreadState* state, uintptr_t addr, size_t size, unsigned id)
+{
+	if (isOnStack(state, addr))
+	{
+		lockSpin(&state->lock);
+		insertAlloc(&state->stackAllocs, addr, size, id);
+		unlockSpin(&state->lock);
+	}
+	else
+	{
+		writeLockShadow();
+		insertAlloc(&sharedAllocs, addr, size, id);
+		writeUnlockShadow();
+	}
+}
+
+// Find the allocation site of addr. Return 0 if addr lies outside every allocation it could belong to
+static int resolveAddress(struct ThreadState* self, uintptr_t addr, unsigned* allocId)
+{
+	struct AllocNode* node;
+	if (isOnStack(self, addr))
+	{
+		node = lookupAlloc(&self->stackAllocs, addr);
+		if (node != NULL)
+			*allocId = node->id;
+		return node != NULL;
+	}
+
+	readLockShadow();
+	struct ThreadState* owner = threadList;
+	while (owner != NULL && !isOnStack(owner, addr))
+		owner = owner->next;
+
+	if (owner != NULL)
+	{
+		lockSpin(&owner->lock);
+		node = lookupAlloc(&owner->stackAllocs, addr);
+	}
+	else
+		node = lookupAlloc(&sharedAllocs, addr);
+	if (node != NULL)
+		*allocId = node->id;
+
+	if (owner != NULL)
+		unlockSpin(&owner->lock);
+	readUnlockShadow();
+	return node != NULL;
+}
+
+/* Violations seen so far, as an open-addressing set of (pointer id, allocation id) pairs. Guarded by violationLock, which is never held while taking another lock */
+
+static volatile int violationLock = 0;
+static uint64_t* violationSet = NULL;
+static size_t violationCap = 0;
+
+static int insertViolation(uint64_t key)
+{
+	if ((numDistinctViolations + 1) * 2 > violationCap)
+	{
+		size_t newCap = violationCap == 0 ? 256 : violationCap * 2;
+		uint64_t* newSet = malloc(newCap * sizeof(uint64_t));
+		if (newSet == NULL)
+			panic("Violation set allocation failed\n");
+		memset(newSet, 0xff, newCap * sizeof(uint64_t));
+		for (size_t i = 0; i < violationCap; ++i)
+		{
+			if (violationSet[i] == UINT64_MAX)
+				continue;
+			size_t slot = (violationSet[i] * 0x9e3779b97f4a7c15ull) >> 20 & (newCap - 1);
+			while (newSet[slot] != UINT64_MAX)
+				slot = (slot + 1) & (newCap - 1);
+			newSet[slot] = violationSet[i];
+		}
+		free(violationSet);
+		violationSet = newSet;
+		violationCap = newCap;
+	}
+
+	size_t slot = (key * 0x9e3779b97f4a7c15ull) >> 20 & (violationCap - 1);
+	while (violationSet[slot] != UINT64_MAX)
+	{
+		if (violationSet[slot] == key)
+			return 0;
+		slot = (slot + 1) & (violationCap - 1);
+	}
+	violationSet[slot] = key;
+	++numDistinctViolations;
+	return 1;
+}
+
+static FILE* getViolationFile()
+{
+	if (violationFile == NULL)
+	{
+		int size = strlen(logDirName) + 32;
+		char* fileName = malloc(size);
+		snprintf(fileName, size, "%s/pts.violations", logDirName);
+		violationFile = fopen(fileName, "w");
+		if (violationFile == NULL)
+			panic("Violation file \'%s\' open failed.\n", fileName);
+		free(fileName);
+	}
+	return violationFile;
+}
+
+static int isInStaticSet(uint32_t setNum, unsigned allocId)
+{
+	// The null object always has index 0
+	uint32_t idx = allocId == 0 ? 0 : (allocId < numIds ? allocIndexTable[allocId] : NO_INDEX);
+	if (idx == NO_INDEX)
+		return 0;
+	const uint32_t* bits = setBitTable + (size_t)(setNum - 1) * wordsPerSet;
+	return (bits[idx / 32] >> (idx % 32)) & 1;
+}
+
+static void checkPointer(unsigned id, void* addr)
+{
+	if (siteSetTable == NULL || id >= numIds || finalized)
+		return;
+	uint32_t setNum = siteSetTable[id];
+	if (setNum == 0)
+		return;
+
+	struct ThreadState* self = getThreadState();
+	__atomic_store_n(&self->numChecks, self->numChecks + 1, __ATOMIC_RELAXED);
+
+	unsigned allocId = 0;
+	// Addresses outside every known allocation cannot be attributed to any site
+	if (addr != NULL && !resolveAddress(self, (uintptr_t)addr, &allocId))
+		return;
+	if (isInStaticSet(setNum, allocId))
+		return;
+
+	lockSpin(&violationLock);
+	if (!finalized)
+	{
+		++numViolations;
+		if (insertViolation(((uint64_t)id << 32) | allocId))
+			fprintf(getViolationFile(), "[UNSOUND] Ptr# %u -> Alloc# %u (%p)\n", id, allocId, addr);
+	}
+	unlockSpin(&violationLock);
+}
+
+extern void HookVerifyInit(const uint32_t* sites, uint32_t n, const uint32_t* allocs, const uint32_t* sets, uint32_t w)
+{
+	siteSetTable = sites;
+	numIds = n;
+	allocIndexTable = allocs;
+	setBitTable = sets;
+	wordsPerSet = w;
+}
+
+extern void HookFinalize()
+{
+	writeLockShadow();
+	lockSpin(&violationLock);
+	if (finalized)
+	{
+		unlockSpin(&violationLock);
+		writeUnlockShadow();
+		return;
+	}
+	finalized = 1;
+
+	unsigned long long numChecks = numRetiredChecks;
+	for (struct ThreadState* state = threadList; state != NULL; state = state->next)
+		numChecks += __atomic_load_n(&state->numChecks, __ATOMIC_RELAXED);
+
+	if (violationFile != NULL)
+		fclose(violationFile);
+	fprintf(stderr, "[pts-verify] %llu checks, %llu violations (%llu distinct)\n", numChecks, numViolations, numDistinctViolations);
+	unlockSpin(&violationLock);
+	writeUnlockShadow();
+}
+
+extern void HookInit()
+{
+	logDirName = "log";
+	const char* logDirEnv = getenv("LOG_DIR");
+	if (logDirEnv != NULL)
+		logDirName = logDirEnv;
+
+	int r = mkdir(logDirName, 0755);
+	if (r == -1 && errno != EEXIST)
+		panic("Log directory \'%s\' creation failed.\n", logDirName);
+
+	atexit(HookFinalize);
+}
+
+extern void HookAlloc(char ty, unsigned id, void* addr, size_t size)
+{
+	// Stack allocations go away when the enclosing function returns
+	if (ty == 1)
+	{
+		struct ThreadState* state = getThreadState();
+		insertStackAlloc(state, (uintptr_t)addr, size, id);
+		if (state->numAddrs == state->addrCap)
+			state->addrs = growArray(state->addrs, &state->addrCap, sizeof(uintptr_t));
+		state->addrs[state->numAddrs++] = (uintptr_t)addr;
+		return;
+	}
+
+	writeLockShadow();
+	insertAlloc(&sharedAllocs, (uintptr_t)addr, size, id);
+	writeUnlockShadow();
+}
+
+// The size of a null-terminated array of strings. The strings themselves are not part of it
+static size_t getStringArraySize(char** strs)
+{
+	size_t n = 0;
+	while (strs[n] != NULL)
+		++n;
+	return (n + 1) * sizeof(char*);
+}
+
+extern void HookMain(int argvId, char** argv, int envpId, char** envp)
+{
+	HookAlloc(1, argvId, argv, getStringArraySize(argv));
+	if (envp != NULL && envpId != 0)
+		HookAlloc(1, envpId, envp, getStringArraySize(envp));
+}
+
+extern void HookPointer(unsigned id, void* addr)
+{
+	checkPointer(id, addr);
+}
+
+extern void HookEnter(unsigned id)
+{
+	(void)id;
+	struct ThreadState* state = getThreadState();
+	if (state->numFrames == state->frameCap)
+		state->frameStarts = growArray(state->frameStarts, &state->frameCap, sizeof(size_t));
+	state->frameStarts[state->numFrames++] = state->numAddrs;
+}
+
+extern void HookExit(unsigned id)
+{
+	(void)id;
+	struct ThreadState* state = getThreadState();
+	if (state->numFrames == 0)
+		return;
+
+	size_t start = state->frameStarts[--state->numFrames];
+	if (start == state->numAddrs)
+		return;
+
+	lockSpin(&state->lock);
+	int hasSharedAddrs = 0;
+	for (size_t i = start; i < state->numAddrs; ++i)
+	{
+		if (isOnStack(state, state->addrs[i]))
+			eraseAlloc(&state->stackAllocs, state->addrs[i]);
+		else
+			hasSharedAddrs = 1;
+	}
+	unlockSpin(&state->lock);
+
+	if (hasSharedAddrs)
+	{
+		writeLockShadow();
+		for (size_t i = start; i < state->numAddrs; ++i)
+		{
+			if (!isOnStack(state, state->addrs[i]))
+				eraseAlloc(&sharedAllocs, state->addrs[i]);
+		}
+		writeUnlockShadow();
+	}
+	state->numAddrs = start;
+}
+
+extern void HookCall(unsigned id)
+{
+	(void)id;
+}
+
+extern void HookFree(void* addr)
+{
+	if (addr == NULL)
+		return;
+
+	writeLockShadow();
+	eraseAlloc(&sharedAllocs, (uintptr_t)addr);
+	writeUnlockShadow();
+}
+
+extern void HookRealloc(unsigned id, void* oldAddr, void* newAddr, size_t size)
+{
+	if (newAddr == NULL)
+		return;
+
+	// realloc(NULL, n) behaves like malloc(n)
+	if (oldAddr == NULL)
+	{
+		HookAlloc(2, id, newAddr, size);
+		return;
+	}
+
+	// The moved block keeps its allocation site
+	writeLockShadow();
+	unsigned allocId = eraseAlloc(&sharedAllocs, (uintptr_t)oldAddr);
+	if (allocId != 0)
+		insertAlloc(&sharedAllocs, (uintptr_t)newAddr, size, allocId);
+	writeUnlockShadow();
+}
@@ -0,0 +1,60 @@
+#include "PointerAnalysis/Analysis/AAResultAdapter.h"
+#include "PointerAnalysis/Analysis/SemiSparsePointerAnalysis.h"
+
+using namespace llvm;
+
+namespace tpa
+{
+
+// Objects of one block are disjoint as addresses, but an access through a pointer to one field may cover the next one. Two accesses stay apart only if their sizes are known and their byte ranges do not meet. Summary objects stand for whole arrays, whose elements may be anywhere in the range
+bool TPAAAResult::accessesOverlapInBlock(const MemoryLocation& locA, const MemoryLocation& locB) const
+{
+	auto s0 = PtsSet::getEmptySet(), s1 = PtsSet::getEmptySet();
+	if (!ptrAnalysis.lookupPtsSet(locA.Ptr, s0) || !ptrAnalysis.lookupPtsSet(locB.Ptr, s1))
+		return true;
+
+	for (auto obj0: s0)
+	{
+		for (auto obj1: s1)
+		{
+			if (obj0->getMemoryBlock() != obj1->getMemoryBlock() || obj0->isSpecialObject())
+				continue;
+			if (obj0->isSummaryObject() || obj1->isSummaryObject() || locA.Size == MemoryLocation::UnknownSize || locB.Size == MemoryLocation::UnknownSize)
+				return true;
+			if (obj0->getOffset() < obj1->getOffset() + locB.Size && obj1->getOffset() < obj0->getOffset() + locA.Size)
+				return true;
+		}
+	}
+	return false;
+}
+
+llvm::AliasResult TPAAAResult::alias(const MemoryLocation& locA, const MemoryLocation& locB)
+{
+	switch (ptrAnalysis.alias(locA.Ptr, locB.Ptr))
+	{
+		case tpa::AliasResult::NoAlias:
+			if (!accessesOverlapInBlock(locA, locB))
+				return llvm::NoAlias;
+			break;
+		case tpa::AliasResult::MustAlias:
+			// The same address does not make the same access unless the sizes match too
+			if (locA.Size == locB.Size)
+				return llvm::MustAlias;
+			break;
+		case tpa::AliasResult::MayAlias:
+			break;
+	}
+	return AAResultBase::alias(locA, locB);
+}
+
+ImmutablePass* createTPAAAWrapperPass(TPAAAResult& result)
+{
+	return createExternalAAWrapperPass(
+		[&result] (Pass&, Function&, AAResults& aaResults)
+		{
+			aaResults.addAAResult(result);
+		}
+	);
+}
+
+}
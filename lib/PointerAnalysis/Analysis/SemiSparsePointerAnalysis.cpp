@@ -1,3 +1,4 @@
+#include "Context/Context.h"
 #include "PointerAnalysis/Analysis/GlobalPointerAnalysis.h"
 #include "PointerAnalysis/Analysis/SemiSparsePointerAnalysis.h"
 #include "PointerAnalysis/Engine/GlobalState.h"
@@ -6,18 +7,42 @@
 #include "PointerAnalysis/Engine/TransferFunction.h"
 #include "PointerAnalysis/Program/SemiSparseProgram.h"
 #include "Util/AnalysisEngine/DataFlowAnalysis.h"
+#include "Util/Statistics/PhaseStatistics.h"
 
 namespace tpa
 {
 
+void SemiSparsePointerAnalysis::addObjectCounters() const
+{
+	phaseStats->addCounter("pointers", ptrManager.getNumPointers());
+	phaseStats->addCounter("memory blocks", memManager.getNumMemoryBlocks());
+	phaseStats->addCounter("memory objects", memManager.getNumMemoryObjects());
+	phaseStats->addCounter("contexts", context::Context::getAllContexts().size());
+	phaseStats->addCounter("interned points-to sets", PtsSet::getNumInternedSets());
+}
+
 void SemiSparsePointerAnalysis::runOnProgram(const SemiSparseProgram& ssProg)
 {
 	auto initStore = Store();
-	std::tie(env, initStore) = GlobalPointerAnalysis(ptrManager, memManager, ssProg.getTypeMap()).runOnModule(ssProg.getModule());
+	{
+		util::ScopedPhase phase(phaseStats, "global pointer analysis");
+		std::tie(env, initStore) = GlobalPointerAnalysis(ptrManager, memManager, ssProg.getTypeMap()).runOnModule(ssProg.getModule());
+		if (phaseStats != nullptr)
+			addObjectCounters();
+	}
 
+	util::ScopedPhase phase(phaseStats, "pointer analysis");
+	extTable.bindModule(ssProg.getModule());
 	auto globalState = GlobalState(ptrManager, memManager, ssProg, extTable, env);
 	auto dfa = util::DataFlowAnalysis<GlobalState, Memo, TransferFunction, SemiSparsePropagator>(globalState, memo);
 	dfa.runOnInitialState<Initializer>(std::move(initStore));
+	numIterations = dfa.getNumIterations();
+
+	if (phaseStats != nullptr)
+	{
+		phaseStats->addCounter("iterations", numIterations);
+		addObjectCounters();
+	}
 }
 
 PtsSet SemiSparsePointerAnalysis::getPtsSetImpl(const Pointer* ptr) const
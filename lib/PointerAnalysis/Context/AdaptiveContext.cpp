@@ -5,9 +5,9 @@ using namespace llvm;
 namespace context
 {
 
-void AdaptiveContext::trackCallSite(const ProgramPoint& pLoc)
+bool AdaptiveContext::trackCallSite(const ProgramPoint& pLoc)
 {
-	trackedCallsites.insert(pLoc);
+	return trackedCallsites.insert(pLoc).second;
 }
 
 const Context* AdaptiveContext::pushContext(const Context* ctx, const llvm::Instruction* inst)
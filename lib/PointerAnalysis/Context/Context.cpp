@@ -13,9 +13,11 @@ const Context* Context::pushContext(const ProgramPoint& pp)
 
 const Context* Context::pushContext(const Context* ctx, const Instruction* inst)
 {
-	auto newCtx = Context(inst, ctx);
-	auto itr = ctxSet.insert(newCtx).first;
-	return &(*itr);
+	return ctx->getOrInsertChild(
+		std::hash<const Instruction*>()(inst),
+		[inst] (const Context& child) { return child.callSite == inst; },
+		[ctx, inst] { return new Context(inst, ctx); }
+	);
 }
 
 const Context* Context::popContext(const Context* ctx)
@@ -26,19 +28,23 @@ const Context* Context::popContext(const Context* ctx)
 
 const Context* Context::getGlobalContext()
 {
-	auto itr = ctxSet.insert(Context()).first;
-	return &(*itr);
+	return &globalCtx;
 }
 
 std::vector<const Context*> Context::getAllContexts()
 {
-	std::vector<const Context*> ret;
-	ret.reserve(ctxSet.size());
+	std::vector<const Context*> ret = { &globalCtx };
 
-	for (auto const& ctx: ctxSet)
-		ret.push_back(&ctx);
+	// The trie is walked in breadth-first order, with ret doubling as the queue
+	for (size_t i = 0; i < ret.size(); ++i)
+		ret[i]->forEachChild([&ret] (const Context* child) { ret.push_back(child); });
 
 	return ret;
 }
 
+void Context::releaseContexts()
+{
+	globalCtx.releaseChildren();
+}
+
 }
@@ -1,3 +1,4 @@
+#include "Context/AdaptiveContext.h"
 #include "Context/KLimitContext.h"
 #include "Context/ProgramPoint.h"
 
@@ -13,10 +14,17 @@ const Context* KLimitContext::pushContext(const ProgramPoint& pp)
 
 const Context* KLimitContext::pushContext(const Context* ctx, const Instruction* inst)
 {
+	// Call sites selected for refinement through AdaptiveContext always get their own context, even beyond the limit. Most runs track none, and they skip the lookup
+	if (AdaptiveContext::hasTrackedCallSites())
+	{
+		if (AdaptiveContext::isTrackedCallSite(ProgramPoint(ctx, inst)))
+			return Context::pushContext(ctx, inst);
+	}
+
 	size_t k = defaultLimit;
-	
-	assert(ctx->size() <= k);
-	if (ctx->size() == k)
+	// Only a context that went through a tracked call site can be longer than the limit
+	assert(ctx->size() <= k || AdaptiveContext::hasTrackedCallSites());
+	if (ctx->size() >= k)
 		return ctx;
 	else
 		return Context::pushContext(ctx, inst);
@@ -302,7 +302,7 @@ void TransferFunction::evalExternalCallByEffect(const context::Context* ctx, con
 
 void TransferFunction::evalExternalCall(const context::Context* ctx, const CallCFGNode& callNode, const FunctionContext& fc, EvalResult& evalResult)
 {
-	auto summary = globalState.getExternalPointerTable().lookup(fc.getFunction()->getName());
+	auto summary = globalState.getExternalPointerTable().lookup(fc.getFunction());
 	if (summary == nullptr)
 	{
 		errs() << "\nPointer Analysis error: cannot find annotation for the following function:\n" << fc.getFunction()->getName() << "\n\n";
@@ -13,7 +13,7 @@
 namespace context
 {
 
-std::unordered_set<Context> Context::ctxSet;
+Context Context::globalCtx;
 unsigned KLimitContext::defaultLimit = 0u;
 std::unordered_set<ProgramPoint> AdaptiveContext::trackedCallsites;
 
@@ -0,0 +1,59 @@
+#include "PointerAnalysis/MemoryModel/MemoryManager.h"
+#include "PointerAnalysis/Support/AliasCache.h"
+
+namespace tpa
+{
+
+// The null object is not memory. Two pointers that may both be null do not alias through it
+static bool overlapsIgnoringNull(const PtsSet& s0, const PtsSet& s1)
+{
+	if (!PtsSet::overlaps(s0, s1))
+		return false;
+
+	auto nObj = MemoryManager::getNullObject();
+	if (!s0.has(nObj) || !s1.has(nObj))
+		return true;
+	return PtsSet::intersects(s0, s1).size() > 1;
+}
+
+// A global object exists exactly once during the whole execution. Other objects may stand for many run-time instances: a stack object for one per activation of its function, a heap object for one per execution of its allocation site, and a summary object for every element of an array
+static bool isSingleInstanceObject(const MemoryObject* obj)
+{
+	return obj->isGlobalObject() && !obj->isSummaryObject();
+}
+
+AliasResult AliasCache::computeAlias(const PtsSet& s0, const PtsSet& s1)
+{
+	// A pointer that points nowhere is never dereferenced
+	if (s0.empty() || s1.empty())
+		return AliasResult::NoAlias;
+
+	auto uObj = MemoryManager::getUniversalObject();
+	if (s0.has(uObj) || s1.has(uObj))
+		return AliasResult::MayAlias;
+
+	if (!overlapsIgnoringNull(s0, s1))
+		return AliasResult::NoAlias;
+
+	if (s0 == s1 && s0.size() == 1 && isSingleInstanceObject(*s0.begin()))
+		return AliasResult::MustAlias;
+
+	return AliasResult::MayAlias;
+}
+
+AliasResult AliasCache::alias(const PtsSet& s0, const PtsSet& s1)
+{
+	// The query is symmetric. Order the key so that (s0, s1) and (s1, s0) share an entry
+	auto hasher = std::hash<PtsSet>();
+	auto key = hasher(s0) <= hasher(s1) ? std::make_pair(s0, s1) : std::make_pair(s1, s0);
+
+	auto itr = cache.find(key);
+	if (itr != cache.end())
+		return itr->second;
+
+	auto result = computeAlias(s0, s1);
+	cache.insert(std::make_pair(key, result));
+	return result;
+}
+
+}
@@ -64,6 +64,13 @@ std::vector<const MemoryObject*> PtsSet::intersects(const PtsSet& s0, const PtsS
 	return SetType::intersects(*s0.pSet, *s1.pSet);
 }
 
+bool PtsSet::overlaps(const PtsSet& s0, const PtsSet& s1)
+{
+	if (s0.pSet == s1.pSet)
+		return !s0.empty();
+	return SetType::overlaps(*s0.pSet, *s1.pSet);
+}
+
 PtsSet PtsSet::mergeAll(const std::vector<PtsSet>& sets)
 {
 	size_t totSize = 0;
@@ -79,4 +86,15 @@ PtsSet PtsSet::mergeAll(const std::vector<PtsSet>& sets)
 	return uniquifySet(SetType(std::move(flatSet)));
 }
 
+void PtsSet::releaseInternedSets()
+{
+	for (auto itr = existingSet.begin(); itr != existingSet.end();)
+	{
+		if (&*itr == emptySet)
+			++itr;
+		else
+			itr = existingSet.erase(itr);
+	}
+}
+
 }
\ No newline at end of file
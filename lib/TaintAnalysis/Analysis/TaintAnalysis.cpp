@@ -4,11 +4,18 @@
 #include "TaintAnalysis/Engine/TaintPropagator.h"
 #include "TaintAnalysis/Engine/TaintGlobalState.h"
 #include "TaintAnalysis/Engine/TransferFunction.h"
+#include "TaintAnalysis/Incremental/TaintCacheManager.h"
+#include "TaintAnalysis/Program/DefUseModule.h"
 #include "Util/AnalysisEngine/DataFlowAnalysis.h"
 #include "Util/IO/TaintAnalysis/Printer.h"
+#include "Util/IO/TaintAnalysis/ViolationReporter.h"
 
 #include <llvm/IR/Instruction.h>
+#include <llvm/Support/FileSystem.h>
 #include <llvm/Support/raw_ostream.h>
+#include <llvm/Support/ToolOutputFile.h>
+
+#include <memory>
 
 using namespace llvm;
 using namespace util::io;
@@ -31,16 +38,71 @@ static void printSinkViolation(const ProgramPoint& pp, const SinkViolationList&
 	}
 }
 
+template <typename SigContainer>
+static SinkViolationRecord reportSinkViolation(SinkViolationChecker& checker, const SigContainer& sinks, JsonViolationReporter& reporter)
+{
+	return checker.checkSinkViolation(sinks, [&reporter] (const ProgramPoint& pp, const SinkViolationList& list)
+	{
+		reporter.report(pp, list);
+	});
+}
+
+template <typename SigContainer>
+static SinkViolationRecord reportSinkViolation(SinkViolationChecker& checker, const SigContainer& sinks, const std::string& reportFileName)
+{
+	std::error_code ec;
+	tool_output_file out(reportFileName.data(), ec, sys::fs::F_Text);
+	if (ec)
+	{
+		errs() << ec.message() << "\n";
+		std::exit(-3);
+	}
+
+	JsonViolationReporter reporter(out.os());
+	auto violationRecord = reportSinkViolation(checker, sinks, reporter);
+	out.keep();
+
+	errs() << reporter.getNumReported() << " sink violations written to " << reportFileName << " (" << reporter.getNumDuplicates() << " duplicates in other contexts omitted)\n";
+	return violationRecord;
+}
+
 bool TaintAnalysis::runOnDefUseModule(const DefUseModule& duModule)
 {
+	extTable.bindModule(duModule.getModule());
 	auto globalState = TaintGlobalState(duModule, ptrAnalysis, extTable, env, memo);
 	auto dfa = util::DataFlowAnalysis<TaintGlobalState, TaintMemo, TransferFunction, TaintPropagator>(globalState, memo);
-	dfa.runOnInitialState<Initializer>(TaintStore());
 
-	auto violationRecord = SinkViolationChecker(env, memo, extTable, ptrAnalysis).checkSinkViolation(globalState.getSinks());
+	std::unique_ptr<TaintCacheManager> cacheManager;
+	if (!cacheFileName.empty())
+		cacheManager = std::make_unique<TaintCacheManager>(globalState, configFileNames);
+
+	if (cacheManager == nullptr || rebuildCache)
+		dfa.runOnInitialState<Initializer>(TaintStore());
+	else
+	{
+		auto workList = Initializer(globalState, memo).runOnInitState(TaintStore());
+		dfa.runOnWorkList(cacheManager->restore(cacheFileName.data(), std::move(workList)));
+	}
+	numIterations = dfa.getNumIterations();
+
+	auto checker = SinkViolationChecker(env, memo, extTable, ptrAnalysis);
+	SinkViolationRecord violationRecord;
+	if (reportStream != nullptr)
+	{
+		JsonViolationReporter reporter(*reportStream);
+		violationRecord = reportSinkViolation(checker, globalState.getSinks(), reporter);
+	}
+	else if (reportFileName.empty())
+	{
+		violationRecord = checker.checkSinkViolation(globalState.getSinks());
+		for (auto const& mapping: violationRecord)
+			printSinkViolation(mapping.first, mapping.second);
+	}
+	else
+		violationRecord = reportSinkViolation(checker, globalState.getSinks(), reportFileName);
 
-	for (auto const& mapping: violationRecord)
-		printSinkViolation(mapping.first, mapping.second);
+	if (cacheManager)
+		cacheManager->save(cacheFileName.data(), violationRecord);
 
 	return violationRecord.empty();
 }
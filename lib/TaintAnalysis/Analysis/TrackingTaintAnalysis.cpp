@@ -5,21 +5,32 @@
 #include "TaintAnalysis/Engine/TaintGlobalState.h"
 #include "TaintAnalysis/Engine/TransferFunction.h"
 #include "TaintAnalysis/Precision/PrecisionLossTracker.h"
+#include "TaintAnalysis/Program/DefUseModule.h"
 #include "Util/AnalysisEngine/DataFlowAnalysis.h"
 
+#include <llvm/Support/raw_ostream.h>
+
 namespace taint
 {
 
-std::pair<bool, ProgramPointSet> TrackingTaintAnalysis::runOnDefUseModule(const DefUseModule& duModule)
+std::pair<bool, LossSiteList> TrackingTaintAnalysis::runOnDefUseModule(const DefUseModule& duModule)
 {
+	extTable.bindModule(duModule.getModule());
 	auto globalState = TaintGlobalState(duModule, ptrAnalysis, extTable, env, memo);
+	// The precision loss tracker walks into callee bodies under the callee context, so every callee has to be analyzed there
+	globalState.getSummaryTable().setEnabled(false);
 	auto dfa = util::DataFlowAnalysis<TaintGlobalState, TaintMemo, TransferFunction, TaintPropagator>(globalState, memo);
 	dfa.runOnInitialState<Initializer>(TaintStore());
+	numIterations = dfa.getNumIterations();
 
 	auto violationRecord = SinkViolationChecker(env, memo, extTable, ptrAnalysis).checkSinkViolation(globalState.getSinks());
 
-	PrecisionLossTracker tracker(globalState);
-	return std::make_pair(violationRecord.empty(), tracker.trackImprecision(violationRecord));
+	PrecisionLossTracker tracker(globalState, trackingBudget);
+	auto lossSites = tracker.trackImprecision(violationRecord);
+	if (tracker.isBudgetExhausted())
+		llvm::errs() << "Precision loss tracking ran out of its budget of " << trackingBudget << " steps. The reported loss sites may be incomplete\n";
+
+	return std::make_pair(violationRecord.empty(), std::move(lossSites));
 }
 
 }
\ No newline at end of file
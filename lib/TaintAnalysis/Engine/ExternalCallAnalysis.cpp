@@ -245,12 +245,11 @@ void TransferFunction::evalCallBySummary(const ProgramPoint& pp, const Function*
 
 void TransferFunction::evalExternalCall(const ProgramPoint& pp, const Function* func, EvalResult& evalResult)
 {
-	auto funName = func->getName();
-	if (auto summary = globalState.getExternalTaintTable().lookup(funName))
+	if (auto summary = globalState.getExternalTaintTable().lookup(func))
 		return evalCallBySummary(pp, func, *summary, evalResult);
 	else
 	{
-		errs() << "Missing annotation for external function " << funName << "\n";
+		errs() << "Missing annotation for external function " << func->getName() << "\n";
 		llvm_unreachable("Please add annotation to the aforementioned function and in the config file and try again.\n");
 	}
 }
@@ -0,0 +1,294 @@
+#include "PointerAnalysis/Analysis/SemiSparsePointerAnalysis.h"
+#include "TaintAnalysis/Engine/FunctionSummaryTable.h"
+
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Instructions.h>
+
+#include <algorithm>
+#include <cassert>
+#include <unordered_map>
+
+using namespace llvm;
+using namespace tpa;
+
+namespace taint
+{
+
+static bool isSummarizableInstruction(const Instruction& inst)
+{
+	switch (inst.getOpcode())
+	{
+		case Instruction::Alloca:
+		case Instruction::Load:
+		case Instruction::Store:
+		case Instruction::Trunc:
+		case Instruction::ZExt:
+		case Instruction::SExt:
+		case Instruction::FPTrunc:
+		case Instruction::FPExt:
+		case Instruction::FPToUI:
+		case Instruction::FPToSI:
+		case Instruction::UIToFP:
+		case Instruction::SIToFP:
+		case Instruction::IntToPtr:
+		case Instruction::PtrToInt:
+		case Instruction::BitCast:
+		case Instruction::AddrSpaceCast:
+		case Instruction::ExtractElement:
+		case Instruction::ExtractValue:
+		case Instruction::And:
+		case Instruction::Or:
+		case Instruction::Xor:
+		case Instruction::Shl:
+		case Instruction::LShr:
+		case Instruction::AShr:
+		case Instruction::Add:
+		case Instruction::FAdd:
+		case Instruction::Sub:
+		case Instruction::FSub:
+		case Instruction::Mul:
+		case Instruction::FMul:
+		case Instruction::UDiv:
+		case Instruction::SDiv:
+		case Instruction::FDiv:
+		case Instruction::URem:
+		case Instruction::SRem:
+		case Instruction::FRem:
+		case Instruction::ICmp:
+		case Instruction::FCmp:
+		case Instruction::ShuffleVector:
+		case Instruction::InsertElement:
+		case Instruction::InsertValue:
+		case Instruction::Select:
+		case Instruction::GetElementPtr:
+		case Instruction::PHI:
+		case Instruction::Br:
+		case Instruction::Ret:
+		case Instruction::Call:
+			return true;
+		default:
+			return false;
+	}
+}
+
+// Return false if v has no points-to set, or if its points-to set differs between contexts
+static bool getContextIndependentPtsSet(const SemiSparsePointerAnalysis& ptrAnalysis, const Value* v, PtsSet& pSet)
+{
+	auto ptrs = ptrAnalysis.getPointerManager().getPointersWithValue(v->stripPointerCasts());
+	if (ptrs.empty())
+		return false;
+
+	pSet = ptrAnalysis.getPtsSet(ptrs.front());
+	for (auto ptr: ptrs)
+		if (!(ptrAnalysis.getPtsSet(ptr) == pSet))
+			return false;
+	return !pSet.empty();
+}
+
+static TaintLattice loadTaintFromPtsSet(PtsSet pSet, const TaintStore& store)
+{
+	auto resVal = TaintLattice::Unknown;
+	for (auto obj: pSet)
+	{
+		if (obj->isUniversalObject())
+			return TaintLattice::Either;
+		else if (obj->isNullObject())
+			continue;
+		resVal = Lattice<TaintLattice>::merge(resVal, store.lookup(obj));
+	}
+	return resVal;
+}
+
+const FunctionSummaryTable::FunctionInfo& FunctionSummaryTable::getFunctionInfo(const Function* f)
+{
+	auto itr = infoMap.find(f);
+	if (itr != infoMap.end())
+		return itr->second;
+
+	// References into an unordered_map survive the insertions made by the recursive calls below
+	auto& info = infoMap[f];
+	info.summarizable = false;
+	if (f->isDeclaration() || f->isVarArg())
+		return info;
+
+	std::vector<const MemoryObject*> readObjs;
+	for (auto const& bb: *f)
+	{
+		for (auto const& inst: bb)
+		{
+			if (!isSummarizableInstruction(inst))
+				return info;
+
+			auto pSet = PtsSet::getEmptySet();
+			if (auto loadInst = dyn_cast<LoadInst>(&inst))
+			{
+				if (!getContextIndependentPtsSet(ptrAnalysis, loadInst->getPointerOperand(), pSet))
+					return info;
+				for (auto obj: pSet)
+					if (!obj->isSpecialObject())
+						readObjs.push_back(obj);
+			}
+			else if (auto storeInst = dyn_cast<StoreInst>(&inst))
+			{
+				if (!getContextIndependentPtsSet(ptrAnalysis, storeInst->getPointerOperand(), pSet))
+					return info;
+				if (pSet.size() == 1 && !(*pSet.begin())->isSummaryObject())
+					return info;
+			}
+			// Only direct calls are allowed since the targets of indirect calls depend on the calling context
+			else if (auto callInst = dyn_cast<CallInst>(&inst))
+			{
+				auto callee = callInst->getCalledFunction();
+				if (callee == nullptr)
+					return info;
+				auto const& calleeInfo = getFunctionInfo(callee);
+				if (!calleeInfo.summarizable)
+					return info;
+				readObjs.insert(readObjs.end(), calleeInfo.readObjs.begin(), calleeInfo.readObjs.end());
+			}
+		}
+	}
+
+	std::sort(readObjs.begin(), readObjs.end());
+	readObjs.erase(std::unique(readObjs.begin(), readObjs.end()), readObjs.end());
+	info.readObjs = std::move(readObjs);
+	info.summarizable = true;
+	return info;
+}
+
+bool FunctionSummaryTable::isSummarizable(const Function* f)
+{
+	if (!enabled)
+		return false;
+	return getFunctionInfo(f).summarizable;
+}
+
+FunctionSummaryTable::Summary FunctionSummaryTable::evalFunction(const Function* f, const TaintVector& argVals, const TaintStore& entryStore)
+{
+	assert(argVals.size() == f->arg_size());
+
+	std::unordered_map<const Value*, TaintLattice> localEnv;
+	auto lookup = [&localEnv] (const Value* v)
+	{
+		if (isa<Constant>(v))
+			return TaintLattice::Untainted;
+		auto itr = localEnv.find(v);
+		if (itr == localEnv.end())
+			return TaintLattice::Unknown;
+		return itr->second;
+	};
+
+	auto argItr = f->arg_begin();
+	for (auto argVal: argVals)
+	{
+		localEnv[&*argItr] = argVal;
+		++argItr;
+	}
+
+	// Memory is tracked flow-insensitively: a single store for the whole body, only ever joined. writes collects everything the body and its callees store
+	auto store = entryStore;
+	TaintStore writes;
+	auto writeMemory = [&store, &writes] (const MemoryObject* obj, TaintLattice val)
+	{
+		writes.weakUpdate(obj, val);
+		return store.weakUpdate(obj, val);
+	};
+
+	// Mirror what the transfer function does for each instruction, iterating until the loops stabilize. The lattice has a height of three, so this terminates quickly
+	Summary summary;
+	summary.retVal = TaintLattice::Unknown;
+	auto changed = true;
+	while (changed)
+	{
+		changed = false;
+		for (auto const& bb: *f)
+		{
+			for (auto const& inst: bb)
+			{
+				auto newVal = TaintLattice::Unknown;
+				if (isa<AllocaInst>(inst))
+					newVal = TaintLattice::Untainted;
+				else if (auto retInst = dyn_cast<ReturnInst>(&inst))
+				{
+					if (auto ret = retInst->getReturnValue())
+						summary.retVal = Lattice<TaintLattice>::merge(summary.retVal, lookup(ret));
+					continue;
+				}
+				else if (isa<BranchInst>(inst))
+					continue;
+				else if (auto loadInst = dyn_cast<LoadInst>(&inst))
+					newVal = loadTaintFromPtsSet(ptrAnalysis.getPtsSet(loadInst->getPointerOperand()), store);
+				else if (auto storeInst = dyn_cast<StoreInst>(&inst))
+				{
+					auto val = lookup(storeInst->getValueOperand());
+					if (val == TaintLattice::Unknown)
+						continue;
+					for (auto obj: ptrAnalysis.getPtsSet(storeInst->getPointerOperand()))
+						if (!obj->isSpecialObject())
+							changed |= writeMemory(obj, val);
+					continue;
+				}
+				else if (auto callInst = dyn_cast<CallInst>(&inst))
+				{
+					auto callee = callInst->getCalledFunction();
+					TaintVector calleeArgVals;
+					for (auto i = 0ul, e = callee->arg_size(); i < e; ++i)
+					{
+						auto argVal = lookup(callInst->getArgOperand(i));
+						if (argVal == TaintLattice::Unknown)
+							break;
+						calleeArgVals.push_back(argVal);
+					}
+					if (calleeArgVals.size() == callee->arg_size())
+					{
+						auto const& calleeSummary = applySummary(callee, calleeArgVals, store);
+						for (auto const& effect: calleeSummary.memEffects)
+							changed |= writeMemory(effect.first, effect.second);
+						newVal = calleeSummary.retVal;
+					}
+				}
+				else
+				{
+					for (auto const& op: inst.operands())
+						newVal = Lattice<TaintLattice>::merge(newVal, lookup(op.get()));
+				}
+
+				if (newVal != TaintLattice::Unknown && newVal != lookup(&inst))
+				{
+					localEnv[&inst] = newVal;
+					changed = true;
+				}
+			}
+		}
+	}
+
+	summary.memEffects.assign(writes.begin(), writes.end());
+	return summary;
+}
+
+const FunctionSummaryTable::Summary& FunctionSummaryTable::applySummary(const Function* f, const TaintVector& argVals, const TaintStore& callerStore)
+{
+	assert(isSummarizable(f));
+
+	auto const& readObjs = getFunctionInfo(f).readObjs;
+	auto key = argVals;
+	key.reserve(argVals.size() + readObjs.size());
+	for (auto obj: readObjs)
+		key.push_back(callerStore.lookup(obj));
+
+	auto& summaryMap = summaries[f];
+	auto itr = summaryMap.find(key);
+	if (itr != summaryMap.end())
+		return itr->second;
+
+	// Only the read objects are passed in, so that the summary depends on nothing but its key
+	TaintStore entryStore;
+	for (auto i = 0ul, e = readObjs.size(); i < e; ++i)
+		if (key[argVals.size() + i] != TaintLattice::Unknown)
+			entryStore.strongUpdate(readObjs[i], key[argVals.size() + i]);
+
+	auto summary = evalFunction(f, argVals, entryStore);
+	return summaryMap.insert(std::make_pair(std::move(key), std::move(summary))).first->second;
+}
+
+}
@@ -90,14 +90,18 @@ SinkViolationList SinkViolationChecker::checkCallSiteWithSummary(const ProgramPo
 	return violations;
 }
 
-void SinkViolationChecker::checkSinkViolation(const SinkSignature& sig, SinkViolationRecord& records)
+const SinkViolationList* SinkViolationChecker::checkSinkViolation(const SinkSignature& sig, SinkViolationRecord& records)
 {
-	if (auto taintSummary = table.lookup(sig.getCallee()->getName()))
+	if (auto taintSummary = table.lookup(sig.getCallee()))
 	{
 		auto callsite = sig.getCallSite();
 		auto violations = checkCallSiteWithSummary(sig.getCallSite(), *taintSummary);
-		if (!violations.empty())
-			records[callsite] = std::move(violations);
+		if (violations.empty())
+			return nullptr;
+
+		auto& entry = records[callsite];
+		entry = std::move(violations);
+		return &entry;
 	}
 	else
 		llvm_unreachable("Unrecognized external function call");
@@ -211,6 +211,20 @@ void TransferFunction::evalInternalCall(const ProgramPoint& pp, const tpa::Funct
 	if (argSets.size() < numParam)
 		return;
 
+	// If the callee behaves the same in every context, reuse its summary instead of walking its body under newCtx
+	auto& summaryTable = globalState.getSummaryTable();
+	if (summaryTable.isSummarizable(callee))
+	{
+		// The store of evalResult may already hold the effects of another target of the same call site. Key the summary on the memory before the call
+		TaintStore emptyStore;
+		auto const& callerStore = localState != nullptr ? *localState : emptyStore;
+		auto const& summary = summaryTable.applySummary(callee, argSets, callerStore);
+		for (auto const& effect: summary.memEffects)
+			evalResult.getStore().weakUpdate(effect.first, effect.second);
+		applyReturn(pp, summary.retVal, evalResult);
+		return;
+	}
+
 	auto envChanged = updateParamTaintValue(fc.getContext(), callee, argSets) || callGraphUpdated;
 	auto entryInst = globalState.getDefUseModule().getDefUseFunction(fc.getFunction()).getEntryInst();
 
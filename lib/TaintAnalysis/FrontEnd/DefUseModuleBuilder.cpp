@@ -165,7 +165,7 @@ private:
 
 	void processExternalCall(CallSite cs, const Function* f)
 	{
-		auto summary = modRefTable.lookup(f->getName());
+		auto summary = modRefTable.lookup(f);
 		if (summary == nullptr)
 		{
 			errs() << "Missing entry in ModRefTable: " << f->getName() << "\n";
@@ -261,6 +261,8 @@ DefUseModule DefUseModuleBuilder::buildDefUseModule(const Module& module)
 {
 	DefUseModule duModule(module);
 
+	modRefTable.bindModule(module);
+
 	// Obtain mod ref summary first
 	auto moduleSummary = ModRefModuleAnalysis(ptrAnalysis, modRefTable).runOnModule(module);
 
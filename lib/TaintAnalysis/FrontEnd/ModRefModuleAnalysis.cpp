@@ -231,7 +231,7 @@ bool updateSummaryForRefEffect(const Instruction* inst, ModRefFunctionSummary& s
 
 bool updateSummaryForExternalCall(const Instruction* inst, const Function* f, ModRefFunctionSummary& summary, const SemiSparsePointerAnalysis& ptrAnalysis, const ExternalModRefTable& modRefTable)
 {
-	auto modRefSummary = modRefTable.lookup(f->getName());
+	auto modRefSummary = modRefTable.lookup(f);
 	if (modRefSummary == nullptr)
 	{
 		errs() << modRefTable.size() << "\n";
@@ -78,7 +78,7 @@ private:
 
 	void evalExternalCall(CallSite cs, const Function* f)
 	{
-		auto summary = modRefTable.lookup(f->getName());
+		auto summary = modRefTable.lookup(f);
 		if (summary == nullptr)
 		{
 			errs() << "Missing entry in ModRefTable: " << f->getName() << "\n";
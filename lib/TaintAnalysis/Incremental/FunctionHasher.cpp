@@ -0,0 +1,170 @@
+#include "Context/KLimitContext.h"
+#include "TaintAnalysis/Incremental/FunctionHasher.h"
+#include "Util/IO/ReadFile.h"
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/IR/InlineAsm.h>
+#include <llvm/IR/Metadata.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/MD5.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <algorithm>
+#include <unordered_map>
+
+using namespace llvm;
+
+namespace taint
+{
+
+namespace
+{
+
+class LocalNumbering
+{
+private:
+	std::unordered_map<const Value*, unsigned> numMap;
+public:
+	LocalNumbering(const Function& f)
+	{
+		for (auto const& arg: f.args())
+			numMap.insert(std::make_pair(&arg, numMap.size()));
+		for (auto const& bb: f)
+		{
+			numMap.insert(std::make_pair(&bb, numMap.size()));
+			for (auto const& inst: bb)
+				numMap.insert(std::make_pair(&inst, numMap.size()));
+		}
+	}
+
+	// Every value that is not local to f gets the same number, which no local has
+	static constexpr unsigned unknownValue = ~0u;
+
+	unsigned lookup(const Value* v) const
+	{
+		auto itr = numMap.find(v);
+		if (itr == numMap.end())
+			return unknownValue;
+		return itr->second;
+	}
+};
+
+std::string finalizeHash(MD5& hasher)
+{
+	MD5::MD5Result result;
+	hasher.final(result);
+
+	SmallString<32> str;
+	MD5::stringifyResult(result, str);
+	return str.str();
+}
+
+void hashType(MD5& hasher, const Type* type)
+{
+	std::string buf;
+	raw_string_ostream os(buf);
+	type->print(os);
+	hasher.update(os.str());
+}
+
+void hashOperand(MD5& hasher, const Value* value, const LocalNumbering& numbering)
+{
+	if (auto gv = dyn_cast<GlobalValue>(value))
+	{
+		hasher.update("@");
+		hasher.update(gv->getName());
+	}
+	else if (auto md = dyn_cast<MetadataAsValue>(value))
+	{
+		// The operands of debug intrinsics. Wrapped values are hashed like any other operand. A metadata node prints with slot numbers that change whenever metadata is added anywhere in the module, so only its kind is hashed
+		auto metadata = md->getMetadata();
+		if (auto wrapped = dyn_cast<ValueAsMetadata>(metadata))
+			return hashOperand(hasher, wrapped->getValue(), numbering);
+		if (auto mdStr = dyn_cast<MDString>(metadata))
+		{
+			hasher.update("!\"");
+			hasher.update(mdStr->getString());
+		}
+		else
+		{
+			hasher.update("!");
+			hasher.update(std::to_string(metadata->getMetadataID()));
+		}
+	}
+	else if (isa<Constant>(value) || isa<InlineAsm>(value))
+	{
+		std::string buf;
+		raw_string_ostream os(buf);
+		value->print(os);
+		hasher.update(os.str());
+	}
+	else
+	{
+		hasher.update("%");
+		hasher.update(std::to_string(numbering.lookup(value)));
+	}
+	hasher.update(",");
+}
+
+}
+
+std::string computeFunctionHash(const Function& f)
+{
+	MD5 hasher;
+	hashType(hasher, f.getFunctionType());
+
+	LocalNumbering numbering(f);
+	for (auto const& bb: f)
+	{
+		hasher.update("{");
+		for (auto const& inst: bb)
+		{
+			hasher.update(inst.getOpcodeName());
+			hashType(hasher, inst.getType());
+			for (auto const& use: inst.operands())
+				hashOperand(hasher, use.get(), numbering);
+			hasher.update(";");
+		}
+		hasher.update("}");
+	}
+
+	return finalizeHash(hasher);
+}
+
+std::string computeStringSetHash(std::vector<std::string> strs)
+{
+	std::sort(strs.begin(), strs.end());
+
+	MD5 hasher;
+	for (auto const& str: strs)
+	{
+		hasher.update(str);
+		hasher.update("\n");
+	}
+	return finalizeHash(hasher);
+}
+
+std::string computeModuleHash(const Module& module, const std::vector<std::string>& configFiles)
+{
+	MD5 hasher;
+	hasher.update(module.getDataLayoutStr());
+	hasher.update(std::to_string(context::KLimitContext::getLimit()));
+
+	for (auto const& global: module.globals())
+	{
+		std::string buf;
+		raw_string_ostream os(buf);
+		global.print(os);
+		hasher.update(os.str());
+	}
+
+	for (auto const& fileName: configFiles)
+	{
+		auto memBuf = util::io::readFileIntoBuffer(fileName.data());
+		hasher.update(memBuf->getBuffer());
+	}
+
+	return finalizeHash(hasher);
+}
+
+}
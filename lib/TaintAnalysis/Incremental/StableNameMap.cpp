@@ -0,0 +1,234 @@
+#include "Context/Context.h"
+#include "PointerAnalysis/Analysis/SemiSparsePointerAnalysis.h"
+#include "TaintAnalysis/Incremental/StableNameMap.h"
+#include "TaintAnalysis/Program/DefUseModule.h"
+
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/ADT/StringRef.h>
+#include <llvm/IR/Module.h>
+
+using namespace context;
+using namespace llvm;
+using namespace tpa;
+
+namespace taint
+{
+
+StableNameMap::StableNameMap(const DefUseModule& m, const SemiSparsePointerAnalysis& ptrAnalysis): duModule(m)
+{
+	auto const& module = duModule.getModule();
+	for (auto const& global: module.globals())
+	{
+		auto name = "@" + global.getName().str();
+		nameMap.insert(std::make_pair(&global, name));
+		valueMap.insert(std::make_pair(name, &global));
+	}
+	for (auto const& f: module)
+		nameFunction(f);
+
+	// Every memory object that may appear in a memo is either a mem-level def-use edge label or the content of a global
+	for (auto const& duFunc: duModule)
+	{
+		auto registerEdges = [this] (const DefUseInstruction* duInst)
+		{
+			for (auto const& mapping: duInst->mem_succs())
+				registerObject(mapping.first);
+			for (auto const& mapping: duInst->mem_preds())
+				registerObject(mapping.first);
+		};
+
+		registerEdges(duFunc.getEntryInst());
+		for (auto const& bb: duFunc.getFunction())
+			for (auto const& inst: bb)
+				if (auto duInst = duFunc.getDefUseInstruction(&inst))
+					registerEdges(duInst);
+	}
+	auto globalCtx = Context::getGlobalContext();
+	for (auto const& global: module.globals())
+		for (auto obj: ptrAnalysis.getPtsSet(globalCtx, &global))
+			registerObject(obj);
+}
+
+void StableNameMap::nameFunction(const Function& f)
+{
+	auto funName = "@" + f.getName().str();
+	nameMap.insert(std::make_pair(&f, funName));
+	valueMap.insert(std::make_pair(funName, &f));
+
+	auto argIdx = 0u;
+	for (auto const& arg: f.args())
+	{
+		auto name = funName + "%a" + std::to_string(argIdx++);
+		nameMap.insert(std::make_pair(&arg, name));
+		valueMap.insert(std::make_pair(name, &arg));
+	}
+
+	auto instIdx = 0u;
+	for (auto const& bb: f)
+	{
+		for (auto const& inst: bb)
+		{
+			auto name = funName + "%i" + std::to_string(instIdx++);
+			nameMap.insert(std::make_pair(&inst, name));
+			valueMap.insert(std::make_pair(name, &inst));
+		}
+	}
+}
+
+void StableNameMap::registerObject(const MemoryObject* obj)
+{
+	objMap.insert(std::make_pair(getObjectName(obj), obj));
+}
+
+bool StableNameMap::isStaleValue(const Value* value) const
+{
+	if (auto arg = dyn_cast<Argument>(value))
+		return isStale(arg->getParent());
+	else if (auto inst = dyn_cast<Instruction>(value))
+		return isStale(inst->getParent()->getParent());
+	else
+		return false;
+}
+
+bool StableNameMap::isStaleContext(const Context* ctx) const
+{
+	while (!ctx->isGlobalContext())
+	{
+		if (isStaleValue(ctx->getCallSite()))
+			return true;
+		ctx = Context::popContext(ctx);
+	}
+	return false;
+}
+
+std::string StableNameMap::getValueName(const Value* value) const
+{
+	auto itr = nameMap.find(value);
+	assert(itr != nameMap.end() && "Value has no stable name");
+	return itr->second;
+}
+
+std::string StableNameMap::getContextName(const Context* ctx) const
+{
+	if (ctx->isGlobalContext())
+		return "-";
+
+	// Callsites are listed from the outermost one to the innermost one
+	std::vector<std::string> callSites;
+	while (!ctx->isGlobalContext())
+	{
+		callSites.push_back(getValueName(ctx->getCallSite()));
+		ctx = Context::popContext(ctx);
+	}
+
+	std::string ret;
+	for (auto itr = callSites.rbegin(), ite = callSites.rend(); itr != ite; ++itr)
+	{
+		if (!ret.empty())
+			ret += "|";
+		ret += *itr;
+	}
+	return ret;
+}
+
+std::string StableNameMap::getObjectName(const MemoryObject* obj) const
+{
+	if (obj->isUniversalObject())
+		return "U";
+	if (obj->isNullObject())
+		return "N";
+
+	auto const& allocSite = obj->getAllocSite();
+	auto offset = "+" + std::to_string(obj->getOffset());
+	switch (allocSite.getAllocType())
+	{
+		case AllocSiteTag::Global:
+			return "G" + getValueName(allocSite.getGlobalValue()) + offset;
+		case AllocSiteTag::Function:
+			return "F" + getValueName(allocSite.getFunction()) + offset;
+		case AllocSiteTag::Stack:
+			return "S" + getContextName(allocSite.getAllocContext()) + "#" + getValueName(allocSite.getLocalValue()) + offset;
+		case AllocSiteTag::Heap:
+			return "H" + getContextName(allocSite.getAllocContext()) + "#" + getValueName(allocSite.getLocalValue()) + offset;
+		default:
+			llvm_unreachable("Special objects should have been handled");
+	}
+}
+
+std::string StableNameMap::getDefUseInstructionName(const DefUseInstruction* duInst) const
+{
+	if (duInst->isEntryInstruction())
+		return getValueName(duInst->getFunction());
+	else
+		return getValueName(duInst->getInstruction());
+}
+
+const Value* StableNameMap::lookupValue(const std::string& name) const
+{
+	auto itr = valueMap.find(name);
+	if (itr == valueMap.end() || isStaleValue(itr->second))
+		return nullptr;
+	return itr->second;
+}
+
+const Function* StableNameMap::lookupFunction(const std::string& name) const
+{
+	auto f = dyn_cast_or_null<Function>(lookupValue(name));
+	if (f == nullptr || isStale(f))
+		return nullptr;
+	return f;
+}
+
+const Context* StableNameMap::lookupContext(const std::string& name) const
+{
+	auto ctx = Context::getGlobalContext();
+	if (name == "-")
+		return ctx;
+
+	SmallVector<StringRef, 8> callSites;
+	StringRef(name).split(callSites, "|");
+	for (auto const& callSiteName: callSites)
+	{
+		auto callSite = dyn_cast_or_null<Instruction>(lookupValue(callSiteName.str()));
+		if (callSite == nullptr)
+			return nullptr;
+		ctx = Context::pushContext(ctx, callSite);
+	}
+	return ctx;
+}
+
+const MemoryObject* StableNameMap::lookupObject(const std::string& name) const
+{
+	auto itr = objMap.find(name);
+	if (itr == objMap.end())
+		return nullptr;
+
+	auto obj = itr->second;
+	if (obj->isStackObject() || obj->isHeapObject())
+	{
+		auto const& allocSite = obj->getAllocSite();
+		if (isStaleContext(allocSite.getAllocContext()) || isStaleValue(allocSite.getLocalValue()))
+			return nullptr;
+	}
+	return obj;
+}
+
+const DefUseInstruction* StableNameMap::lookupDefUseInstruction(const std::string& name) const
+{
+	auto value = lookupValue(name);
+	if (value == nullptr)
+		return nullptr;
+
+	if (auto f = dyn_cast<Function>(value))
+	{
+		if (f->isDeclaration() || isStale(f))
+			return nullptr;
+		return duModule.getDefUseFunction(f).getEntryInst();
+	}
+	else if (auto inst = dyn_cast<Instruction>(value))
+		return duModule.getDefUseFunction(inst->getParent()->getParent()).getDefUseInstruction(inst);
+	else
+		return nullptr;
+}
+
+}
@@ -0,0 +1,167 @@
+#include "TaintAnalysis/Incremental/TaintCache.h"
+
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/ToolOutputFile.h>
+#include <llvm/Support/raw_ostream.h>
+
+using namespace annotation;
+using namespace llvm;
+
+namespace taint
+{
+
+// The cache is a line-based text file. Fields are separated by tabs and each line starts with a tag:
+//   MODULE <hash>
+//   FUNC <name> <hash>
+//   ENV <ctx> <value> <taint>
+//   MEMO <ctx> <inst> <obj> <taint>
+//   CALL <callerCtx> <callSite> <calleeCtx> <callee>
+//   SINK <ctx> <callSite> <callee>
+//   VIOL <ctx> <callSite> <argPos> <tclass> <expect> <actual>
+// All lines other than MODULE and FUNC belong to the closest FUNC line above them
+
+namespace
+{
+
+bool parseUInt(StringRef str, unsigned& ret)
+{
+	return !str.getAsInteger(10, ret);
+}
+
+bool parseTaint(StringRef str, TaintLattice& ret)
+{
+	unsigned num;
+	if (!parseUInt(str, num) || num > static_cast<unsigned>(TaintLattice::Either))
+		return false;
+	ret = static_cast<TaintLattice>(num);
+	return true;
+}
+
+bool parseTClass(StringRef str, TClass& ret)
+{
+	unsigned num;
+	if (!parseUInt(str, num) || num > static_cast<unsigned>(TClass::ReachableMemory))
+		return false;
+	ret = static_cast<TClass>(num);
+	return true;
+}
+
+}
+
+const TaintCache::FunctionRecord* TaintCache::lookup(const std::string& funName) const
+{
+	auto itr = records.find(funName);
+	if (itr == records.end())
+		return nullptr;
+	else
+		return &itr->second;
+}
+
+TaintCache TaintCache::parseCache(const StringRef& content)
+{
+	TaintCache cache;
+	FunctionRecord* currRecord = nullptr;
+
+	SmallVector<StringRef, 8> fields;
+	auto rest = content;
+	while (!rest.empty())
+	{
+		StringRef line;
+		std::tie(line, rest) = rest.split('\n');
+		if (line.empty())
+			continue;
+
+		fields.clear();
+		line.split(fields, "\t");
+		auto tag = fields[0];
+
+		auto malformed = false;
+		if (tag == "MODULE" && fields.size() == 2)
+			cache.moduleHash = fields[1];
+		else if (tag == "FUNC" && fields.size() == 3)
+		{
+			currRecord = &cache.records[fields[1]];
+			currRecord->hash = fields[2];
+		}
+		else if (currRecord == nullptr)
+			malformed = true;
+		else if (tag == "ENV" && fields.size() == 4)
+		{
+			TaintLattice taint;
+			malformed = !parseTaint(fields[3], taint);
+			currRecord->envEntries.push_back({ fields[1], fields[2], taint });
+		}
+		else if (tag == "MEMO" && fields.size() == 5)
+		{
+			TaintLattice taint;
+			malformed = !parseTaint(fields[4], taint);
+			currRecord->memoEntries.push_back({ fields[1], fields[2], fields[3], taint });
+		}
+		else if (tag == "CALL" && fields.size() == 5)
+			currRecord->callEntries.push_back({ fields[1], fields[2], fields[3], fields[4] });
+		else if (tag == "SINK" && fields.size() == 4)
+			currRecord->sinkEntries.push_back({ fields[1], fields[2], fields[3] });
+		else if (tag == "VIOL" && fields.size() == 7)
+		{
+			unsigned argPos;
+			TClass what;
+			TaintLattice expectVal, actualVal;
+			malformed = !parseUInt(fields[3], argPos) || !parseTClass(fields[4], what) || !parseTaint(fields[5], expectVal) || !parseTaint(fields[6], actualVal);
+			currRecord->violationEntries.push_back({ fields[1], fields[2], static_cast<uint8_t>(argPos), what, expectVal, actualVal });
+		}
+		else
+			malformed = true;
+
+		if (malformed)
+		{
+			errs() << "Malformed line in taint cache, ignoring the cache: " << line << "\n";
+			return TaintCache();
+		}
+	}
+
+	return cache;
+}
+
+TaintCache TaintCache::loadFromFile(const char* fileName)
+{
+	auto fileOrErr = MemoryBuffer::getFile(fileName);
+	if (fileOrErr.getError())
+		return TaintCache();
+
+	return parseCache(fileOrErr.get()->getBuffer());
+}
+
+void TaintCache::writeToFile(const char* fileName) const
+{
+	std::error_code ec;
+	tool_output_file out(fileName, ec, sys::fs::F_None);
+	if (ec)
+	{
+		errs() << "Failed to write taint cache " << fileName << ": " << ec.message() << "\n";
+		return;
+	}
+
+	auto& os = out.os();
+	os << "MODULE\t" << moduleHash << "\n";
+	for (auto const& mapping: records)
+	{
+		auto const& record = mapping.second;
+		os << "FUNC\t" << mapping.first << "\t" << record.hash << "\n";
+		for (auto const& entry: record.envEntries)
+			os << "ENV\t" << entry.ctx << "\t" << entry.value << "\t" << static_cast<unsigned>(entry.taint) << "\n";
+		for (auto const& entry: record.memoEntries)
+			os << "MEMO\t" << entry.ctx << "\t" << entry.inst << "\t" << entry.obj << "\t" << static_cast<unsigned>(entry.taint) << "\n";
+		for (auto const& entry: record.callEntries)
+			os << "CALL\t" << entry.callerCtx << "\t" << entry.callSite << "\t" << entry.calleeCtx << "\t" << entry.callee << "\n";
+		for (auto const& entry: record.sinkEntries)
+			os << "SINK\t" << entry.ctx << "\t" << entry.callSite << "\t" << entry.callee << "\n";
+		for (auto const& entry: record.violationEntries)
+			os << "VIOL\t" << entry.ctx << "\t" << entry.callSite << "\t" << static_cast<unsigned>(entry.argPos) << "\t" << static_cast<unsigned>(entry.what) << "\t" << static_cast<unsigned>(entry.expectVal) << "\t" << static_cast<unsigned>(entry.actualVal) << "\n";
+	}
+
+	out.keep();
+}
+
+}
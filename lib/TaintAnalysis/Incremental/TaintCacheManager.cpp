@@ -0,0 +1,287 @@
+#include "PointerAnalysis/Analysis/SemiSparsePointerAnalysis.h"
+#include "TaintAnalysis/Engine/TaintGlobalState.h"
+#include "TaintAnalysis/Incremental/FunctionHasher.h"
+#include "TaintAnalysis/Incremental/TaintCacheManager.h"
+#include "TaintAnalysis/Program/DefUseModule.h"
+#include "TaintAnalysis/Support/TaintEnv.h"
+#include "TaintAnalysis/Support/TaintMemo.h"
+
+#include <llvm/IR/CallSite.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <algorithm>
+#include <map>
+#include <set>
+
+using namespace llvm;
+using namespace tpa;
+
+namespace taint
+{
+
+static std::string getViolationKey(const TaintCache::ViolationEntry& entry)
+{
+	return entry.ctx + "\t" + entry.callSite + "\t" + std::to_string(entry.argPos);
+}
+
+TaintCacheManager::TaintCacheManager(TaintGlobalState& g, const std::vector<std::string>& configFiles): globalState(g), nameMap(g.getDefUseModule(), g.getPointerAnalysis()), moduleHash(computeModuleHash(g.getDefUseModule().getModule(), configFiles))
+{
+	for (auto const& duFunc: globalState.getDefUseModule())
+		funcHashes.insert(std::make_pair(&duFunc.getFunction(), computeFunctionHash(duFunc.getFunction()) + computeInputHash(duFunc)));
+}
+
+// The body hash only covers the IR. The taint of a function also depends on what the pointer analysis computed for it, which may change with edits elsewhere in the program
+std::string TaintCacheManager::computeInputHash(const DefUseFunction& duFunc) const
+{
+	auto const& ptrAnalysis = globalState.getPointerAnalysis();
+	std::vector<std::string> inputs;
+
+	auto addPtsSets = [this, &ptrAnalysis, &inputs] (const Value* value)
+	{
+		if (!value->getType()->isPointerTy())
+			return;
+
+		for (auto ptr: ptrAnalysis.getPointerManager().getPointersWithValue(value))
+		{
+			std::vector<std::string> objNames;
+			for (auto obj: ptrAnalysis.getPtsSet(ptr))
+				objNames.push_back(nameMap.getObjectName(obj));
+			std::sort(objNames.begin(), objNames.end());
+
+			auto input = nameMap.getValueName(value) + "@" + nameMap.getContextName(ptr->getContext()) + "->";
+			for (auto const& objName: objNames)
+				input += objName + ",";
+			inputs.push_back(std::move(input));
+		}
+	};
+
+	auto addMemEdges = [this, &inputs] (const DefUseInstruction* duInst)
+	{
+		auto instName = nameMap.getDefUseInstructionName(duInst);
+		for (auto const& mapping: duInst->mem_preds())
+		{
+			auto objName = nameMap.getObjectName(mapping.first);
+			for (auto pred: mapping.second)
+				inputs.push_back(instName + "<-" + objName + "<-" + nameMap.getDefUseInstructionName(pred));
+		}
+	};
+
+	auto const& f = duFunc.getFunction();
+	for (auto const& arg: f.args())
+		addPtsSets(&arg);
+	for (auto const& bb: f)
+	{
+		for (auto const& inst: bb)
+		{
+			addPtsSets(&inst);
+			if (auto duInst = duFunc.getDefUseInstruction(&inst))
+				addMemEdges(duInst);
+		}
+	}
+	addMemEdges(duFunc.getEntryInst());
+
+	return computeStringSetHash(std::move(inputs));
+}
+
+void TaintCacheManager::detectChangedFunctions(const TaintCache& cache)
+{
+	for (auto const& mapping: funcHashes)
+	{
+		auto record = cache.lookup(nameMap.getValueName(mapping.first));
+		if (record == nullptr || record->hash != mapping.second)
+			nameMap.markStale(mapping.first);
+	}
+}
+
+// An unchanged function may still reach different callees when the pointer analysis resolves one of its indirect calls differently. Such a function has to be re-solved as well
+void TaintCacheManager::detectChangedCallTargets(const TaintCache& cache)
+{
+	auto const& ptrAnalysis = globalState.getPointerAnalysis();
+	for (auto const& mapping: funcHashes)
+	{
+		auto f = mapping.first;
+		if (nameMap.isStale(f))
+			continue;
+
+		auto record = cache.lookup(nameMap.getValueName(f));
+		assert(record != nullptr);
+
+		std::map<std::pair<std::string, std::string>, std::set<std::string>> cachedTargets;
+		for (auto const& entry: record->callEntries)
+			cachedTargets[std::make_pair(entry.callerCtx, entry.callSite)].insert(entry.callee);
+
+		for (auto const& targetMapping: cachedTargets)
+		{
+			auto ctx = nameMap.lookupContext(targetMapping.first.first);
+			auto callSite = dyn_cast_or_null<Instruction>(nameMap.lookupValue(targetMapping.first.second));
+			if (ctx == nullptr || callSite == nullptr)
+				continue;
+
+			std::set<std::string> currTargets;
+			for (auto callee: ptrAnalysis.getCallees(ImmutableCallSite(callSite), ctx))
+				if (!callee->isDeclaration())
+					currTargets.insert(nameMap.getValueName(callee));
+
+			if (currTargets != targetMapping.second)
+			{
+				nameMap.markStale(f);
+				break;
+			}
+		}
+	}
+}
+
+void TaintCacheManager::restoreFunction(const TaintCache::FunctionRecord& record)
+{
+	auto& env = globalState.getEnv();
+	for (auto const& entry: record.envEntries)
+	{
+		auto ctx = nameMap.lookupContext(entry.ctx);
+		auto value = nameMap.lookupValue(entry.value);
+		if (ctx != nullptr && value != nullptr)
+			env.strongUpdate(TaintValue(ctx, value), entry.taint);
+	}
+
+	auto& memo = globalState.getMemo();
+	for (auto const& entry: record.memoEntries)
+	{
+		auto ctx = nameMap.lookupContext(entry.ctx);
+		auto duInst = nameMap.lookupDefUseInstruction(entry.inst);
+		auto obj = nameMap.lookupObject(entry.obj);
+		if (ctx != nullptr && duInst != nullptr && obj != nullptr)
+			memo.insert(ProgramPoint(ctx, duInst), obj, entry.taint);
+	}
+
+	// Edges into changed functions are left out on purpose: re-inserting them during the solve is what triggers the re-evaluation of the callee entries
+	auto& callGraph = globalState.getCallGraph();
+	for (auto const& entry: record.callEntries)
+	{
+		auto callerCtx = nameMap.lookupContext(entry.callerCtx);
+		auto callSite = nameMap.lookupDefUseInstruction(entry.callSite);
+		auto calleeCtx = nameMap.lookupContext(entry.calleeCtx);
+		auto callee = nameMap.lookupFunction(entry.callee);
+		if (callerCtx != nullptr && callSite != nullptr && calleeCtx != nullptr && callee != nullptr)
+			callGraph.insertEdge(ProgramPoint(callerCtx, callSite), FunctionContext(calleeCtx, callee));
+	}
+
+	auto& sinks = globalState.getSinks();
+	for (auto const& entry: record.sinkEntries)
+	{
+		auto ctx = nameMap.lookupContext(entry.ctx);
+		auto callSite = nameMap.lookupDefUseInstruction(entry.callSite);
+		auto callee = nameMap.lookupFunction(entry.callee);
+		if (ctx != nullptr && callSite != nullptr && callee != nullptr)
+			sinks.insert(SinkSignature(ProgramPoint(ctx, callSite), callee));
+	}
+}
+
+void TaintCacheManager::enqueueCallersOfChangedFunctions(const TaintCache& cache, WorkList& workList)
+{
+	for (auto const& mapping: cache)
+	{
+		for (auto const& entry: mapping.second.callEntries)
+		{
+			auto callee = dyn_cast_or_null<Function>(nameMap.lookupValue(entry.callee));
+			if (callee == nullptr || !nameMap.isStale(callee))
+				continue;
+
+			auto callerCtx = nameMap.lookupContext(entry.callerCtx);
+			auto callSite = nameMap.lookupDefUseInstruction(entry.callSite);
+			if (callerCtx != nullptr && callSite != nullptr)
+				workList.enqueue(ProgramPoint(callerCtx, callSite));
+		}
+	}
+}
+
+WorkList TaintCacheManager::restore(const char* cacheFile, WorkList workList)
+{
+	auto cache = TaintCache::loadFromFile(cacheFile);
+	if (cache.getModuleHash() != moduleHash)
+		cache = TaintCache();
+
+	for (auto const& mapping: cache)
+		for (auto const& entry: mapping.second.violationEntries)
+			cachedViolations.insert(getViolationKey(entry));
+
+	detectChangedFunctions(cache);
+	detectChangedCallTargets(cache);
+
+	for (auto const& mapping: funcHashes)
+		if (!nameMap.isStale(mapping.first))
+			restoreFunction(*cache.lookup(nameMap.getValueName(mapping.first)));
+
+	enqueueCallersOfChangedFunctions(cache, workList);
+
+	errs() << "Incremental taint check: " << nameMap.getNumStaleFunctions() << " of " << funcHashes.size() << " functions need to be re-analyzed\n";
+	return workList;
+}
+
+void TaintCacheManager::save(const char* cacheFile, const SinkViolationRecord& violationRecord)
+{
+	TaintCache cache;
+	cache.setModuleHash(moduleHash);
+	for (auto const& mapping: funcHashes)
+		cache.getOrCreateRecord(nameMap.getValueName(mapping.first)).hash = mapping.second;
+
+	auto getRecord = [this, &cache] (const Function* f) -> TaintCache::FunctionRecord&
+	{
+		return cache.getOrCreateRecord(nameMap.getValueName(f));
+	};
+
+	for (auto const& mapping: globalState.getEnv())
+	{
+		auto value = mapping.first.getValue();
+
+		const Function* f = nullptr;
+		if (auto arg = dyn_cast<Argument>(value))
+			f = arg->getParent();
+		else if (auto inst = dyn_cast<Instruction>(value))
+			f = inst->getParent()->getParent();
+		else
+			continue;
+
+		getRecord(f).envEntries.push_back({ nameMap.getContextName(mapping.first.getContext()), nameMap.getValueName(value), mapping.second });
+	}
+
+	for (auto const& mapping: globalState.getMemo())
+	{
+		auto const& pp = mapping.first;
+		auto& record = getRecord(pp.getDefUseInstruction()->getFunction());
+		auto ctxName = nameMap.getContextName(pp.getContext());
+		auto instName = nameMap.getDefUseInstructionName(pp.getDefUseInstruction());
+		for (auto const& objMapping: mapping.second)
+			record.memoEntries.push_back({ ctxName, instName, nameMap.getObjectName(objMapping.first), objMapping.second });
+	}
+
+	for (auto const& mapping: globalState.getCallGraph())
+	{
+		auto const& pp = mapping.first;
+		auto& record = getRecord(pp.getDefUseInstruction()->getFunction());
+		for (auto const& fc: mapping.second)
+			record.callEntries.push_back({ nameMap.getContextName(pp.getContext()), nameMap.getDefUseInstructionName(pp.getDefUseInstruction()), nameMap.getContextName(fc.getContext()), nameMap.getValueName(fc.getFunction()) });
+	}
+
+	for (auto const& sig: globalState.getSinks())
+	{
+		auto const& pp = sig.getCallSite();
+		getRecord(pp.getDefUseInstruction()->getFunction()).sinkEntries.push_back({ nameMap.getContextName(pp.getContext()), nameMap.getDefUseInstructionName(pp.getDefUseInstruction()), nameMap.getValueName(sig.getCallee()) });
+	}
+
+	auto numNewViolations = 0u;
+	for (auto const& mapping: violationRecord)
+	{
+		auto const& pp = mapping.first;
+		auto& record = getRecord(pp.getDefUseInstruction()->getFunction());
+		for (auto const& violation: mapping.second)
+		{
+			record.violationEntries.push_back({ nameMap.getContextName(pp.getContext()), nameMap.getDefUseInstructionName(pp.getDefUseInstruction()), violation.argPos, violation.what, violation.expectVal, violation.actualVal });
+			if (!cachedViolations.count(getViolationKey(record.violationEntries.back())))
+				++numNewViolations;
+		}
+	}
+	errs() << "Incremental taint check: " << numNewViolations << " sink violations were not reported by the cached run\n";
+
+	cache.writeToFile(cacheFile);
+}
+
+}
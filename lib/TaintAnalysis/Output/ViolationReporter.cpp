@@ -0,0 +1,127 @@
+#include "Context/Context.h"
+#include "TaintAnalysis/Program/DefUseInstruction.h"
+#include "Util/IO/TaintAnalysis/Printer.h"
+#include "Util/IO/TaintAnalysis/ViolationReporter.h"
+#include "Util/IO/WriteJson.h"
+
+#include <llvm/IR/DebugInfoMetadata.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Instruction.h>
+#include <llvm/Support/ErrorHandling.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace annotation;
+using namespace llvm;
+using namespace taint;
+
+namespace util
+{
+namespace io
+{
+
+static const char* getTClassName(TClass what)
+{
+	switch (what)
+	{
+		case TClass::ValueOnly:
+			return "ValueOnly";
+		case TClass::DirectMemory:
+			return "DirectMemory";
+		case TClass::ReachableMemory:
+			return "ReachableMemory";
+	}
+	llvm_unreachable("Illegal TClass");
+}
+
+static std::string getLatticeName(TaintLattice l)
+{
+	std::string str;
+	raw_string_ostream strStream(str);
+	strStream << l;
+	return strStream.str();
+}
+
+// Return "function:file:line" for an instruction, or just the function name if it carries no debug location
+static std::string getShortLocation(const Instruction* inst)
+{
+	std::string str;
+	raw_string_ostream strStream(str);
+	strStream << inst->getParent()->getParent()->getName();
+	if (auto loc = inst->getDebugLoc().get())
+		strStream << ":" << loc->getFilename() << ":" << loc->getLine();
+	return strStream.str();
+}
+
+size_t JsonViolationReporter::ViolationKeyHash::operator()(const ViolationKey& key) const
+{
+	std::size_t seed = hashPair(std::get<0>(key), std::get<1>(key));
+	hash_combine(seed, hashEnumClass(std::get<2>(key)));
+	hash_combine(seed, hashEnumClass(std::get<3>(key)));
+	return seed;
+}
+
+void JsonViolationReporter::writeViolation(const ProgramPoint& pp, const SinkViolation& violation)
+{
+	auto inst = pp.getDefUseInstruction()->getInstruction();
+
+	os << "{\"function\":";
+	writeJsonString(os, inst->getParent()->getParent()->getName());
+
+	if (auto loc = inst->getDebugLoc().get())
+	{
+		os << ",\"file\":";
+		writeJsonString(os, loc->getFilename());
+		os << ",\"line\":" << loc->getLine() << ",\"column\":" << loc->getColumn();
+	}
+
+	std::string instStr;
+	raw_string_ostream instStream(instStr);
+	instStream << *inst;
+	os << ",\"instruction\":";
+	writeJsonString(os, StringRef(instStream.str()).trim());
+
+	// Call sites are listed from the outermost caller to the innermost one
+	std::vector<const Instruction*> callSites;
+	for (auto ctx = pp.getContext(); !ctx->isGlobalContext(); ctx = context::Context::popContext(ctx))
+		callSites.push_back(ctx->getCallSite());
+	std::reverse(callSites.begin(), callSites.end());
+
+	os << ",\"context\":[";
+	bool isFirst = true;
+	for (auto callSite: callSites)
+	{
+		if (!isFirst)
+			os << ",";
+		isFirst = false;
+		writeJsonString(os, getShortLocation(callSite));
+	}
+	os << "]";
+
+	os << ",\"argument\":" << static_cast<unsigned>(violation.argPos);
+	os << ",\"class\":\"" << getTClassName(violation.what) << "\"";
+	os << ",\"expected\":\"" << getLatticeName(violation.expectVal) << "\"";
+	os << ",\"actual\":\"" << getLatticeName(violation.actualVal) << "\"}\n";
+}
+
+void JsonViolationReporter::report(const ProgramPoint& pp, const SinkViolationList& list)
+{
+	auto inst = pp.getDefUseInstruction()->getInstruction();
+	for (auto const& violation: list)
+	{
+		if (!reported.insert(std::make_tuple(inst, violation.argPos, violation.what, violation.actualVal)).second)
+		{
+			++numDuplicates;
+			continue;
+		}
+		writeViolation(pp, violation);
+	}
+	// Flush so that a consumer reading the stream sees each violation as soon as it is confirmed
+	os.flush();
+}
+
+}
+}
@@ -1,6 +1,7 @@
 #include "TaintAnalysis/Precision/CallTracker.h"
 #include "TaintAnalysis/Precision/LocalTracker.h"
 #include "TaintAnalysis/Precision/TrackerGlobalState.h"
+#include "TaintAnalysis/Precision/TrackerWorkList.h"
 #include "TaintAnalysis/Support/TaintEnv.h"
 #include "TaintAnalysis/Support/TaintMemo.h"
 #include "Util/DataStructure/VectorSet.h"
@@ -56,7 +57,7 @@ void CallTracker::trackValue(const ProgramPoint& pp, const CallerVector& callers
 
 		auto demandingIndices = getDemandingIndices(callTaints);
 		for (auto idx: demandingIndices)
-			trackerState.addImprecisionSource(callers[idx]);
+			trackerState.addImprecisionSource(callers[idx], workList.getCurrentViolations());
 
 		auto impreciseIndices = getImpreciseIndices(callTaints);
 		for (auto idx: impreciseIndices)
@@ -87,36 +88,32 @@ TaintVector CallTracker::getMemoryTaintValues(const CallerVector& callers, const
 	return retVec;
 }
 
-void CallTracker::trackMemory(const ProgramPoint& pp, const CallerVector& callers)
+void CallTracker::trackMemory(const ProgramPoint& pp, const CallerVector& callers, const tpa::MemoryObject* obj)
 {
-	std::unordered_map<size_t, util::VectorSet<const tpa::MemoryObject*>> trackedObjects;
-	
-	for (auto const& mapping: pp.getDefUseInstruction()->mem_succs())
-	{
-		auto obj = mapping.first;
-		auto callTaints = getMemoryTaintValues(callers, obj);
+	auto callTaints = getMemoryTaintValues(callers, obj);
 
-		auto demandingIndices = getDemandingIndices(callTaints);
-		for (auto idx: demandingIndices)
-			trackerState.addImprecisionSource(callers[idx]);
+	auto demandingIndices = getDemandingIndices(callTaints);
+	for (auto idx: demandingIndices)
+		trackerState.addImprecisionSource(callers[idx], workList.getCurrentViolations());
 
-		auto impreciseIndices = getImpreciseIndices(callTaints);
-		for (auto idx: impreciseIndices)
-			trackedObjects[idx].insert(obj);
-	}
+	util::VectorSet<const tpa::MemoryObject*> trackedObjects;
+	trackedObjects.insert(obj);
 
 	LocalTracker localTracker(workList);
-	for (auto const& mapping: trackedObjects)
-		localTracker.trackMemory(callers[mapping.first], mapping.second);
+	auto impreciseIndices = getImpreciseIndices(callTaints);
+	for (auto idx: impreciseIndices)
+		localTracker.trackMemory(callers[idx], trackedObjects);
 }
 
-void CallTracker::trackCall(const ProgramPoint& pp, const std::vector<ProgramPoint>& callers)
+void CallTracker::trackCall(const ProgramPoint& pp, const std::vector<ProgramPoint>& callers, const tpa::MemoryObject* obj)
 {
-	if (!callers.empty())
-	{
+	if (callers.empty())
+		return;
+
+	if (obj == nullptr)
 		trackValue(pp, callers);
-		trackMemory(pp, callers);
-	}
+	else
+		trackMemory(pp, callers, obj);
 }
 
 }
\ No newline at end of file
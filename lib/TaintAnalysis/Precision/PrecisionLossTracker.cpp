@@ -1,3 +1,4 @@
+#include "Context/Context.h"
 #include "PointerAnalysis/Analysis/SemiSparsePointerAnalysis.h"
 #include "TaintAnalysis/Engine/TaintGlobalState.h"
 #include "TaintAnalysis/Precision/LocalTracker.h"
@@ -5,17 +6,41 @@
 #include "TaintAnalysis/Precision/TrackerGlobalState.h"
 #include "TaintAnalysis/Precision/TrackerTransferFunction.h"
 #include "TaintAnalysis/Precision/TrackerWorkList.h"
+#include "TaintAnalysis/Program/DefUseModule.h"
 
 #include <llvm/IR/CallSite.h>
 
+#include <algorithm>
 #include <unordered_set>
 
 namespace taint
 {
 
+// Program points are compared by address, which differs from run to run. This key names the instruction and every call site of the context by function name and reverse postorder number instead
+using StableKey = std::vector<std::pair<llvm::StringRef, size_t>>;
+
+static StableKey getStableKey(const DefUseModule& duModule, const ProgramPoint& pp)
+{
+	auto getInstKey = [] (const DefUseInstruction* duInst)
+	{
+		return std::make_pair(duInst->getFunction()->getName(), duInst->getPriority());
+	};
+
+	StableKey key = { getInstKey(pp.getDefUseInstruction()) };
+	for (auto ctx = pp.getContext(); !ctx->isGlobalContext(); ctx = context::Context::popContext(ctx))
+	{
+		auto callSite = ctx->getCallSite();
+		auto duInst = duModule.getDefUseFunction(callSite->getParent()->getParent()).getDefUseInstruction(callSite);
+		assert(duInst != nullptr);
+		key.push_back(getInstKey(duInst));
+	}
+	return key;
+}
+
 void PrecisionLossTracker::initializeWorkList(TrackerWorkList& workList, const SinkViolationRecord& record)
 {
 	auto const& ptrAnalysis = globalState.getPointerAnalysis();
+	auto violationId = 0u;
 	for (auto const& mapping: record)
 	{
 		// We only care about imprecision
@@ -25,11 +50,13 @@ void PrecisionLossTracker::initializeWorkList(TrackerWorkList& workList, const S
 		auto ctx = pp.getContext();
 		std::unordered_set<const llvm::Value*> trackedValues;
 		std::unordered_set<const tpa::MemoryObject*> trackedObjects;
-		
+		TrackerWorkList::ViolationSet violations;
+
 		for (auto const& violation: mapping.second)
 		{
 			if (violation.actualVal != TaintLattice::Either)
 				continue;
+			violations.set(violationId++);
 
 			auto argVal = cs.getArgument(violation.argPos);
 			if (violation.what == annotation::TClass::ValueOnly)
@@ -45,32 +72,62 @@ void PrecisionLossTracker::initializeWorkList(TrackerWorkList& workList, const S
 			}
 		}
 
+		if (violations.empty())
+			continue;
+
+		workList.setCurrentViolations(std::move(violations));
 		LocalTracker tracker(workList);
 		tracker.trackValue(pp, trackedValues);
 		tracker.trackMemory(pp, trackedObjects);
 	}
 }
 
-ProgramPointSet PrecisionLossTracker::trackImprecision(const SinkViolationRecord& record)
+LossSiteList PrecisionLossTracker::trackImprecision(const SinkViolationRecord& record)
 {
-	ProgramPointSet ppSet;
+	TrackerGlobalState::SourceMap sourceMap;
 
 	// Prepare the tracker state
-	TrackerGlobalState trackerState(globalState.getDefUseModule(), globalState.getPointerAnalysis(), globalState.getExternalTaintTable(), globalState.getEnv(), globalState.getMemo(), globalState.getCallGraph(), ppSet);
+	TrackerGlobalState trackerState(globalState.getDefUseModule(), globalState.getPointerAnalysis(), globalState.getExternalTaintTable(), globalState.getEnv(), globalState.getMemo(), globalState.getCallGraph(), sourceMap);
 
 	// Prepare the tracker worklist
 	TrackerWorkList workList;
 	initializeWorkList(workList, record);
 
 	// The main analysis
+	budgetExhausted = false;
+	unsigned numSteps = 0;
 	while (!workList.empty())
 	{
+		if (stepBudget != 0 && numSteps >= stepBudget)
+		{
+			budgetExhausted = true;
+			break;
+		}
+		++numSteps;
+
 		auto pp = workList.dequeue();
 
 		TrackerTransferFunction(trackerState, workList).eval(pp);
 	}
 
-	return ppSet;
+	std::vector<std::pair<LossSite, StableKey>> sortedSites;
+	sortedSites.reserve(sourceMap.size());
+	for (auto const& mapping: sourceMap)
+		sortedSites.push_back(std::make_pair(LossSite{ mapping.first, mapping.second.count() }, getStableKey(globalState.getDefUseModule(), mapping.first)));
+	std::sort(sortedSites.begin(), sortedSites.end(),
+		[] (const std::pair<LossSite, StableKey>& lhs, const std::pair<LossSite, StableKey>& rhs)
+		{
+			if (lhs.first.numViolations != rhs.first.numViolations)
+				return lhs.first.numViolations > rhs.first.numViolations;
+			return lhs.second < rhs.second;
+		}
+	);
+
+	LossSiteList lossSites;
+	lossSites.reserve(sortedSites.size());
+	for (auto const& pair: sortedSites)
+		lossSites.push_back(pair.first);
+	return lossSites;
 }
 
 }
\ No newline at end of file
@@ -57,21 +57,21 @@ TaintVector ReturnTracker::getReturnTaintValues(const tpa::MemoryObject* obj, co
 	);
 }
 
-void ReturnTracker::propagateReturns(const ReturnVector& retVec, const TaintVector& returnTaints)
+void ReturnTracker::propagateReturns(const ReturnVector& retVec, const TaintVector& returnTaints, const tpa::MemoryObject* obj)
 {
 	assert(retVec.size() == returnTaints.size());
 
 	auto indices = getImpreciseIndices(returnTaints);
 	for (auto idx: indices)
-		workList.enqueue(retVec[idx]);
+		workList.enqueue(retVec[idx], obj);
 }
 
-void ReturnTracker::processReturns(const ProgramPoint& pp, const ReturnVector& retVec, const TaintVector& returnTaints)
+void ReturnTracker::processReturns(const ProgramPoint& pp, const ReturnVector& retVec, const TaintVector& returnTaints, const tpa::MemoryObject* obj)
 {
 	if (!getDemandingIndices(returnTaints).empty())
-		trackerState.addImprecisionSource(pp);
+		trackerState.addImprecisionSource(pp, workList.getCurrentViolations());
 
-	propagateReturns(retVec, returnTaints);
+	propagateReturns(retVec, returnTaints, obj);
 }
 
 void ReturnTracker::trackValue(const ProgramPoint& pp, const ReturnVector& retVec)
@@ -83,23 +83,22 @@ void ReturnTracker::trackValue(const ProgramPoint& pp, const ReturnVector& retVe
 
 	auto retTaints = getReturnTaintValues(retVec);
 
-	processReturns(pp, retVec, retTaints);
+	processReturns(pp, retVec, retTaints, nullptr);
 }
 
-void ReturnTracker::trackMemory(const ProgramPoint& pp, const ReturnVector& retVec)
+void ReturnTracker::trackMemory(const ProgramPoint& pp, const ReturnVector& retVec, const tpa::MemoryObject* obj)
 {
-	for (auto const& mapping: pp.getDefUseInstruction()->mem_succs())
-	{
-		auto retTaints = getReturnTaintValues(mapping.first, retVec);
-		processReturns(pp, retVec, retTaints);
-	}
+	auto retTaints = getReturnTaintValues(obj, retVec);
+	processReturns(pp, retVec, retTaints, obj);
 }
 
-void ReturnTracker::trackReturn(const ProgramPoint& pp, const CalleeVector& callees)
+void ReturnTracker::trackReturn(const ProgramPoint& pp, const CalleeVector& callees, const tpa::MemoryObject* obj)
 {
 	auto retVec = getReturnVector(callees);
-	trackValue(pp, retVec);
-	trackMemory(pp, retVec);
+	if (obj == nullptr)
+		trackValue(pp, retVec);
+	else
+		trackMemory(pp, retVec, obj);
 }
 
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "TaintAnalysis/Precision/ReturnTracker.h"
 #include "TaintAnalysis/Precision/TrackerGlobalState.h"
 #include "TaintAnalysis/Precision/TrackerTransferFunction.h"
+#include "TaintAnalysis/Precision/TrackerWorkList.h"
 #include "TaintAnalysis/Precision/VectorTransform.h"
 #include "TaintAnalysis/Support/ProgramPoint.h"
 #include "TaintAnalysis/Support/TaintEnv.h"
@@ -56,13 +57,13 @@ static void propagateImprecision(ContainerType& container, LookupFunction&& look
 		std::for_each(candidates.begin(), candidates.end(), std::forward<Action>(action));
 }
 
-void TrackerTransferFunction::evalEntryInst(const ProgramPoint& pp)
+void TrackerTransferFunction::evalEntryInst(const ProgramPoint& pp, const MemoryObject* obj)
 {
 	auto fc = tpa::FunctionContext(pp.getContext(), pp.getDefUseInstruction()->getFunction());
 	auto callers = trackerState.getCallGraph().getCallers(fc);
 
 	auto callerVec = vectorTransform(callers, [] (auto const& x) { return x; });
-	CallTracker(trackerState, workList).trackCall(pp, callerVec);
+	CallTracker(trackerState, workList).trackCall(pp, callerVec, obj);
 }
 
 TrackerTransferFunction::ValueSet TrackerTransferFunction::evalAllOperands(const ProgramPoint& pp)
@@ -160,7 +161,7 @@ void TrackerTransferFunction::evalExternalCallInst(const ProgramPoint&, const ll
 	llvm_unreachable("Not implemented yet");
 }
 
-void TrackerTransferFunction::evalCallInst(const ProgramPoint& pp)
+void TrackerTransferFunction::evalCallInst(const ProgramPoint& pp, const MemoryObject* obj)
 {
 	auto callees = trackerState.getCallGraph().getCallees(pp);
 
@@ -174,11 +175,11 @@ void TrackerTransferFunction::evalCallInst(const ProgramPoint& pp)
 			nonExtCallees.push_back(callTgt);
 	}
 
-	ReturnTracker(trackerState, workList).trackReturn(pp, nonExtCallees);
+	ReturnTracker(trackerState, workList).trackReturn(pp, nonExtCallees, obj);
 }
 
 
-void TrackerTransferFunction::evalInst(const ProgramPoint& pp, const TaintStore* store)
+void TrackerTransferFunction::evalInst(const ProgramPoint& pp, const TaintStore* store, const MemoryObject* obj)
 {
 	auto inst = pp.getDefUseInstruction()->getInstruction();
 	assert(inst != nullptr);
@@ -254,11 +255,19 @@ void TrackerTransferFunction::evalInst(const ProgramPoint& pp, const TaintStore*
 		case Instruction::Invoke:
 		case Instruction::Call:
 		{
-			evalCallInst(pp);
+			evalCallInst(pp, obj);
 			break;
 		}
 		case Instruction::Ret:
 		{
+			// The exit of a function is tracked for a memory object when the object is imprecise at one of the call sites it returns to
+			if (obj != nullptr)
+			{
+				MemorySet memSet = { obj };
+				LocalTracker(workList).trackMemory(pp, memSet);
+				break;
+			}
+
 			auto retVal = cast<ReturnInst>(inst)->getReturnValue();
 			if (retVal != nullptr)
 			{
@@ -283,21 +292,27 @@ void TrackerTransferFunction::evalInst(const ProgramPoint& pp, const TaintStore*
 	}
 }
 
-void TrackerTransferFunction::eval(const ProgramPoint& pp)
+void TrackerTransferFunction::evalTracked(const ProgramPoint& pp, const MemoryObject* obj)
 {
-	if (!trackerState.insertVisitedLocation(pp))
-		return;
-
-	errs() << "tracking " << pp << "\n";
-
 	auto duInst = pp.getDefUseInstruction();
 	if (duInst->isEntryInstruction())
-		evalEntryInst(pp);
+		evalEntryInst(pp, obj);
 	else
 	{
-		//errs() << "tracking " << *duInst->getInstruction() << "\n";
 		auto store = trackerState.getMemo().lookup(pp);
-		evalInst(pp, store);
+		evalInst(pp, store, obj);
+	}
+}
+
+void TrackerTransferFunction::eval(const ProgramPoint& pp)
+{
+	for (auto& mapping: workList.takeCurrentTracked())
+	{
+		if (!trackerState.insertVisitedLocation(pp, mapping.first, mapping.second))
+			continue;
+
+		workList.setCurrentViolations(std::move(mapping.second));
+		evalTracked(pp, mapping.first);
 	}
 }
 
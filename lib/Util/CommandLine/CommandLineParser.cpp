@@ -108,7 +108,8 @@ void CommandLineParser::addOptionalFlag(const StringRef& name, const StringRef&
 static bool isOption(const StringRef& str)
 {
 	assert(!str.empty());
-	return str.front() == '-';
+	// A lone "-" is an argument, conventionally standing for stdin or stdout
+	return str.size() > 1 && str.front() == '-';
 }
 
 void CommandLineParser::parseArgs(const std::vector<StringRef>& args, CommandLineFlags& result) const
@@ -131,6 +132,9 @@ void CommandLineParser::parseArgs(const std::vector<StringRef>& args, CommandLin
 		else	// Optional arguments
 		{
 			flag = flag.drop_front();
+			// Accept "--flag" as well as "-flag"
+			if (flag.startswith("-"))
+				flag = flag.drop_front();
 
 			// See if flag is "-help"
 			if (flag == "help")
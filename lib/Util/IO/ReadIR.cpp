@@ -33,7 +33,17 @@ std::unique_ptr<Module> readModuleFromFile(const char* fileName)
 	return std::move(module);
 }
 
-std::unique_ptr<Module> parseAssembly(const char *assembly)
+std::unique_ptr<Module> readModuleFromFile(const char* fileName, LLVMContext& context)
+{
+	SMDiagnostic error;
+	auto module = parseIRFile(fileName, error, context);
+	if (!module)
+		error.print(fileName, errs());
+
+	return module;
+}
+
+std::unique_ptr<Module> readModuleFromString(const char *assembly)
 {
 	SMDiagnostic error;
 	auto module = parseAssemblyString(assembly, error, getGlobalContext());
@@ -51,5 +61,15 @@ std::unique_ptr<Module> parseAssembly(const char *assembly)
 	return std::move(module);
 }
 
+std::unique_ptr<Module> readModuleFromString(const char *assembly, LLVMContext& context)
+{
+	SMDiagnostic error;
+	auto module = parseAssemblyString(assembly, error, context);
+	if (!module)
+		error.print("", errs());
+
+	return module;
+}
+
 }
 }
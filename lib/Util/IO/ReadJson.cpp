@@ -0,0 +1,248 @@
+#include "Util/IO/ReadJson.h"
+#include "Util/pcomb/pcomb.h"
+
+#include <cctype>
+#include <cstdlib>
+
+using namespace llvm;
+using namespace pcomb;
+
+namespace util
+{
+namespace io
+{
+
+static std::string encodeUtf8(unsigned codePoint)
+{
+	std::string ret;
+	if (codePoint < 0x80)
+		ret.push_back(codePoint);
+	else if (codePoint < 0x800)
+	{
+		ret.push_back(0xc0 | (codePoint >> 6));
+		ret.push_back(0x80 | (codePoint & 0x3f));
+	}
+	else
+	{
+		ret.push_back(0xe0 | (codePoint >> 12));
+		ret.push_back(0x80 | ((codePoint >> 6) & 0x3f));
+		ret.push_back(0x80 | (codePoint & 0x3f));
+	}
+	return ret;
+}
+
+// A JSON number, the same as regex("-?[0-9]+(\\.[0-9]+)?([eE][+-]?[0-9]+)?"). std::regex_search on the raw buffer would run strlen over the rest of the input for every number, so the digit runs are matched with integer() and the rest is checked by hand
+class JsonNumberParser: public Parser<StringRef>
+{
+private:
+	CharClassParser digits;
+
+	// Return the length of the digit run at pos, or 0 if there is none
+	size_t scanDigits(const InputStream& input, size_t pos) const
+	{
+		auto result = digits.parse(input.consume(pos));
+		return result.success() ? result.getOutput().size() : 0;
+	}
+public:
+	using OutputType = StringRef;
+	using ResultType = typename Parser<StringRef>::ResultType;
+
+	JsonNumberParser(): digits(integer()) {}
+
+	ResultType parse(const InputStream& input) const override
+	{
+		auto ret = ResultType(input);
+
+		auto str = input.getRemainingString();
+		size_t len = str.startswith("-") ? 1 : 0;
+		auto intLen = scanDigits(input, len);
+		if (intLen == 0)
+			return ret;
+		len += intLen;
+
+		// The fraction and the exponent are optional. Without digits they are not part of the number, and whatever follows it will fail to parse
+		if (len < str.size() && str[len] == '.')
+		{
+			if (auto fracLen = scanDigits(input, len + 1))
+				len += 1 + fracLen;
+		}
+		if (len < str.size() && (str[len] == 'e' || str[len] == 'E'))
+		{
+			auto signLen = (len + 1 < str.size() && (str[len + 1] == '+' || str[len + 1] == '-')) ? 1 : 0;
+			if (auto expLen = scanDigits(input, len + 1 + signLen))
+				len += 1 + signLen + expLen;
+		}
+
+		return ResultType(input.consume(len), str.substr(0, len));
+	}
+};
+
+// The grammar is built on first use and shared by all later calls, since building it costs far more than parsing a request line. Combinators keep references to the parsers they are made of, so every piece of the grammar has to be static
+static const Parser<JsonValue>& getJsonParser()
+{
+	// Arrays and objects refer back to jvalue, so it has to be declared before its definition
+	static LazyParser<JsonValue> jvalue;
+
+	static auto jnull = rule(str("null"), [] (auto const&) { return JsonValue(); });
+	static auto jtrue = rule(str("true"), [] (auto const&) { return JsonValue::getBool(true); });
+	static auto jfalse = rule(str("false"), [] (auto const&) { return JsonValue::getBool(false); });
+
+	static auto jnumber = rule(
+		JsonNumberParser(),
+		[] (auto const& digits)
+		{
+			auto numStr = digits.str();
+			if (digits.find_first_of(".eE") == StringRef::npos)
+				return JsonValue::getInteger(std::strtoll(numStr.data(), nullptr, 10));
+			return JsonValue::getDouble(std::strtod(numStr.data(), nullptr));
+		}
+	);
+
+	// Everything but quotes, backslashes and control chars stands for itself
+	static auto plainChars = rule(
+		CharClassParser(pcomb::detail::CharClass().addRange('\x20', '\x21').addRange('\x23', '\x5b').addRange('\x5d', '\xff')),
+		[] (auto const& chars)
+		{
+			return chars.str();
+		}
+	);
+	static auto simpleEscape = rule(
+		seq(ch('\\'), ch([] (char c) { return StringRef("\"\\/bfnrt").find(c) != StringRef::npos; })),
+		[] (auto const& pair)
+		{
+			switch (std::get<1>(pair))
+			{
+				case 'b':
+					return std::string("\b");
+				case 'f':
+					return std::string("\f");
+				case 'n':
+					return std::string("\n");
+				case 'r':
+					return std::string("\r");
+				case 't':
+					return std::string("\t");
+				default:
+					return std::string(1, std::get<1>(pair));
+			}
+		}
+	);
+	static auto hexDigit = ch([] (char c) { return std::isxdigit(static_cast<unsigned char>(c)) != 0; });
+	static auto unicodeEscape = rule(
+		seq(str("\\u"), hexDigit, hexDigit, hexDigit, hexDigit),
+		[] (auto const& tuple)
+		{
+			char digits[] = { std::get<1>(tuple), std::get<2>(tuple), std::get<3>(tuple), std::get<4>(tuple), '\0' };
+			// Surrogate pairs are encoded half by half. Requests only name LLVM values, which are plain ASCII in practice
+			return encodeUtf8(std::strtoul(digits, nullptr, 16));
+		}
+	);
+	static auto jstring = rule(
+		seq(ch('"'), many(alt(plainChars, simpleEscape, unicodeEscape)), ch('"')),
+		[] (auto const& tuple)
+		{
+			std::string ret;
+			for (auto const& piece: std::get<1>(tuple))
+				ret += piece;
+			return ret;
+		}
+	);
+	static auto jstringValue = rule(jstring, [] (auto&& s) { return JsonValue::getString(std::move(s)); });
+
+	static auto jarray = alt(
+		rule(seq(ch('['), token(ch(']'))), [] (auto const&) { return JsonValue::getArray({}); }),
+		rule(
+			seq(
+				ch('['),
+				jvalue,
+				many(rule(seq(token(ch(',')), jvalue), [] (auto&& pair) { return std::move(std::get<1>(pair)); })),
+				token(ch(']'))
+			),
+			[] (auto&& tuple)
+			{
+				JsonValue::ArrayType elems;
+				elems.reserve(std::get<2>(tuple).size() + 1);
+				elems.push_back(std::move(std::get<1>(tuple)));
+				for (auto& elem: std::get<2>(tuple))
+					elems.push_back(std::move(elem));
+				return JsonValue::getArray(std::move(elems));
+			}
+		)
+	);
+
+	static auto jmember = rule(
+		seq(token(jstring), token(ch(':')), jvalue),
+		[] (auto&& tuple)
+		{
+			return std::make_pair(std::move(std::get<0>(tuple)), std::move(std::get<2>(tuple)));
+		}
+	);
+	static auto jobject = alt(
+		rule(seq(ch('{'), token(ch('}'))), [] (auto const&) { return JsonValue::getObject({}); }),
+		rule(
+			seq(
+				ch('{'),
+				jmember,
+				many(rule(seq(token(ch(',')), jmember), [] (auto&& pair) { return std::move(std::get<1>(pair)); })),
+				token(ch('}'))
+			),
+			[] (auto&& tuple)
+			{
+				JsonValue::ObjectType members;
+				members.reserve(std::get<2>(tuple).size() + 1);
+				members.push_back(std::move(std::get<1>(tuple)));
+				for (auto& member: std::get<2>(tuple))
+					members.push_back(std::move(member));
+				return JsonValue::getObject(std::move(members));
+			}
+		)
+	);
+
+	static auto jvalueDef = token(alt(jobject, jarray, jstringValue, jnumber, jtrue, jfalse, jnull));
+	static auto const& jvalueParser = jvalue.setParser(jvalueDef);
+	return jvalueParser;
+}
+
+// The parser recurses a few frames deep for every level of nesting, so a line like [[[[... would run the stack out long before it runs out of input
+static bool isNestedTooDeep(const StringRef& text)
+{
+	unsigned depth = 0;
+	bool inString = false;
+	for (size_t i = 0; i < text.size(); ++i)
+	{
+		auto c = text[i];
+		if (inString)
+		{
+			if (c == '\\')
+				++i;
+			else if (c == '"')
+				inString = false;
+		}
+		else if (c == '"')
+			inString = true;
+		else if (c == '[' || c == '{')
+		{
+			if (++depth > maxJsonDepth)
+				return true;
+		}
+		else if ((c == ']' || c == '}') && depth > 0)
+			--depth;
+	}
+	return false;
+}
+
+bool parseJson(const StringRef& text, JsonValue& value)
+{
+	if (isNestedTooDeep(text))
+		return false;
+
+	auto parseResult = getJsonParser().parse(text);
+	if (parseResult.hasError() || !parseResult.getInputStream().getRemainingString().ltrim().empty())
+		return false;
+
+	value = std::move(parseResult).getOutput();
+	return true;
+}
+
+}
+}
@@ -0,0 +1,121 @@
+#include "Util/IO/ReadJson.h"
+#include "Util/IO/WriteJson.h"
+
+#include <llvm/ADT/StringRef.h>
+#include <llvm/Support/Format.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace llvm;
+
+namespace util
+{
+namespace io
+{
+
+void writeJsonString(raw_ostream& os, StringRef str)
+{
+	os << '"';
+	for (auto c: str)
+	{
+		switch (c)
+		{
+			case '"':
+				os << "\\\"";
+				break;
+			case '\\':
+				os << "\\\\";
+				break;
+			case '\n':
+				os << "\\n";
+				break;
+			case '\r':
+				os << "\\r";
+				break;
+			case '\t':
+				os << "\\t";
+				break;
+			default:
+				if (static_cast<unsigned char>(c) < 0x20)
+					os << format("\\u%04x", static_cast<unsigned>(c));
+				else
+					os << c;
+		}
+	}
+	os << '"';
+}
+
+void writeJsonValue(raw_ostream& os, const JsonValue& value)
+{
+	switch (value.getKind())
+	{
+		case JsonValue::Kind::Null:
+			os << "null";
+			break;
+		case JsonValue::Kind::Bool:
+			os << (value.getAsBool() ? "true" : "false");
+			break;
+		case JsonValue::Kind::Integer:
+			os << value.getAsInteger();
+			break;
+		case JsonValue::Kind::Double:
+		{
+			// JSON has no literal for infinities or NaN. A double that prints like an integer gets a fraction so that it is read back as a double
+			auto d = value.getAsDouble();
+			if (!std::isfinite(d))
+			{
+				os << "null";
+				break;
+			}
+			// 15 digits avoid printing noise such as 0.0025000000000000001. 17 are needed only when 15 do not read back as the same double
+			char buf[32];
+			std::snprintf(buf, sizeof(buf), "%.15g", d);
+			if (std::strtod(buf, nullptr) != d)
+				std::snprintf(buf, sizeof(buf), "%.17g", d);
+			os << buf;
+			if (std::strpbrk(buf, ".e") == nullptr)
+				os << ".0";
+			break;
+		}
+		case JsonValue::Kind::String:
+			writeJsonString(os, value.getAsString());
+			break;
+		case JsonValue::Kind::Array:
+		{
+			os << '[';
+			bool isFirst = true;
+			for (auto const& elem: value.getAsArray())
+			{
+				if (!isFirst)
+					os << ',';
+				isFirst = false;
+				writeJsonValue(os, elem);
+			}
+			os << ']';
+			break;
+		}
+		case JsonValue::Kind::Object:
+		{
+			os << '{';
+			bool isFirst = true;
+			for (auto const& member: value.getAsObject())
+			{
+				if (!isFirst)
+					os << ',';
+				isFirst = false;
+				writeJsonString(os, member.first);
+				os << ':';
+				writeJsonValue(os, member.second);
+			}
+			os << '}';
+			break;
+		}
+	}
+}
+
+}
+}
@@ -0,0 +1,189 @@
+#include "Util/IO/WriteJson.h"
+#include "Util/Statistics/PhaseStatistics.h"
+
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Format.h>
+#include <llvm/Support/ToolOutputFile.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <fstream>
+
+#include <sys/resource.h>
+
+using namespace llvm;
+
+namespace util
+{
+
+namespace
+{
+
+// Return the value of a "<field>: <n> kB" line of /proc/self/status, or -1 if there is none
+long readProcStatusField(const StringRef& field)
+{
+	std::ifstream status("/proc/self/status");
+	std::string line;
+	while (std::getline(status, line))
+	{
+		auto lineRef = StringRef(line);
+		if (!lineRef.startswith(field) || lineRef.size() <= field.size() || lineRef[field.size()] != ':')
+			continue;
+
+		long value;
+		if (lineRef.drop_front(field.size() + 1).trim().split(' ').first.getAsInteger(10, value))
+			return -1;
+		return value;
+	}
+	return -1;
+}
+
+// Return the current resident set size in kilobytes, or 0 if it is unknown
+long getCurrentRSS()
+{
+	auto rss = readProcStatusField("VmRSS");
+	return rss < 0 ? 0 : rss;
+}
+
+// Return the peak resident set size in kilobytes since the process started or since the last resetPeakRSS()
+long getPeakRSSSinceReset()
+{
+	auto hwm = readProcStatusField("VmHWM");
+	if (hwm >= 0)
+		return hwm;
+
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+	return usage.ru_maxrss;
+}
+
+// Writing "5" to clear_refs resets VmHWM to the current RSS (Linux 4.0 and later)
+bool resetPeakRSS()
+{
+	std::ofstream clearRefs("/proc/self/clear_refs");
+	if (!clearRefs)
+		return false;
+	clearRefs << "5";
+	clearRefs.flush();
+	return static_cast<bool>(clearRefs);
+}
+
+}
+
+void PhaseStatistics::beginPhase(const StringRef& name)
+{
+	assert(!inPhase && "Phases do not nest");
+	inPhase = true;
+
+	Phase phase;
+	phase.name = name.str();
+	phase.wallTime = 0;
+	phase.peakRSS = 0;
+	phase.rssDelta = 0;
+	phases.push_back(std::move(phase));
+
+	peakWasReset = resetPeakRSS();
+	phaseStartRSS = getCurrentRSS();
+	phaseStart = Clock::now();
+}
+
+void PhaseStatistics::endPhase()
+{
+	assert(inPhase && !phases.empty());
+	std::chrono::duration<double, std::milli> elapsed = Clock::now() - phaseStart;
+	inPhase = false;
+
+	auto& phase = phases.back();
+	phase.wallTime = elapsed.count();
+	auto peakRSS = getPeakRSSSinceReset();
+	// Without a reset the high-water mark may have been reached in an earlier phase
+	phase.peakRSS = peakWasReset ? peakRSS : -1;
+	phase.rssDelta = getCurrentRSS() - phaseStartRSS;
+	processPeakRSS = std::max(processPeakRSS, peakRSS);
+}
+
+void PhaseStatistics::addCounter(const StringRef& name, size_t value)
+{
+	assert(!phases.empty() && "No phase to attach the counter to");
+	phases.back().counters.emplace_back(name.str(), value);
+}
+
+double PhaseStatistics::getTotalWallTime() const
+{
+	double total = 0;
+	for (auto const& phase: phases)
+		total += phase.wallTime;
+	return total;
+}
+
+void PhaseStatistics::print(raw_ostream& os) const
+{
+	os << "Phase                               Time (ms)  Peak RSS (MB) RSS delta (MB)\n";
+	for (auto const& phase: phases)
+	{
+		os << format("%-32s %12.3f ", phase.name.data(), phase.wallTime);
+		if (phase.peakRSS < 0)
+			os.indent(11) << "n/a";
+		else
+			os << format("%14.1f", phase.peakRSS / 1024.0);
+		os << format(" %+14.1f\n", phase.rssDelta / 1024.0);
+		for (auto const& counter: phase.counters)
+			os << "    " << counter.first << ": " << counter.second << "\n";
+	}
+	os << "Total" << format("%40.3f %14.1f\n", getTotalWallTime(), getPeakRSS() / 1024.0);
+}
+
+void PhaseStatistics::writeJson(raw_ostream& os) const
+{
+	os << "{\"phases\": [";
+	for (auto i = 0u; i < phases.size(); ++i)
+	{
+		auto const& phase = phases[i];
+		os << (i == 0 ? "" : ", ") << "{\"name\": ";
+		io::writeJsonString(os, phase.name);
+		os << ", \"wall_ms\": " << format("%.3f", phase.wallTime);
+		os << ", \"peak_rss_kb\": ";
+		if (phase.peakRSS < 0)
+			os << "null";
+		else
+			os << phase.peakRSS;
+		os << ", \"rss_delta_kb\": " << phase.rssDelta;
+		os << ", \"counters\": {";
+		for (auto j = 0u; j < phase.counters.size(); ++j)
+		{
+			os << (j == 0 ? "" : ", ");
+			io::writeJsonString(os, phase.counters[j].first);
+			os << ": " << phase.counters[j].second;
+		}
+		os << "}}";
+	}
+	os << "], \"total_wall_ms\": " << format("%.3f", getTotalWallTime());
+	os << ", \"peak_rss_kb\": " << getPeakRSS() << "}";
+}
+
+void PhaseStatistics::writeJsonToFile(const char* fileName) const
+{
+	if (StringRef(fileName) == "-")
+	{
+		writeJson(outs());
+		outs() << "\n";
+		return;
+	}
+
+	std::error_code ec;
+	tool_output_file out(fileName, ec, sys::fs::F_Text);
+	if (ec)
+	{
+		errs() << "Failed to write statistics to " << fileName << ": " << ec.message() << "\n";
+		std::exit(-1);
+	}
+
+	writeJson(out.os());
+	out.os() << "\n";
+	out.keep();
+}
+
+}
@@ -0,0 +1,20 @@
+#include "CommandLineOptions.h"
+#include "Util/CommandLine/TypedCommandLineParser.h"
+
+using namespace util;
+
+CommandLineOptions::CommandLineOptions(int argc, char** argv): outputDirName("."), ptrConfigFileName("ptr.config"), modRefConfigFileName("modref.config"), taintConfigFileName("taint.config"), noPrepassFlag(false), dumpPtsFlag(false), k(0), numJobs(1)
+{
+	TypedCommandLineParser cmdParser("Batch pointer and taint analysis");
+	cmdParser.addStringPositionalFlag("manifest", "File that lists the LLVM bitcode files to analyze, one per line. Empty lines and lines starting with '#' are ignored", manifestFileName);
+	cmdParser.addStringOptionalFlag("o", "Directory where the results of each module are written (default = <current dir>)", outputDirName);
+	cmdParser.addStringOptionalFlag("ptr-config", "Annotation file for external library points-to analysis (default = <current dir>/ptr.config)", ptrConfigFileName);
+	cmdParser.addStringOptionalFlag("modref-config", "Annotation file for external library mod/ref analysis (default = <current dir>/modref.config)", modRefConfigFileName);
+	cmdParser.addStringOptionalFlag("taint-config", "Annotation file for external library taint analysis (default = <current dir>/taint.config)", taintConfigFileName);
+	cmdParser.addUIntOptionalFlag("k", "The size limit of the stack for k-CFA", k);
+	cmdParser.addUIntOptionalFlag("j", "Number of worker processes (default = 1, 0 means one per core)", numJobs);
+	cmdParser.addBooleanOptionalFlag("dump-pts", "Also write the points-to sets of every module", dumpPtsFlag);
+	cmdParser.addBooleanOptionalFlag("no-prepass", "Do no run IR cannonicalization before the analysis", noPrepassFlag);
+
+	cmdParser.parseCommandLineOptions(argc, argv);
+}
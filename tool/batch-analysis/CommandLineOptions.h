@@ -0,0 +1,33 @@
+#pragma once
+
+#include <llvm/ADT/StringRef.h>
+
+class CommandLineOptions
+{
+private:
+	llvm::StringRef manifestFileName;
+	llvm::StringRef outputDirName;
+
+	llvm::StringRef ptrConfigFileName;
+	llvm::StringRef modRefConfigFileName;
+	llvm::StringRef taintConfigFileName;
+	bool noPrepassFlag;
+	bool dumpPtsFlag;
+	unsigned k;
+
+	unsigned numJobs;
+public:
+	CommandLineOptions(int argc, char** argv);
+
+	const llvm::StringRef& getManifestFileName() const { return manifestFileName; }
+	const llvm::StringRef& getOutputDirName() const { return outputDirName; }
+
+	const llvm::StringRef& getPtrConfigFileName() const { return ptrConfigFileName; }
+	const llvm::StringRef& getModRefConfigFileName() const { return modRefConfigFileName; }
+	const llvm::StringRef& getTaintConfigFileName() const { return taintConfigFileName; }
+	bool isPrepassDisabled() const { return noPrepassFlag; }
+	bool isPtsDumpEnabled() const { return dumpPtsFlag; }
+	unsigned getContextSensitivity() const { return k; }
+
+	unsigned getNumJobs() const { return numJobs; }
+};
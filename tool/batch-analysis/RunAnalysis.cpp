@@ -0,0 +1,128 @@
+#include "CommandLineOptions.h"
+#include "RunAnalysis.h"
+
+#include "Context/AdaptiveContext.h"
+#include "Context/Context.h"
+#include "PointerAnalysis/Analysis/SemiSparsePointerAnalysis.h"
+#include "PointerAnalysis/FrontEnd/SemiSparseProgramBuilder.h"
+#include "TaintAnalysis/Analysis/TaintAnalysis.h"
+#include "TaintAnalysis/FrontEnd/DefUseModuleBuilder.h"
+#include "Transforms/RunPrepass.h"
+#include "Util/IO/PointerAnalysis/Printer.h"
+#include "Util/IO/ReadIR.h"
+
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/ToolOutputFile.h>
+#include <llvm/Support/raw_ostream.h>
+
+using namespace llvm;
+using namespace tpa;
+using namespace taint;
+using namespace util::io;
+
+AnnotationTables::AnnotationTables(const CommandLineOptions& opts):
+	ptrTable(annotation::ExternalPointerTable::loadFromFile(opts.getPtrConfigFileName().data())),
+	modRefTable(annotation::ExternalModRefTable::loadFromFile(opts.getModRefConfigFileName().data())),
+	taintTable(annotation::ExternalTaintTable::loadFromFile(opts.getTaintConfigFileName().data()))
+{
+}
+
+std::string getOutputFileName(const StringRef& fileName, const StringRef& ext, const CommandLineOptions& opts)
+{
+	SmallString<256> outName(opts.getOutputDirName());
+	sys::path::append(outName, sys::path::stem(fileName) + ext);
+	return outName.str();
+}
+
+static void dumpPtsSetForValue(raw_ostream& os, const Value* value, const SemiSparsePointerAnalysis& ptrAnalysis)
+{
+	if (!value->getType()->isPointerTy())
+		return;
+
+	for (auto const& ptr: ptrAnalysis.getPointerManager().getPointersWithValue(value))
+	{
+		os << *ptr->getContext() << "::";
+		dumpValue(os, *value);
+		os << "  -->>  " << ptrAnalysis.getPtsSet(ptr) << "\n";
+	}
+}
+
+static void dumpAll(raw_ostream& os, const Module& module, const SemiSparsePointerAnalysis& ptrAnalysis)
+{
+	for (auto const& g: module.globals())
+		dumpPtsSetForValue(os, &g, ptrAnalysis);
+	for (auto const& f: module)
+	{
+		if (f.isDeclaration())
+			continue;
+		for (auto const& arg: f.args())
+			dumpPtsSetForValue(os, &arg, ptrAnalysis);
+		for (auto const& bb: f)
+			for (auto const& inst: bb)
+				dumpPtsSetForValue(os, &inst, ptrAnalysis);
+	}
+}
+
+static bool dumpPtsToFile(const StringRef& fileName, const Module& module, const SemiSparsePointerAnalysis& ptrAnalysis, const CommandLineOptions& opts)
+{
+	auto outName = getOutputFileName(fileName, ".pts", opts);
+	std::error_code ec;
+	tool_output_file out(outName.data(), ec, sys::fs::F_Text);
+	if (ec)
+	{
+		errs() << "Failed to write " << outName << ": " << ec.message() << "\n";
+		return false;
+	}
+
+	dumpAll(out.os(), module, ptrAnalysis);
+	out.keep();
+	return true;
+}
+
+static ModuleStatus analyzeModule(const StringRef& fileName, const Module& module, const AnnotationTables& tables, const CommandLineOptions& opts)
+{
+	SemiSparseProgramBuilder ssProgBuilder;
+	auto ssProg = ssProgBuilder.runOnModule(module);
+
+	SemiSparsePointerAnalysis ptrAnalysis;
+	ptrAnalysis.setExternalPointerTable(tables.getPointerTable());
+	ptrAnalysis.runOnProgram(ssProg);
+
+	if (opts.isPtsDumpEnabled() && !dumpPtsToFile(fileName, module, ptrAnalysis, opts))
+		return ModuleStatus::Failed;
+
+	DefUseModuleBuilder builder(ptrAnalysis);
+	builder.setExternalModRefTable(tables.getModRefTable());
+	auto duModule = builder.buildDefUseModule(module);
+
+	TaintAnalysis taintAnalysis(ptrAnalysis);
+	taintAnalysis.setExternalTaintTable(tables.getTaintTable());
+	taintAnalysis.setReportFile(getOutputFileName(fileName, ".taint.jsonl", opts).data());
+	return taintAnalysis.runOnDefUseModule(duModule) ? ModuleStatus::Passed : ModuleStatus::Violated;
+}
+
+ModuleStatus runAnalysisOnModule(const StringRef& fileName, const AnnotationTables& tables, const CommandLineOptions& opts)
+{
+	ModuleStatus status;
+	{
+		// Everything that refers to the module is gone when the context is
+		LLVMContext context;
+		auto module = readModuleFromFile(fileName.data(), context);
+		if (!module)
+			return ModuleStatus::Failed;
+
+		if (!opts.isPrepassDisabled())
+			transform::runPrepassOn(*module);
+
+		status = analyzeModule(fileName, *module, tables, opts);
+	}
+
+	// The points-to sets and contexts of this module are dead now. Without this the interned sets and contexts of every module analyzed so far would pile up, and the contexts would keep pointing to call sites of freed modules
+	PtsSet::releaseInternedSets();
+	context::AdaptiveContext::clearTrackedCallSites();
+	context::Context::releaseContexts();
+	return status;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Annotation/ModRef/ExternalModRefTable.h"
+#include "Annotation/Pointer/ExternalPointerTable.h"
+#include "Annotation/Taint/ExternalTaintTable.h"
+
+#include <llvm/ADT/StringRef.h>
+
+class CommandLineOptions;
+
+// The annotation tables are loaded once per process and handed to the analyses of each module. The copies the analyses make share the loaded entries
+class AnnotationTables
+{
+private:
+	annotation::ExternalPointerTable ptrTable;
+	annotation::ExternalModRefTable modRefTable;
+	annotation::ExternalTaintTable taintTable;
+public:
+	AnnotationTables(const CommandLineOptions&);
+
+	const annotation::ExternalPointerTable& getPointerTable() const { return ptrTable; }
+	const annotation::ExternalModRefTable& getModRefTable() const { return modRefTable; }
+	const annotation::ExternalTaintTable& getTaintTable() const { return taintTable; }
+};
+
+enum class ModuleStatus
+{
+	Passed,
+	Violated,
+	Failed,
+};
+
+// Analyze one bitcode file in a fresh LLVMContext and write its results to the output directory
+ModuleStatus runAnalysisOnModule(const llvm::StringRef& fileName, const AnnotationTables&, const CommandLineOptions&);
+
+// Return the name of the file under the output directory where the results of module fileName with the given extension go
+std::string getOutputFileName(const llvm::StringRef& fileName, const llvm::StringRef& ext, const CommandLineOptions&);
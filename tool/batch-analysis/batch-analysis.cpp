@@ -0,0 +1,181 @@
+#include "CommandLineOptions.h"
+#include "RunAnalysis.h"
+
+#include "Context/KLimitContext.h"
+#include "Util/IO/ReadFile.h"
+
+#include <llvm/ADT/StringSet.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/PrettyStackTrace.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Support/Signals.h>
+
+#include <atomic>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace llvm;
+
+namespace
+{
+
+// Shared by all worker processes through an anonymous shared mapping. Workers take the next module from nextIndex, so a few large modules do not hold up the rest of a worker's share
+struct BatchProgress
+{
+	std::atomic<unsigned> nextIndex;
+	std::atomic<unsigned> numPassed;
+	std::atomic<unsigned> numViolated;
+	std::atomic<unsigned> numFailed;
+};
+
+std::vector<std::string> readManifest(const CommandLineOptions& opts)
+{
+	auto buffer = util::io::readFileIntoBuffer(opts.getManifestFileName().data());
+
+	std::vector<std::string> fileNames;
+	StringSet<> outputNames;
+	SmallVector<StringRef, 64> lines;
+	buffer->getBuffer().split(lines, '\n', -1, false);
+	for (auto line: lines)
+	{
+		line = line.trim();
+		if (line.empty() || line.startswith("#"))
+			continue;
+
+		// Results are named after the module, so two modules with the same file name would overwrite each other's results
+		if (!outputNames.insert(sys::path::stem(line)).second)
+		{
+			errs() << "Manifest lists more than one module named " << sys::path::stem(line) << ": " << line << "\n";
+			std::exit(-1);
+		}
+		fileNames.push_back(line.str());
+	}
+	return fileNames;
+}
+
+void runWorker(const std::vector<std::string>& fileNames, const AnnotationTables& tables, const CommandLineOptions& opts, BatchProgress& progress)
+{
+	unsigned i;
+	while ((i = progress.nextIndex++) < fileNames.size())
+	{
+		auto const& fileName = fileNames[i];
+		auto status = runAnalysisOnModule(fileName, tables, opts);
+
+		// One write per line so that lines from different workers do not interleave
+		std::string line;
+		raw_string_ostream lineStream(line);
+		lineStream << "[" << (i + 1) << "/" << fileNames.size() << "] " << fileName << ": ";
+		switch (status)
+		{
+			case ModuleStatus::Passed:
+				++progress.numPassed;
+				lineStream << "passed\n";
+				break;
+			case ModuleStatus::Violated:
+				++progress.numViolated;
+				lineStream << "sink violations in " << getOutputFileName(fileName, ".taint.jsonl", opts) << "\n";
+				break;
+			case ModuleStatus::Failed:
+				++progress.numFailed;
+				lineStream << "failed\n";
+				break;
+		}
+		outs() << lineStream.str();
+		outs().flush();
+	}
+}
+
+// Fork the workers after the tables are loaded, so that they share the parsed tables instead of parsing them again. Processes rather than threads because the pointer analysis interns points-to sets and type layouts in unsynchronized global tables
+void runWorkers(unsigned numJobs, const std::vector<std::string>& fileNames, const AnnotationTables& tables, const CommandLineOptions& opts, BatchProgress& progress)
+{
+	outs().flush();
+	errs().flush();
+
+	std::vector<pid_t> workers;
+	for (auto i = 0u; i < numJobs; ++i)
+	{
+		auto pid = fork();
+		if (pid < 0)
+		{
+			errs() << "Failed to start worker process " << i << "\n";
+			break;
+		}
+		if (pid == 0)
+		{
+			runWorker(fileNames, tables, opts, progress);
+			outs().flush();
+			// Skip the destructors of the copied global state. The parent still owns it
+			_exit(0);
+		}
+		workers.push_back(pid);
+	}
+
+	// The modules that a crashed worker was on are neither passed nor violated
+	for (auto pid: workers)
+	{
+		int status;
+		waitpid(pid, &status, 0);
+		if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+			errs() << "Worker process " << pid << " terminated abnormally\n";
+	}
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	// Print full stack trace when crashed
+	sys::PrintStackTraceOnErrorSignal();
+	PrettyStackTraceProgram X(argc, argv);
+
+	// Parse command line options
+	auto opts = CommandLineOptions(argc, argv);
+
+	auto fileNames = readManifest(opts);
+	if (auto ec = sys::fs::create_directories(opts.getOutputDirName()))
+	{
+		errs() << "Failed to create output directory " << opts.getOutputDirName() << ": " << ec.message() << "\n";
+		std::exit(-1);
+	}
+
+	// Everything below is shared by all modules
+	auto tables = AnnotationTables(opts);
+	context::KLimitContext::setLimit(opts.getContextSensitivity());
+
+	auto numJobs = opts.getNumJobs();
+	if (numJobs == 0)
+		numJobs = std::max(std::thread::hardware_concurrency(), 1u);
+	numJobs = std::min<unsigned>(numJobs, fileNames.size());
+
+	auto mapping = mmap(nullptr, sizeof(BatchProgress), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (mapping == MAP_FAILED)
+	{
+		errs() << "Failed to map shared memory\n";
+		std::exit(-1);
+	}
+	auto& progress = *new (mapping) BatchProgress{ {0}, {0}, {0}, {0} };
+
+	if (numJobs <= 1)
+		runWorker(fileNames, tables, opts, progress);
+	else
+		runWorkers(numJobs, fileNames, tables, opts, progress);
+
+	auto numPassed = progress.numPassed.load(), numViolated = progress.numViolated.load(), numFailed = progress.numFailed.load();
+	auto numAborted = fileNames.size() - numPassed - numViolated - numFailed;
+	outs() << "\n" << fileNames.size() << " module(s): " << numPassed << " passed, " << numViolated << " with sink violations, " << numFailed << " failed";
+	if (numAborted > 0)
+		outs() << ", " << numAborted << " lost to crashed workers";
+	outs() << "\n";
+
+	munmap(mapping, sizeof(BatchProgress));
+	if (numFailed + numAborted > 0)
+		return -2;
+	return numViolated > 0 ? -3 : 0;
+}
@@ -0,0 +1,640 @@
+#include "PointerAnalysis/Support/PtsSet.h"
+#include "Util/DataStructure/FIFOWorkList.h"
+#include "Util/DataStructure/PriorityWorkList.h"
+#include "Util/DataStructure/TwoLevelWorkList.h"
+#include "Util/DataStructure/VectorMap.h"
+#include "Util/DataStructure/VectorSet.h"
+
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/ADT/SparseBitVector.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+
+// Every benchmark returns a checksum of what it computed, so that the work cannot be optimized away
+// When the implementations in a group compute the same thing, their checksums must agree. Worklists are the exception: the order of dequeues is the very thing that differs between them
+class BenchmarkGroup
+{
+private:
+	const char* name;
+	unsigned numRuns;
+	bool checkAgreement;
+	bool hasChecksum;
+	std::uint64_t checksum;
+public:
+	BenchmarkGroup(const char* n, unsigned r, bool c = true): name(n), numRuns(r), checkAgreement(c), hasChecksum(false), checksum(0)
+	{
+		std::cout << name << "\n";
+	}
+
+	// setup() runs before every run of func() and is not timed
+	template <typename Func, typename Setup>
+	void run(const char* impl, std::size_t numOps, Func&& func, Setup&& setup)
+	{
+		double best = 0;
+		std::uint64_t sum = 0;
+		for (auto i = 0u; i < numRuns; ++i)
+		{
+			setup();
+			auto start = std::chrono::steady_clock::now();
+			sum = func();
+			std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+			if (i == 0 || elapsed.count() < best)
+				best = elapsed.count();
+		}
+
+		std::cout << "  " << std::left << std::setw(20) << impl << std::right << std::setw(10) << numOps << " ops" << std::setw(12) << std::fixed << std::setprecision(3) << best << " ms";
+		if (numOps > 0)
+			std::cout << std::setw(10) << std::setprecision(1) << best * 1e6 / numOps << " ns/op";
+		std::cout << '\n';
+
+		if (!checkAgreement || !hasChecksum)
+		{
+			hasChecksum = true;
+			checksum = sum;
+		}
+		else if (sum != checksum)
+		{
+			std::cerr << "Implementations of " << name << " disagree: " << impl << " computed " << sum << " instead of " << checksum << "\n";
+			std::exit(-1);
+		}
+	}
+
+	template <typename Func>
+	void run(const char* impl, std::size_t numOps, Func&& func)
+	{
+		run(impl, numOps, std::forward<Func>(func), [] {});
+	}
+};
+
+// Fixed seed: every run of the benchmark sees the same workload
+std::mt19937 rng(20161014);
+
+unsigned randomBelow(unsigned n)
+{
+	return std::uniform_int_distribution<unsigned>(0, n - 1)(rng);
+}
+
+std::vector<unsigned> randomSample(unsigned size, unsigned universe)
+{
+	std::vector<unsigned> all(universe);
+	for (auto i = 0u; i < universe; ++i)
+		all[i] = i;
+	std::shuffle(all.begin(), all.end(), rng);
+	all.resize(std::min(size, universe));
+	return all;
+}
+
+/***************************** Sets *****************************/
+
+// Each set is a list of distinct object ids in random order
+using SetWorkload = std::vector<std::vector<unsigned>>;
+
+// Points-to sets in a typical run are mostly singletons and pairs, with a thin tail of sets that hold a large part of the heap. Draw set sizes from roughly that histogram
+unsigned drawPtsSetSize()
+{
+	auto bucket = randomBelow(100);
+	if (bucket < 55)
+		return 1;
+	if (bucket < 75)
+		return 2;
+	if (bucket < 95)
+		return 3 + randomBelow(14);
+	return 64 + randomBelow(961);
+}
+
+SetWorkload makeMixedSetWorkload(unsigned numSets, unsigned universe)
+{
+	SetWorkload sets;
+	for (auto i = 0u; i < numSets; ++i)
+		sets.push_back(randomSample(drawPtsSetSize(), universe));
+	return sets;
+}
+
+SetWorkload makeUniformSetWorkload(unsigned numSets, unsigned setSize, unsigned universe)
+{
+	SetWorkload sets;
+	for (auto i = 0u; i < numSets; ++i)
+		sets.push_back(randomSample(setSize, universe));
+	return sets;
+}
+
+std::size_t getTotalSize(const SetWorkload& sets)
+{
+	std::size_t total = 0;
+	for (auto const& set: sets)
+		total += set.size();
+	return total;
+}
+
+// The set representations under test. Each adapter exposes the same operations on object ids
+
+struct VectorSetAdapter
+{
+	using SetType = util::VectorSet<unsigned>;
+	static void insert(SetType& s, unsigned elem) { s.insert(elem); }
+	static void merge(SetType& s, const SetType& rhs) { s.merge(rhs); }
+	static bool has(const SetType& s, unsigned elem) { return s.count(elem); }
+	static const SetType& elements(const SetType& s) { return s; }
+};
+
+// A SmallVector kept sorted by hand. This is what VectorSet would become with inline storage for the common small sets
+struct SmallVectorAdapter
+{
+	using SetType = llvm::SmallVector<unsigned, 4>;
+	static void insert(SetType& s, unsigned elem)
+	{
+		auto itr = std::lower_bound(s.begin(), s.end(), elem);
+		if (itr == s.end() || *itr != elem)
+			s.insert(itr, elem);
+	}
+	static void merge(SetType& s, const SetType& rhs)
+	{
+		SetType result;
+		result.reserve(s.size() + rhs.size());
+		std::set_union(s.begin(), s.end(), rhs.begin(), rhs.end(), std::back_inserter(result));
+		s = std::move(result);
+	}
+	static bool has(const SetType& s, unsigned elem) { return std::binary_search(s.begin(), s.end(), elem); }
+	static const SetType& elements(const SetType& s) { return s; }
+};
+
+struct SparseBitVectorAdapter
+{
+	using SetType = llvm::SparseBitVector<>;
+	static void insert(SetType& s, unsigned elem) { s.set(elem); }
+	static void merge(SetType& s, const SetType& rhs) { s |= rhs; }
+	static bool has(const SetType& s, unsigned elem) { return s.test(elem); }
+	static const SetType& elements(const SetType& s) { return s; }
+};
+
+template <typename Adapter>
+std::vector<typename Adapter::SetType> buildSets(const SetWorkload& workload)
+{
+	std::vector<typename Adapter::SetType> sets(workload.size());
+	for (auto i = 0u; i < workload.size(); ++i)
+		for (auto elem: workload[i])
+			Adapter::insert(sets[i], elem);
+	return sets;
+}
+
+// Insert one element at a time in random order, which is how the transfer functions grow a set
+template <typename Adapter>
+void benchmarkSetInsert(BenchmarkGroup& group, const char* impl, const SetWorkload& workload)
+{
+	group.run(impl, getTotalSize(workload), [&workload] ()
+	{
+		std::uint64_t sum = 0;
+		for (auto const& elems: workload)
+		{
+			typename Adapter::SetType set;
+			for (auto elem: elems)
+				Adapter::insert(set, elem);
+			for (auto elem: Adapter::elements(set))
+				sum += elem;
+		}
+		return sum;
+	});
+}
+
+// Merge every set with another one, as the propagator does at join points
+template <typename Adapter>
+void benchmarkSetMerge(BenchmarkGroup& group, const char* impl, const SetWorkload& workload)
+{
+	auto sets = buildSets<Adapter>(workload);
+	group.run(impl, sets.size(), [&sets] ()
+	{
+		std::uint64_t sum = 0;
+		for (auto i = 0u; i < sets.size(); ++i)
+		{
+			auto set = sets[i];
+			Adapter::merge(set, sets[(i * 7 + 1) % sets.size()]);
+			for (auto elem: Adapter::elements(set))
+				sum += elem + 1;
+		}
+		return sum;
+	});
+}
+
+template <typename Adapter>
+void benchmarkSetLookup(BenchmarkGroup& group, const char* impl, const SetWorkload& workload, const std::vector<unsigned>& probes)
+{
+	auto sets = buildSets<Adapter>(workload);
+	group.run(impl, sets.size() * probes.size(), [&sets, &probes] ()
+	{
+		std::uint64_t sum = 0;
+		for (auto const& set: sets)
+			for (auto probe: probes)
+				sum += Adapter::has(set, probe);
+		return sum;
+	});
+}
+
+template <typename Adapter>
+void benchmarkSetIterate(BenchmarkGroup& group, const char* impl, const SetWorkload& workload)
+{
+	auto sets = buildSets<Adapter>(workload);
+	group.run(impl, getTotalSize(workload), [&sets] ()
+	{
+		std::uint64_t sum = 0;
+		for (auto const& set: sets)
+			for (auto elem: Adapter::elements(set))
+				sum = sum * 31 + elem;
+		return sum;
+	});
+}
+
+void benchmarkSets(const char* workloadName, const SetWorkload& workload, unsigned universe, unsigned numRuns)
+{
+	std::cout << "\n=== Sets: " << workloadName << " (" << workload.size() << " sets, " << getTotalSize(workload) << " elements) ===\n";
+
+	{
+		BenchmarkGroup group("insert", numRuns);
+		benchmarkSetInsert<VectorSetAdapter>(group, "VectorSet", workload);
+		benchmarkSetInsert<SmallVectorAdapter>(group, "SmallVector", workload);
+		benchmarkSetInsert<SparseBitVectorAdapter>(group, "SparseBitVector", workload);
+	}
+	{
+		BenchmarkGroup group("merge", numRuns);
+		benchmarkSetMerge<VectorSetAdapter>(group, "VectorSet", workload);
+		benchmarkSetMerge<SmallVectorAdapter>(group, "SmallVector", workload);
+		benchmarkSetMerge<SparseBitVectorAdapter>(group, "SparseBitVector", workload);
+	}
+	{
+		auto probes = randomSample(16, universe);
+		BenchmarkGroup group("lookup", numRuns);
+		benchmarkSetLookup<VectorSetAdapter>(group, "VectorSet", workload, probes);
+		benchmarkSetLookup<SmallVectorAdapter>(group, "SmallVector", workload, probes);
+		benchmarkSetLookup<SparseBitVectorAdapter>(group, "SparseBitVector", workload, probes);
+	}
+	{
+		BenchmarkGroup group("iterate", numRuns);
+		benchmarkSetIterate<VectorSetAdapter>(group, "VectorSet", workload);
+		benchmarkSetIterate<SmallVectorAdapter>(group, "SmallVector", workload);
+		benchmarkSetIterate<SparseBitVectorAdapter>(group, "SparseBitVector", workload);
+	}
+}
+
+/***************************** PtsSet *****************************/
+
+// PtsSet only compares and hashes object addresses, so made-up addresses do as well as real MemoryObjects
+const tpa::MemoryObject* getFakeObject(unsigned id)
+{
+	return reinterpret_cast<const tpa::MemoryObject*>(static_cast<std::uintptr_t>(id + 1) * 16);
+}
+
+unsigned getFakeObjectId(const tpa::MemoryObject* obj)
+{
+	return reinterpret_cast<std::uintptr_t>(obj) / 16 - 1;
+}
+
+// Compare the interned PtsSet against the VectorSet it wraps, to see what interning costs and what it saves
+void benchmarkPtsSet(const SetWorkload& workload, unsigned numRuns)
+{
+	std::cout << "\n=== PtsSet (" << workload.size() << " sets, " << getTotalSize(workload) << " elements) ===\n";
+
+	auto releaseSets = [] { tpa::PtsSet::releaseInternedSets(); };
+	{
+		BenchmarkGroup group("insert", numRuns);
+		benchmarkSetInsert<VectorSetAdapter>(group, "VectorSet", workload);
+		group.run("PtsSet", getTotalSize(workload), [&workload] ()
+		{
+			std::uint64_t sum = 0;
+			for (auto const& elems: workload)
+			{
+				auto set = tpa::PtsSet::getEmptySet();
+				for (auto elem: elems)
+					set = set.insert(getFakeObject(elem));
+				for (auto obj: set)
+					sum += getFakeObjectId(obj);
+			}
+			return sum;
+		}, releaseSets);
+	}
+	{
+		BenchmarkGroup group("merge", numRuns);
+		benchmarkSetMerge<VectorSetAdapter>(group, "VectorSet", workload);
+
+		std::vector<tpa::PtsSet> sets;
+		auto buildPtsSets = [&workload, &sets] ()
+		{
+			tpa::PtsSet::releaseInternedSets();
+			sets.clear();
+			for (auto const& elems: workload)
+			{
+				auto set = tpa::PtsSet::getEmptySet();
+				for (auto elem: elems)
+					set = set.insert(getFakeObject(elem));
+				sets.push_back(set);
+			}
+		};
+		group.run("PtsSet", workload.size(), [&sets] ()
+		{
+			std::uint64_t sum = 0;
+			for (auto i = 0u; i < sets.size(); ++i)
+			{
+				auto set = sets[i].merge(sets[(i * 7 + 1) % sets.size()]);
+				for (auto obj: set)
+					sum += getFakeObjectId(obj) + 1;
+			}
+			return sum;
+		}, buildPtsSets);
+	}
+	{
+		// Equal sets are one pointer comparison once interned. This is the operation the propagator relies on to tell that a state has not changed
+		BenchmarkGroup group("equality", numRuns);
+		auto vecSets = buildSets<VectorSetAdapter>(workload);
+		auto copies = vecSets;
+		group.run("VectorSet", vecSets.size(), [&vecSets, &copies] ()
+		{
+			std::uint64_t sum = 0;
+			for (auto i = 0u; i < vecSets.size(); ++i)
+				sum += (vecSets[i] == copies[i]) + (vecSets[i] == copies[(i + 1) % copies.size()]);
+			return sum;
+		});
+
+		std::vector<tpa::PtsSet> sets, ptsCopies;
+		auto buildPtsSets = [&workload, &sets, &ptsCopies] ()
+		{
+			tpa::PtsSet::releaseInternedSets();
+			sets.clear();
+			for (auto const& elems: workload)
+			{
+				auto set = tpa::PtsSet::getEmptySet();
+				for (auto elem: elems)
+					set = set.insert(getFakeObject(elem));
+				sets.push_back(set);
+			}
+			ptsCopies = sets;
+		};
+		group.run("PtsSet", workload.size(), [&sets, &ptsCopies] ()
+		{
+			std::uint64_t sum = 0;
+			for (auto i = 0u; i < sets.size(); ++i)
+				sum += (sets[i] == ptsCopies[i]) + (sets[i] == ptsCopies[(i + 1) % ptsCopies.size()]);
+			return sum;
+		}, buildPtsSets);
+	}
+	tpa::PtsSet::releaseInternedSets();
+}
+
+/***************************** Maps *****************************/
+
+struct VectorMapAdapter
+{
+	using MapType = util::VectorMap<unsigned, unsigned>;
+	static unsigned* find(MapType& m, unsigned key)
+	{
+		auto itr = m.find(key);
+		return itr == m.end() ? nullptr : &itr->second;
+	}
+};
+
+struct DenseMapAdapter
+{
+	using MapType = llvm::DenseMap<unsigned, unsigned>;
+	static unsigned* find(MapType& m, unsigned key)
+	{
+		auto itr = m.find(key);
+		return itr == m.end() ? nullptr : &itr->second;
+	}
+};
+
+struct UnorderedMapAdapter
+{
+	using MapType = std::unordered_map<unsigned, unsigned>;
+	static unsigned* find(MapType& m, unsigned key)
+	{
+		auto itr = m.find(key);
+		return itr == m.end() ? nullptr : &itr->second;
+	}
+};
+
+// Each map is a list of distinct keys in random order. The value of a key is derived from the key
+using MapWorkload = std::vector<std::vector<unsigned>>;
+
+template <typename Adapter>
+std::vector<typename Adapter::MapType> buildMaps(const MapWorkload& workload)
+{
+	std::vector<typename Adapter::MapType> maps(workload.size());
+	for (auto i = 0u; i < workload.size(); ++i)
+		for (auto key: workload[i])
+			maps[i][key] = key * 3 + 1;
+	return maps;
+}
+
+template <typename Adapter>
+void benchmarkMapInsert(BenchmarkGroup& group, const char* impl, const MapWorkload& workload)
+{
+	group.run(impl, getTotalSize(workload), [&workload] ()
+	{
+		std::uint64_t sum = 0;
+		for (auto const& keys: workload)
+		{
+			typename Adapter::MapType map;
+			for (auto key: keys)
+				map[key] = key * 3 + 1;
+			sum += map.size();
+		}
+		return sum;
+	});
+}
+
+template <typename Adapter>
+void benchmarkMapLookup(BenchmarkGroup& group, const char* impl, const MapWorkload& workload, const std::vector<unsigned>& probes)
+{
+	auto maps = buildMaps<Adapter>(workload);
+	group.run(impl, maps.size() * probes.size(), [&maps, &probes] ()
+	{
+		std::uint64_t sum = 0;
+		for (auto& map: maps)
+			for (auto probe: probes)
+				if (auto val = Adapter::find(map, probe))
+					sum += *val;
+		return sum;
+	});
+}
+
+// The iteration order differs between the maps, so the checksum must not depend on it
+template <typename Adapter>
+void benchmarkMapIterate(BenchmarkGroup& group, const char* impl, const MapWorkload& workload)
+{
+	auto maps = buildMaps<Adapter>(workload);
+	group.run(impl, getTotalSize(workload), [&maps] ()
+	{
+		std::uint64_t sum = 0;
+		for (auto const& map: maps)
+			for (auto const& mapping: map)
+				sum += mapping.first ^ mapping.second;
+		return sum;
+	});
+}
+
+void benchmarkMaps(unsigned mapSize, unsigned numMaps, unsigned universe, unsigned numRuns)
+{
+	MapWorkload workload;
+	for (auto i = 0u; i < numMaps; ++i)
+		workload.push_back(randomSample(mapSize, universe));
+
+	std::cout << "\n=== Maps: " << numMaps << " maps of " << mapSize << " keys ===\n";
+	{
+		BenchmarkGroup group("insert", numRuns);
+		benchmarkMapInsert<VectorMapAdapter>(group, "VectorMap", workload);
+		benchmarkMapInsert<DenseMapAdapter>(group, "DenseMap", workload);
+		benchmarkMapInsert<UnorderedMapAdapter>(group, "unordered_map", workload);
+	}
+	{
+		auto probes = randomSample(16, universe);
+		BenchmarkGroup group("lookup", numRuns);
+		benchmarkMapLookup<VectorMapAdapter>(group, "VectorMap", workload, probes);
+		benchmarkMapLookup<DenseMapAdapter>(group, "DenseMap", workload, probes);
+		benchmarkMapLookup<UnorderedMapAdapter>(group, "unordered_map", workload, probes);
+	}
+	{
+		BenchmarkGroup group("iterate", numRuns);
+		benchmarkMapIterate<VectorMapAdapter>(group, "VectorMap", workload);
+		benchmarkMapIterate<DenseMapAdapter>(group, "DenseMap", workload);
+		benchmarkMapIterate<UnorderedMapAdapter>(group, "unordered_map", workload);
+	}
+}
+
+/***************************** Worklists *****************************/
+
+// A recorded run of a solver: after dequeuing a node, the solver enqueues the successors whose state changed
+// Nodes are grouped into functions of nodesPerFunction consecutive ids. Most successors are in the same function, a few are calls or returns into another one
+struct WorkListTrace
+{
+	static const unsigned nodesPerFunction = 32;
+
+	std::vector<std::vector<unsigned>> succs;
+	unsigned maxVisits;
+};
+
+WorkListTrace makeWorkListTrace(unsigned numNodes)
+{
+	WorkListTrace trace;
+	trace.succs.resize(numNodes);
+	trace.maxVisits = 4;
+	for (auto i = 0u; i < numNodes; ++i)
+	{
+		auto& succs = trace.succs[i];
+		if ((i + 1) % WorkListTrace::nodesPerFunction != 0 && i + 1 < numNodes)
+			succs.push_back(i + 1);
+		// A branch or a back edge within the function
+		auto funcBase = i - i % WorkListTrace::nodesPerFunction;
+		succs.push_back(std::min(funcBase + randomBelow(WorkListTrace::nodesPerFunction), numNodes - 1));
+		if (randomBelow(8) == 0)
+			succs.push_back(randomBelow(numNodes));
+	}
+	return trace;
+}
+
+// Adapt the worklists to take plain node ids
+struct FIFOWorkListAdapter
+{
+	util::FIFOWorkList<unsigned> workList;
+	void enqueue(unsigned node) { workList.enqueue(node); }
+	unsigned dequeue() { return workList.dequeue(); }
+	bool empty() const { return workList.empty(); }
+};
+
+struct PriorityWorkListAdapter
+{
+	util::PriorityWorkList<unsigned, std::greater<unsigned>> workList;
+	void enqueue(unsigned node) { workList.enqueue(node); }
+	unsigned dequeue() { return workList.dequeue(); }
+	bool empty() const { return workList.empty(); }
+};
+
+// The configuration of the pointer analysis: functions in FIFO order, nodes within a function in priority order
+struct TwoLevelWorkListAdapter
+{
+	util::TwoLevelWorkList<util::FIFOWorkList<unsigned>, util::PriorityWorkList<unsigned, std::greater<unsigned>>> workList;
+	void enqueue(unsigned node) { workList.enqueue(std::make_pair(node / WorkListTrace::nodesPerFunction, node)); }
+	unsigned dequeue() { return workList.dequeue().second; }
+	bool empty() const { return workList.empty(); }
+};
+
+// Replay the trace, revisiting each node at most maxVisits times so that the run terminates
+template <typename Adapter>
+void benchmarkWorkList(BenchmarkGroup& group, const char* impl, const WorkListTrace& trace)
+{
+	std::vector<unsigned> visits;
+	auto replay = [&trace, &visits] ()
+	{
+		visits.assign(trace.succs.size(), 0);
+		Adapter workList;
+		workList.enqueue(0);
+		// Count enqueues and dequeues
+		std::uint64_t numOps = 1;
+		while (!workList.empty())
+		{
+			auto node = workList.dequeue();
+			++numOps;
+			if (++visits[node] > trace.maxVisits)
+				continue;
+			for (auto succ: trace.succs[node])
+			{
+				workList.enqueue(succ);
+				++numOps;
+			}
+		}
+		return numOps;
+	};
+	// The number of operations depends on the order of dequeues. Count them with an untimed run
+	auto numOps = replay();
+	group.run(impl, numOps, replay);
+}
+
+void benchmarkWorkLists(unsigned numNodes, unsigned numRuns)
+{
+	auto trace = makeWorkListTrace(numNodes);
+
+	std::cout << "\n=== Worklists: " << numNodes << " nodes ===\n";
+	BenchmarkGroup group("enqueue+dequeue", numRuns, false);
+	benchmarkWorkList<FIFOWorkListAdapter>(group, "FIFOWorkList", trace);
+	benchmarkWorkList<PriorityWorkListAdapter>(group, "PriorityWorkList", trace);
+	benchmarkWorkList<TwoLevelWorkListAdapter>(group, "TwoLevelWorkList", trace);
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	if (argc > 2)
+	{
+		std::cout << "Usage: " << argv[0] << " [number of runs]\n\n";
+		std::exit(-1);
+	}
+
+	auto numRuns = argc == 2 ? std::strtoul(argv[1], nullptr, 10) : 5u;
+	if (numRuns == 0)
+		numRuns = 1;
+
+	// Most sets are tiny, a few are large. This is what the engines see
+	auto mixedSets = makeMixedSetWorkload(10000, 4096);
+	benchmarkSets("mixed sizes", mixedSets, 4096, numRuns);
+	// The tail of the histogram on its own, where the asymptotic behavior shows
+	benchmarkSets("large", makeUniformSetWorkload(64, 2048, 65536), 65536, numRuns);
+
+	benchmarkPtsSet(mixedSets, numRuns);
+
+	// Store sizes range from a handful of objects in small functions to most of the heap at the entry of main
+	benchmarkMaps(8, 4096, 1 << 16, numRuns);
+	benchmarkMaps(64, 512, 1 << 16, numRuns);
+	benchmarkMaps(1024, 32, 1 << 16, numRuns);
+	benchmarkMaps(16384, 2, 1 << 16, numRuns);
+
+	benchmarkWorkLists(1 << 16, numRuns);
+}
\ No newline at end of file
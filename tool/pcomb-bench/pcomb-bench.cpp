@@ -0,0 +1,125 @@
+#include "Util/pcomb/pcomb.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace pcomb;
+
+namespace
+{
+
+// Generate an annotation file in the format of ptr.config, with numEntries entries of every kind
+std::string generateInput(unsigned numEntries)
+{
+	std::string ret;
+	for (auto i = 0u; i < numEntries; ++i)
+	{
+		auto name = "lib_function_" + std::to_string(i);
+		switch (i % 6)
+		{
+			case 0:
+				ret += "# " + name + " is generated\n";
+				break;
+			case 1:
+				ret += "IGNORE " + name + "\n";
+				break;
+			case 2:
+				ret += name + " ALLOC Arg" + std::to_string(i % 4) + "\n";
+				break;
+			case 3:
+				ret += name + " COPY Ret V Arg0 R\n";
+				break;
+			case 4:
+				ret += name + " COPY Arg1 D STATIC\n";
+				break;
+			case 5:
+				ret += name + " EXIT\n";
+				break;
+		}
+	}
+	return ret;
+}
+
+// The shape of the pointer annotation grammar, parameterized by its lexical primitives. The result is the number of entries
+template <typename IdParser, typename IdxParser, typename CommentParser>
+size_t parseInput(const std::string& input, IdParser id, IdxParser idx, CommentParser comment)
+{
+	auto parg = seq(str("Arg"), idx);
+	auto ppos = alt(rule(parg, [] (auto const&) { return 0; }), rule(str("Ret"), [] (auto const&) { return 1; }));
+	auto vdr = token(alt(ch('V'), ch('D'), ch('R')));
+	auto copysrc = alt(
+		rule(str("NULL"), [] (auto const&) { return 0; }),
+		rule(str("UNKNOWN"), [] (auto const&) { return 1; }),
+		rule(str("STATIC"), [] (auto const&) { return 2; }),
+		rule(seq(parg, vdr), [] (auto const&) { return 3; })
+	);
+
+	auto commentEntry = rule(token(comment), [] (auto const&) { return 0; });
+	auto ignoreEntry = rule(seq(token(str("IGNORE")), token(id)), [] (auto const&) { return 1; });
+	auto allocEntry = rule(seq(token(id), token(str("ALLOC")), token(parg)), [] (auto const&) { return 2; });
+	auto copyEntry = rule(seq(token(id), token(str("COPY")), token(seq(ppos, vdr)), token(copysrc)), [] (auto const&) { return 3; });
+	auto exitEntry = rule(seq(token(id), token(str("EXIT"))), [] (auto const&) { return 4; });
+
+	auto result = many(alt(commentEntry, ignoreEntry, allocEntry, copyEntry, exitEntry)).parse(llvm::StringRef(input));
+	if (result.hasError() || !llvm::StringRef(result.getInputStream().getRawBuffer()).ltrim().empty())
+	{
+		auto& stream = result.getInputStream();
+		std::cerr << "Parsing failed at line " << stream.getLineNumber() << ", column " << stream.getColumnNumber() << "\n";
+		std::exit(-1);
+	}
+	return result.getOutput().size();
+}
+
+template <typename ParseFunc>
+size_t benchmark(const char* name, const std::string& input, unsigned numRuns, ParseFunc&& parseFunc)
+{
+	size_t numEntries = 0;
+	double best = 0;
+	for (auto i = 0u; i < numRuns; ++i)
+	{
+		auto start = std::chrono::steady_clock::now();
+		numEntries = parseFunc(input);
+		std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+		if (i == 0 || elapsed.count() < best)
+			best = elapsed.count();
+	}
+
+	std::cout << std::left << std::setw(10) << name << std::right << std::setw(12) << numEntries << " entries" << std::setw(12) << std::fixed << std::setprecision(2) << best << " ms";
+	if (best > 0)
+		std::cout << std::setw(12) << std::setprecision(2) << input.size() / best / 1000 << " MB/s";
+	std::cout << '\n';
+	return numEntries;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	if (argc > 3)
+	{
+		std::cout << "Usage: " << argv[0] << " [number of entries] [number of runs]\n\n";
+		std::exit(-1);
+	}
+
+	auto numEntries = argc >= 2 ? std::strtoul(argv[1], nullptr, 10) : 20000u;
+	auto numRuns = argc == 3 ? std::strtoul(argv[2], nullptr, 10) : 5u;
+	if (numRuns == 0)
+		numRuns = 1;
+
+	auto input = generateInput(numEntries);
+
+	// The regex primitives are what the annotation parsers used to be built on
+	auto regexCount = benchmark("regex", input, numRuns, [] (const std::string& in) { return parseInput(in, regex("[\\w\\.]+"), regex("\\d+"), regex("#.*\\n")); });
+	auto scanCount = benchmark("scan", input, numRuns, [] (const std::string& in) { return parseInput(in, ident("."), integer(), lineComment('#')); });
+	// A fresh memo table per run, since a memo table is only valid for one input
+	auto memoCount = benchmark("scan+memo", input, numRuns, [] (const std::string& in) { return parseInput(in, memo(ident(".")), integer(), lineComment('#')); });
+
+	if (regexCount != scanCount || regexCount != memoCount)
+	{
+		std::cerr << "Parsers disagree on the number of entries\n";
+		std::exit(-1);
+	}
+}
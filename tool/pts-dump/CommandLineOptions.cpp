@@ -3,12 +3,15 @@
 
 using namespace util;
 
-CommandLineOptions::CommandLineOptions(int argc, char** argv): ptrConfigFileName("ptr.config"), noPrepassFlag(false), k(0)
+CommandLineOptions::CommandLineOptions(int argc, char** argv): ptrConfigFileName("ptr.config"), noPrepassFlag(false), compactFlag(false), k(0), numThreads(0)
 {
 	TypedCommandLineParser cmdParser("Points-to set dumper");
 	cmdParser.addStringPositionalFlag("inputFile", "Input LLVM bitcode file name", inputFileName);
 	cmdParser.addStringOptionalFlag("ptr-config", "Annotation file for external library points-to analysis (default = <current dir>/ptr.config)", ptrConfigFileName);
+	cmdParser.addStringOptionalFlag("o", "Write the points-to sets to this file instead of stderr", outputFileName);
 	cmdParser.addUIntOptionalFlag("k", "The size limit of the stack for k-CFA", k);
+	cmdParser.addUIntOptionalFlag("j", "Number of threads used to format the output (default = 0, which means one per core)", numThreads);
+	cmdParser.addBooleanOptionalFlag("compact", "Write each distinct points-to set once and refer to it by id", compactFlag);
 	cmdParser.addBooleanOptionalFlag("no-prepass", "Do no run IR cannonicalization before the analysis", noPrepassFlag);
 
 	cmdParser.parseCommandLineOptions(argc, argv);
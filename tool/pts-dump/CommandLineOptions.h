@@ -7,15 +7,21 @@ class CommandLineOptions
 private:
 	llvm::StringRef inputFileName;
 	llvm::StringRef ptrConfigFileName;
+	llvm::StringRef outputFileName;
 
 	bool noPrepassFlag;
+	bool compactFlag;
 	unsigned k;
+	unsigned numThreads;
 public:
 	CommandLineOptions(int argc, char** argv);
 
 	const llvm::StringRef& getInputFileName() const { return inputFileName; }
 	const llvm::StringRef& getPtrConfigFileName() const { return ptrConfigFileName; }
+	const llvm::StringRef& getOutputFileName() const { return outputFileName; }
 
 	bool isPrepassDisabled() const { return noPrepassFlag; }
+	bool isCompactOutputEnabled() const { return compactFlag; }
 	unsigned getContextSensitivity() const { return k; }
+	unsigned getNumThreads() const { return numThreads; }
 };
@@ -0,0 +1,143 @@
+#include "PtsDumper.h"
+
+#include "PointerAnalysis/Analysis/SemiSparsePointerAnalysis.h"
+#include "Util/IO/PointerAnalysis/Printer.h"
+
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+using namespace llvm;
+using namespace tpa;
+using namespace util::io;
+
+PtsDumper::PtsDumper(const SemiSparsePointerAnalysis& p, unsigned n, bool c): ptrAnalysis(p), numThreads(n), compact(c)
+{
+	if (numThreads == 0)
+		numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+void PtsDumper::formatValue(raw_ostream& os, const Value* value, Chunk& chunk) const
+{
+	assert(value != nullptr);
+	if (!value->getType()->isPointerTy())
+		return;
+
+	auto ptrs = ptrAnalysis.getPointerManager().getPointersWithValue(value);
+	assert((!ptrs.empty() || isa<PHINode>(value) || isa<IntToPtrInst>(value)) && "cannot find corresponding ptr for value?");
+
+	for (auto const& ptr: ptrs)
+	{
+		auto lineBegin = os.tell();
+		os << *ptr->getContext() << "::";
+		dumpValue(os, *value);
+		os << "  -->>  ";
+		if (compact)
+			chunk.sets.push_back({ lineBegin, os.tell(), ptrAnalysis.getPtsSet(ptr) });
+		else
+			os << ptrAnalysis.getPtsSet(ptr) << "\n";
+	}
+}
+
+void PtsDumper::formatItem(const Module& module, const Function* f, Chunk& chunk) const
+{
+	raw_string_ostream os(chunk.text);
+	if (f == nullptr)
+	{
+		for (auto const& g: module.globals())
+			formatValue(os, &g, chunk);
+	}
+	else
+	{
+		for (auto const& arg: f->args())
+			formatValue(os, &arg, chunk);
+		for (auto const& bb: *f)
+			for (auto const& inst: bb)
+				formatValue(os, &inst, chunk);
+	}
+	os.flush();
+}
+
+void PtsDumper::writeChunk(raw_ostream& os, const Chunk& chunk)
+{
+	if (!compact)
+	{
+		os << chunk.text;
+		return;
+	}
+
+	for (auto const& ref: chunk.sets)
+	{
+		auto itr = setIds.find(ref.pSet);
+		if (itr == setIds.end())
+		{
+			itr = setIds.insert(std::make_pair(ref.pSet, setIds.size())).first;
+			os << "#" << itr->second << " = " << ref.pSet << "\n";
+		}
+		os << StringRef(chunk.text).slice(ref.lineBegin, ref.lineEnd) << "#" << itr->second << "\n";
+	}
+}
+
+void PtsDumper::dump(const Module& module, raw_ostream& os)
+{
+	// Item 0 is the globals. Item i > 0 is the i-th defined function
+	std::vector<const Function*> items = { nullptr };
+	for (auto const& f: module)
+		if (!f.isDeclaration())
+			items.push_back(&f);
+
+	if (numThreads <= 1)
+	{
+		for (auto f: items)
+		{
+			Chunk chunk;
+			formatItem(module, f, chunk);
+			writeChunk(os, chunk);
+		}
+		return;
+	}
+
+	std::vector<Chunk> chunks(items.size());
+	std::vector<bool> isDone(items.size(), false);
+	std::mutex doneMutex;
+	std::condition_variable doneCond;
+
+	std::atomic<size_t> nextItem(0);
+	auto formatItems = [this, &module, &items, &chunks, &isDone, &doneMutex, &doneCond, &nextItem] ()
+	{
+		size_t i;
+		while ((i = nextItem++) < items.size())
+		{
+			formatItem(module, items[i], chunks[i]);
+			{
+				std::lock_guard<std::mutex> lock(doneMutex);
+				isDone[i] = true;
+			}
+			doneCond.notify_one();
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for (auto i = 0u, e = std::min<unsigned>(numThreads, items.size()); i < e; ++i)
+		workers.emplace_back(formatItems);
+
+	// Stream the chunks in module order while the workers are still busy with later ones. A chunk is freed once it is written
+	for (size_t i = 0; i < items.size(); ++i)
+	{
+		{
+			std::unique_lock<std::mutex> lock(doneMutex);
+			doneCond.wait(lock, [&isDone, i] { return isDone[i]; });
+		}
+		writeChunk(os, chunks[i]);
+		chunks[i] = Chunk();
+	}
+
+	for (auto& worker: workers)
+		worker.join();
+}
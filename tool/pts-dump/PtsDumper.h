@@ -0,0 +1,55 @@
+#pragma once
+
+#include "PointerAnalysis/Support/PtsSet.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace llvm
+{
+	class Function;
+	class Module;
+	class raw_ostream;
+	class Value;
+}
+
+namespace tpa
+{
+	class SemiSparsePointerAnalysis;
+}
+
+// Writes the points-to set of every pointer in a module: the globals first, then the arguments and instructions of each function, in module order
+// Functions are formatted by a pool of threads into buffers of their own, and the buffers are written out in module order as soon as all the ones before them are done. The output is the same no matter how many threads there are
+// In compact mode each distinct points-to set is written once as "#<id> = { ... }" right before its first use, and pointers refer to it as "#<id>". Ids are numbered in order of first use
+class PtsDumper
+{
+private:
+	const tpa::SemiSparsePointerAnalysis& ptrAnalysis;
+	unsigned numThreads;
+	bool compact;
+
+	// The output of one global list or function. In compact mode the lines in text stop right before the set, which the writer fills in from sets
+	struct Chunk
+	{
+		std::string text;
+
+		struct SetRef
+		{
+			size_t lineBegin, lineEnd;
+			tpa::PtsSet pSet;
+		};
+		std::vector<SetRef> sets;
+	};
+
+	std::unordered_map<tpa::PtsSet, unsigned> setIds;
+
+	void formatValue(llvm::raw_ostream&, const llvm::Value*, Chunk&) const;
+	void formatItem(const llvm::Module&, const llvm::Function*, Chunk&) const;
+	void writeChunk(llvm::raw_ostream&, const Chunk&);
+public:
+	// numThreads = 0 means one thread per core
+	PtsDumper(const tpa::SemiSparsePointerAnalysis& p, unsigned n, bool c);
+
+	void dump(const llvm::Module&, llvm::raw_ostream&);
+};
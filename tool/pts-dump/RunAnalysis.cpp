@@ -1,64 +1,41 @@
 #include "CommandLineOptions.h"
+#include "PtsDumper.h"
 #include "RunAnalysis.h"
 
 #include "Context/KLimitContext.h"
 #include "PointerAnalysis/Analysis/SemiSparsePointerAnalysis.h"
 #include "PointerAnalysis/FrontEnd/SemiSparseProgramBuilder.h"
-#include "Util/DataStructure/VectorSet.h"
-#include "Util/Iterator/MapValueIterator.h"
-#include "Util/IO/PointerAnalysis/Printer.h"
 
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/ToolOutputFile.h>
 #include <llvm/Support/raw_ostream.h>
 
+#include <unistd.h>
+
 using namespace llvm;
 using namespace tpa;
-using namespace util::io;
 
-static void dumpPtsSetForValue(const Value* value, const SemiSparsePointerAnalysis& ptrAnalysis)
+static void dumpAll(const Module& module, const SemiSparsePointerAnalysis& ptrAnalysis, const CommandLineOptions& opts)
 {
-	assert(value != nullptr);
-	if (!value->getType()->isPointerTy())
-		return;
+	auto dumper = PtsDumper(ptrAnalysis, opts.getNumThreads(), opts.isCompactOutputEnabled());
 
-	auto ptrs = ptrAnalysis.getPointerManager().getPointersWithValue(value);
-	if (ptrs.empty())
+	if (opts.getOutputFileName().empty())
 	{
-		errs() << "val = " << *value << "\n";
-		assert((isa<PHINode>(value) || isa<IntToPtrInst>(value)) && "cannot find corresponding ptr for value?");
+		// errs() is unbuffered, which makes the many small writes of the compact format expensive
+		raw_fd_ostream os(STDERR_FILENO, false);
+		dumper.dump(module, os);
 		return;
 	}
 
-	for (auto const& ptr: ptrs)
-	{
-		errs() << *ptr->getContext() << "::";
-		dumpValue(errs(), *value);
-		errs() << "  -->>  " << ptrAnalysis.getPtsSet(ptr) << "\n";
-	}
-}
-
-static void dumpPtsSetInBasicBlock(const BasicBlock& bb, const SemiSparsePointerAnalysis& ptrAnalysis)
-{
-	for (auto const& inst: bb)
-		dumpPtsSetForValue(&inst, ptrAnalysis);
-}
-
-static void dumpPtsSetInFunction(const Function& f, const SemiSparsePointerAnalysis& ptrAnalysis)
-{
-	for (auto const& arg: f.args())
-		dumpPtsSetForValue(&arg, ptrAnalysis);
-	for (auto const& bb: f)
-		dumpPtsSetInBasicBlock(bb, ptrAnalysis);
-}
-
-static void dumpAll(const Module& module, const SemiSparsePointerAnalysis& ptrAnalysis)
-{
-	for (auto const& g: module.globals())
-		dumpPtsSetForValue(&g, ptrAnalysis);
-	for (auto const& f: module)
+	std::error_code ec;
+	tool_output_file out(opts.getOutputFileName().data(), ec, sys::fs::F_Text);
+	if (ec)
 	{
-		if (!f.isDeclaration())
-			dumpPtsSetInFunction(f, ptrAnalysis);
+		errs() << "Failed to write " << opts.getOutputFileName() << ": " << ec.message() << "\n";
+		std::exit(-3);
 	}
+	dumper.dump(module, out.os());
+	out.keep();
 }
 
 void runAnalysisOnModule(const Module& module, const CommandLineOptions& opts)
@@ -71,5 +48,5 @@ void runAnalysisOnModule(const Module& module, const CommandLineOptions& opts)
 	context::KLimitContext::setLimit(opts.getContextSensitivity());
 	ptrAnalysis.runOnProgram(ssProg);
 
-	dumpAll(module, ptrAnalysis);
+	dumpAll(module, ptrAnalysis, opts);
 }
\ No newline at end of file
@@ -3,7 +3,7 @@
 
 using namespace util;
 
-CommandLineOptions::CommandLineOptions(int argc, char** argv): outputFileName("-"), ptrConfigFileName("ptr.config"), noPrepassFlag(false), outputTextFlag(false)
+CommandLineOptions::CommandLineOptions(int argc, char** argv): outputFileName("-"), ptrConfigFileName("ptr.config"), noPrepassFlag(false), outputTextFlag(false), noPruneFlag(false), prunePreciseFlag(false), onlineVerifyFlag(false), sampleRate(1), sampleBurst(1), sampleFirst(0)
 {
 	TypedCommandLineParser cmdParser("Program instrumentation for dynamic pointer analysis");
 	cmdParser.addStringPositionalFlag("inputFile", "Input LLVM bitcode file name", inputFileName);
@@ -11,6 +11,12 @@ CommandLineOptions::CommandLineOptions(int argc, char** argv): outputFileName("-
 	cmdParser.addStringOptionalFlag("ptr-config", "Annotation file for external library points-to analysis (default = <current dir>/ptr.config)", ptrConfigFileName);
 	cmdParser.addBooleanOptionalFlag("no-prepass", "Do no run IR cannonicalization before the analysis", noPrepassFlag);
 	cmdParser.addBooleanOptionalFlag("S", "Output IR in text format rather than bitcode format", outputTextFlag);
+	cmdParser.addBooleanOptionalFlag("no-prune", "Hook every pointer value, including trivial copies of an already hooked pointer", noPruneFlag);
+	cmdParser.addBooleanOptionalFlag("prune-precise", "Do not hook pointer values that the static analysis resolves to a single non-summary object. Those values are then trusted rather than checked by pts-verify", prunePreciseFlag);
+	cmdParser.addBooleanOptionalFlag("online-verify", "Embed the static points-to sets into the output so that the program checks them as it runs. Link the result against the DynamicVerifyRuntime library instead of DynamicRuntime, and with -pthread", onlineVerifyFlag);
+	cmdParser.addUIntOptionalFlag("sample-rate", "Only log one out of every N hits of each pointer hook (default = 1, which logs every hit)", sampleRate);
+	cmdParser.addUIntOptionalFlag("sample-burst", "With -sample-rate, log this many consecutive hits at the start of every window of N hits instead of just one. Must be smaller than the rate (default = 1)", sampleBurst);
+	cmdParser.addUIntOptionalFlag("sample-first", "Only log the first N hits of each pointer hook. Overrides -sample-rate (default = 0, which means no limit)", sampleFirst);
 
 	cmdParser.parseCommandLineOptions(argc, argv);
 }
\ No newline at end of file
@@ -11,6 +11,13 @@ private:
 
 	bool noPrepassFlag;
 	bool outputTextFlag;
+	bool noPruneFlag;
+	bool prunePreciseFlag;
+	bool onlineVerifyFlag;
+
+	unsigned sampleRate;
+	unsigned sampleBurst;
+	unsigned sampleFirst;
 public:
 	CommandLineOptions(int argc, char** argv);
 
@@ -20,4 +27,11 @@ public:
 
 	bool isPrepassDisabled() const { return noPrepassFlag; }
 	bool isTextOutput() const { return outputTextFlag || outputFileName == "-"; }
+	bool isPruningDisabled() const { return noPruneFlag; }
+	bool isPrecisePruningEnabled() const { return prunePreciseFlag; }
+	bool isOnlineVerifyEnabled() const { return onlineVerifyFlag; }
+
+	unsigned getSampleRate() const { return sampleRate; }
+	unsigned getSampleBurst() const { return sampleBurst; }
+	unsigned getSampleFirst() const { return sampleFirst; }
 };
\ No newline at end of file
@@ -0,0 +1,185 @@
+#include "StaticPtsTable.h"
+
+#include "Dynamic/Instrument/IDAssigner.h"
+#include "PointerAnalysis/Analysis/SemiSparsePointerAnalysis.h"
+#include "PointerAnalysis/FrontEnd/SemiSparseProgramBuilder.h"
+
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/InstIterator.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <algorithm>
+#include <limits>
+#include <map>
+
+using namespace llvm;
+
+namespace
+{
+
+const std::uint32_t noIndex = std::numeric_limits<std::uint32_t>::max();
+
+const Value* getAllocValue(const tpa::AllocSite& site)
+{
+	switch (site.getAllocType())
+	{
+		case tpa::AllocSiteTag::Global:
+			return site.getGlobalValue();
+		case tpa::AllocSiteTag::Function:
+			return site.getFunction();
+		case tpa::AllocSiteTag::Stack:
+		case tpa::AllocSiteTag::Heap:
+			return site.getLocalValue();
+		default:
+			return nullptr;
+	}
+}
+
+}
+
+StaticPtsTable StaticPtsTable::build(const Module& module, const char* ptrConfigFileName)
+{
+	tpa::SemiSparseProgramBuilder ssBuilder;
+	auto ssProg = ssBuilder.runOnModule(module);
+
+	tpa::SemiSparsePointerAnalysis ptrAnalysis;
+	ptrAnalysis.loadExternalPointerTable(ptrConfigFileName);
+	ptrAnalysis.runOnProgram(ssProg);
+
+	dynamic::IDAssigner idMap(module);
+
+	StaticPtsTable table;
+	std::uint32_t numAllocs = 1;
+	std::map<std::vector<std::uint32_t>, std::uint32_t> setMap;
+
+	auto getAllocIndex = [&table, &idMap, &numAllocs] (const Value* val)
+	{
+		auto id = *idMap.getID(val);
+		if (table.allocIndices.size() <= id)
+			table.allocIndices.resize(id + 1, noIndex);
+		if (table.allocIndices[id] == noIndex)
+			table.allocIndices[id] = numAllocs++;
+		return table.allocIndices[id];
+	};
+
+	auto addSite = [&] (const Value* val)
+	{
+		auto idPtr = idMap.getID(val);
+		if (idPtr == nullptr)
+			return;
+
+		// Values in unreachable code have no static points-to set to check against
+		if (ptrAnalysis.getPointerManager().getPointersWithValue(val->stripPointerCasts()).empty())
+		{
+			++table.numUncheckedSites;
+			return;
+		}
+
+		// Static points-to sets are merged across contexts. An observed target outside the merged set is a violation in every context
+		std::vector<std::uint32_t> allocs;
+		for (auto obj: ptrAnalysis.getPtsSet(val))
+		{
+			if (obj->isUniversalObject())
+			{
+				++table.numUncheckedSites;
+				return;
+			}
+			if (obj->isNullObject())
+				allocs.push_back(0);
+			else if (auto allocVal = getAllocValue(obj->getAllocSite()))
+				allocs.push_back(getAllocIndex(allocVal));
+		}
+		std::sort(allocs.begin(), allocs.end());
+		allocs.erase(std::unique(allocs.begin(), allocs.end()), allocs.end());
+
+		auto itr = setMap.find(allocs);
+		if (itr == setMap.end())
+			itr = setMap.insert(std::make_pair(std::move(allocs), static_cast<std::uint32_t>(setMap.size()))).first;
+
+		if (table.siteSets.size() <= *idPtr)
+			table.siteSets.resize(*idPtr + 1, 0);
+		table.siteSets[*idPtr] = itr->second + 1;
+		++table.numCheckedSites;
+	};
+
+	for (auto const& f: module)
+	{
+		// The instrumenter leaves these functions alone
+		if (f.isDeclaration() || f.isVarArg())
+			continue;
+
+		for (auto const& arg: f.args())
+			if (arg.getType()->isPointerTy())
+				addSite(&arg);
+		for (auto const& inst: instructions(f))
+			if (inst.getType()->isPointerTy() && !isa<AllocaInst>(inst))
+				addSite(&inst);
+	}
+
+	table.numSets = setMap.size();
+	table.wordsPerSet = (numAllocs + 31) / 32;
+	table.setBits.assign(table.numSets * table.wordsPerSet, 0);
+	for (auto const& mapping: setMap)
+	{
+		auto base = mapping.second * table.wordsPerSet;
+		for (auto idx: mapping.first)
+			table.setBits[base + idx / 32] |= 1u << (idx % 32);
+	}
+
+	// The runtime indexes both arrays by value ID without bounds checks against each other
+	auto numIds = std::max(table.siteSets.size(), table.allocIndices.size());
+	table.siteSets.resize(numIds, 0);
+	table.allocIndices.resize(numIds, noIndex);
+
+	return table;
+}
+
+void StaticPtsTable::embed(Module& module) const
+{
+	auto& context = module.getContext();
+	auto intType = Type::getInt32Ty(context);
+	auto intPtrType = PointerType::getUnqual(intType);
+
+	auto createArray = [&module, intPtrType] (const std::vector<std::uint32_t>& data, const char* name) -> Constant*
+	{
+		auto init = ConstantDataArray::get(module.getContext(), ArrayRef<std::uint32_t>(data));
+		auto gv = new GlobalVariable(module, init->getType(), true, GlobalValue::PrivateLinkage, init, name);
+		return ConstantExpr::getBitCast(gv, intPtrType);
+	};
+
+	auto mainFunc = module.getFunction("main");
+	auto initHook = module.getFunction("HookInit");
+	if (mainFunc == nullptr || mainFunc->isDeclaration() || initHook == nullptr)
+	{
+		errs() << "Online verification needs an instrumented main() function\n";
+		std::exit(-1);
+	}
+
+	Instruction* pos = nullptr;
+	for (auto& inst: mainFunc->getEntryBlock())
+	{
+		if (auto callInst = dyn_cast<CallInst>(&inst))
+		{
+			if (callInst->getCalledFunction() == initHook)
+			{
+				pos = callInst->getNextNode();
+				break;
+			}
+		}
+	}
+	assert(pos != nullptr && "HookInit not found in main()");
+
+	auto verifyInitType = FunctionType::get(Type::getVoidTy(context), { intPtrType, intType, intPtrType, intPtrType, intType }, false);
+	auto verifyInitHook = Function::Create(verifyInitType, GlobalValue::ExternalLinkage, "HookVerifyInit", &module);
+
+	Value* args[] = {
+		createArray(siteSets, "pts.verify.sites"),
+		ConstantInt::get(intType, siteSets.size()),
+		createArray(allocIndices, "pts.verify.allocs"),
+		createArray(setBits, "pts.verify.sets"),
+		ConstantInt::get(intType, wordsPerSet),
+	};
+	CallInst::Create(verifyInitHook, args, "", pos);
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace llvm
+{
+	class Module;
+}
+
+// The static points-to sets of all pointer hook sites, encoded for the online verification runtime
+// Every allocation site that appears in some static points-to set gets a dense index, with index 0 reserved for the null object. Each distinct points-to set is stored once as a bitset over these indices, and each hook site refers to its set by number
+class StaticPtsTable
+{
+private:
+	// Indexed by value ID: the set number plus one for a checked hook site, or 0 for a site that is not checked
+	std::vector<std::uint32_t> siteSets;
+	// Indexed by value ID: the dense index of an allocation site, or UINT32_MAX if no static points-to set contains it
+	std::vector<std::uint32_t> allocIndices;
+	std::vector<std::uint32_t> setBits;
+	std::uint32_t wordsPerSet;
+
+	unsigned numCheckedSites;
+	unsigned numUncheckedSites;
+	unsigned numSets;
+
+	StaticPtsTable(): wordsPerSet(0), numCheckedSites(0), numUncheckedSites(0), numSets(0) {}
+public:
+	// Must run on the module before it gets instrumented, so that value IDs match the ones the instrumenter assigns
+	static StaticPtsTable build(const llvm::Module&, const char* ptrConfigFileName);
+
+	// Emit the table into the module and hand it to the runtime through HookVerifyInit, right after HookInit in main
+	void embed(llvm::Module&) const;
+
+	unsigned getNumCheckedSites() const { return numCheckedSites; }
+	unsigned getNumUncheckedSites() const { return numUncheckedSites; }
+	unsigned getNumSets() const { return numSets; }
+	std::size_t getSizeInBytes() const { return (siteSets.size() + allocIndices.size() + setBits.size()) * sizeof(std::uint32_t); }
+};
@@ -1,17 +1,64 @@
 #include "CommandLineOptions.h"
+#include "StaticPtsTable.h"
 
 #include "Dynamic/Instrument/MemoryInstrument.h"
+#include "PointerAnalysis/Analysis/SemiSparsePointerAnalysis.h"
+#include "PointerAnalysis/FrontEnd/SemiSparseProgramBuilder.h"
 #include "Transforms/RunPrepass.h"
 #include "Util/IO/ReadIR.h"
 #include "Util/IO/WriteIR.h"
 
+#include <llvm/IR/InstIterator.h>
 #include <llvm/IR/Module.h>
 #include <llvm/Support/PrettyStackTrace.h>
 #include <llvm/Support/raw_ostream.h>
 #include <llvm/Support/Signals.h>
 
+#include <experimental/optional>
+
 using namespace llvm;
 
+namespace
+{
+
+bool isPrecise(const tpa::SemiSparsePointerAnalysis& ptrAnalysis, const Value* val)
+{
+	// Values in unreachable code have no pointer at all
+	if (ptrAnalysis.getPointerManager().getPointersWithValue(val->stripPointerCasts()).empty())
+		return false;
+
+	auto pSet = ptrAnalysis.getPtsSet(val);
+	if (pSet.size() != 1)
+		return false;
+	auto obj = *pSet.begin();
+	return !obj->isSpecialObject() && !obj->isSummaryObject();
+}
+
+void prunePreciseValues(const Module& module, const char* ptrConfigFileName, dynamic::HookPruner& pruner)
+{
+	tpa::SemiSparseProgramBuilder ssBuilder;
+	auto ssProg = ssBuilder.runOnModule(module);
+
+	tpa::SemiSparsePointerAnalysis ptrAnalysis;
+	ptrAnalysis.loadExternalPointerTable(ptrConfigFileName);
+	ptrAnalysis.runOnProgram(ssProg);
+
+	for (auto const& f: module)
+	{
+		if (f.isDeclaration())
+			continue;
+
+		for (auto const& arg: f.args())
+			if (arg.getType()->isPointerTy() && isPrecise(ptrAnalysis, &arg))
+				pruner.prunePreciseValue(&arg);
+		for (auto const& inst: instructions(f))
+			if (inst.getType()->isPointerTy() && isPrecise(ptrAnalysis, &inst))
+				pruner.prunePreciseValue(&inst);
+	}
+}
+
+}
+
 int main(int argc, char** argv)
 {
 	// Print full stack trace when crashed
@@ -20,6 +67,20 @@ int main(int argc, char** argv)
 
 	// Parse command line options
 	auto opts = CommandLineOptions(argc, argv);
+	if (opts.getSampleBurst() != 1)
+	{
+		// A burst only means something inside a sampling window. Without this check it would silently fall back to logging every hit
+		if (opts.getSampleRate() <= 1 || opts.getSampleFirst() > 0)
+		{
+			llvm::errs() << "-sample-burst requires -sample-rate and cannot be combined with -sample-first\n";
+			std::exit(-1);
+		}
+		if (opts.getSampleBurst() == 0 || opts.getSampleBurst() >= opts.getSampleRate())
+		{
+			llvm::errs() << "-sample-burst must be between 1 and the -sample-rate minus 1\n";
+			std::exit(-1);
+		}
+	}
 
 	// Read module from file
 	auto module = util::io::readModuleFromFile(opts.getInputFileName().data());
@@ -33,11 +94,34 @@ int main(int argc, char** argv)
 	if (!opts.isPrepassDisabled())
 		transform::runPrepassOn(*module);
 
+	// The static points-to sets have to be computed on the uninstrumented module
+	std::experimental::optional<StaticPtsTable> ptsTable;
+	if (opts.isOnlineVerifyEnabled())
+		ptsTable = StaticPtsTable::build(*module, opts.getPtrConfigFileName().data());
+
 	// Instrument the module
 	auto instrumenter = dynamic::MemoryInstrument();
 	instrumenter.loadExternalTable(opts.getPtrConfigFileName().data());
+	if (!opts.isPruningDisabled())
+		instrumenter.getHookPruner().pruneTrivialCopies(*module);
+	if (opts.isPrecisePruningEnabled())
+		prunePreciseValues(*module, opts.getPtrConfigFileName().data(), instrumenter.getHookPruner());
+	if (opts.getSampleFirst() > 0)
+		instrumenter.setSamplingPolicy(dynamic::SamplingPolicy::getFirstNPolicy(opts.getSampleFirst()));
+	else
+		instrumenter.setSamplingPolicy(dynamic::SamplingPolicy::getWindowPolicy(opts.getSampleRate(), opts.getSampleBurst()));
 	instrumenter.runOnModule(*module);
 
+	auto const& pruner = instrumenter.getHookPruner();
+	auto numPruned = instrumenter.getNumPrunedHooks();
+	llvm::errs() << "Inserted " << instrumenter.getNumPointerHooks() << " pointer hooks, removed " << numPruned << " (" << pruner.getNumPrunedCopies() << " trivial copies, " << pruner.getNumPrunedPreciseValues() << " precise values)\n";
+
+	if (ptsTable)
+	{
+		ptsTable->embed(*module);
+		llvm::errs() << "Embedded points-to sets of " << ptsTable->getNumCheckedSites() << " hook sites (" << ptsTable->getNumSets() << " distinct sets, " << ptsTable->getSizeInBytes() << " bytes). " << ptsTable->getNumUncheckedSites() << " sites may point to unknown memory and are not checked\n";
+	}
+
 	// Output the instrumented program
 	util::io::writeModuleToFile(*module, opts.getOutputFileName().data(), opts.isTextOutput());
 
@@ -0,0 +1,140 @@
+#include "Dynamic/Log/LogReader.h"
+#include "Dynamic/Log/MappedLogReader.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+using namespace dynamic;
+
+namespace
+{
+
+// Fold every field into a checksum so that the decoding work cannot be optimized away, and so that the readers can be cross-checked
+struct Digest
+{
+	std::size_t numRecords = 0;
+	std::uint64_t checksum = 0;
+
+	void add(const LogRecord& rec)
+	{
+		++numRecords;
+		std::uint64_t val = 0;
+		switch (rec.type)
+		{
+			case TAllocRec:
+				val = (static_cast<std::uint64_t>(rec.allocRecord.type) << 32) ^ rec.allocRecord.id ^ reinterpret_cast<std::uintptr_t>(rec.allocRecord.address) ^ (rec.allocRecord.size << 40);
+				break;
+			case TPointerRec:
+				val = rec.ptrRecord.id ^ reinterpret_cast<std::uintptr_t>(rec.ptrRecord.address);
+				break;
+			case TEnterRec:
+				val = rec.enterRecord.id;
+				break;
+			case TExitRec:
+				val = rec.exitRecord.id;
+				break;
+			case TCallRec:
+				val = rec.callRecord.id;
+				break;
+			case TFreeRec:
+				val = reinterpret_cast<std::uintptr_t>(rec.freeRecord.address);
+				break;
+			case TReallocRec:
+				val = reinterpret_cast<std::uintptr_t>(rec.reallocRecord.oldAddress) * 31 ^ reinterpret_cast<std::uintptr_t>(rec.reallocRecord.newAddress) ^ (rec.reallocRecord.newSize << 40);
+				break;
+			case TSyncRec:
+				val = rec.syncRecord.seq;
+				break;
+			case TThreadRec:
+				val = rec.threadRecord.id;
+				break;
+		}
+		checksum = (checksum ^ (val + rec.type)) * 1099511628211ull;
+	}
+};
+
+template <typename Reader>
+Digest runOnce(const char* fileName)
+{
+	Digest digest;
+	Reader::read(fileName, digest);
+	return digest;
+}
+
+struct EagerReaderDriver
+{
+	static void read(const char* fileName, Digest& digest)
+	{
+		for (auto const& rec: EagerLogReader::readLogFromFile(fileName))
+			digest.add(rec);
+	}
+};
+
+struct LazyReaderDriver
+{
+	static void read(const char* fileName, Digest& digest)
+	{
+		LazyLogReader reader(fileName);
+		while (auto rec = reader.readLogRecord())
+			digest.add(*rec);
+	}
+};
+
+struct MappedReaderDriver
+{
+	static void read(const char* fileName, Digest& digest)
+	{
+		MappedLogReader reader(fileName);
+		for (auto const& rec: reader)
+			digest.add(rec);
+	}
+};
+
+template <typename Reader>
+Digest benchmark(const char* name, const char* fileName, unsigned numRuns)
+{
+	Digest digest;
+	double best = 0;
+	for (auto i = 0u; i < numRuns; ++i)
+	{
+		auto start = std::chrono::steady_clock::now();
+		digest = runOnce<Reader>(fileName);
+		std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+		if (i == 0 || elapsed.count() < best)
+			best = elapsed.count();
+	}
+
+	std::cout << std::left << std::setw(8) << name << std::right << std::setw(12) << digest.numRecords << " records" << std::setw(12) << std::fixed << std::setprecision(2) << best << " ms";
+	if (best > 0)
+		std::cout << std::setw(12) << std::setprecision(2) << digest.numRecords / best / 1000 << " Mrec/s";
+	std::cout << '\n';
+	return digest;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	if (argc != 2 && argc != 3)
+	{
+		std::cout << "Usage: " << argv[0] << " <input log filename> [number of runs]\n\n";
+		std::exit(-1);
+	}
+
+	auto fileName = argv[1];
+	auto numRuns = argc == 3 ? std::strtoul(argv[2], nullptr, 10) : 5u;
+	if (numRuns == 0)
+		numRuns = 1;
+
+	auto eager = benchmark<EagerReaderDriver>("eager", fileName, numRuns);
+	auto lazy = benchmark<LazyReaderDriver>("lazy", fileName, numRuns);
+	auto mapped = benchmark<MappedReaderDriver>("mapped", fileName, numRuns);
+
+	if (eager.numRecords != lazy.numRecords || eager.checksum != lazy.checksum || eager.numRecords != mapped.numRecords || eager.checksum != mapped.checksum)
+	{
+		std::cerr << "Log readers disagree on the content of " << fileName << "\n";
+		std::exit(-1);
+	}
+}
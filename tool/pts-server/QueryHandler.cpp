@@ -0,0 +1,357 @@
+#include "CommandLineOptions.h"
+#include "QueryHandler.h"
+
+#include "Annotation/ModRef/ExternalModRefTable.h"
+#include "Annotation/Taint/ExternalTaintTable.h"
+#include "PointerAnalysis/Analysis/SemiSparsePointerAnalysis.h"
+#include "TaintAnalysis/Analysis/TaintAnalysis.h"
+#include "TaintAnalysis/FrontEnd/DefUseModuleBuilder.h"
+#include "Util/IO/PointerAnalysis/Printer.h"
+#include "Util/IO/WriteJson.h"
+
+#include <llvm/IR/CallSite.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/ValueSymbolTable.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+using namespace annotation;
+using namespace llvm;
+using namespace tpa;
+using namespace taint;
+using namespace util::io;
+
+const Value* QueryHandler::resolveValue(const JsonValue* ref, std::string& errMsg) const
+{
+	auto name = ref == nullptr ? nullptr : ref->getMember("name");
+	if (name == nullptr || !name->isString())
+	{
+		errMsg = "a value must be an object with a \"name\" string";
+		return nullptr;
+	}
+
+	auto funcName = ref->getMember("function");
+	if (funcName == nullptr)
+	{
+		auto value = module.getNamedValue(name->getAsString());
+		if (value == nullptr)
+			errMsg = "no global value named " + name->getAsString();
+		return value;
+	}
+
+	if (!funcName->isString())
+	{
+		errMsg = "\"function\" must be a string";
+		return nullptr;
+	}
+	auto f = module.getFunction(funcName->getAsString());
+	if (f == nullptr || f->isDeclaration())
+	{
+		errMsg = "no function defined with name " + funcName->getAsString();
+		return nullptr;
+	}
+	auto value = f->getValueSymbolTable().lookup(name->getAsString());
+	if (value == nullptr)
+		errMsg = "no value named " + name->getAsString() + " in function " + funcName->getAsString();
+	return value;
+}
+
+static bool getPtsSetOfValue(const SemiSparsePointerAnalysis& ptrAnalysis, const Value* value, PtsSet& pSet, std::string& errMsg)
+{
+	// The analysis only has pointers for values of pointer type in reachable functions
+	if (!ptrAnalysis.lookupPtsSet(value, pSet))
+	{
+		errMsg = "the analysis has no pointer for this value";
+		return false;
+	}
+	return true;
+}
+
+JsonValue QueryHandler::handlePointsTo(const JsonValue& request, std::string& errMsg) const
+{
+	auto value = resolveValue(request.getMember("value"), errMsg);
+	auto pSet = PtsSet::getEmptySet();
+	if (value == nullptr || !getPtsSetOfValue(ptrAnalysis, value, pSet, errMsg))
+		return JsonValue();
+
+	JsonValue::ArrayType objs;
+	objs.reserve(pSet.size());
+	for (auto obj: pSet)
+	{
+		std::string objStr;
+		raw_string_ostream objStream(objStr);
+		objStream << *obj;
+		objs.push_back(JsonValue::getString(objStream.str()));
+	}
+	return JsonValue::getArray(std::move(objs));
+}
+
+JsonValue QueryHandler::handleAlias(const JsonValue& request, std::string& errMsg) const
+{
+	auto a = resolveValue(request.getMember("a"), errMsg);
+	if (a == nullptr)
+		return JsonValue();
+	auto b = resolveValue(request.getMember("b"), errMsg);
+	if (b == nullptr)
+		return JsonValue();
+
+	auto pSetA = PtsSet::getEmptySet(), pSetB = PtsSet::getEmptySet();
+	if (!getPtsSetOfValue(ptrAnalysis, a, pSetA, errMsg) || !getPtsSetOfValue(ptrAnalysis, b, pSetB, errMsg))
+		return JsonValue();
+
+	switch (ptrAnalysis.alias(pSetA, pSetB))
+	{
+		case AliasResult::NoAlias:
+			return JsonValue::getString("no");
+		case AliasResult::MustAlias:
+			return JsonValue::getString("must");
+		case AliasResult::MayAlias:
+			break;
+	}
+	return JsonValue::getString("may");
+}
+
+JsonValue QueryHandler::handleCallees(const JsonValue& request, std::string& errMsg) const
+{
+	auto value = resolveValue(request.getMember("call"), errMsg);
+	if (value == nullptr)
+		return JsonValue();
+
+	ImmutableCallSite cs(value);
+	if (!cs)
+	{
+		errMsg = "the value is not a call instruction";
+		return JsonValue();
+	}
+	if (cs.getCalledFunction() == nullptr && ptrAnalysis.getPointerManager().getPointersWithValue(cs.getCalledValue()->stripPointerCasts()).empty())
+	{
+		errMsg = "the call is not reachable";
+		return JsonValue();
+	}
+
+	JsonValue::ArrayType callees;
+	for (auto f: ptrAnalysis.getCallees(cs))
+		callees.push_back(JsonValue::getString(f->getName().str()));
+	return JsonValue::getArray(std::move(callees));
+}
+
+// Return the names of the external functions the module may call that table has no entry for. These are the calls the mod/ref and taint analyses would abort on. Callees are found the same way ModRefModuleAnalysis finds them
+template <typename Table>
+static std::vector<std::string> findUnannotatedCallees(const Module& module, const SemiSparsePointerAnalysis& ptrAnalysis, const Table& table)
+{
+	std::set<std::string> missing;
+	for (auto const& f: module)
+	{
+		if (f.isDeclaration())
+			continue;
+		for (auto const& bb: f)
+		{
+			for (auto const& inst: bb)
+			{
+				ImmutableCallSite cs(&inst);
+				if (!cs)
+					continue;
+				// An indirect call the analysis never reached has no pointer for its target
+				if (cs.getCalledFunction() == nullptr && ptrAnalysis.getPointerManager().getPointersWithValue(cs.getCalledValue()->stripPointerCasts()).empty())
+					continue;
+
+				for (auto callee: ptrAnalysis.getCallees(cs))
+					if (callee->isDeclaration() && table.lookup(callee) == nullptr)
+						missing.insert(callee->getName().str());
+			}
+		}
+	}
+	return std::vector<std::string>(missing.begin(), missing.end());
+}
+
+static bool isReadableFile(const StringRef& fileName, const char* what, std::string& errMsg)
+{
+	if (::access(fileName.data(), R_OK) != 0)
+	{
+		errMsg = std::string("cannot read the ") + what + " config file " + fileName.str();
+		return false;
+	}
+	return true;
+}
+
+static std::string joinNames(const std::vector<std::string>& names)
+{
+	std::string ret;
+	for (auto const& name: names)
+	{
+		if (!ret.empty())
+			ret += ", ";
+		ret += name;
+	}
+	return ret;
+}
+
+JsonValue QueryHandler::handleTaint(std::string& errMsg)
+{
+	if (!taintResult)
+	{
+		// The analyses exit the process when a config file is missing or an external call has no annotation, which would take the server down with them. Check for both first. Nothing is cached on failure, so the query can be retried once the config files are fixed
+		if (!isReadableFile(opts.getModRefConfigFileName(), "mod/ref", errMsg) || !isReadableFile(opts.getTaintConfigFileName(), "taint", errMsg))
+			return JsonValue();
+
+		auto modRefTable = ExternalModRefTable::loadFromFile(opts.getModRefConfigFileName().data());
+		auto missingModRef = findUnannotatedCallees(module, ptrAnalysis, modRefTable);
+		if (!missingModRef.empty())
+		{
+			errMsg = "missing mod/ref annotations for " + joinNames(missingModRef);
+			return JsonValue();
+		}
+		auto taintTable = ExternalTaintTable::loadFromFile(opts.getTaintConfigFileName().data());
+		auto missingTaint = findUnannotatedCallees(module, ptrAnalysis, taintTable);
+		if (!missingTaint.empty())
+		{
+			errMsg = "missing taint annotations for " + joinNames(missingTaint);
+			return JsonValue();
+		}
+
+		DefUseModuleBuilder builder(ptrAnalysis);
+		builder.setExternalModRefTable(modRefTable);
+		auto duModule = builder.buildDefUseModule(module);
+
+		std::string report;
+		raw_string_ostream reportStream(report);
+		TaintAnalysis taintAnalysis(ptrAnalysis);
+		taintAnalysis.setExternalTaintTable(taintTable);
+		taintAnalysis.setReportStream(reportStream);
+		taintAnalysis.runOnDefUseModule(duModule);
+
+		// The report is in JSON Lines. Keep it parsed so that later queries only have to write it out
+		JsonValue::ArrayType violations;
+		SmallVector<StringRef, 16> lines;
+		StringRef(reportStream.str()).split(lines, '\n', -1, false);
+		for (auto line: lines)
+		{
+			JsonValue violation;
+			if (parseJson(line, violation))
+				violations.push_back(std::move(violation));
+		}
+		taintResult = std::make_unique<JsonValue>(JsonValue::getArray(std::move(violations)));
+	}
+	return *taintResult;
+}
+
+JsonValue QueryHandler::handleRequest(const JsonValue& request)
+{
+	JsonValue::ObjectType response;
+	if (auto id = request.getMember("id"))
+		response.emplace_back("id", *id);
+
+	std::string errMsg;
+	JsonValue result;
+	auto method = request.getMember("method");
+	if (method == nullptr || !method->isString())
+		errMsg = "a request must be an object with a \"method\" string";
+	else if (method->getAsString() == "points-to")
+		result = handlePointsTo(request, errMsg);
+	else if (method->getAsString() == "alias")
+		result = handleAlias(request, errMsg);
+	else if (method->getAsString() == "callees")
+		result = handleCallees(request, errMsg);
+	else if (method->getAsString() == "taint")
+		result = handleTaint(errMsg);
+	else if (method->getAsString() == "shutdown")
+		shutdownRequested = true;
+	else
+		errMsg = "unknown method " + method->getAsString();
+
+	if (errMsg.empty())
+		response.emplace_back("result", std::move(result));
+	else
+		response.emplace_back("error", JsonValue::getString(std::move(errMsg)));
+	return JsonValue::getObject(std::move(response));
+}
+
+void QueryHandler::handleLine(const StringRef& line, raw_ostream& os)
+{
+	if (line.trim().empty())
+		return;
+
+	JsonValue request;
+	if (!parseJson(line, request))
+	{
+		os << "{\"error\":\"malformed JSON\"}\n";
+		return;
+	}
+
+	if (request.isArray())
+	{
+		JsonValue::ArrayType responses;
+		responses.reserve(request.getAsArray().size());
+		for (auto const& elem: request.getAsArray())
+			responses.push_back(handleRequest(elem));
+		writeJsonValue(os, JsonValue::getArray(std::move(responses)));
+	}
+	else
+		writeJsonValue(os, handleRequest(request));
+	os << "\n";
+}
+
+static void rejectLongLine(raw_ostream& os)
+{
+	os << "{\"error\":\"request line too long\"}\n";
+}
+
+void serveRequests(int inFd, int outFd, QueryHandler& handler)
+{
+	raw_fd_ostream os(outFd, false);
+	std::string pending;
+	char buf[64 * 1024];
+	// Set while the rest of a line that has already been rejected is arriving
+	bool skipLine = false;
+
+	while (!handler.isShutdownRequested())
+	{
+		auto numRead = read(inFd, buf, sizeof(buf));
+		if (numRead < 0 && errno == EINTR)
+			continue;
+		if (numRead <= 0)
+			break;
+		// Everything already in pending has been searched for a newline
+		auto searchStart = pending.size();
+		pending.append(buf, numRead);
+
+		size_t lineStart = 0, lineEnd;
+		while (!handler.isShutdownRequested() && (lineEnd = pending.find('\n', std::max(lineStart, searchStart))) != std::string::npos)
+		{
+			if (skipLine)
+				skipLine = false;
+			else if (lineEnd - lineStart > maxRequestLineSize)
+				rejectLongLine(os);
+			else
+				handler.handleLine(StringRef(pending).slice(lineStart, lineEnd), os);
+			lineStart = lineEnd + 1;
+		}
+		pending.erase(0, lineStart);
+
+		if (pending.size() > maxRequestLineSize)
+		{
+			if (!skipLine)
+				rejectLongLine(os);
+			skipLine = true;
+			pending.clear();
+		}
+		os.flush();
+
+		// The client went away. There is nobody left to answer
+		if (os.has_error())
+			break;
+	}
+
+	// The last request may not end with a newline
+	if (!handler.isShutdownRequested() && !skipLine && !os.has_error())
+		handler.handleLine(pending, os);
+	os.flush();
+	os.clear_error();
+}
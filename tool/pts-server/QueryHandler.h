@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Util/IO/ReadJson.h"
+
+#include <llvm/ADT/StringRef.h>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace llvm
+{
+	class Module;
+	class raw_ostream;
+	class Value;
+}
+
+namespace tpa
+{
+	class SemiSparsePointerAnalysis;
+}
+
+class CommandLineOptions;
+
+// Longer request lines are answered with an error and dropped, so that a client that never sends a newline cannot make the server buffer without bound
+constexpr std::size_t maxRequestLineSize = 16 * 1024 * 1024;
+
+// Answers queries against a pointer analysis that has already run. The protocol is line based:
+//   - A request is one line holding a JSON object, or a JSON array of such objects for a batch. The response to a request is one line holding a JSON object, and the response to a batch is one line holding an array of responses in request order
+//   - Every request has a "method" and optionally an "id" of any type, which the response repeats. A response has either a "result" or an "error" message
+//   - A line longer than maxRequestLineSize, or one whose JSON nests deeper than util::io::maxJsonDepth, gets an error response of its own and is otherwise ignored
+//   - Values are named by {"function": "f", "name": "x"} for an argument or instruction of f, and by {"name": "g"} for a global variable or a function. Unless the prepass is disabled every instruction has a name
+// The methods are:
+//   - "points-to" with a "value": the memory objects the value may point to in any context, as strings
+//   - "alias" with values "a" and "b": "must", "may" or "no", as defined by tpa::AliasResult
+//   - "callees" with a call instruction "call": the names of the functions it may call
+//   - "taint": the sink violations of the module, in the same format as "taint-check -report". The taint analysis runs when it is first asked for. It is an error if a mod/ref or taint config file cannot be read, or if an external function the module calls has no annotation in one of them
+//   - "shutdown": no result. The server stops after answering it
+class QueryHandler
+{
+private:
+	const llvm::Module& module;
+	const tpa::SemiSparsePointerAnalysis& ptrAnalysis;
+	const CommandLineOptions& opts;
+
+	std::unique_ptr<util::io::JsonValue> taintResult;
+	bool shutdownRequested;
+
+	const llvm::Value* resolveValue(const util::io::JsonValue* ref, std::string& errMsg) const;
+
+	util::io::JsonValue handlePointsTo(const util::io::JsonValue& request, std::string& errMsg) const;
+	util::io::JsonValue handleAlias(const util::io::JsonValue& request, std::string& errMsg) const;
+	util::io::JsonValue handleCallees(const util::io::JsonValue& request, std::string& errMsg) const;
+	util::io::JsonValue handleTaint(std::string& errMsg);
+
+	util::io::JsonValue handleRequest(const util::io::JsonValue& request);
+public:
+	QueryHandler(const llvm::Module& m, const tpa::SemiSparsePointerAnalysis& p, const CommandLineOptions& o): module(m), ptrAnalysis(p), opts(o), shutdownRequested(false) {}
+
+	// Answer the request or batch on this line and write the response line to os
+	void handleLine(const llvm::StringRef& line, llvm::raw_ostream& os);
+
+	bool isShutdownRequested() const { return shutdownRequested; }
+};
+
+// Answer requests from inFd on outFd until the input ends or a shutdown is requested
+// All complete lines that arrive together are answered before the responses are flushed, so a client that pipelines its queries pays for one write per read instead of one per query
+void serveRequests(int inFd, int outFd, QueryHandler& handler);
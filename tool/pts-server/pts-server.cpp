@@ -0,0 +1,105 @@
+#include "CommandLineOptions.h"
+#include "QueryHandler.h"
+
+#include "Context/KLimitContext.h"
+#include "PointerAnalysis/Analysis/SemiSparsePointerAnalysis.h"
+#include "PointerAnalysis/FrontEnd/SemiSparseProgramBuilder.h"
+#include "Transforms/RunPrepass.h"
+#include "Util/IO/ReadIR.h"
+
+#include <llvm/IR/Module.h>
+#include <llvm/Support/PrettyStackTrace.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Support/Signals.h>
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace llvm;
+using namespace tpa;
+
+static void serveOnSocket(const StringRef& socketName, QueryHandler& handler)
+{
+	sockaddr_un addr;
+	std::memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	if (socketName.size() >= sizeof(addr.sun_path))
+	{
+		errs() << "Socket name too long: " << socketName << "\n";
+		std::exit(-1);
+	}
+	std::memcpy(addr.sun_path, socketName.data(), socketName.size());
+
+	auto listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+	unlink(addr.sun_path);
+	if (listenFd < 0 || bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || listen(listenFd, 16) < 0)
+	{
+		errs() << "Failed to listen on " << socketName << ": " << std::strerror(errno) << "\n";
+		std::exit(-1);
+	}
+	errs() << "Listening on " << socketName << "\n";
+
+	// Clients are served one at a time. Queries are cheap, and the analysis results are not safe to read from several threads while the taint analysis may be running
+	while (!handler.isShutdownRequested())
+	{
+		auto clientFd = accept(listenFd, nullptr, nullptr);
+		if (clientFd < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			errs() << "Failed to accept a connection: " << std::strerror(errno) << "\n";
+			break;
+		}
+		serveRequests(clientFd, clientFd, handler);
+		close(clientFd);
+	}
+
+	close(listenFd);
+	unlink(addr.sun_path);
+}
+
+int main(int argc, char** argv)
+{
+	// Print full stack trace when crashed
+	sys::PrintStackTraceOnErrorSignal();
+	PrettyStackTraceProgram X(argc, argv);
+
+	// Parse command line options
+	auto opts = CommandLineOptions(argc, argv);
+
+	// Read module from file
+	auto module = util::io::readModuleFromFile(opts.getInputFileName().data());
+	if (!module)
+	{
+		errs() << "Failed to read IR from " << opts.getInputFileName().data() << "\n";
+		std::exit(-2);
+	}
+
+	// Run prepasses to canonicalize the IR
+	if (!opts.isPrepassDisabled())
+		transform::runPrepassOn(*module);
+
+	// Run the pointer analysis once. Every query is answered from its results
+	context::KLimitContext::setLimit(opts.getContextSensitivity());
+	SemiSparseProgramBuilder ssProgBuilder;
+	auto ssProg = ssProgBuilder.runOnModule(*module);
+	SemiSparsePointerAnalysis ptrAnalysis;
+	ptrAnalysis.loadExternalPointerTable(opts.getPtrConfigFileName().data());
+	ptrAnalysis.runOnProgram(ssProg);
+
+	// A client that disconnects before reading its responses must not take the server down
+	std::signal(SIGPIPE, SIG_IGN);
+
+	QueryHandler handler(*module, ptrAnalysis, opts);
+	if (opts.getSocketName().empty())
+		serveRequests(STDIN_FILENO, STDOUT_FILENO, handler);
+	else
+		serveOnSocket(opts.getSocketName(), handler);
+
+	return 0;
+}
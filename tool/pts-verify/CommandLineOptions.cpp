@@ -3,13 +3,15 @@
 
 using namespace util;
 
-CommandLineOptions::CommandLineOptions(int argc, char** argv): ptrConfigFileName("ptr.config"), k(0)
+CommandLineOptions::CommandLineOptions(int argc, char** argv): ptrConfigFileName("ptr.config"), k(0), numThreads(0), segmentSize(1u << 20)
 {
 	TypedCommandLineParser cmdParser("Points-to analysis verifier");
 	cmdParser.addStringPositionalFlag("irFile", "Input LLVM bitcode file name", inputFileName);
 	cmdParser.addStringPositionalFlag("logFile", "Input dynamic log file name", inputLogName);
 	cmdParser.addStringOptionalFlag("ptr-config", "Annotation file for external library points-to analysis (default = <current dir>/ptr.config)", ptrConfigFileName);
 	cmdParser.addUIntOptionalFlag("k", "The size limit of the stack for k-CFA", k);
+	cmdParser.addUIntOptionalFlag("j", "Number of threads used to replay the log (default = 0, which means one per core)", numThreads);
+	cmdParser.addUIntOptionalFlag("segment-size", "Number of log records between two replay checkpoints (default = 1048576)", segmentSize);
 
 	cmdParser.parseCommandLineOptions(argc, argv);
 }
\ No newline at end of file
@@ -10,6 +10,9 @@ private:
 
 	llvm::StringRef ptrConfigFileName;
 	unsigned k;
+
+	unsigned numThreads;
+	unsigned segmentSize;
 public:
 	CommandLineOptions(int argc, char** argv);
 
@@ -18,4 +21,7 @@ public:
 
 	const llvm::StringRef& getPtrConfigFileName() { return ptrConfigFileName; }
 	unsigned getContextSensitivity() const { return k; }
+
+	unsigned getNumThreads() const { return numThreads; }
+	unsigned getSegmentSize() const { return segmentSize; }
 };
\ No newline at end of file
@@ -13,6 +13,10 @@
 #include <llvm/IR/Instructions.h>
 #include <llvm/Support/raw_ostream.h>
 
+#include <algorithm>
+#include <thread>
+#include <unordered_set>
+
 using namespace dynamic;
 using namespace llvm;
 using namespace util::io;
@@ -79,26 +83,17 @@ void dumpPointer(const DynamicPointer& ptr, const IDAssigner& idMap)
 	outs() << ">";
 }
 
-void dumpMemoryObject(const DynamicMemoryObject& obj, const IDAssigner& idMap)
-{
-	outs() << "[";
-	dumpPointer(obj.getAllocSite(), idMap);
-	outs() << " + ";
-	outs() << obj.getOffset() << "]";
-}
-
 void dumpDynamicPtsMap(const DynamicPointerAnalysis& dynAnalysis, const IDAssigner& idMap)
 {
-	for (auto const& mapping: dynAnalysis)
-	{
-		auto const& ptr = mapping.first;
-		auto const& obj = mapping.second;
-
-		dumpPointer(ptr, idMap);
-		outs() << "  -->>  ";
-		dumpMemoryObject(obj, idMap);
-		outs() << "\n";
-	}
+	dynAnalysis.getPointsToFacts().forEachFact(
+		[&idMap] (const DynamicPointer& ptr, const DynamicPointer& allocSite)
+		{
+			dumpPointer(ptr, idMap);
+			outs() << "  -->>  [";
+			dumpPointer(allocSite, idMap);
+			outs() << "]\n";
+		}
+	);
 }
 
 const context::Context* translateContext(const DynamicContext* dynCtx, const IDAssigner& idMap)
@@ -113,10 +108,14 @@ const context::Context* translateContext(const DynamicContext* dynCtx, const IDA
 	auto currDynCtx = dynCtx;
 	while (currDynCtx->getDepth() > 0)
 	{
-		auto csValue = idMap.getValue(currDynCtx->getCallSite());
-		assert(csValue != nullptr);
+		// The start routine of a thread is entered with call site 0, since the thread library calls it. Like main, it runs in the global context
+		if (currDynCtx->getCallSite() != 0)
+		{
+			auto csValue = idMap.getValue(currDynCtx->getCallSite());
+			assert(csValue != nullptr);
 
-		callsites.push_back(cast<Instruction>(csValue));
+			callsites.push_back(cast<Instruction>(csValue));
+		}
 		currDynCtx = DynamicContext::popContext(currDynCtx);
 	}
 
@@ -151,13 +150,13 @@ const tpa::Pointer* translatePointer(const DynamicPointer& dynPtr, const IDAssig
 	return ptr;
 }
 
-tpa::AllocSite translateMemory(const DynamicMemoryObject& dynObj, const IDAssigner& idMap)
+tpa::AllocSite translateMemory(const DynamicPointer& dynAllocSite, const IDAssigner& idMap)
 {
-	if (dynObj.getAllocSite().getID() == 0)
+	if (dynAllocSite.getID() == 0)
 		return tpa::AllocSite::getNullAllocSite();
 
-	auto ctx = translateContext(dynObj.getAllocSite().getContext(), idMap);
-	auto ptrValue = idMap.getValue(dynObj.getAllocSite().getID());
+	auto ctx = translateContext(dynAllocSite.getContext(), idMap);
+	auto ptrValue = idMap.getValue(dynAllocSite.getID());
 	assert(ptrValue != nullptr);
 
 	if (auto func = dyn_cast<Function>(ptrValue))
@@ -178,58 +177,80 @@ tpa::AllocSite translateMemory(const DynamicMemoryObject& dynObj, const IDAssign
 	}
 }
 
+using AllocSiteSet = std::unordered_set<tpa::AllocSite>;
+
 template <typename T>
-bool checkPointerAnalysis(const tpa::PointerAnalysis<T>& ptrAnalysis, const tpa::Pointer* ptr, const tpa::AllocSite& allocSite)
+bool checkPointerAnalysis(const tpa::PointerAnalysis<T>& ptrAnalysis, const tpa::Pointer* ptr, const AllocSiteSet& observedSites)
 {
 	auto pSet = ptrAnalysis.getPtsSet(ptr);
 	if (pSet.has(tpa::MemoryManager::getUniversalObject()))
 		return true;
 
+	AllocSiteSet staticSites;
 	for (auto obj: pSet)
+		staticSites.insert(obj->getAllocSite());
+
+	bool passed = true;
+	for (auto const& site: observedSites)
 	{
-		if (obj->getAllocSite() == allocSite)
-			return true;
-	}
+		if (staticSites.count(site))
+			continue;
 
-	errs() << "Unsound points-to set found\n";
-	errs() << "\tPointer: " << *ptr << "\n";
-	return false;
+		if (passed)
+		{
+			errs() << "Unsound points-to set found\n";
+			errs() << "\tPointer: " << *ptr << "\n";
+			passed = false;
+		}
+		errs() << "\tMissing: " << site << "\n";
+	}
+	return passed;
 }
 
 template <typename T>
 bool checkResult(const DynamicPointerAnalysis& dynAnalysis, const tpa::PointerAnalysis<T>& ptrAnalysis, const IDAssigner& idMap)
 {
 	bool passed = true;
-	for (auto const& mapping: dynAnalysis)
-	{
-		auto& ptr = mapping.first;
-		auto& obj = mapping.second;
 
-		auto tpaPtr = translatePointer(ptr, idMap, ptrAnalysis.getPointerManager());
-		if (tpaPtr == nullptr)
+	// Translate every observed fact first. Different dynamic pointers may map to the same static pointer, so grouping them lets each points-to set be fetched and checked only once
+	std::unordered_map<const tpa::Pointer*, AllocSiteSet> observedMap;
+	const DynamicPointer* lastPtr = nullptr;
+	const tpa::Pointer* lastTpaPtr = nullptr;
+	dynAnalysis.getPointsToFacts().forEachFact(
+		[&] (const DynamicPointer& ptr, const DynamicPointer& allocSite)
 		{
-			passed = false;
-			continue;
+			// Facts of the same pointer come in a row, so each pointer is translated once
+			if (lastPtr == nullptr || *lastPtr != ptr)
+			{
+				lastPtr = &ptr;
+				lastTpaPtr = translatePointer(ptr, idMap, ptrAnalysis.getPointerManager());
+				if (lastTpaPtr == nullptr)
+					passed = false;
+			}
+			if (lastTpaPtr != nullptr)
+				observedMap[lastTpaPtr].insert(translateMemory(allocSite, idMap));
 		}
+	);
 
-		auto tpaAllocSite = translateMemory(obj, idMap);
-
-		passed &= checkPointerAnalysis(ptrAnalysis, tpaPtr, tpaAllocSite);
-	}
+	for (auto const& mapping: observedMap)
+		passed &= checkPointerAnalysis(ptrAnalysis, mapping.first, mapping.second);
 
 	return passed;
 }
 
 }
 
-bool runAnalysisOnModule(const Module& module, const char* logName, const char* configName, unsigned k)
+bool runAnalysisOnModule(const Module& module, const char* logName, const char* configName, unsigned k, unsigned numThreads, unsigned segmentSize)
 {
 	outs() << "Step1> Rebuilding ID map from the input module...\n\n";
 	auto idMap = IDAssigner(module);
 
-	outs() << "Step2> Running dynamic analysis on log " << logName << "...\n\n";
+	if (numThreads == 0)
+		numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+	outs() << "Step2> Running dynamic analysis on log " << logName << " with " << numThreads << " thread(s)...\n\n";
 	auto dynAnalysis = DynamicPointerAnalysis(logName);
-	dynAnalysis.process();
+	dynAnalysis.processParallel(numThreads, segmentSize);
+	outs() << "Observed " << dynAnalysis.getPointsToFacts().size() << " distinct points-to facts\n\n";
 	//dumpDynamicPtsMap(dynAnalysis, idMap);
 
 	outs() << "Step3> Running pointer analysis with k=" << k << " ...\n\n";
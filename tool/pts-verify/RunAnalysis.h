@@ -6,4 +6,4 @@ namespace llvm
 }
 
 // Return true if all test passed
-bool runAnalysisOnModule(const llvm::Module&, const char*, const char*, unsigned);
\ No newline at end of file
+bool runAnalysisOnModule(const llvm::Module&, const char*, const char*, unsigned, unsigned, unsigned);
\ No newline at end of file
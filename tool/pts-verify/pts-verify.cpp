@@ -28,7 +28,7 @@ int main(int argc, char** argv)
 	}
 
 	// Run the analysis
-	bool succ = runAnalysisOnModule(*module, opts.getInputLogName().data(), opts.getPtrConfigFileName().data(), opts.getContextSensitivity());
+	bool succ = runAnalysisOnModule(*module, opts.getInputLogName().data(), opts.getPtrConfigFileName().data(), opts.getContextSensitivity(), opts.getNumThreads(), opts.getSegmentSize());
 
 	if (succ)
 		outs() << "Congratulations! All tests passed.\n";
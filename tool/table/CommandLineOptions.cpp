@@ -3,11 +3,12 @@
 
 using namespace util;
 
-CommandLineOptions::CommandLineOptions(int argc, char** argv)
+CommandLineOptions::CommandLineOptions(int argc, char** argv): compileFlag(false)
 {
 	TypedCommandLineParser cmdParser("Annotation pretty printer");
 	cmdParser.addStringPositionalFlag("inputType", "Type of the input annotation (choices: ptr, modref, taint)", inputFileType);
 	cmdParser.addStringPositionalFlag("inputFile", "Input annotation file name", inputFileName);
+	cmdParser.addBooleanOptionalFlag("compile", "Compile the input into a binary annotation database <inputFile>.db instead of printing it", compileFlag);
 
 	cmdParser.parseCommandLineOptions(argc, argv);
 }
\ No newline at end of file
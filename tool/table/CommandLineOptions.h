@@ -7,9 +7,11 @@ class CommandLineOptions
 private:
 	llvm::StringRef inputFileType;
 	llvm::StringRef inputFileName;
+	bool compileFlag;
 public:
 	CommandLineOptions(int argc, char** argv);
 
 	const llvm::StringRef& getInputFileType() const { return inputFileType; }
 	const llvm::StringRef& getInputFileName() const { return inputFileName; }
+	bool isCompileEnabled() const { return compileFlag; }
 };
@@ -62,26 +62,28 @@ static void printRefEffects(raw_ostream& os, const ModRefEffectSummary& summary)
 void ExternalModRefTablePrinter::printTable(const ExternalModRefTable& table)
 {
 	os << "\n----- ExternalModRefTable -----\n";
-	for (auto const& mapping: table)
-	{
-		os.resetColor();
+	table.forEachSummary(
+		[this] (const StringRef& name, const ModRefEffectSummary& summary)
+		{
+			os.resetColor();
 
-		os << "Function ";
-		os.changeColor(raw_ostream::GREEN);
-		os << mapping.first << ":\n";
+			os << "Function ";
+			os.changeColor(raw_ostream::GREEN);
+			os << name << ":\n";
 		
-		if (mapping.second.empty())
-		{
-			os.changeColor(raw_ostream::RED);
-			os << "  Ignored\n";
-			continue;
-		}
+			if (summary.empty())
+			{
+				os.changeColor(raw_ostream::RED);
+				os << "  Ignored\n";
+				return;
+			}
 
-		os.changeColor(raw_ostream::MAGENTA);
-		printModEffects(os, mapping.second);
-		os.changeColor(raw_ostream::YELLOW);
-		printRefEffects(os, mapping.second);
-	}
+			os.changeColor(raw_ostream::MAGENTA);
+			printModEffects(os, summary);
+			os.changeColor(raw_ostream::YELLOW);
+			printRefEffects(os, summary);
+		}
+	);
 
 	os.resetColor();
 	os << "--------- End of Table ---------\n\n";
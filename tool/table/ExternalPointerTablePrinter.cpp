@@ -113,25 +113,27 @@ static void printPointerEffect(raw_ostream& os, const PointerEffect& effect)
 void ExternalPointerTablePrinter::printTable(const ExternalPointerTable& table)
 {
 	os << "\n----- ExternalPointerTable -----\n";
-	for (auto const& mapping: table)
-	{
-		os.resetColor();
+	table.forEachSummary(
+		[this] (const StringRef& name, const PointerEffectSummary& summary)
+		{
+			os.resetColor();
 
-		os << "Function ";
-		os.changeColor(raw_ostream::GREEN);
-		os << mapping.first << ":\n";
+			os << "Function ";
+			os.changeColor(raw_ostream::GREEN);
+			os << name << ":\n";
 		
-		if (mapping.second.empty())
-		{
-			os.changeColor(raw_ostream::RED);
-			os << "  Ignored\n";
-			continue;
-		}
+			if (summary.empty())
+			{
+				os.changeColor(raw_ostream::RED);
+				os << "  Ignored\n";
+				return;
+			}
 
-		os.changeColor(raw_ostream::YELLOW);
-		for (auto const& effect: mapping.second)
-			printPointerEffect(os, effect);
-	}
+			os.changeColor(raw_ostream::YELLOW);
+			for (auto const& effect: summary)
+				printPointerEffect(os, effect);
+		}
+	);
 
 	os.resetColor();
 	os << "--------- End of Table ---------\n\n";
@@ -94,24 +94,26 @@ static void printTEntry(raw_ostream& os, const TaintEntry& entry)
 void ExternalTaintTablePrinter::printTable(const ExternalTaintTable& table) const
 {
 	os << "\n----- ExternalTaintTable -----\n";
-	for (auto const& mapping: table)
-	{
-		os.resetColor();
+	table.forEachSummary(
+		[this] (const StringRef& name, const TaintSummary& summary)
+		{
+			os.resetColor();
 
-		os << "Function ";
-		os.changeColor(raw_ostream::GREEN);
-		os << mapping.first << ":\n";
+			os << "Function ";
+			os.changeColor(raw_ostream::GREEN);
+			os << name << ":\n";
 		
-		if (mapping.second.empty())
-		{
-			os.changeColor(raw_ostream::RED);
-			os << "  Ignored\n";
-			continue;
-		}
+			if (summary.empty())
+			{
+				os.changeColor(raw_ostream::RED);
+				os << "  Ignored\n";
+				return;
+			}
 
-		for (auto const& entry: mapping.second)
-			printTEntry(os, entry);
-	}
+			for (auto const& entry: summary)
+				printTEntry(os, entry);
+		}
+	);
 
 	os.resetColor();
 	os << "---------- End of Table ---------\n";
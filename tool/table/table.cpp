@@ -3,6 +3,7 @@
 #include "TablePrinter/ExternalPointerTablePrinter.h"
 #include "TablePrinter/ExternalTaintTablePrinter.h"
 
+#include "Annotation/AnnotationDatabase.h"
 #include "Annotation/Pointer/ExternalPointerTable.h"
 #include "Annotation/ModRef/ExternalModRefTable.h"
 #include "Annotation/Taint/ExternalTaintTable.h"
@@ -20,6 +21,25 @@ void printTable(const StringRef& fileName)
 	PrinterType(outs()).printTable(table);
 }
 
+template <typename PrinterType>
+void compileTable(const StringRef& fileName)
+{
+	using TableType = typename PrinterType::TableType;
+	auto table = TableType::loadFromFile(fileName.data());
+	auto dbName = getAnnotationDatabaseName(fileName);
+	table.writeDatabase(dbName.data());
+	outs() << "Wrote " << table.size() << " entries to " << dbName << "\n";
+}
+
+template <typename PrinterType>
+void processTable(const CommandLineOptions& opts)
+{
+	if (opts.isCompileEnabled())
+		compileTable<PrinterType>(opts.getInputFileName());
+	else
+		printTable<PrinterType>(opts.getInputFileName());
+}
+
 int main(int argc, char** argv)
 {
 	// Parse command line options
@@ -27,11 +47,11 @@ int main(int argc, char** argv)
 
 	auto typeStr = opts.getInputFileType();
 	if (typeStr == "ptr")
-		printTable<ExternalPointerTablePrinter>(opts.getInputFileName());
+		processTable<ExternalPointerTablePrinter>(opts);
 	else if (typeStr == "modref")
-		printTable<ExternalModRefTablePrinter>(opts.getInputFileName());
+		processTable<ExternalModRefTablePrinter>(opts);
 	else if (typeStr == "taint")
-		printTable<ExternalTaintTablePrinter>(opts.getInputFileName());
+		processTable<ExternalTaintTablePrinter>(opts);
 	else
 	{
 		outs() << "Unknown annotation file type: " << typeStr << "\n";
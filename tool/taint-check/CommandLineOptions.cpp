@@ -3,15 +3,20 @@
 
 using namespace util;
 
-CommandLineOptions::CommandLineOptions(int argc, char** argv): ptrConfigFileName("ptr.config"), modRefConfigFileName("modref.config"), taintConfigFileName("taint.config"), k(0)
+CommandLineOptions::CommandLineOptions(int argc, char** argv): ptrConfigFileName("ptr.config"), modRefConfigFileName("modref.config"), taintConfigFileName("taint.config"), k(0), statsFlag(false)
 {
 	TypedCommandLineParser cmdParser("Points-to analysis verifier");
 	cmdParser.addStringPositionalFlag("irFile", "Input LLVM bitcode file name", inputFileName);
 	cmdParser.addStringOptionalFlag("ptr-config", "Annotation file for external library points-to analysis (default = <current dir>/ptr.config)", ptrConfigFileName);
 	cmdParser.addStringOptionalFlag("modref-config", "Annotation file for external library mod/ref analysis (default = <current dir>/modref.config)", modRefConfigFileName);
 	cmdParser.addStringOptionalFlag("taint-config", "Annotation file for external library taint analysis (default = <current dir>/taint.config)", taintConfigFileName);
+	cmdParser.addStringOptionalFlag("cache", "Reuse and update the analysis results stored in this file, re-analyzing only functions that changed since the last run", cacheFileName);
+	cmdParser.addBooleanOptionalFlag("cache-rebuild", "Ignore the results stored in the -cache file and overwrite them with those of a full run", rebuildCacheFlag);
+	cmdParser.addStringOptionalFlag("report", "Write sink violations to this file as JSON Lines (one object per violation, \"-\" for stdout) instead of printing them", reportFileName);
 	cmdParser.addUIntOptionalFlag("k", "The size limit of the stack for k-CFA", k);
 	cmdParser.addBooleanOptionalFlag("no-prepass", "Do no run IR cannonicalization before the analysis", noPrepassFlag);
+	cmdParser.addBooleanOptionalFlag("stats", "Print the time, memory usage and object counts of every phase of the analysis to stderr", statsFlag);
+	cmdParser.addStringOptionalFlag("stats-json", "Write the statistics of -stats to this file as JSON (\"-\" for stdout)", statsFileName);
 
 	cmdParser.parseCommandLineOptions(argc, argv);
 }
\ No newline at end of file
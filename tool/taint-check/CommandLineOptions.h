@@ -10,8 +10,14 @@ private:
 	llvm::StringRef ptrConfigFileName;
 	llvm::StringRef modRefConfigFileName;
 	llvm::StringRef taintConfigFileName;
+	llvm::StringRef cacheFileName;
+	bool rebuildCacheFlag;
+	llvm::StringRef reportFileName;
 	bool noPrepassFlag;
 	unsigned k;
+
+	bool statsFlag;
+	llvm::StringRef statsFileName;
 public:
 	CommandLineOptions(int argc, char** argv);
 
@@ -20,6 +26,12 @@ public:
 	const llvm::StringRef& getPtrConfigFileName() const { return ptrConfigFileName; }
 	const llvm::StringRef& getModRefConfigFileName() const { return modRefConfigFileName; }
 	const llvm::StringRef& getTaintConfigFileName() const { return taintConfigFileName; }
+	const llvm::StringRef& getCacheFileName() const { return cacheFileName; }
+	bool isCacheRebuildEnabled() const { return rebuildCacheFlag; }
+	const llvm::StringRef& getReportFileName() const { return reportFileName; }
 	bool isPrepassDisabled() const { return noPrepassFlag; }
 	unsigned getContextSensitivity() const { return k; }
+
+	bool isStatsEnabled() const { return statsFlag; }
+	const llvm::StringRef& getStatsFileName() const { return statsFileName; }
 };
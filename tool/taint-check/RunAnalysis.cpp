@@ -6,6 +6,7 @@
 #include "PointerAnalysis/FrontEnd/SemiSparseProgramBuilder.h"
 #include "TaintAnalysis/Analysis/TaintAnalysis.h"
 #include "TaintAnalysis/FrontEnd/DefUseModuleBuilder.h"
+#include "Util/Statistics/PhaseStatistics.h"
 
 #include <llvm/IR/Function.h>
 #include <llvm/IR/Module.h>
@@ -14,23 +15,42 @@ using namespace context;
 using namespace llvm;
 using namespace tpa;
 using namespace taint;
+using namespace util;
 
-bool runAnalysisOnModule(const Module& module, const CommandLineOptions& opts)
+bool runAnalysisOnModule(const Module& module, const CommandLineOptions& opts, PhaseStatistics& stats)
 {
 	KLimitContext::setLimit(opts.getContextSensitivity());
 
+	SemiSparsePointerAnalysis ptrAnalysis;
+	DefUseModuleBuilder builder(ptrAnalysis);
+	TaintAnalysis taintAnalysis(ptrAnalysis);
+
+	stats.beginPhase("load annotations");
+	ptrAnalysis.loadExternalPointerTable(opts.getPtrConfigFileName().data());
+	builder.loadExternalModRefTable(opts.getModRefConfigFileName().data());
+	taintAnalysis.loadExternalTaintTable(opts.getTaintConfigFileName().data());
+	stats.endPhase();
+
+	stats.beginPhase("build semi-sparse program");
 	SemiSparseProgramBuilder ssProgBuilder;
 	auto ssProg = ssProgBuilder.runOnModule(module);
+	stats.endPhase();
 
-	SemiSparsePointerAnalysis ptrAnalysis;
-	ptrAnalysis.loadExternalPointerTable(opts.getPtrConfigFileName().data());
+	ptrAnalysis.setPhaseStatistics(stats);
 	ptrAnalysis.runOnProgram(ssProg);
 
-	DefUseModuleBuilder builder(ptrAnalysis);
-	builder.loadExternalModRefTable(opts.getModRefConfigFileName().data());
+	stats.beginPhase("build def-use module");
 	auto duModule = builder.buildDefUseModule(module);
-
-	TaintAnalysis taintAnalysis(ptrAnalysis);
-	taintAnalysis.loadExternalTaintTable(opts.getTaintConfigFileName().data());
-	return taintAnalysis.runOnDefUseModule(duModule);
+	stats.endPhase();
+
+	if (!opts.getCacheFileName().empty())
+		taintAnalysis.enableIncrementalMode(opts.getCacheFileName().data(), { opts.getPtrConfigFileName(), opts.getModRefConfigFileName(), opts.getTaintConfigFileName() }, opts.isCacheRebuildEnabled());
+	if (!opts.getReportFileName().empty())
+		taintAnalysis.setReportFile(opts.getReportFileName().data());
+
+	stats.beginPhase("taint analysis");
+	auto succ = taintAnalysis.runOnDefUseModule(duModule);
+	stats.endPhase();
+	stats.addCounter("iterations", taintAnalysis.getNumIterations());
+	return succ;
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #include "Transforms/RunPrepass.h"
 #include "Util/IO/ReadIR.h"
+#include "Util/Statistics/PhaseStatistics.h"
 
 #include <llvm/IR/Module.h>
 #include <llvm/Support/PrettyStackTrace.h>
@@ -19,26 +20,45 @@ int main(int argc, char** argv)
 
 	// Parse command line options
 	auto opts = CommandLineOptions(argc, argv);
+	if (opts.getReportFileName() == "-" && opts.getStatsFileName() == "-")
+	{
+		errs() << "-report and -stats-json cannot both write to stdout\n";
+		std::exit(-1);
+	}
+
+	util::PhaseStatistics stats;
 
 	// Read module from file
+	stats.beginPhase("read IR");
 	auto module = util::io::readModuleFromFile(opts.getInputFileName().data());
 	if (!module)
 	{
 		errs() << "Failed to read IR from " << opts.getInputFileName().data() << "\n";
 		std::exit(-2);
 	}
+	stats.endPhase();
 
 	// Run prepasses to canonicalize the IR
 	if (!opts.isPrepassDisabled())
+	{
+		util::ScopedPhase phase(&stats, "prepass");
 		transform::runPrepassOn(*module);
+	}
 
 	// Run the analysis
-	bool succ = runAnalysisOnModule(*module, opts);
+	bool succ = runAnalysisOnModule(*module, opts, stats);
+
+	if (opts.isStatsEnabled())
+		stats.print(errs());
+	if (!opts.getStatsFileName().empty())
+		stats.writeJsonToFile(opts.getStatsFileName().data());
 
+	// Keep stdout parseable when the report or the statistics go there
+	auto& resultStream = (opts.getReportFileName() == "-" || opts.getStatsFileName() == "-") ? errs() : outs();
 	if (succ)
-		outs() << "Congratulations! Taint check passed.\n";
+		resultStream << "Congratulations! Taint check passed.\n";
 	else
-		outs() << "Taint check failed\n";
+		resultStream << "Taint check failed\n";
 
 	return succ ? 0: -3;
 }
\ No newline at end of file
@@ -0,0 +1,279 @@
+#include "BenchmarkCorpus.h"
+
+#include <llvm/Support/raw_ostream.h>
+
+using namespace llvm;
+
+namespace
+{
+
+// Declarations of the library functions that the generated modules call. All of them are covered by the annotation files under config/
+const char* libraryDecls =
+	"declare i8* @malloc(i64)\n"
+	"declare i8* @memcpy(i8*, i8*, i64)\n"
+	"declare i8* @fgets(i8*, i32, i8*)\n"
+	"declare i32 @printf(i8*, ...)\n"
+	"declare void @exit(i32)\n";
+
+std::string generateCallChain(unsigned scale)
+{
+	auto depth = 256 * scale;
+
+	std::string assembly;
+	raw_string_ostream os(assembly);
+	os << libraryDecls;
+
+	for (auto i = 0u; i < depth; ++i)
+	{
+		os << "define i8* @chain" << i << "(i8* %p, i8* %q) {\n";
+		os << "entry:\n";
+		if (i + 1 < depth)
+		{
+			os << "  %a = call i8* @chain" << (i + 1) << "(i8* %p, i8* %q)\n";
+			os << "  %b = call i8* @chain" << (i + 1) << "(i8* %q, i8* %a)\n";
+			os << "  ret i8* %b\n";
+		}
+		else
+		{
+			os << "  %m = call i8* @malloc(i64 16)\n";
+			os << "  %mp = bitcast i8* %m to i8**\n";
+			os << "  store i8* %p, i8** %mp\n";
+			os << "  %l = load i8*, i8** %mp\n";
+			os << "  ret i8* %l\n";
+		}
+		os << "}\n";
+	}
+
+	os << "define i32 @main() {\n";
+	os << "entry:\n";
+	os << "  %buf = call i8* @malloc(i64 64)\n";
+	os << "  %s = call i8* @fgets(i8* %buf, i32 64, i8* null)\n";
+	os << "  %other = call i8* @malloc(i64 64)\n";
+	os << "  %r = call i8* @chain0(i8* %buf, i8* %other)\n";
+	os << "  %x = call i32 (i8*, ...) @printf(i8* %r)\n";
+	os << "  ret i32 0\n";
+	os << "}\n";
+
+	return os.str();
+}
+
+std::string generateBigStruct(unsigned scale)
+{
+	auto numFields = 128 * scale;
+
+	std::string assembly;
+	raw_string_ostream os(assembly);
+	os << libraryDecls;
+
+	os << "%struct.big = type { ";
+	for (auto i = 0u; i < numFields; ++i)
+		os << (i == 0 ? "" : ", ") << "i8*";
+	os << " }\n";
+	os << "@gbig = global %struct.big zeroinitializer\n";
+
+	os << "define i32 @main() {\n";
+	os << "entry:\n";
+	os << "  %s = alloca %struct.big\n";
+	for (auto i = 0u; i < numFields; ++i)
+	{
+		os << "  %m" << i << " = call i8* @malloc(i64 8)\n";
+		os << "  %f" << i << " = getelementptr inbounds %struct.big, %struct.big* %s, i64 0, i32 " << i << "\n";
+		os << "  store i8* %m" << i << ", i8** %f" << i << "\n";
+	}
+	os << "  %src = bitcast %struct.big* %s to i8*\n";
+	os << "  %dst = bitcast %struct.big* @gbig to i8*\n";
+	os << "  %c = call i8* @memcpy(i8* %dst, i8* %src, i64 " << numFields * 8 << ")\n";
+	for (auto i = 0u; i < numFields; ++i)
+	{
+		os << "  %g" << i << " = getelementptr inbounds %struct.big, %struct.big* @gbig, i64 0, i32 " << i << "\n";
+		os << "  %l" << i << " = load i8*, i8** %g" << i << "\n";
+	}
+	os << "  %s0 = call i8* @fgets(i8* %l0, i32 8, i8* null)\n";
+	os << "  %x = call i32 (i8*, ...) @printf(i8* %l" << (numFields - 1) << ")\n";
+	os << "  ret i32 0\n";
+	os << "}\n";
+
+	return os.str();
+}
+
+std::string generateFunctionPointerTable(unsigned scale)
+{
+	auto numHandlers = 64 * scale;
+
+	std::string assembly;
+	raw_string_ostream os(assembly);
+	os << libraryDecls;
+
+	std::string tableType;
+	raw_string_ostream(tableType) << "[" << numHandlers << " x i8* (i8*)*]";
+
+	os << "@table = global " << tableType << " [";
+	for (auto i = 0u; i < numHandlers; ++i)
+		os << (i == 0 ? "" : ", ") << "i8* (i8*)* @handler" << i;
+	os << "]\n";
+
+	// Half of the handlers pass their argument through, the other half wrap it in a fresh heap cell
+	for (auto i = 0u; i < numHandlers; ++i)
+	{
+		os << "define i8* @handler" << i << "(i8* %p) {\n";
+		os << "entry:\n";
+		if (i % 2 == 0)
+			os << "  ret i8* %p\n";
+		else
+		{
+			os << "  %m = call i8* @malloc(i64 8)\n";
+			os << "  %mp = bitcast i8* %m to i8**\n";
+			os << "  store i8* %p, i8** %mp\n";
+			os << "  ret i8* %m\n";
+		}
+		os << "}\n";
+	}
+
+	os << "define i32 @main() {\n";
+	os << "entry:\n";
+	os << "  %buf = call i8* @malloc(i64 64)\n";
+	os << "  %s = call i8* @fgets(i8* %buf, i32 64, i8* null)\n";
+	os << "  br label %loop\n";
+	os << "loop:\n";
+	os << "  %i = phi i64 [ 0, %entry ], [ %inext, %loop ]\n";
+	os << "  %p = phi i8* [ %buf, %entry ], [ %r, %loop ]\n";
+	os << "  %slot = getelementptr inbounds " << tableType << ", " << tableType << "* @table, i64 0, i64 %i\n";
+	os << "  %fp = load i8* (i8*)*, i8* (i8*)** %slot\n";
+	os << "  %r = call i8* %fp(i8* %p)\n";
+	os << "  %inext = add i64 %i, 1\n";
+	os << "  %done = icmp eq i64 %inext, " << numHandlers << "\n";
+	os << "  br i1 %done, label %exit, label %loop\n";
+	os << "exit:\n";
+	os << "  %x = call i32 (i8*, ...) @printf(i8* %r)\n";
+	os << "  ret i32 0\n";
+	os << "}\n";
+
+	return os.str();
+}
+
+std::string generatePhiLoop(unsigned scale)
+{
+	auto numPhis = 64 * scale;
+
+	std::string assembly;
+	raw_string_ostream os(assembly);
+	os << libraryDecls;
+
+	os << "define i32 @main() {\n";
+	os << "entry:\n";
+	os << "  %cell = alloca i8*\n";
+	for (auto i = 0u; i < numPhis; ++i)
+		os << "  %o" << i << " = call i8* @malloc(i64 8)\n";
+	os << "  br label %loop\n";
+
+	// Every phi takes the value of its neighbour on the back edge, so it takes numPhis iterations for each of them to see every object
+	os << "loop:\n";
+	os << "  %i = phi i32 [ 0, %entry ], [ %inext, %latch ]\n";
+	for (auto i = 0u; i < numPhis; ++i)
+		os << "  %p" << i << " = phi i8* [ %o" << i << ", %entry ], [ %p" << (i + 1) % numPhis << ", %latch ]\n";
+	os << "  store i8* %p0, i8** %cell\n";
+	os << "  %odd = trunc i32 %i to i1\n";
+	os << "  br i1 %odd, label %reload, label %latch\n";
+	os << "reload:\n";
+	os << "  %l = load i8*, i8** %cell\n";
+	os << "  br label %latch\n";
+	os << "latch:\n";
+	os << "  %q = phi i8* [ %l, %reload ], [ %p1, %loop ]\n";
+	os << "  store i8* %q, i8** %cell\n";
+	os << "  %inext = add i32 %i, 1\n";
+	os << "  %done = icmp eq i32 %inext, 1000\n";
+	os << "  br i1 %done, label %exit, label %loop\n";
+	os << "exit:\n";
+	os << "  %r = load i8*, i8** %cell\n";
+	os << "  %s = call i8* @fgets(i8* %r, i32 8, i8* null)\n";
+	os << "  %x = call i32 (i8*, ...) @printf(i8* %p" << numPhis - 1 << ")\n";
+	os << "  ret i32 0\n";
+	os << "}\n";
+
+	return os.str();
+}
+
+std::string generateHeapWrapper(unsigned scale)
+{
+	auto numNodes = 128 * scale;
+
+	std::string assembly;
+	raw_string_ostream os(assembly);
+	os << libraryDecls;
+
+	os << "%struct.node = type { %struct.node*, i8* }\n";
+
+	os <<
+		"define i8* @xmalloc(i64 %n) {\n"
+		"entry:\n"
+		"  %m = call i8* @malloc(i64 %n)\n"
+		"  %isnull = icmp eq i8* %m, null\n"
+		"  br i1 %isnull, label %fail, label %ok\n"
+		"fail:\n"
+		"  call void @exit(i32 1)\n"
+		"  unreachable\n"
+		"ok:\n"
+		"  ret i8* %m\n"
+		"}\n"
+		"define i8* @xcalloc(i64 %n) {\n"
+		"entry:\n"
+		"  %m = call i8* @xmalloc(i64 %n)\n"
+		"  ret i8* %m\n"
+		"}\n"
+		"define %struct.node* @node_new(%struct.node* %next, i8* %data) {\n"
+		"entry:\n"
+		"  %m = call i8* @xcalloc(i64 16)\n"
+		"  %n = bitcast i8* %m to %struct.node*\n"
+		"  %nf = getelementptr inbounds %struct.node, %struct.node* %n, i64 0, i32 0\n"
+		"  store %struct.node* %next, %struct.node** %nf\n"
+		"  %df = getelementptr inbounds %struct.node, %struct.node* %n, i64 0, i32 1\n"
+		"  store i8* %data, i8** %df\n"
+		"  ret %struct.node* %n\n"
+		"}\n"
+		"define i8* @list_last_data(%struct.node* %head) {\n"
+		"entry:\n"
+		"  br label %loop\n"
+		"loop:\n"
+		"  %cur = phi %struct.node* [ %head, %entry ], [ %next, %body ]\n"
+		"  %df = getelementptr inbounds %struct.node, %struct.node* %cur, i64 0, i32 1\n"
+		"  %d = load i8*, i8** %df\n"
+		"  %nf = getelementptr inbounds %struct.node, %struct.node* %cur, i64 0, i32 0\n"
+		"  %next = load %struct.node*, %struct.node** %nf\n"
+		"  %end = icmp eq %struct.node* %next, null\n"
+		"  br i1 %end, label %exit, label %body\n"
+		"body:\n"
+		"  br label %loop\n"
+		"exit:\n"
+		"  ret i8* %d\n"
+		"}\n";
+
+	os << "define i32 @main() {\n";
+	os << "entry:\n";
+	os << "  %buf = call i8* @xmalloc(i64 64)\n";
+	os << "  %s = call i8* @fgets(i8* %buf, i32 64, i8* null)\n";
+	os << "  %n0 = call %struct.node* @node_new(%struct.node* null, i8* %buf)\n";
+	for (auto i = 1u; i < numNodes; ++i)
+	{
+		os << "  %d" << i << " = call i8* @xcalloc(i64 8)\n";
+		os << "  %n" << i << " = call %struct.node* @node_new(%struct.node* %n" << (i - 1) << ", i8* %d" << i << ")\n";
+	}
+	os << "  %last = call i8* @list_last_data(%struct.node* %n" << (numNodes - 1) << ")\n";
+	os << "  %x = call i32 (i8*, ...) @printf(i8* %last)\n";
+	os << "  ret i32 0\n";
+	os << "}\n";
+
+	return os.str();
+}
+
+}
+
+std::vector<BenchmarkCase> generateCorpus(unsigned scale)
+{
+	std::vector<BenchmarkCase> corpus;
+	corpus.push_back(BenchmarkCase{ "call-chain", "", generateCallChain(scale) });
+	corpus.push_back(BenchmarkCase{ "big-struct", "", generateBigStruct(scale) });
+	corpus.push_back(BenchmarkCase{ "fptr-table", "", generateFunctionPointerTable(scale) });
+	corpus.push_back(BenchmarkCase{ "phi-loop", "", generatePhiLoop(scale) });
+	corpus.push_back(BenchmarkCase{ "heap-wrapper", "", generateHeapWrapper(scale) });
+	return corpus;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// A module for the benchmark harness. Generated cases carry their assembly, cases read from disk carry a file name and no assembly
+struct BenchmarkCase
+{
+	std::string name;
+	std::string fileName;
+	std::string assembly;
+
+	bool isGenerated() const { return fileName.empty(); }
+};
+
+// Build the generated part of the corpus. Each case stresses one shape that real programs are made of, and its size grows linearly with scale:
+//   - call-chain: a deep chain of functions, each calling the next from two call sites
+//   - big-struct: a struct with many pointer fields, filled field by field and copied with memcpy
+//   - fptr-table: a global table of function pointers, dispatched through in a loop
+//   - phi-loop: a loop header with many pointer phis that rotate their values every iteration
+//   - heap-wrapper: a linked list whose nodes come from several layers of malloc wrappers
+std::vector<BenchmarkCase> generateCorpus(unsigned scale);
@@ -0,0 +1,21 @@
+#include "CommandLineOptions.h"
+#include "Util/CommandLine/TypedCommandLineParser.h"
+
+using namespace util;
+
+CommandLineOptions::CommandLineOptions(int argc, char** argv): outputFileName(""), corpusFileName(""), emitDirName(""), filter(""), ptrConfigFileName("ptr.config"), modRefConfigFileName("modref.config"), taintConfigFileName("taint.config"), noPrepassFlag(false), k(0), scale(1)
+{
+	TypedCommandLineParser cmdParser("Benchmark harness for the pointer and taint analysis engines");
+	cmdParser.addStringOptionalFlag("o", "File where the JSON results are written (default = stdout)", outputFileName);
+	cmdParser.addStringOptionalFlag("corpus", "File that lists LLVM bitcode files to benchmark in addition to the generated modules, one per line. Empty lines and lines starting with '#' are ignored", corpusFileName);
+	cmdParser.addStringOptionalFlag("emit-corpus", "Write the generated modules as .ll files into the given directory and exit", emitDirName);
+	cmdParser.addStringOptionalFlag("filter", "Only run the cases whose name contains the given string", filter);
+	cmdParser.addStringOptionalFlag("ptr-config", "Annotation file for external library points-to analysis (default = <current dir>/ptr.config)", ptrConfigFileName);
+	cmdParser.addStringOptionalFlag("modref-config", "Annotation file for external library mod/ref analysis (default = <current dir>/modref.config)", modRefConfigFileName);
+	cmdParser.addStringOptionalFlag("taint-config", "Annotation file for external library taint analysis (default = <current dir>/taint.config)", taintConfigFileName);
+	cmdParser.addUIntOptionalFlag("k", "The size limit of the stack for k-CFA", k);
+	cmdParser.addUIntOptionalFlag("scale", "Size multiplier of the generated modules (default = 1)", scale);
+	cmdParser.addBooleanOptionalFlag("no-prepass", "Do no run IR cannonicalization before the analysis", noPrepassFlag);
+
+	cmdParser.parseCommandLineOptions(argc, argv);
+}
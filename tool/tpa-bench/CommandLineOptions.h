@@ -0,0 +1,35 @@
+#pragma once
+
+#include <llvm/ADT/StringRef.h>
+
+class CommandLineOptions
+{
+private:
+	llvm::StringRef outputFileName;
+	llvm::StringRef corpusFileName;
+	llvm::StringRef emitDirName;
+	llvm::StringRef filter;
+
+	llvm::StringRef ptrConfigFileName;
+	llvm::StringRef modRefConfigFileName;
+	llvm::StringRef taintConfigFileName;
+	bool noPrepassFlag;
+	unsigned k;
+
+	unsigned scale;
+public:
+	CommandLineOptions(int argc, char** argv);
+
+	const llvm::StringRef& getOutputFileName() const { return outputFileName; }
+	const llvm::StringRef& getCorpusFileName() const { return corpusFileName; }
+	const llvm::StringRef& getEmitDirName() const { return emitDirName; }
+	const llvm::StringRef& getFilter() const { return filter; }
+
+	const llvm::StringRef& getPtrConfigFileName() const { return ptrConfigFileName; }
+	const llvm::StringRef& getModRefConfigFileName() const { return modRefConfigFileName; }
+	const llvm::StringRef& getTaintConfigFileName() const { return taintConfigFileName; }
+	bool isPrepassDisabled() const { return noPrepassFlag; }
+	unsigned getContextSensitivity() const { return k; }
+
+	unsigned getScale() const { return scale; }
+};
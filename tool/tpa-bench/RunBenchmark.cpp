@@ -0,0 +1,115 @@
+#include "BenchmarkCorpus.h"
+#include "CommandLineOptions.h"
+#include "RunBenchmark.h"
+
+#include "Context/Context.h"
+#include "PointerAnalysis/Analysis/SemiSparsePointerAnalysis.h"
+#include "PointerAnalysis/FrontEnd/SemiSparseProgramBuilder.h"
+#include "TaintAnalysis/Analysis/TaintAnalysis.h"
+#include "TaintAnalysis/FrontEnd/DefUseModuleBuilder.h"
+#include "Transforms/RunPrepass.h"
+#include "Util/IO/ReadIR.h"
+#include "Util/IO/WriteJson.h"
+#include "Util/Statistics/PhaseStatistics.h"
+
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/Format.h>
+#include <llvm/Support/raw_ostream.h>
+
+using namespace llvm;
+using namespace tpa;
+using namespace taint;
+using namespace util;
+using namespace util::io;
+
+AnnotationTables::AnnotationTables(const CommandLineOptions& opts):
+	ptrTable(annotation::ExternalPointerTable::loadFromFile(opts.getPtrConfigFileName().data())),
+	modRefTable(annotation::ExternalModRefTable::loadFromFile(opts.getModRefConfigFileName().data())),
+	taintTable(annotation::ExternalTaintTable::loadFromFile(opts.getTaintConfigFileName().data()))
+{
+}
+
+namespace
+{
+
+std::unique_ptr<Module> loadModule(const BenchmarkCase& benchCase, LLVMContext& context)
+{
+	if (benchCase.isGenerated())
+		return readModuleFromString(benchCase.assembly.data(), context);
+	else
+		return readModuleFromFile(benchCase.fileName.data(), context);
+}
+
+size_t getNumInstructions(const Module& module)
+{
+	size_t numInsts = 0;
+	for (auto const& f: module)
+		for (auto const& bb: f)
+			numInsts += bb.size();
+	return numInsts;
+}
+
+}
+
+bool runBenchmarkCase(const BenchmarkCase& benchCase, const AnnotationTables& tables, const CommandLineOptions& opts, raw_ostream& os)
+{
+	PhaseStatistics stats;
+
+	LLVMContext llvmContext;
+	stats.beginPhase("read IR");
+	auto module = loadModule(benchCase, llvmContext);
+	stats.endPhase();
+	if (!module)
+		return false;
+
+	if (!opts.isPrepassDisabled())
+	{
+		ScopedPhase phase(&stats, "prepass");
+		transform::runPrepassOn(*module);
+	}
+
+	stats.beginPhase("build semi-sparse program");
+	SemiSparseProgramBuilder ssProgBuilder;
+	auto ssProg = ssProgBuilder.runOnModule(*module);
+	stats.endPhase();
+
+	SemiSparsePointerAnalysis ptrAnalysis;
+	ptrAnalysis.setExternalPointerTable(tables.getPointerTable());
+	ptrAnalysis.setPhaseStatistics(stats);
+	ptrAnalysis.runOnProgram(ssProg);
+
+	stats.beginPhase("build def-use module");
+	DefUseModuleBuilder builder(ptrAnalysis);
+	builder.setExternalModRefTable(tables.getModRefTable());
+	auto duModule = builder.buildDefUseModule(*module);
+	stats.endPhase();
+
+	// Violations are part of the result, but reporting them is not what we measure
+	raw_null_ostream nullStream;
+	TaintAnalysis taintAnalysis(ptrAnalysis);
+	taintAnalysis.setExternalTaintTable(tables.getTaintTable());
+	taintAnalysis.setReportStream(nullStream);
+	stats.beginPhase("taint analysis");
+	auto taintPassed = taintAnalysis.runOnDefUseModule(duModule);
+	stats.endPhase();
+	stats.addCounter("iterations", taintAnalysis.getNumIterations());
+
+	// Keys are always written in the same order so that results of two runs can be diffed line by line
+	os << "{\"name\": ";
+	writeJsonString(os, benchCase.name);
+	os << ", \"status\": \"ok\"";
+	os << ", \"functions\": " << module->size();
+	os << ", \"instructions\": " << getNumInstructions(*module);
+	os << ", \"wall_ms\": " << format("%.3f", stats.getTotalWallTime());
+	os << ", \"peak_rss_kb\": " << stats.getPeakRSS();
+	os << ", \"pointer_iterations\": " << ptrAnalysis.getNumIterations();
+	os << ", \"taint_iterations\": " << taintAnalysis.getNumIterations();
+	os << ", \"interned_pts_sets\": " << PtsSet::getNumInternedSets();
+	os << ", \"contexts\": " << context::Context::getAllContexts().size();
+	os << ", \"taint_passed\": " << (taintPassed ? "true" : "false");
+	os << ", \"stats\": ";
+	stats.writeJson(os);
+	os << "}";
+	return true;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Annotation/ModRef/ExternalModRefTable.h"
+#include "Annotation/Pointer/ExternalPointerTable.h"
+#include "Annotation/Taint/ExternalTaintTable.h"
+
+namespace llvm
+{
+	class raw_ostream;
+}
+
+class CommandLineOptions;
+struct BenchmarkCase;
+
+// The annotation tables are loaded once, before the cases are forked off, so that their parsing time does not count towards any case
+class AnnotationTables
+{
+private:
+	annotation::ExternalPointerTable ptrTable;
+	annotation::ExternalModRefTable modRefTable;
+	annotation::ExternalTaintTable taintTable;
+public:
+	AnnotationTables(const CommandLineOptions&);
+
+	const annotation::ExternalPointerTable& getPointerTable() const { return ptrTable; }
+	const annotation::ExternalModRefTable& getModRefTable() const { return modRefTable; }
+	const annotation::ExternalTaintTable& getTaintTable() const { return taintTable; }
+};
+
+// Load the module of one case, run pointer analysis, def-use construction and taint analysis on it, and write the measurements to os as a single-line JSON object
+// Meant to run in a process of its own: the interned set and context counts cover everything the process has done so far. Return false if the module cannot be loaded
+bool runBenchmarkCase(const BenchmarkCase&, const AnnotationTables&, const CommandLineOptions&, llvm::raw_ostream& os);
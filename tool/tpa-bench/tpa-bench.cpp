@@ -0,0 +1,186 @@
+#include "BenchmarkCorpus.h"
+#include "CommandLineOptions.h"
+#include "RunBenchmark.h"
+
+#include "Context/KLimitContext.h"
+#include "Util/IO/ReadFile.h"
+#include "Util/IO/WriteJson.h"
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/PrettyStackTrace.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Support/Signals.h>
+#include <llvm/Support/ToolOutputFile.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace llvm;
+
+namespace
+{
+
+void readCorpusFile(const CommandLineOptions& opts, std::vector<BenchmarkCase>& corpus)
+{
+	auto buffer = util::io::readFileIntoBuffer(opts.getCorpusFileName().data());
+
+	SmallVector<StringRef, 64> lines;
+	buffer->getBuffer().split(lines, '\n', -1, false);
+	for (auto line: lines)
+	{
+		line = line.trim();
+		if (line.empty() || line.startswith("#"))
+			continue;
+		corpus.push_back(BenchmarkCase{ sys::path::stem(line).str(), line.str(), "" });
+	}
+}
+
+void emitCorpus(const std::vector<BenchmarkCase>& corpus, const CommandLineOptions& opts)
+{
+	if (auto ec = sys::fs::create_directories(opts.getEmitDirName()))
+	{
+		errs() << "Failed to create directory " << opts.getEmitDirName() << ": " << ec.message() << "\n";
+		std::exit(-1);
+	}
+
+	for (auto const& benchCase: corpus)
+	{
+		SmallString<256> fileName(opts.getEmitDirName());
+		sys::path::append(fileName, benchCase.name + ".ll");
+
+		std::error_code ec;
+		tool_output_file out(fileName.c_str(), ec, sys::fs::F_Text);
+		if (ec)
+		{
+			errs() << "Failed to write " << fileName << ": " << ec.message() << "\n";
+			std::exit(-1);
+		}
+		out.os() << benchCase.assembly;
+		out.keep();
+	}
+}
+
+// Run every case in a child process of its own, so that the peak RSS, the interned sets and the contexts of one case do not carry over to the next. Return the JSON object of the case, or an empty string if the child failed
+std::string runInChildProcess(const BenchmarkCase& benchCase, const AnnotationTables& tables, const CommandLineOptions& opts)
+{
+	int fds[2];
+	if (pipe(fds) != 0)
+	{
+		errs() << "Failed to create pipe\n";
+		std::exit(-1);
+	}
+
+	outs().flush();
+	errs().flush();
+	auto pid = fork();
+	if (pid < 0)
+	{
+		errs() << "Failed to start child process for " << benchCase.name << "\n";
+		std::exit(-1);
+	}
+	if (pid == 0)
+	{
+		close(fds[0]);
+		bool success;
+		{
+			raw_fd_ostream os(fds[1], true);
+			success = runBenchmarkCase(benchCase, tables, opts, os);
+		}
+		// Skip the destructors of the copied global state. The parent still owns it
+		_exit(success ? 0 : 1);
+	}
+
+	close(fds[1]);
+	std::string result;
+	char buf[4096];
+	ssize_t n;
+	while ((n = read(fds[0], buf, sizeof(buf))) > 0)
+		result.append(buf, n);
+	close(fds[0]);
+
+	int status;
+	waitpid(pid, &status, 0);
+	if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+		return std::string();
+	return result;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	// Print full stack trace when crashed
+	sys::PrintStackTraceOnErrorSignal();
+	PrettyStackTraceProgram X(argc, argv);
+
+	// Parse command line options
+	auto opts = CommandLineOptions(argc, argv);
+
+	auto scale = std::max(opts.getScale(), 1u);
+	auto corpus = generateCorpus(scale);
+	if (!opts.getEmitDirName().empty())
+	{
+		emitCorpus(corpus, opts);
+		return 0;
+	}
+	if (!opts.getCorpusFileName().empty())
+		readCorpusFile(opts, corpus);
+
+	auto tables = AnnotationTables(opts);
+	context::KLimitContext::setLimit(opts.getContextSensitivity());
+
+	std::unique_ptr<tool_output_file> outFile;
+	if (!opts.getOutputFileName().empty())
+	{
+		std::error_code ec;
+		outFile = std::make_unique<tool_output_file>(opts.getOutputFileName().data(), ec, sys::fs::F_Text);
+		if (ec)
+		{
+			errs() << "Failed to write " << opts.getOutputFileName() << ": " << ec.message() << "\n";
+			std::exit(-1);
+		}
+	}
+	auto& os = outFile ? outFile->os() : outs();
+
+	// One case per line, so that two result files diff case by case
+	os << "{\n";
+	os << "  \"scale\": " << scale << ",\n";
+	os << "  \"k\": " << opts.getContextSensitivity() << ",\n";
+	os << "  \"prepass\": " << (opts.isPrepassDisabled() ? "false" : "true") << ",\n";
+	os << "  \"benchmarks\": [";
+
+	auto numRun = 0u, numFailed = 0u;
+	for (auto const& benchCase: corpus)
+	{
+		if (!opts.getFilter().empty() && StringRef(benchCase.name).find(opts.getFilter()) == StringRef::npos)
+			continue;
+
+		errs() << "Running " << benchCase.name << "...\n";
+		auto result = runInChildProcess(benchCase, tables, opts);
+		if (result.empty())
+		{
+			++numFailed;
+			std::string failure;
+			raw_string_ostream failureStream(failure);
+			failureStream << "{\"name\": ";
+			util::io::writeJsonString(failureStream, benchCase.name);
+			failureStream << ", \"status\": \"failed\"}";
+			result = failureStream.str();
+		}
+
+		os << (numRun == 0 ? "\n" : ",\n") << "    " << result;
+		++numRun;
+	}
+	os << "\n  ]\n}\n";
+
+	if (outFile)
+		outFile->keep();
+	return numFailed > 0 ? -2 : 0;
+}
\ No newline at end of file
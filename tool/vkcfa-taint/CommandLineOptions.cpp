@@ -3,14 +3,18 @@
 
 using namespace util;
 
-CommandLineOptions::CommandLineOptions(int argc, char** argv): ptrConfigFileName("ptr.config"), modRefConfigFileName("modref.config"), taintConfigFileName("taint.config")
+CommandLineOptions::CommandLineOptions(int argc, char** argv): ptrConfigFileName("ptr.config"), modRefConfigFileName("modref.config"), taintConfigFileName("taint.config"), trackBudget(0), refineBudget(10), statsFlag(false)
 {
 	TypedCommandLineParser cmdParser("Points-to analysis verifier");
 	cmdParser.addStringPositionalFlag("irFile", "Input LLVM bitcode file name", inputFileName);
 	cmdParser.addStringOptionalFlag("ptr-config", "Annotation file for external library points-to analysis (default = <current dir>/ptr.config)", ptrConfigFileName);
 	cmdParser.addStringOptionalFlag("modref-config", "Annotation file for external library mod/ref analysis (default = <current dir>/modref.config)", modRefConfigFileName);
 	cmdParser.addStringOptionalFlag("taint-config", "Annotation file for external library taint analysis (default = <current dir>/taint.config)", taintConfigFileName);
+	cmdParser.addUIntOptionalFlag("track-budget", "Maximum number of program points visited when tracking precision loss (default = 0, which means no limit)", trackBudget);
+	cmdParser.addUIntOptionalFlag("refine-budget", "Maximum number of context refinement rounds, each of which re-runs the analysis with more call sites made context-sensitive (default = 10)", refineBudget);
 	cmdParser.addBooleanOptionalFlag("no-prepass", "Do no run IR cannonicalization before the analysis", noPrepassFlag);
+	cmdParser.addBooleanOptionalFlag("stats", "Print the time, memory usage and object counts of every phase of the analysis to stderr. Phases that run once per refinement round are listed once per round", statsFlag);
+	cmdParser.addStringOptionalFlag("stats-json", "Write the statistics of -stats to this file as JSON (\"-\" for stdout)", statsFileName);
 
 	cmdParser.parseCommandLineOptions(argc, argv);
 }
\ No newline at end of file
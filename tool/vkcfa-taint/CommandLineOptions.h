@@ -11,6 +11,11 @@ private:
 	llvm::StringRef modRefConfigFileName;
 	llvm::StringRef taintConfigFileName;
 	bool noPrepassFlag;
+	unsigned trackBudget;
+	unsigned refineBudget;
+
+	bool statsFlag;
+	llvm::StringRef statsFileName;
 public:
 	CommandLineOptions(int argc, char** argv);
 
@@ -20,4 +25,9 @@ public:
 	const llvm::StringRef& getModRefConfigFileName() const { return modRefConfigFileName; }
 	const llvm::StringRef& getTaintConfigFileName() const { return taintConfigFileName; }
 	bool isPrepassDisabled() const { return noPrepassFlag; }
+	unsigned getTrackBudget() const { return trackBudget; }
+	unsigned getRefineBudget() const { return refineBudget; }
+
+	bool isStatsEnabled() const { return statsFlag; }
+	const llvm::StringRef& getStatsFileName() const { return statsFileName; }
 };
@@ -1,12 +1,15 @@
 #include "CommandLineOptions.h"
 #include "RunAnalysis.h"
 
+#include "Context/AdaptiveContext.h"
 #include "Context/KLimitContext.h"
 #include "PointerAnalysis/Analysis/SemiSparsePointerAnalysis.h"
 #include "PointerAnalysis/FrontEnd/SemiSparseProgramBuilder.h"
 #include "TaintAnalysis/Analysis/TrackingTaintAnalysis.h"
 #include "TaintAnalysis/FrontEnd/DefUseModuleBuilder.h"
+#include "TaintAnalysis/Program/DefUseInstruction.h"
 #include "Util/IO/TaintAnalysis/Printer.h"
+#include "Util/Statistics/PhaseStatistics.h"
 
 #include <llvm/IR/Function.h>
 #include <llvm/IR/Module.h>
@@ -16,29 +19,86 @@ using namespace context;
 using namespace llvm;
 using namespace tpa;
 using namespace taint;
+using namespace util;
 using namespace util::io;
 
-bool runAnalysisOnModule(const Module& module, const CommandLineOptions& opts)
+static std::pair<bool, LossSiteList> runTrackingAnalysis(const Module& module, const SemiSparseProgram& ssProg, const CommandLineOptions& opts, PhaseStatistics& stats)
 {
-	KLimitContext::setLimit(0);
-
-	SemiSparseProgramBuilder ssProgBuilder;
-	auto ssProg = ssProgBuilder.runOnModule(module);
-
 	SemiSparsePointerAnalysis ptrAnalysis;
+	DefUseModuleBuilder builder(ptrAnalysis);
+	TrackingTaintAnalysis taintAnalysis(ptrAnalysis);
+
+	stats.beginPhase("load annotations");
 	ptrAnalysis.loadExternalPointerTable(opts.getPtrConfigFileName().data());
+	builder.loadExternalModRefTable(opts.getModRefConfigFileName().data());
+	taintAnalysis.loadExternalTaintTable(opts.getTaintConfigFileName().data());
+	stats.endPhase();
+
+	ptrAnalysis.setPhaseStatistics(stats);
 	ptrAnalysis.runOnProgram(ssProg);
 
-	DefUseModuleBuilder builder(ptrAnalysis);
-	builder.loadExternalModRefTable(opts.getModRefConfigFileName().data());
+	stats.beginPhase("build def-use module");
 	auto duModule = builder.buildDefUseModule(module);
+	stats.endPhase();
 
-	TrackingTaintAnalysis taintAnalysis(ptrAnalysis);
-	taintAnalysis.loadExternalTaintTable(opts.getTaintConfigFileName().data());
+	taintAnalysis.setTrackingBudget(opts.getTrackBudget());
+	stats.beginPhase("tracking taint analysis");
 	auto ret = taintAnalysis.runOnDefUseModule(duModule);
+	stats.endPhase();
+	stats.addCounter("iterations", taintAnalysis.getNumIterations());
+	stats.addCounter("loss sites", ret.second.size());
+	return ret;
+}
+
+// Give every call site among the loss sites its own context in the next round. Return the number of call sites that were not tracked before
+static size_t refineContexts(const LossSiteList& lossSites)
+{
+	size_t numNewSites = 0;
+	for (auto const& site: lossSites)
+	{
+		auto duInst = site.pp.getDefUseInstruction();
+		// Imprecision at other kinds of instructions comes from weak updates or path insensitivity, which more contexts won't fix
+		if (duInst->isEntryInstruction() || !duInst->isCallInstruction())
+			continue;
+
+		if (AdaptiveContext::trackCallSite(context::ProgramPoint(site.pp.getContext(), duInst->getInstruction())))
+			++numNewSites;
+	}
+	return numNewSites;
+}
+
+bool runAnalysisOnModule(const Module& module, const CommandLineOptions& opts, PhaseStatistics& stats)
+{
+	// Start context-insensitive and only add contexts where the tracker finds them useful
+	KLimitContext::setLimit(0);
+
+	stats.beginPhase("build semi-sparse program");
+	SemiSparseProgramBuilder ssProgBuilder;
+	auto ssProg = ssProgBuilder.runOnModule(module);
+	stats.endPhase();
+
+	// Every round adds its own phases, in the same order
+	for (auto round = 0u; ; ++round)
+	{
+		auto ret = runTrackingAnalysis(module, ssProg, opts, stats);
+		if (ret.first || ret.second.empty())
+			return ret.first;
 
-	for (auto const& pp: ret.second)
-		errs() << "Find loss site " << pp << "\n";
+		if (round >= opts.getRefineBudget())
+		{
+			for (auto const& site: ret.second)
+				errs() << "Find loss site " << site.pp << " (explains " << site.numViolations << " violations)\n";
+			return false;
+		}
 
-	return ret.first;
-}
\ No newline at end of file
+		auto numNewSites = refineContexts(ret.second);
+		if (numNewSites == 0)
+		{
+			errs() << "No more call sites to refine after " << round + 1 << " rounds\n";
+			for (auto const& site: ret.second)
+				errs() << "Find loss site " << site.pp << " (explains " << site.numViolations << " violations)\n";
+			return false;
+		}
+		errs() << "Refinement round " << round + 1 << ": " << numNewSites << " new call sites, " << AdaptiveContext::getNumTrackedCallSites() << " in total\n";
+	}
+}
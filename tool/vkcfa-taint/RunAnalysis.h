@@ -5,7 +5,12 @@ namespace llvm
 	class Module;
 }
 
+namespace util
+{
+	class PhaseStatistics;
+}
+
 class CommandLineOptions;
 
 // Return true if all test passed
-bool runAnalysisOnModule(const llvm::Module&, const CommandLineOptions&);
\ No newline at end of file
+bool runAnalysisOnModule(const llvm::Module&, const CommandLineOptions&, util::PhaseStatistics&);
\ No newline at end of file
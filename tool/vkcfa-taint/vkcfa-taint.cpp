@@ -3,6 +3,7 @@
 
 #include "Transforms/RunPrepass.h"
 #include "Util/IO/ReadIR.h"
+#include "Util/Statistics/PhaseStatistics.h"
 
 #include <llvm/IR/Module.h>
 #include <llvm/Support/PrettyStackTrace.h>
@@ -20,25 +21,39 @@ int main(int argc, char** argv)
 	// Parse command line options
 	auto opts = CommandLineOptions(argc, argv);
 
+	util::PhaseStatistics stats;
+
 	// Read module from file
+	stats.beginPhase("read IR");
 	auto module = util::io::readModuleFromFile(opts.getInputFileName().data());
 	if (!module)
 	{
 		errs() << "Failed to read IR from " << opts.getInputFileName().data() << "\n";
 		std::exit(-2);
 	}
+	stats.endPhase();
 
 	// Run prepasses to canonicalize the IR
 	if (!opts.isPrepassDisabled())
+	{
+		util::ScopedPhase phase(&stats, "prepass");
 		transform::runPrepassOn(*module);
+	}
 
 	// Run the analysis
-	bool succ = runAnalysisOnModule(*module, opts);
+	bool succ = runAnalysisOnModule(*module, opts, stats);
+
+	if (opts.isStatsEnabled())
+		stats.print(errs());
+	if (!opts.getStatsFileName().empty())
+		stats.writeJsonToFile(opts.getStatsFileName().data());
 
+	// Keep stdout valid JSON when the statistics go there
+	auto& resultStream = opts.getStatsFileName() == "-" ? errs() : outs();
 	if (succ)
-		outs() << "Congratulations! Taint check passed.\n";
+		resultStream << "Congratulations! Taint check passed.\n";
 	else
-		outs() << "Taint check failed\n";
+		resultStream << "Taint check failed\n";
 
 	return succ ? 0: -3;
 }
\ No newline at end of file
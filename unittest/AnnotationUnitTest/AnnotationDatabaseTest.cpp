@@ -0,0 +1,293 @@
+#include "Annotation/AnnotationDatabase.h"
+#include "Annotation/ModRef/ExternalModRefTable.h"
+#include "Annotation/Pointer/ExternalPointerTable.h"
+#include "Annotation/Taint/ExternalTaintTable.h"
+#include "Util/IO/ReadFile.h"
+
+#include "gtest/gtest.h"
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <utime.h>
+
+using namespace annotation;
+using namespace llvm;
+
+namespace {
+
+const size_t headerSize = 24;
+const size_t entrySize = 16;
+
+AnnotationRecord makeRecord(std::uint8_t first, std::uint8_t second = 0)
+{
+	AnnotationRecord record = {};
+	record[0] = first;
+	record[1] = second;
+	return record;
+}
+
+std::string writeDatabase(AnnotationDatabaseWriter& writer)
+{
+	std::string ret;
+	raw_string_ostream os(ret);
+	writer.write(os);
+	return os.str();
+}
+
+// Three entries, added out of order, one of them without records. The string table holds "absfreememcpy"
+std::string makeDatabase()
+{
+	AnnotationDatabaseWriter writer(AnnotationKind::Taint);
+	writer.addEntry("memcpy", { makeRecord(1, 2), makeRecord(3, 4) });
+	writer.addEntry("abs", {});
+	writer.addEntry("free", { makeRecord(5) });
+	return writeDatabase(writer);
+}
+
+void setU32(std::string& buffer, size_t offset, std::uint32_t val)
+{
+	for (auto i = 0u; i < 4; ++i)
+		buffer[offset + i] = static_cast<char>(val >> (8 * i));
+}
+
+// A temporary file, which is removed along with its database when the test ends
+class TempFile
+{
+private:
+	std::string path;
+public:
+	TempFile()
+	{
+		SmallString<128> tmpPath;
+		auto ec = sys::fs::createTemporaryFile("annotation", "config", tmpPath);
+		EXPECT_FALSE(ec);
+		path = tmpPath.str();
+	}
+	~TempFile()
+	{
+		sys::fs::remove(path);
+		sys::fs::remove(getDatabaseName());
+	}
+
+	const char* getName() const { return path.data(); }
+	std::string getDatabaseName() const { return getAnnotationDatabaseName(path); }
+};
+
+void writeFile(const StringRef& fileName, const StringRef& content)
+{
+	std::error_code ec;
+	raw_fd_ostream os(fileName, ec, sys::fs::F_None);
+	ASSERT_FALSE(ec);
+	os << content;
+}
+
+std::string readFile(const char* fileName)
+{
+	return util::io::readFileIntoBuffer(fileName)->getBuffer().str();
+}
+
+TEST(AnnotationDatabaseTest, RoundTrip)
+{
+	auto buffer = makeDatabase();
+	ASSERT_TRUE(AnnotationDatabaseReader::isDatabase(buffer));
+	AnnotationDatabaseReader reader(buffer, AnnotationKind::Taint);
+
+	ASSERT_EQ(3u, reader.getNumEntries());
+	EXPECT_EQ("abs", reader.getName(0));
+	EXPECT_EQ("free", reader.getName(1));
+	EXPECT_EQ("memcpy", reader.getName(2));
+
+	EXPECT_TRUE(reader.getRecords(0).empty());
+	ASSERT_EQ(1u, reader.getRecords(1).size());
+	EXPECT_EQ(makeRecord(5), reader.getRecords(1)[0]);
+	ASSERT_EQ(2u, reader.getRecords(2).size());
+	EXPECT_EQ(makeRecord(1, 2), reader.getRecords(2)[0]);
+	EXPECT_EQ(makeRecord(3, 4), reader.getRecords(2)[1]);
+
+	for (auto i = 0u; i < reader.getNumEntries(); ++i)
+		EXPECT_EQ(i, reader.findEntry(reader.getName(i)));
+	for (auto name: { "", "a", "abs2", "fre", "malloc", "zzz" })
+		EXPECT_EQ(reader.getNumEntries(), reader.findEntry(name)) << name;
+
+	// The output does not depend on the order of the entries
+	AnnotationDatabaseWriter writer(AnnotationKind::Taint);
+	writer.addEntry("free", { makeRecord(5) });
+	writer.addEntry("abs", {});
+	writer.addEntry("memcpy", { makeRecord(1, 2), makeRecord(3, 4) });
+	EXPECT_EQ(buffer, writeDatabase(writer));
+}
+
+TEST(AnnotationDatabaseTest, EmptyDatabase)
+{
+	AnnotationDatabaseWriter writer(AnnotationKind::Pointer);
+	auto buffer = writeDatabase(writer);
+	EXPECT_EQ(headerSize, buffer.size());
+
+	AnnotationDatabaseReader reader(buffer, AnnotationKind::Pointer);
+	EXPECT_EQ(0u, reader.getNumEntries());
+	EXPECT_EQ(0u, reader.findEntry("malloc"));
+}
+
+TEST(AnnotationDatabaseTest, Positions)
+{
+	std::uint8_t bytes[2];
+	for (auto pos: { APosition::getArgPosition(0), APosition::getArgPosition(255), APosition::getAfterArgPosition(3) })
+	{
+		encodePosition(pos, bytes);
+		auto decoded = decodePosition(bytes);
+		ASSERT_TRUE(decoded.isArgPosition());
+		EXPECT_EQ(pos.getAsArgPosition().getArgIndex(), decoded.getAsArgPosition().getArgIndex());
+		EXPECT_EQ(pos.getAsArgPosition().isAfterArgPosition(), decoded.getAsArgPosition().isAfterArgPosition());
+	}
+
+	encodePosition(APosition::getReturnPosition(), bytes);
+	EXPECT_TRUE(decodePosition(bytes).isReturnPosition());
+
+	bytes[0] = 3;
+	EXPECT_EXIT(decodePosition(bytes), ::testing::ExitedWithCode(255), "bad position");
+}
+
+TEST(AnnotationDatabaseTest, MalformedDatabase)
+{
+	auto buffer = makeDatabase();
+	auto expectRejected = [] (const std::string& buf, AnnotationKind kind, const char* reason)
+	{
+		EXPECT_EXIT(AnnotationDatabaseReader(buf, kind), ::testing::ExitedWithCode(255), reason);
+	};
+
+	EXPECT_FALSE(AnnotationDatabaseReader::isDatabase("fopen ALLOC\n"));
+	EXPECT_FALSE(AnnotationDatabaseReader::isDatabase(buffer.substr(0, 4)));
+	expectRejected("fopen ALLOC\n", AnnotationKind::Taint, "bad header");
+	expectRejected(buffer.substr(0, headerSize - 1), AnnotationKind::Taint, "bad header");
+
+	expectRejected(buffer, AnnotationKind::ModRef, "wrong annotation kind");
+
+	auto wideRecords = buffer;
+	wideRecords[9] = 16;
+	expectRejected(wideRecords, AnnotationKind::Taint, "unsupported record size");
+
+	expectRejected(buffer + "x", AnnotationKind::Taint, "size mismatch");
+	expectRejected(buffer.substr(0, buffer.size() - 1), AnnotationKind::Taint, "size mismatch");
+	auto moreEntries = buffer;
+	setU32(moreEntries, 12, 4);
+	expectRejected(moreEntries, AnnotationKind::Taint, "size mismatch");
+
+	// The name of the last entry runs past the string table
+	auto longName = buffer;
+	setU32(longName, headerSize + 2 * entrySize + 4, 7);
+	expectRejected(longName, AnnotationKind::Taint, "name out of range");
+	auto farName = buffer;
+	setU32(farName, headerSize, 0xffffffff);
+	expectRejected(farName, AnnotationKind::Taint, "name out of range");
+
+	auto manyRecords = buffer;
+	setU32(manyRecords, headerSize + 2 * entrySize + 12, 3);
+	expectRejected(manyRecords, AnnotationKind::Taint, "record out of range");
+	auto farRecords = buffer;
+	setU32(farRecords, headerSize + 8, 0xffffffff);
+	expectRejected(farRecords, AnnotationKind::Taint, "record out of range");
+
+	// "abs" becomes "zbs", which sorts after "free"
+	auto unsorted = buffer;
+	unsorted[headerSize + 3 * entrySize] = 'z';
+	expectRejected(unsorted, AnnotationKind::Taint, "entries not sorted by name");
+	auto duplicate = buffer;
+	setU32(duplicate, headerSize + entrySize, 0);
+	setU32(duplicate, headerSize + entrySize + 4, 3);
+	expectRejected(duplicate, AnnotationKind::Taint, "entries not sorted by name");
+}
+
+TEST(AnnotationDatabaseTest, MalformedRecords)
+{
+	TempFile file;
+
+	// The records are checked by the table that decodes them
+	AnnotationDatabaseWriter badType(AnnotationKind::Taint);
+	badType.addEntry("f", { makeRecord(7) });
+	badType.writeToFile(file.getName());
+	EXPECT_EXIT(ExternalTaintTable::loadFromFile(file.getName()), ::testing::ExitedWithCode(255), "bad taint entry type");
+
+	// A source whose position has tag 9
+	AnnotationDatabaseWriter badPosition(AnnotationKind::Taint);
+	badPosition.addEntry("f", { makeRecord(0, 9) });
+	badPosition.writeToFile(file.getName());
+	EXPECT_EXIT(ExternalTaintTable::loadFromFile(file.getName()), ::testing::ExitedWithCode(255), "bad position");
+
+	// A taint database is not a mod/ref database
+	EXPECT_EXIT(ExternalModRefTable::loadFromFile(file.getName()), ::testing::ExitedWithCode(255), "wrong annotation kind");
+}
+
+template <typename Table>
+size_t countEffects(const Table& table, const StringRef& name)
+{
+	auto summary = table.lookup(name);
+	if (summary == nullptr)
+		return static_cast<size_t>(-1);
+	return std::distance(summary->begin(), summary->end());
+}
+
+// Load the config file that the build copies next to the tests, write its database and load that. The database of the second table has to be the same, byte for byte
+template <typename Table>
+void testTableRoundTrip(const char* configName)
+{
+	TempFile textFile, dbCopy;
+	writeFile(textFile.getName(), readFile(configName));
+
+	auto textTable = Table::loadFromFile(textFile.getName());
+	ASSERT_LT(0u, textTable.size());
+	textTable.writeDatabase(textFile.getDatabaseName().data());
+
+	// The database is now at least as new as the text file, so it is loaded instead
+	ASSERT_TRUE(AnnotationDatabaseReader::isDatabase(readAnnotationFile(textFile.getName())->getBuffer()));
+	auto dbTable = Table::loadFromFile(textFile.getName());
+	EXPECT_EQ(textTable.size(), dbTable.size());
+	textTable.forEachSummary(
+		[&dbTable, &textTable] (const StringRef& name, auto const&)
+		{
+			EXPECT_EQ(countEffects(textTable, name), countEffects(dbTable, name)) << name.str();
+		}
+	);
+	EXPECT_EQ(nullptr, dbTable.lookup("no_such_function"));
+
+	dbTable.writeDatabase(dbCopy.getName());
+	EXPECT_EQ(readFile(textFile.getDatabaseName().data()), readFile(dbCopy.getName()));
+}
+
+TEST(AnnotationDatabaseTest, PointerTableRoundTrip)
+{
+	testTableRoundTrip<ExternalPointerTable>("ptr.config");
+}
+
+TEST(AnnotationDatabaseTest, ModRefTableRoundTrip)
+{
+	testTableRoundTrip<ExternalModRefTable>("modref.config");
+}
+
+TEST(AnnotationDatabaseTest, TaintTableRoundTrip)
+{
+	testTableRoundTrip<ExternalTaintTable>("taint.config");
+}
+
+TEST(AnnotationDatabaseTest, StaleDatabase)
+{
+	TempFile file;
+	writeFile(file.getName(), "SOURCE getenv Ret V T\n");
+	ExternalTaintTable::loadFromFile(file.getName()).writeDatabase(file.getDatabaseName().data());
+	writeFile(file.getName(), "SOURCE getenv Ret V T\nSINK system Arg0 D\n");
+
+	// An edit of the text file after the database was built makes the database stale
+	utimbuf times = { 0, 0 };
+	ASSERT_EQ(0, ::utime(file.getDatabaseName().data(), &times));
+	EXPECT_FALSE(AnnotationDatabaseReader::isDatabase(readAnnotationFile(file.getName())->getBuffer()));
+	auto table = ExternalTaintTable::loadFromFile(file.getName());
+	EXPECT_EQ(2u, table.size());
+	EXPECT_NE(nullptr, table.lookup("system"));
+}
+
+}
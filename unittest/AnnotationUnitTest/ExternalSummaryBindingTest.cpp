@@ -0,0 +1,178 @@
+#include "Annotation/ExternalSummaryBinding.h"
+#include "Annotation/ModRef/ExternalModRefTable.h"
+#include "Annotation/Pointer/ExternalPointerTable.h"
+#include "Annotation/Taint/ExternalTaintTable.h"
+#include "Util/IO/ReadIR.h"
+
+#include "gtest/gtest.h"
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <map>
+#include <memory>
+#include <string>
+
+using namespace annotation;
+using namespace llvm;
+
+namespace {
+
+// getenv and malloc have annotations in every table below, and strlen is defined in the module although the tables know it
+const char* testModule =
+	"declare i8* @getenv(i8*)\n"
+	"declare i8* @malloc(i64)\n"
+	"declare void @unannotated()\n"
+	"define i64 @strlen(i8* %s) {\n"
+	"entry:\n"
+	"  ret i64 0\n"
+	"}\n";
+
+const char* otherModule =
+	"declare i8* @getenv(i8*)\n";
+
+struct FakeSummary
+{
+	std::string name;
+};
+
+// Counts the lookups by name, which a binding is there to avoid
+class FakeTable
+{
+private:
+	std::map<std::string, FakeSummary> summaries;
+	mutable unsigned numLookups = 0;
+public:
+	FakeTable()
+	{
+		for (auto name: { "getenv", "malloc", "strlen" })
+			summaries[name] = FakeSummary{ name };
+	}
+
+	const FakeSummary* lookup(const std::string& name) const
+	{
+		++numLookups;
+		auto itr = summaries.find(name);
+		return itr == summaries.end() ? nullptr : &itr->second;
+	}
+	unsigned getNumLookups() const { return numLookups; }
+};
+
+class ExternalSummaryBindingTest: public ::testing::Test
+{
+protected:
+	LLVMContext context;
+	std::unique_ptr<Module> module, other;
+
+	void SetUp() override
+	{
+		module = util::io::readModuleFromString(testModule, context);
+		ASSERT_NE(nullptr, module);
+		other = util::io::readModuleFromString(otherModule, context);
+		ASSERT_NE(nullptr, other);
+	}
+};
+
+TEST_F(ExternalSummaryBindingTest, Bind)
+{
+	FakeTable table;
+	ExternalSummaryBinding<FakeSummary> binding;
+	binding.bind(*module, table);
+	// One lookup per declaration
+	EXPECT_EQ(3u, table.getNumLookups());
+
+	const FakeSummary* summary = nullptr;
+	ASSERT_TRUE(binding.lookup(module->getFunction("getenv"), summary));
+	ASSERT_NE(nullptr, summary);
+	EXPECT_EQ("getenv", summary->name);
+	ASSERT_TRUE(binding.lookup(module->getFunction("malloc"), summary));
+	ASSERT_NE(nullptr, summary);
+	EXPECT_EQ("malloc", summary->name);
+
+	// A declaration without annotation is bound to nullptr
+	ASSERT_TRUE(binding.lookup(module->getFunction("unannotated"), summary));
+	EXPECT_EQ(nullptr, summary);
+
+	// Definitions and functions of other modules are not bound, whatever their names
+	summary = nullptr;
+	EXPECT_FALSE(binding.lookup(module->getFunction("strlen"), summary));
+	EXPECT_FALSE(binding.lookup(other->getFunction("getenv"), summary));
+	EXPECT_EQ(nullptr, summary);
+	EXPECT_EQ(3u, table.getNumLookups());
+}
+
+TEST_F(ExternalSummaryBindingTest, Rebind)
+{
+	FakeTable table;
+	ExternalSummaryBinding<FakeSummary> binding;
+	binding.bind(*module, table);
+	binding.bind(*other, table);
+
+	const FakeSummary* summary = nullptr;
+	EXPECT_FALSE(binding.lookup(module->getFunction("getenv"), summary));
+	ASSERT_TRUE(binding.lookup(other->getFunction("getenv"), summary));
+	ASSERT_NE(nullptr, summary);
+	EXPECT_EQ("getenv", summary->name);
+}
+
+void writeFile(const std::string& fileName, const char* content)
+{
+	std::error_code ec;
+	raw_fd_ostream os(fileName, ec, sys::fs::F_None);
+	ASSERT_FALSE(ec);
+	os << content;
+}
+
+// Lookups through a bound table give the same summaries as lookups by name, whether the table was loaded from a text file or from its database
+template <typename Table>
+void testTableBinding(const Module& module, const Module& other, const char* config)
+{
+	SmallString<128> path;
+	ASSERT_FALSE(sys::fs::createTemporaryFile("binding", "config", path));
+	auto fileName = path.str().str();
+	auto dbName = getAnnotationDatabaseName(fileName);
+	writeFile(fileName, config);
+
+	auto textTable = Table::loadFromFile(fileName.data());
+	textTable.writeDatabase(dbName.data());
+	auto dbTable = Table::loadFromFile(fileName.data());
+	sys::fs::remove(fileName);
+	sys::fs::remove(dbName);
+
+	for (auto table: { &textTable, &dbTable })
+	{
+		table->bindModule(module);
+		for (auto name: { "getenv", "malloc", "strlen" })
+		{
+			ASSERT_NE(nullptr, table->lookup(name)) << name;
+			EXPECT_EQ(table->lookup(name), table->lookup(module.getFunction(name))) << name;
+		}
+		EXPECT_EQ(nullptr, table->lookup(module.getFunction("unannotated")));
+		// Functions of another module fall back to lookup by name
+		EXPECT_EQ(table->lookup("getenv"), table->lookup(other.getFunction("getenv")));
+
+		// A copy keeps the binding, and its summaries are those of the original
+		auto copy = *table;
+		EXPECT_EQ(table->lookup(module.getFunction("malloc")), copy.lookup(module.getFunction("malloc")));
+	}
+}
+
+TEST_F(ExternalSummaryBindingTest, PointerTable)
+{
+	testTableBinding<ExternalPointerTable>(*module, *other, "getenv COPY Ret V STATIC\nmalloc ALLOC Arg0\nIGNORE strlen\n");
+}
+
+TEST_F(ExternalSummaryBindingTest, ModRefTable)
+{
+	testTableBinding<ExternalModRefTable>(*module, *other, "getenv REF Arg0 D\nmalloc MOD Ret D\nstrlen REF Arg0 D\n");
+}
+
+TEST_F(ExternalSummaryBindingTest, TaintTable)
+{
+	testTableBinding<ExternalTaintTable>(*module, *other, "SOURCE getenv Ret V T\nSINK malloc Arg0 V\nPIPE strlen Ret V Arg0 V\n");
+}
+
+}
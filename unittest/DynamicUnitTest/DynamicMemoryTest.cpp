@@ -0,0 +1,98 @@
+#include "Dynamic/Analysis/DynamicContext.h"
+#include "Dynamic/Analysis/DynamicMemory.h"
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+
+using namespace dynamic;
+
+namespace {
+
+const void* toAddress(std::uintptr_t addr)
+{
+	return reinterpret_cast<const void*>(addr);
+}
+
+DynamicPointer makeSite(unsigned id)
+{
+	return DynamicPointer(DynamicContext::getGlobalContext(), id);
+}
+
+// 0 is the id of the null object
+unsigned getSiteID(DynamicMemory& memory, std::uintptr_t addr)
+{
+	return memory.getMemoryObject(toAddress(addr)).getAllocSite().getID();
+}
+
+TEST(DynamicMemoryTest, SizedBlocks)
+{
+	DynamicMemory memory;
+	memory.allocate(AllocType::Heap, makeSite(1), toAddress(0x1000), 16, 0);
+	memory.allocate(AllocType::Heap, makeSite(2), toAddress(0x2000), 8, 0);
+
+	EXPECT_EQ(0u, getSiteID(memory, 0xfff));
+	EXPECT_EQ(1u, getSiteID(memory, 0x1000));
+	EXPECT_EQ(1u, getSiteID(memory, 0x100f));
+	EXPECT_EQ(8, memory.getMemoryObject(toAddress(0x1008)).getOffset());
+	// The gap between the blocks belongs to neither of them
+	EXPECT_EQ(0u, getSiteID(memory, 0x1010));
+	EXPECT_EQ(0u, getSiteID(memory, 0x1fff));
+	EXPECT_EQ(2u, getSiteID(memory, 0x2007));
+	EXPECT_EQ(0u, getSiteID(memory, 0x2008));
+}
+
+TEST(DynamicMemoryTest, UnknownSizeExtendsToNextBlock)
+{
+	DynamicMemory memory;
+	memory.allocate(AllocType::Heap, makeSite(1), toAddress(0x1000), 0, 0);
+	EXPECT_EQ(1u, getSiteID(memory, 0x5000));
+
+	memory.allocate(AllocType::Heap, makeSite(2), toAddress(0x3000), 0, 0);
+	EXPECT_EQ(1u, getSiteID(memory, 0x2fff));
+	EXPECT_EQ(2u, getSiteID(memory, 0x5000));
+}
+
+TEST(DynamicMemoryTest, FreeAndRealloc)
+{
+	DynamicMemory memory;
+	memory.allocate(AllocType::Heap, makeSite(1), toAddress(0x1000), 16, 0);
+	memory.allocate(AllocType::Heap, makeSite(2), toAddress(0x2000), 16, 0);
+
+	// Warm up the lookup cache before the blocks change
+	EXPECT_EQ(1u, getSiteID(memory, 0x1004));
+	memory.reallocateHeap(toAddress(0x1000), toAddress(0x4000), 64);
+	EXPECT_EQ(0u, getSiteID(memory, 0x1004));
+	EXPECT_EQ(1u, getSiteID(memory, 0x403f));
+	EXPECT_EQ(0u, getSiteID(memory, 0x4040));
+
+	EXPECT_EQ(2u, getSiteID(memory, 0x2004));
+	memory.deallocateHeap(toAddress(0x2000));
+	EXPECT_EQ(0u, getSiteID(memory, 0x2004));
+}
+
+TEST(DynamicMemoryTest, ReplacedBlockTakesNewSize)
+{
+	DynamicMemory memory;
+	memory.allocate(AllocType::Heap, makeSite(1), toAddress(0x1000), 64, 0);
+	EXPECT_EQ(1u, getSiteID(memory, 0x1020));
+
+	// The old block was freed by uninstrumented code and the address reused for a smaller one
+	memory.allocate(AllocType::Heap, makeSite(2), toAddress(0x1000), 16, 0);
+	EXPECT_EQ(0u, getSiteID(memory, 0x1020));
+	EXPECT_EQ(2u, getSiteID(memory, 0x1008));
+}
+
+TEST(DynamicMemoryTest, StackBlocksGoAwayWithTheirFrame)
+{
+	DynamicMemory memory;
+	auto ctx = DynamicContext::pushContext(DynamicContext::getGlobalContext(), 5);
+	memory.allocate(AllocType::Stack, DynamicPointer(ctx, 3), toAddress(0x7000), 4, 0);
+	EXPECT_EQ(3u, getSiteID(memory, 0x7003));
+	EXPECT_EQ(0u, getSiteID(memory, 0x7004));
+
+	memory.deallocateStack(ctx, 0);
+	EXPECT_EQ(0u, getSiteID(memory, 0x7000));
+}
+
+}
@@ -0,0 +1,441 @@
+#include "Dynamic/Log/LogFormat.h"
+#include "Dynamic/Log/LogReader.h"
+#include "Dynamic/Log/MappedLogReader.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+using namespace dynamic;
+
+namespace {
+
+const char* testLogName = "LogReaderTest.log";
+
+void* toAddress(std::uintptr_t addr)
+{
+	return reinterpret_cast<void*>(addr);
+}
+
+LogRecord makeAllocRecord(char type, unsigned id, std::uintptr_t addr, std::uint64_t size)
+{
+	LogRecord rec;
+	rec.type = TAllocRec;
+	rec.allocRecord.type = type;
+	rec.allocRecord.id = id;
+	rec.allocRecord.address = toAddress(addr);
+	rec.allocRecord.size = size;
+	return rec;
+}
+
+LogRecord makePointerRecord(unsigned id, std::uintptr_t addr)
+{
+	LogRecord rec;
+	rec.type = TPointerRec;
+	rec.ptrRecord.id = id;
+	rec.ptrRecord.address = toAddress(addr);
+	return rec;
+}
+
+LogRecord makeIDRecord(LogRecordType type, unsigned id)
+{
+	LogRecord rec;
+	rec.type = type;
+	rec.enterRecord.id = id;
+	return rec;
+}
+
+LogRecord makeFreeRecord(std::uintptr_t addr)
+{
+	LogRecord rec;
+	rec.type = TFreeRec;
+	rec.freeRecord.address = toAddress(addr);
+	return rec;
+}
+
+LogRecord makeReallocRecord(std::uintptr_t oldAddr, std::uintptr_t newAddr, std::uint64_t newSize)
+{
+	LogRecord rec;
+	rec.type = TReallocRec;
+	rec.reallocRecord.oldAddress = toAddress(oldAddr);
+	rec.reallocRecord.newAddress = toAddress(newAddr);
+	rec.reallocRecord.newSize = newSize;
+	return rec;
+}
+
+LogRecord makeSyncRecord(std::uint64_t seq)
+{
+	LogRecord rec;
+	rec.type = TSyncRec;
+	rec.syncRecord.seq = seq;
+	return rec;
+}
+
+// Every record type, with addresses that go up and down so that the deltas of the v2 encoding take both signs
+std::vector<LogRecord> makeTestRecords(unsigned numRounds)
+{
+	std::vector<LogRecord> recs;
+	for (auto i = 0u; i < numRounds; ++i)
+	{
+		std::uintptr_t heap = 0x602000 + i * 32;
+		std::uintptr_t stack = 0x7ffd0000 - i * 16;
+		recs.push_back(makeIDRecord(TCallRec, 7 + i));
+		recs.push_back(makeIDRecord(TEnterRec, 3));
+		recs.push_back(makeAllocRecord(1, 10, stack, 16));
+		recs.push_back(makeAllocRecord(2, 11 + i, heap, i % 3 == 0 ? 0 : 32 + i));
+		recs.push_back(makePointerRecord(12, heap + 8));
+		recs.push_back(makePointerRecord(300000 + i, stack));
+		recs.push_back(makeSyncRecord(1000 + i * 3));
+		recs.push_back(makeReallocRecord(heap, heap + 0x100000, 1 << 20));
+		recs.push_back(makeFreeRecord(heap + 0x100000));
+		recs.push_back(makeIDRecord(TExitRec, 3));
+	}
+	return recs;
+}
+
+// v1 logs carry no sizes, so they read back as unknown
+std::vector<LogRecord> dropSizes(std::vector<LogRecord> recs)
+{
+	for (auto& rec: recs)
+	{
+		if (rec.type == TAllocRec)
+			rec.allocRecord.size = 0;
+		else if (rec.type == TReallocRec)
+			rec.reallocRecord.newSize = 0;
+	}
+	return recs;
+}
+
+void expectSameRecord(const LogRecord& lhs, const LogRecord& rhs)
+{
+	ASSERT_EQ(lhs.type, rhs.type);
+	switch (lhs.type)
+	{
+		case TAllocRec:
+			EXPECT_EQ(lhs.allocRecord.type, rhs.allocRecord.type);
+			EXPECT_EQ(lhs.allocRecord.id, rhs.allocRecord.id);
+			EXPECT_EQ(lhs.allocRecord.address, rhs.allocRecord.address);
+			EXPECT_EQ(lhs.allocRecord.size, rhs.allocRecord.size);
+			break;
+		case TPointerRec:
+			EXPECT_EQ(lhs.ptrRecord.id, rhs.ptrRecord.id);
+			EXPECT_EQ(lhs.ptrRecord.address, rhs.ptrRecord.address);
+			break;
+		case TEnterRec:
+		case TExitRec:
+		case TCallRec:
+			EXPECT_EQ(lhs.enterRecord.id, rhs.enterRecord.id);
+			break;
+		case TFreeRec:
+			EXPECT_EQ(lhs.freeRecord.address, rhs.freeRecord.address);
+			break;
+		case TReallocRec:
+			EXPECT_EQ(lhs.reallocRecord.oldAddress, rhs.reallocRecord.oldAddress);
+			EXPECT_EQ(lhs.reallocRecord.newAddress, rhs.reallocRecord.newAddress);
+			EXPECT_EQ(lhs.reallocRecord.newSize, rhs.reallocRecord.newSize);
+			break;
+		case TSyncRec:
+			EXPECT_EQ(lhs.syncRecord.seq, rhs.syncRecord.seq);
+			break;
+		case TThreadRec:
+			EXPECT_EQ(lhs.threadRecord.id, rhs.threadRecord.id);
+			break;
+	}
+}
+
+void expectSameRecords(const std::vector<LogRecord>& expected, const std::vector<LogRecord>& actual)
+{
+	ASSERT_EQ(expected.size(), actual.size());
+	for (auto i = 0u; i < expected.size(); ++i)
+		expectSameRecord(expected[i], actual[i]);
+}
+
+template <typename T>
+void appendData(std::vector<std::uint8_t>& out, const T& data)
+{
+	auto bytes = reinterpret_cast<const std::uint8_t*>(&data);
+	out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+// The same encoding as writeLogRecord() in MemoryHooks.c
+std::vector<std::uint8_t> encodeV1(const std::vector<LogRecord>& recs)
+{
+	std::vector<std::uint8_t> out;
+	for (auto const& rec: recs)
+	{
+		out.push_back(static_cast<std::uint8_t>(rec.type));
+		switch (rec.type)
+		{
+			case TAllocRec:
+				appendData(out, rec.allocRecord.type);
+				appendData(out, rec.allocRecord.id);
+				appendData(out, rec.allocRecord.address);
+				break;
+			case TPointerRec:
+				appendData(out, rec.ptrRecord.id);
+				appendData(out, rec.ptrRecord.address);
+				break;
+			case TEnterRec:
+			case TExitRec:
+			case TCallRec:
+				appendData(out, rec.enterRecord.id);
+				break;
+			case TFreeRec:
+				appendData(out, rec.freeRecord.address);
+				break;
+			case TReallocRec:
+				appendData(out, rec.reallocRecord.oldAddress);
+				appendData(out, rec.reallocRecord.newAddress);
+				break;
+			case TSyncRec:
+				appendData(out, rec.syncRecord.seq);
+				break;
+			case TThreadRec:
+				break;
+		}
+	}
+	return out;
+}
+
+void appendVarint(std::vector<std::uint8_t>& out, std::uint64_t val)
+{
+	std::uint8_t buf[10];
+	auto len = logEncodeVarint(buf, val);
+	out.insert(out.end(), buf, buf + len);
+}
+
+void appendAddress(std::vector<std::uint8_t>& out, std::uint64_t& prevAddress, void* addr)
+{
+	auto currAddress = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(addr));
+	appendVarint(out, logZigzagEncode(static_cast<std::int64_t>(currAddress - prevAddress)));
+	prevAddress = currAddress;
+}
+
+std::vector<std::uint8_t> encodeV2Payload(std::vector<LogRecord>::const_iterator itr, std::vector<LogRecord>::const_iterator ite)
+{
+	std::vector<std::uint8_t> out;
+	std::uint64_t prevAddress = 0;
+	for (; itr != ite; ++itr)
+	{
+		auto const& rec = *itr;
+		out.push_back(static_cast<std::uint8_t>(rec.type));
+		switch (rec.type)
+		{
+			case TAllocRec:
+				out.push_back(static_cast<std::uint8_t>(rec.allocRecord.type));
+				appendVarint(out, rec.allocRecord.id);
+				appendAddress(out, prevAddress, rec.allocRecord.address);
+				appendVarint(out, rec.allocRecord.size);
+				break;
+			case TPointerRec:
+				appendVarint(out, rec.ptrRecord.id);
+				appendAddress(out, prevAddress, rec.ptrRecord.address);
+				break;
+			case TEnterRec:
+			case TExitRec:
+			case TCallRec:
+				appendVarint(out, rec.enterRecord.id);
+				break;
+			case TFreeRec:
+				appendAddress(out, prevAddress, rec.freeRecord.address);
+				break;
+			case TReallocRec:
+				appendAddress(out, prevAddress, rec.reallocRecord.oldAddress);
+				appendAddress(out, prevAddress, rec.reallocRecord.newAddress);
+				appendVarint(out, rec.reallocRecord.newSize);
+				break;
+			case TSyncRec:
+				appendVarint(out, rec.syncRecord.seq);
+				break;
+			case TThreadRec:
+				break;
+		}
+	}
+	return out;
+}
+
+void appendBlock(std::vector<std::uint8_t>& out, std::uint8_t flags, std::size_t rawSize, const std::vector<std::uint8_t>& stored)
+{
+	std::uint8_t header[LOG_BLOCK_HEADER_SIZE];
+	std::copy(LOG_BLOCK_SYNC, LOG_BLOCK_SYNC + LOG_BLOCK_SYNC_SIZE, header);
+	header[LOG_BLOCK_SYNC_SIZE] = flags;
+	logWriteU32(header + LOG_BLOCK_SYNC_SIZE + 1, rawSize);
+	logWriteU32(header + LOG_BLOCK_SYNC_SIZE + 5, stored.size());
+	out.insert(out.end(), header, header + LOG_BLOCK_HEADER_SIZE);
+	out.insert(out.end(), stored.begin(), stored.end());
+}
+
+// The same encoding as flushThreadLog() in MemoryHooks.c, with a block every recordsPerBlock records
+std::vector<std::uint8_t> encodeV2(const std::vector<LogRecord>& recs, std::size_t recordsPerBlock, bool compress)
+{
+	std::vector<std::uint8_t> out(LOG_V2_MAGIC, LOG_V2_MAGIC + LOG_V2_MAGIC_SIZE);
+	for (std::size_t i = 0; i < recs.size(); i += recordsPerBlock)
+	{
+		auto blockEnd = std::min(recs.size(), i + recordsPerBlock);
+		auto payload = encodeV2Payload(recs.begin() + i, recs.begin() + blockEnd);
+		if (compress)
+		{
+			std::vector<std::uint8_t> compressed(LOG_COMPRESS_BOUND(payload.size()));
+			std::vector<std::uint32_t> hashTable(LOG_COMPRESS_HASH_SIZE);
+			compressed.resize(logCompressBlock(payload.data(), payload.size(), compressed.data(), hashTable.data()));
+			appendBlock(out, LOG_BLOCK_COMPRESSED, payload.size(), compressed);
+		}
+		else
+			appendBlock(out, 0, payload.size(), payload);
+	}
+	return out;
+}
+
+void writeLogFile(const std::vector<std::uint8_t>& bytes)
+{
+	std::ofstream ofs(testLogName, std::ios::out|std::ios::binary|std::ios::trunc);
+	ofs.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+}
+
+std::vector<LogRecord> readWithLazyReader()
+{
+	std::vector<LogRecord> ret;
+	LazyLogReader reader(testLogName);
+	while (auto rec = reader.readLogRecord())
+		ret.push_back(*rec);
+	return ret;
+}
+
+std::vector<LogRecord> readWithMappedReader()
+{
+	MappedLogReader reader(testLogName);
+	return std::vector<LogRecord>(reader.begin(), reader.end());
+}
+
+void expectAllReadersRead(const std::vector<LogRecord>& expected)
+{
+	expectSameRecords(expected, EagerLogReader::readLogFromFile(testLogName));
+	expectSameRecords(expected, readWithLazyReader());
+	expectSameRecords(expected, readWithMappedReader());
+}
+
+class LogReaderTest: public ::testing::Test
+{
+protected:
+	void TearDown() override
+	{
+		std::remove(testLogName);
+	}
+};
+
+TEST_F(LogReaderTest, V1RoundTrip)
+{
+	auto recs = makeTestRecords(100);
+	writeLogFile(encodeV1(recs));
+	expectAllReadersRead(dropSizes(recs));
+}
+
+TEST_F(LogReaderTest, V2RoundTrip)
+{
+	auto recs = makeTestRecords(100);
+	writeLogFile(encodeV2(recs, 64, false));
+	expectAllReadersRead(recs);
+}
+
+TEST_F(LogReaderTest, V2CompressedRoundTrip)
+{
+	auto recs = makeTestRecords(1000);
+	auto bytes = encodeV2(recs, 4096, true);
+	// The repetitive records must actually take the compressed path
+	EXPECT_LT(bytes.size(), encodeV2(recs, 4096, false).size());
+	writeLogFile(bytes);
+	expectAllReadersRead(recs);
+}
+
+TEST_F(LogReaderTest, EmptyLogs)
+{
+	writeLogFile({});
+	expectAllReadersRead({});
+
+	writeLogFile(std::vector<std::uint8_t>(LOG_V2_MAGIC, LOG_V2_MAGIC + LOG_V2_MAGIC_SIZE));
+	expectAllReadersRead({});
+}
+
+TEST_F(LogReaderTest, EagerReaderReturnsNothingForMissingFile)
+{
+	std::remove(testLogName);
+	EXPECT_TRUE(EagerLogReader::readLogFromFile(testLogName).empty());
+}
+
+TEST_F(LogReaderTest, TruncatedV1RecordIsDropped)
+{
+	auto recs = makeTestRecords(10);
+	auto bytes = encodeV1(recs);
+	bytes.resize(bytes.size() - 1);
+	writeLogFile(bytes);
+
+	recs = dropSizes(recs);
+	recs.pop_back();
+	expectSameRecords(recs, readWithLazyReader());
+	expectSameRecords(recs, readWithMappedReader());
+}
+
+TEST_F(LogReaderTest, BrokenBlockIsSkipped)
+{
+	auto recs = makeTestRecords(30);
+	auto bytes = encodeV2(recs, 100, false);
+
+	// Break the sync marker of the second block. Its records are lost, and the third block is found again
+	auto secondBlock = LOG_V2_MAGIC_SIZE + LOG_BLOCK_HEADER_SIZE + encodeV2Payload(recs.begin(), recs.begin() + 100).size();
+	ASSERT_EQ(bytes[secondBlock], static_cast<std::uint8_t>(LOG_BLOCK_SYNC[0]));
+	bytes[secondBlock] = 0;
+	writeLogFile(bytes);
+
+	std::vector<LogRecord> expected(recs.begin(), recs.begin() + 100);
+	expected.insert(expected.end(), recs.begin() + 200, recs.end());
+	expectSameRecords(expected, readWithLazyReader());
+	expectSameRecords(expected, readWithMappedReader());
+}
+
+TEST_F(LogReaderTest, ManyBrokenBlocksInARow)
+{
+	// Each of these claims to be compressed but does not decompress. Readers have to get past all of them without running out of stack
+	std::vector<std::uint8_t> bytes(LOG_V2_MAGIC, LOG_V2_MAGIC + LOG_V2_MAGIC_SIZE);
+	for (auto i = 0; i < 200000; ++i)
+		appendBlock(bytes, LOG_BLOCK_COMPRESSED, 16, { 0xf0 });
+
+	auto recs = makeTestRecords(5);
+	auto tail = encodeV2(recs, recs.size(), false);
+	bytes.insert(bytes.end(), tail.begin() + LOG_V2_MAGIC_SIZE, tail.end());
+	writeLogFile(bytes);
+
+	// The reports of the broken blocks would flood the test output
+	auto cerrBuf = std::cerr.rdbuf(nullptr);
+	auto lazyRecs = readWithLazyReader();
+	auto mappedRecs = readWithMappedReader();
+	std::cerr.rdbuf(cerrBuf);
+
+	expectSameRecords(recs, lazyRecs);
+	expectSameRecords(recs, mappedRecs);
+}
+
+TEST_F(LogReaderTest, MappedIteratorCopiesResumeIndependently)
+{
+	auto recs = makeTestRecords(200);
+	writeLogFile(encodeV2(recs, 50, true));
+
+	MappedLogReader reader(testLogName);
+	auto itr = reader.begin();
+	for (auto i = 0; i < 777; ++i)
+		++itr;
+
+	// A copy taken in the middle of a compressed block reads the same records as the original
+	auto copy = itr;
+	std::vector<LogRecord> fromOriginal(itr, reader.end());
+	std::vector<LogRecord> fromCopy(copy, reader.end());
+	std::vector<LogRecord> expected(recs.begin() + 777, recs.end());
+	expectSameRecords(expected, fromOriginal);
+	expectSameRecords(expected, fromCopy);
+}
+
+}
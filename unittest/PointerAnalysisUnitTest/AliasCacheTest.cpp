@@ -0,0 +1,162 @@
+#include "Context/Context.h"
+#include "PointerAnalysis/MemoryModel/MemoryManager.h"
+#include "PointerAnalysis/MemoryModel/Type/TypeLayout.h"
+#include "PointerAnalysis/Support/AliasCache.h"
+#include "Util/IO/ReadIR.h"
+
+#include "gtest/gtest.h"
+
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+
+#include <memory>
+#include <vector>
+
+using namespace context;
+using namespace llvm;
+using namespace tpa;
+
+namespace {
+
+// Objects of every kind: two globals, an element of a global array, a stack object and a heap object
+class AliasCacheTest: public ::testing::Test
+{
+protected:
+	LLVMContext context;
+	std::unique_ptr<Module> module;
+	MemoryManager memManager;
+
+	const MemoryObject* uObj;
+	const MemoryObject* nObj;
+	const MemoryObject* g1Obj;
+	const MemoryObject* g2Obj;
+	const MemoryObject* arrObj;
+	const MemoryObject* stackObj;
+	const MemoryObject* heapObj;
+
+	void SetUp() override
+	{
+		module = util::io::readModuleFromString(
+			"@g1 = global i32 0\n"
+			"@g2 = global i32 0\n"
+			"@arr = global [4 x i32] zeroinitializer\n"
+			"declare i8* @malloc(i64)\n"
+			"define i32 @main() {\n"
+			"entry:\n"
+			"  %x = alloca i32\n"
+			"  %h = call i8* @malloc(i64 4)\n"
+			"  ret i32 0\n"
+			"}\n",
+			context
+		);
+		ASSERT_NE(nullptr, module);
+
+		auto intLayout = TypeLayout::getNonPointerTypeLayoutWithSize(4);
+		auto globalCtx = Context::getGlobalContext();
+		auto entry = module->getFunction("main")->begin();
+		auto itr = entry->begin();
+		auto x = &*itr++;
+		auto h = &*itr;
+
+		uObj = MemoryManager::getUniversalObject();
+		nObj = MemoryManager::getNullObject();
+		g1Obj = memManager.allocateGlobalMemory(module->getGlobalVariable("g1"), intLayout);
+		g2Obj = memManager.allocateGlobalMemory(module->getGlobalVariable("g2"), intLayout);
+		arrObj = memManager.allocateGlobalMemory(module->getGlobalVariable("arr"), TypeLayout::getArrayTypeLayout(intLayout, 4));
+		stackObj = memManager.allocateStackMemory(globalCtx, x, intLayout);
+		heapObj = memManager.allocateHeapMemory(globalCtx, h, intLayout);
+		ASSERT_TRUE(arrObj->isSummaryObject());
+	}
+
+	static PtsSet makeSet(std::initializer_list<const MemoryObject*> objs)
+	{
+		auto ret = PtsSet::getEmptySet();
+		for (auto obj: objs)
+			ret = ret.insert(obj);
+		return ret;
+	}
+
+	static void expectAlias(AliasResult expected, const PtsSet& s0, const PtsSet& s1)
+	{
+		EXPECT_EQ(expected, AliasCache::computeAlias(s0, s1));
+		EXPECT_EQ(expected, AliasCache::computeAlias(s1, s0));
+	}
+};
+
+TEST_F(AliasCacheTest, EmptySet)
+{
+	auto emptySet = PtsSet::getEmptySet();
+	expectAlias(AliasResult::NoAlias, emptySet, emptySet);
+	expectAlias(AliasResult::NoAlias, emptySet, makeSet({ g1Obj }));
+	expectAlias(AliasResult::NoAlias, emptySet, makeSet({ uObj }));
+}
+
+TEST_F(AliasCacheTest, UniversalObject)
+{
+	expectAlias(AliasResult::MayAlias, makeSet({ uObj }), makeSet({ uObj }));
+	expectAlias(AliasResult::MayAlias, makeSet({ uObj }), makeSet({ g1Obj }));
+	expectAlias(AliasResult::MayAlias, makeSet({ uObj, g1Obj }), makeSet({ g2Obj }));
+	expectAlias(AliasResult::MayAlias, makeSet({ uObj }), makeSet({ nObj }));
+}
+
+TEST_F(AliasCacheTest, NullObject)
+{
+	expectAlias(AliasResult::NoAlias, makeSet({ nObj }), makeSet({ nObj }));
+	expectAlias(AliasResult::NoAlias, makeSet({ nObj, g1Obj }), makeSet({ nObj, g2Obj }));
+	expectAlias(AliasResult::NoAlias, makeSet({ nObj }), makeSet({ g1Obj }));
+	expectAlias(AliasResult::MayAlias, makeSet({ nObj, g1Obj }), makeSet({ nObj, g1Obj }));
+	expectAlias(AliasResult::MayAlias, makeSet({ nObj, g1Obj }), makeSet({ g1Obj }));
+}
+
+TEST_F(AliasCacheTest, SingleObject)
+{
+	expectAlias(AliasResult::MustAlias, makeSet({ g1Obj }), makeSet({ g1Obj }));
+	expectAlias(AliasResult::NoAlias, makeSet({ g1Obj }), makeSet({ g2Obj }));
+	expectAlias(AliasResult::MayAlias, makeSet({ g1Obj }), makeSet({ g1Obj, g2Obj }));
+	expectAlias(AliasResult::MayAlias, makeSet({ g1Obj, g2Obj }), makeSet({ g1Obj, g2Obj }));
+
+	// These objects may stand for more than one address at run time
+	for (auto obj: { arrObj, stackObj, heapObj })
+	{
+		expectAlias(AliasResult::MayAlias, makeSet({ obj }), makeSet({ obj }));
+		expectAlias(AliasResult::NoAlias, makeSet({ obj }), makeSet({ g1Obj }));
+	}
+}
+
+TEST_F(AliasCacheTest, Cache)
+{
+	std::vector<PtsSet> sets = {
+		PtsSet::getEmptySet(),
+		makeSet({ uObj }),
+		makeSet({ nObj }),
+		makeSet({ g1Obj }),
+		makeSet({ g2Obj }),
+		makeSet({ nObj, g1Obj }),
+		makeSet({ g1Obj, g2Obj }),
+		makeSet({ arrObj, stackObj, heapObj }),
+	};
+
+	// The order of the two sets does not matter, so each unordered pair gets one entry
+	AliasCache cache;
+	for (auto const& s0: sets)
+	{
+		for (auto const& s1: sets)
+		{
+			EXPECT_EQ(AliasCache::computeAlias(s0, s1), cache.alias(s0, s1));
+			EXPECT_EQ(AliasCache::computeAlias(s0, s1), cache.alias(s1, s0));
+		}
+	}
+	EXPECT_EQ(sets.size() * (sets.size() + 1) / 2, cache.size());
+
+	// Cached results are returned as they are
+	EXPECT_EQ(AliasResult::MustAlias, cache.alias(sets[3], sets[3]));
+	EXPECT_EQ(sets.size() * (sets.size() + 1) / 2, cache.size());
+
+	cache.clear();
+	EXPECT_EQ(0u, cache.size());
+	EXPECT_EQ(AliasResult::NoAlias, cache.alias(sets[3], sets[4]));
+	EXPECT_EQ(1u, cache.size());
+}
+
+}
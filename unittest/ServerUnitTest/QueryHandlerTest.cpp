@@ -0,0 +1,241 @@
+#include "CommandLineOptions.h"
+#include "QueryHandler.h"
+
+#include "PointerAnalysis/Analysis/SemiSparsePointerAnalysis.h"
+#include "PointerAnalysis/FrontEnd/SemiSparseProgramBuilder.h"
+#include "Util/IO/ReadIR.h"
+
+#include "gtest/gtest.h"
+
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <cstdio>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+using namespace llvm;
+using namespace tpa;
+using namespace util::io;
+
+namespace {
+
+// id() is called both directly and through a pointer. Without context sensitivity the results of all three calls are the same
+const char* testModule =
+	"@g = global i32 0\n"
+	"define i32* @id(i32* %x) {\n"
+	"entry:\n"
+	"  ret i32* %x\n"
+	"}\n"
+	"define i32 @main() {\n"
+	"entry:\n"
+	"  %a = alloca i32\n"
+	"  %b = alloca i32\n"
+	"  %fpp = alloca i32* (i32*)*\n"
+	"  %p = call i32* @id(i32* %a)\n"
+	"  %q = call i32* @id(i32* %b)\n"
+	"  store i32* (i32*)* @id, i32* (i32*)** %fpp\n"
+	"  %fp = load i32* (i32*)*, i32* (i32*)** %fpp\n"
+	"  %r = call i32* %fp(i32* @g)\n"
+	"  %n = load i32, i32* %a\n"
+	"  ret i32 %n\n"
+	"}\n";
+
+class QueryHandlerTest: public ::testing::Test
+{
+protected:
+	LLVMContext context;
+	std::unique_ptr<Module> module;
+	SemiSparseProgramBuilder ssProgBuilder;
+	std::unique_ptr<SemiSparseProgram> ssProg;
+	SemiSparsePointerAnalysis ptrAnalysis;
+
+	// CommandLineOptions keeps StringRefs into argv
+	std::vector<std::string> args;
+	std::vector<char*> argv;
+	std::unique_ptr<CommandLineOptions> opts;
+	std::unique_ptr<QueryHandler> handler;
+
+	void SetUp() override
+	{
+		module = util::io::readModuleFromString(testModule, context);
+		ASSERT_NE(nullptr, module);
+		ssProg = std::make_unique<SemiSparseProgram>(ssProgBuilder.runOnModule(*module));
+		ptrAnalysis.runOnProgram(*ssProg);
+
+		// The config files are copied to the build directory, which is where ctest runs the test
+		setOptions({});
+	}
+
+	void setOptions(std::vector<std::string> extraArgs)
+	{
+		args = { "pts-server", "test.ll" };
+		args.insert(args.end(), extraArgs.begin(), extraArgs.end());
+		argv.clear();
+		for (auto& arg: args)
+			argv.push_back(&arg[0]);
+		opts = std::make_unique<CommandLineOptions>(argv.size(), argv.data());
+		handler = std::make_unique<QueryHandler>(*module, ptrAnalysis, *opts);
+	}
+
+	std::string query(const std::string& line)
+	{
+		std::string ret;
+		raw_string_ostream os(ret);
+		handler->handleLine(line, os);
+		return os.str();
+	}
+
+	// Feed input to serveRequests() through a pipe and return everything it answered
+	std::string serve(const std::string& input)
+	{
+		int fds[2];
+		EXPECT_EQ(0, pipe(fds));
+		auto outFile = std::tmpfile();
+
+		std::thread writer([&input, fds] ()
+		{
+			for (size_t written = 0; written < input.size(); )
+			{
+				auto numWritten = write(fds[1], input.data() + written, input.size() - written);
+				if (numWritten <= 0)
+					break;
+				written += numWritten;
+			}
+			close(fds[1]);
+		});
+		serveRequests(fds[0], fileno(outFile), *handler);
+		// A shutdown leaves the rest of the input unread
+		close(fds[0]);
+		writer.join();
+
+		std::string ret;
+		std::rewind(outFile);
+		char buf[4096];
+		size_t numRead;
+		while ((numRead = std::fread(buf, 1, sizeof(buf), outFile)) > 0)
+			ret.append(buf, numRead);
+		std::fclose(outFile);
+		return ret;
+	}
+};
+
+TEST_F(QueryHandlerTest, PointsTo)
+{
+	auto response = query("{\"id\": 1, \"method\": \"points-to\", \"value\": {\"function\": \"main\", \"name\": \"p\"}}");
+	ASSERT_EQ('\n', response.back());
+	JsonValue value;
+	ASSERT_TRUE(parseJson(response, value)) << response;
+	ASSERT_NE(nullptr, value.getMember("id"));
+	EXPECT_EQ(1, value.getMember("id")->getAsInteger());
+	ASSERT_NE(nullptr, value.getMember("result")) << response;
+	std::set<std::string> objs;
+	for (auto const& obj: value.getMember("result")->getAsArray())
+		objs.insert(obj.getAsString());
+	EXPECT_EQ((std::set<std::string>{ "(@g)", "(S [GLOBAL]::main/a)", "(S [GLOBAL]::main/b)" }), objs);
+
+	EXPECT_EQ("{\"result\":[\"(@g)\"]}\n", query("{\"method\": \"points-to\", \"value\": {\"name\": \"g\"}}"));
+}
+
+TEST_F(QueryHandlerTest, Alias)
+{
+	auto local = [] (const char* name)
+	{
+		return std::string("{\"function\": \"main\", \"name\": \"") + name + "\"}";
+	};
+	auto alias = [this] (const std::string& a, const std::string& b)
+	{
+		return query("{\"method\": \"alias\", \"a\": " + a + ", \"b\": " + b + "}");
+	};
+	auto global = std::string("{\"name\": \"g\"}");
+
+	EXPECT_EQ("{\"result\":\"must\"}\n", alias(global, global));
+	// A stack object stands for one object per call of its function
+	EXPECT_EQ("{\"result\":\"may\"}\n", alias(local("a"), local("a")));
+	EXPECT_EQ("{\"result\":\"no\"}\n", alias(local("a"), local("b")));
+	EXPECT_EQ("{\"result\":\"no\"}\n", alias(local("a"), global));
+	EXPECT_EQ("{\"result\":\"may\"}\n", alias(local("p"), local("a")));
+	EXPECT_EQ("{\"result\":\"may\"}\n", alias(local("p"), local("q")));
+	EXPECT_EQ("{\"result\":\"may\"}\n", alias(local("r"), global));
+}
+
+TEST_F(QueryHandlerTest, Callees)
+{
+	EXPECT_EQ("{\"result\":[\"id\"]}\n", query("{\"method\": \"callees\", \"call\": {\"function\": \"main\", \"name\": \"r\"}}"));
+	EXPECT_EQ("{\"result\":[\"id\"]}\n", query("{\"method\": \"callees\", \"call\": {\"function\": \"main\", \"name\": \"p\"}}"));
+	EXPECT_EQ("{\"error\":\"the value is not a call instruction\"}\n", query("{\"method\": \"callees\", \"call\": {\"function\": \"main\", \"name\": \"a\"}}"));
+}
+
+TEST_F(QueryHandlerTest, Errors)
+{
+	EXPECT_EQ("{\"error\":\"malformed JSON\"}\n", query("{\"method\": "));
+	EXPECT_EQ("{\"error\":\"malformed JSON\"}\n", query(std::string(maxJsonDepth + 1, '[')));
+	EXPECT_EQ("{\"id\":\"x\",\"error\":\"unknown method frobnicate\"}\n", query("{\"id\": \"x\", \"method\": \"frobnicate\"}"));
+	EXPECT_EQ("{\"error\":\"a request must be an object with a \\\"method\\\" string\"}\n", query("42"));
+	EXPECT_EQ("{\"error\":\"a value must be an object with a \\\"name\\\" string\"}\n", query("{\"method\": \"points-to\"}"));
+	EXPECT_EQ("{\"error\":\"no global value named h\"}\n", query("{\"method\": \"points-to\", \"value\": {\"name\": \"h\"}}"));
+	EXPECT_EQ("{\"error\":\"no function defined with name f\"}\n", query("{\"method\": \"points-to\", \"value\": {\"function\": \"f\", \"name\": \"a\"}}"));
+	EXPECT_EQ("{\"error\":\"no value named z in function main\"}\n", query("{\"method\": \"points-to\", \"value\": {\"function\": \"main\", \"name\": \"z\"}}"));
+	EXPECT_EQ("{\"error\":\"the analysis has no pointer for this value\"}\n", query("{\"method\": \"points-to\", \"value\": {\"function\": \"main\", \"name\": \"n\"}}"));
+
+	// Blank lines get no response at all
+	EXPECT_EQ("", query(""));
+	EXPECT_EQ("", query(" \t"));
+}
+
+TEST_F(QueryHandlerTest, Batch)
+{
+	EXPECT_EQ("[{\"id\":1,\"result\":\"must\"},{\"id\":2,\"error\":\"unknown method x\"},{\"id\":[3],\"result\":null}]\n", query(
+		"[{\"id\": 1, \"method\": \"alias\", \"a\": {\"name\": \"g\"}, \"b\": {\"name\": \"g\"}},"
+		" {\"id\": 2, \"method\": \"x\"},"
+		" {\"id\": [3], \"method\": \"shutdown\"}]"));
+	EXPECT_TRUE(handler->isShutdownRequested());
+	EXPECT_EQ("[]\n", query("[]"));
+}
+
+TEST_F(QueryHandlerTest, Taint)
+{
+	// The module makes no external calls, so it has nothing to report. The result is kept for later queries
+	EXPECT_EQ("{\"result\":[]}\n", query("{\"method\": \"taint\"}"));
+	EXPECT_EQ("{\"result\":[]}\n", query("{\"method\": \"taint\"}"));
+
+	setOptions({ "-modref-config", "/nonexistent/modref.config" });
+	EXPECT_EQ("{\"error\":\"cannot read the mod/ref config file /nonexistent/modref.config\"}\n", query("{\"method\": \"taint\"}"));
+}
+
+TEST_F(QueryHandlerTest, ServeLines)
+{
+	auto aliasGG = std::string("{\"method\": \"alias\", \"a\": {\"name\": \"g\"}, \"b\": {\"name\": \"g\"}}");
+
+	// The last line needs no newline, and blank lines are skipped
+	EXPECT_EQ("{\"result\":\"must\"}\n{\"result\":\"must\"}\n", serve(aliasGG + "\n\n" + aliasGG));
+
+	// Nothing after a shutdown is answered
+	EXPECT_EQ("{\"result\":null}\n", serve("{\"method\": \"shutdown\"}\n" + aliasGG + "\n"));
+}
+
+TEST_F(QueryHandlerTest, ServeLongLines)
+{
+	auto aliasGG = std::string("{\"method\": \"alias\", \"a\": {\"name\": \"g\"}, \"b\": {\"name\": \"g\"}}");
+	auto tooLong = "{\"error\":\"request line too long\"}\n";
+
+	// A long line is rejected once, however many reads it takes to arrive, and the next line is answered as usual
+	auto longLine = "[" + std::string(maxRequestLineSize + 1, ' ') + "]";
+	EXPECT_EQ(tooLong + std::string("{\"result\":\"must\"}\n"), serve(longLine + "\n" + aliasGG + "\n"));
+	// The same when the newline of the long line arrives with the next line
+	EXPECT_EQ(tooLong + std::string("{\"result\":\"must\"}\n"), serve(std::string(maxRequestLineSize + 100, ' ') + "\n" + aliasGG));
+	// An unterminated long line at the end is not answered twice
+	EXPECT_EQ(tooLong, serve(std::string(maxRequestLineSize * 2, ' ')));
+
+	// A line of exactly the maximum size is still answered
+	auto maxLine = aliasGG + std::string(maxRequestLineSize - aliasGG.size(), ' ');
+	EXPECT_EQ("{\"result\":\"must\"}\n", serve(maxLine + "\n"));
+}
+
+}
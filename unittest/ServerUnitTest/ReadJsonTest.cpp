@@ -0,0 +1,168 @@
+#include "Util/IO/ReadJson.h"
+#include "Util/IO/WriteJson.h"
+
+#include "gtest/gtest.h"
+
+#include <llvm/Support/raw_ostream.h>
+
+#include <string>
+
+using namespace util::io;
+
+namespace {
+
+// Parse str and write it back out, or return "<error>" if it does not parse
+std::string roundTrip(const std::string& str)
+{
+	JsonValue value;
+	if (!parseJson(str, value))
+		return "<error>";
+
+	std::string ret;
+	llvm::raw_string_ostream os(ret);
+	writeJsonValue(os, value);
+	return os.str();
+}
+
+std::string nest(unsigned depth, char open, char close, const std::string& inner)
+{
+	return std::string(depth, open) + inner + std::string(depth, close);
+}
+
+TEST(ReadJsonTest, Literals)
+{
+	EXPECT_EQ("null", roundTrip("null"));
+	EXPECT_EQ("true", roundTrip("true"));
+	EXPECT_EQ("false", roundTrip(" \t\nfalse\r\n"));
+
+	EXPECT_EQ("<error>", roundTrip(""));
+	EXPECT_EQ("<error>", roundTrip("nul"));
+	EXPECT_EQ("<error>", roundTrip("True"));
+	EXPECT_EQ("<error>", roundTrip("true false"));
+}
+
+TEST(ReadJsonTest, Numbers)
+{
+	JsonValue value;
+	ASSERT_TRUE(parseJson("42", value));
+	ASSERT_TRUE(value.isInteger());
+	EXPECT_EQ(42, value.getAsInteger());
+
+	ASSERT_TRUE(parseJson("-9223372036854775807", value));
+	ASSERT_TRUE(value.isInteger());
+	EXPECT_EQ(-9223372036854775807LL, value.getAsInteger());
+
+	// Any fraction or exponent makes a double
+	for (auto str: { "1.5", "-0.25", "1e3", "1E+3", "25e-2", "-2.5e1" })
+	{
+		ASSERT_TRUE(parseJson(str, value)) << str;
+		EXPECT_TRUE(value.isDouble()) << str;
+	}
+	ASSERT_TRUE(parseJson("25e-2", value));
+	EXPECT_EQ(0.25, value.getAsDouble());
+
+	// What the number grammar used to reject as a regex, the hand-written scanner must reject too
+	for (auto str: { "-", "+1", ".5", "1.", "1.e3", "1e", "1e+", "0x10", "1-2", "--1", "1 2", "- 1" })
+		EXPECT_EQ("<error>", roundTrip(str)) << str;
+}
+
+TEST(ReadJsonTest, NumbersInContainers)
+{
+	EXPECT_EQ("[1,-2,3.5,4000.0]", roundTrip("[1, -2 ,3.5,\n4e3]"));
+	EXPECT_EQ("{\"a\":0,\"b\":[-1]}", roundTrip("{\"a\": 0, \"b\": [-1]}"));
+	EXPECT_EQ("<error>", roundTrip("[1.]"));
+	EXPECT_EQ("<error>", roundTrip("[1e]"));
+}
+
+TEST(ReadJsonTest, ManyNumbers)
+{
+	// Each number used to scan the rest of the line, which made a line of numbers quadratic
+	std::string str = "[";
+	for (auto i = 0; i < 100000; ++i)
+	{
+		if (i != 0)
+			str += ",";
+		str += std::to_string(i);
+	}
+	str += "]";
+
+	JsonValue value;
+	ASSERT_TRUE(parseJson(str, value));
+	ASSERT_TRUE(value.isArray());
+	ASSERT_EQ(100000u, value.getAsArray().size());
+	EXPECT_EQ(99999, value.getAsArray().back().getAsInteger());
+}
+
+TEST(ReadJsonTest, Strings)
+{
+	EXPECT_EQ("\"abc\"", roundTrip("\"abc\""));
+	EXPECT_EQ("\"\"", roundTrip("\"\""));
+	EXPECT_EQ("\"a\\\"b\\\\c/d\\n\\t\"", roundTrip("\"a\\\"b\\\\c\\/d\\n\\t\""));
+
+	JsonValue value;
+	ASSERT_TRUE(parseJson("\"\\u0041\\u00e9\\u20AC\"", value));
+	EXPECT_EQ("A\xc3\xa9\xe2\x82\xac", value.getAsString());
+	// Bytes at or above 0x80 pass through unchanged
+	ASSERT_TRUE(parseJson("\"\xc3\xa9\"", value));
+	EXPECT_EQ("\xc3\xa9", value.getAsString());
+
+	EXPECT_EQ("<error>", roundTrip("\"abc"));
+	EXPECT_EQ("<error>", roundTrip("\"a\nb\""));
+	EXPECT_EQ("<error>", roundTrip("\"\\x\""));
+	EXPECT_EQ("<error>", roundTrip("\"\\u12\""));
+}
+
+TEST(ReadJsonTest, ArraysAndObjects)
+{
+	EXPECT_EQ("[]", roundTrip("[ ]"));
+	EXPECT_EQ("{}", roundTrip("{ }"));
+	EXPECT_EQ("[null,true,\"x\",[],{}]", roundTrip("[null, true, \"x\", [], {}]"));
+
+	JsonValue value;
+	ASSERT_TRUE(parseJson("{\"method\": \"alias\", \"a\": {\"name\": \"x\"}, \"b\": {\"name\": \"y\"}}", value));
+	ASSERT_TRUE(value.isObject());
+	// Members stay in input order
+	ASSERT_EQ(3u, value.getAsObject().size());
+	EXPECT_EQ("method", value.getAsObject()[0].first);
+	EXPECT_EQ("b", value.getAsObject()[2].first);
+	ASSERT_NE(nullptr, value.getMember("a"));
+	EXPECT_EQ("x", value.getMember("a")->getMember("name")->getAsString());
+	EXPECT_EQ(nullptr, value.getMember("c"));
+	EXPECT_EQ(nullptr, value.getMember("a")->getMember("name")->getMember("name"));
+
+	for (auto str: { "[", "[1,]", "[,1]", "[1 2]", "{\"a\"}", "{\"a\":}", "{a:1}", "{\"a\":1,}", "{\"a\":1]", "[1}" })
+		EXPECT_EQ("<error>", roundTrip(str)) << str;
+}
+
+TEST(ReadJsonTest, NestingLimit)
+{
+	EXPECT_EQ(nest(maxJsonDepth, '[', ']', ""), roundTrip(nest(maxJsonDepth, '[', ']', "")));
+	EXPECT_EQ("<error>", roundTrip(nest(maxJsonDepth + 1, '[', ']', "")));
+
+	// Objects count as well, and so do arrays and objects in turn
+	std::string mixed;
+	for (auto i = 0u; i < maxJsonDepth; ++i)
+		mixed += (i % 2 == 0) ? "{\"a\":" : "[";
+	for (auto i = maxJsonDepth; i > 0; --i)
+		mixed += ((i - 1) % 2 == 0) ? "}" : "]";
+	JsonValue value;
+	EXPECT_TRUE(parseJson(mixed, value));
+	EXPECT_FALSE(parseJson("[" + mixed + "]", value));
+
+	// A line that would run the parser out of stack is rejected up front
+	EXPECT_EQ("<error>", roundTrip(std::string(1000000, '[')));
+
+	// Brackets in strings are not nesting
+	auto quoted = "[\"" + std::string(maxJsonDepth + 1, '[') + "\\\"{\"]";
+	ASSERT_TRUE(parseJson(quoted, value));
+	EXPECT_EQ(std::string(maxJsonDepth + 1, '[') + "\"{", value.getAsArray()[0].getAsString());
+
+	// Siblings do not add up
+	std::string siblings = "[";
+	for (auto i = 0u; i < 2 * maxJsonDepth; ++i)
+		siblings += (i == 0) ? "[]" : ",[]";
+	siblings += "]";
+	EXPECT_TRUE(parseJson(siblings, value));
+}
+
+}
@@ -0,0 +1,74 @@
+#include "TaintAnalysis/Incremental/FunctionHasher.h"
+#include "Util/IO/ReadIR.h"
+
+#include "gtest/gtest.h"
+
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+
+#include <memory>
+#include <string>
+
+using namespace llvm;
+using namespace taint;
+
+namespace {
+
+// What clang -g emits for "int f(int a) { return a + 1; }", with the addition done in inline assembly. The debug intrinsic takes metadata operands and the asm call an InlineAsm callee, neither of which is a constant, a global or a local
+std::string makeDebugModule(const std::string& asmString, const std::string& varLine)
+{
+	return
+		"define i32 @f(i32 %a) !dbg !4 {\n"
+		"entry:\n"
+		"  %a.addr = alloca i32, align 4\n"
+		"  store i32 %a, i32* %a.addr, align 4\n"
+		"  call void @llvm.dbg.declare(metadata i32* %a.addr, metadata !10, metadata !11), !dbg !12\n"
+		"  %0 = load i32, i32* %a.addr, align 4, !dbg !12\n"
+		"  %1 = call i32 asm \"" + asmString + "\", \"=r,0\"(i32 %0), !dbg !12\n"
+		"  ret i32 %1, !dbg !12\n"
+		"}\n"
+		"declare void @llvm.dbg.declare(metadata, metadata, metadata)\n"
+		"!llvm.dbg.cu = !{!0}\n"
+		"!llvm.module.flags = !{!7, !8}\n"
+		"!0 = distinct !DICompileUnit(language: DW_LANG_C99, file: !1, producer: \"clang\", isOptimized: false, runtimeVersion: 0, emissionKind: 1, enums: !2, subprograms: !3)\n"
+		"!1 = !DIFile(filename: \"f.c\", directory: \"/tmp\")\n"
+		"!2 = !{}\n"
+		"!3 = !{!4}\n"
+		"!4 = distinct !DISubprogram(name: \"f\", scope: !1, file: !1, line: 1, type: !5, isLocal: false, isDefinition: true, scopeLine: 1, flags: DIFlagPrototyped, isOptimized: false, variables: !2)\n"
+		"!5 = !DISubroutineType(types: !6)\n"
+		"!6 = !{!9, !9}\n"
+		"!7 = !{i32 2, !\"Dwarf Version\", i32 4}\n"
+		"!8 = !{i32 2, !\"Debug Info Version\", i32 3}\n"
+		"!9 = !DIBasicType(name: \"int\", size: 32, align: 32, encoding: DW_ATE_signed)\n"
+		"!10 = !DILocalVariable(name: \"a\", arg: 1, scope: !4, file: !1, line: " + varLine + ", type: !9)\n"
+		"!11 = !DIExpression()\n"
+		"!12 = !DILocation(line: 1, column: 11, scope: !4)\n";
+}
+
+std::string hashFunction(const std::string& assembly)
+{
+	LLVMContext context;
+	auto module = util::io::readModuleFromString(assembly.data(), context);
+	if (module == nullptr)
+		return std::string();
+	return computeFunctionHash(*module->getFunction("f"));
+}
+
+TEST(FunctionHasherTest, DebugModule)
+{
+	auto hash = hashFunction(makeDebugModule("addl $$1, $0", "1"));
+	ASSERT_FALSE(hash.empty());
+
+	// Hashing is deterministic across contexts
+	EXPECT_EQ(hash, hashFunction(makeDebugModule("addl $$1, $0", "1")));
+	// The asm string is part of the hash
+	EXPECT_NE(hash, hashFunction(makeDebugModule("addl $$2, $0", "1")));
+}
+
+TEST(FunctionHasherTest, DebugInfoIsIgnored)
+{
+	// Lines of variables shift with edits above the function, and so do the numbers of the metadata nodes
+	EXPECT_EQ(hashFunction(makeDebugModule("addl $$1, $0", "1")), hashFunction(makeDebugModule("addl $$1, $0", "2")));
+}
+
+}
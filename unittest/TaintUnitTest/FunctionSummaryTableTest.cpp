@@ -0,0 +1,335 @@
+#include "Annotation/ModRef/ExternalModRefTable.h"
+#include "Annotation/Taint/ExternalTaintTable.h"
+#include "Context/KLimitContext.h"
+#include "PointerAnalysis/Analysis/SemiSparsePointerAnalysis.h"
+#include "PointerAnalysis/FrontEnd/SemiSparseProgramBuilder.h"
+#include "TaintAnalysis/Engine/FunctionSummaryTable.h"
+#include "TaintAnalysis/Engine/Initializer.h"
+#include "TaintAnalysis/Engine/SinkViolationChecker.h"
+#include "TaintAnalysis/Engine/TaintGlobalState.h"
+#include "TaintAnalysis/Engine/TaintPropagator.h"
+#include "TaintAnalysis/Engine/TransferFunction.h"
+#include "TaintAnalysis/FrontEnd/DefUseModuleBuilder.h"
+#include "TaintAnalysis/Program/DefUseModule.h"
+#include "TaintAnalysis/Support/TaintEnv.h"
+#include "TaintAnalysis/Support/TaintMemo.h"
+#include "Util/AnalysisEngine/DataFlowAnalysis.h"
+#include "Util/IO/ReadIR.h"
+#include "Util/IO/TaintAnalysis/Printer.h"
+
+#include "gtest/gtest.h"
+
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+
+using namespace annotation;
+using namespace context;
+using namespace llvm;
+using namespace taint;
+using namespace tpa;
+using namespace util::io;
+
+namespace {
+
+// Every function has a single return, as the prepass would leave it. Every function but main, fact, indirect and setCell is summarizable. main calls each of them with tainted and untainted arguments, and every result ends up in a sink
+const char* moduleText =
+	"@table = global [4 x i64] zeroinitializer\n"
+	"@cell = global i64 0\n"
+	"@fp = global i64 (i64)* @twice\n"
+	"declare i64 @read(i32, i8*, i64)\n"
+	"declare i8* @malloc(i64)\n"
+	"define i64 @twice(i64 %x) {\n"
+	"entry:\n"
+	"  %y = add i64 %x, %x\n"
+	"  ret i64 %y\n"
+	"}\n"
+	"define i64 @wrap(i64 %x) {\n"
+	"entry:\n"
+	"  %y = call i64 @twice(i64 %x)\n"
+	"  %z = add i64 %y, 1\n"
+	"  ret i64 %z\n"
+	"}\n"
+	"define i64 @pick(i64 %a, i64 %b, i1 %c) {\n"
+	"entry:\n"
+	"  br i1 %c, label %left, label %right\n"
+	"left:\n"
+	"  br label %join\n"
+	"right:\n"
+	"  br label %join\n"
+	"join:\n"
+	"  %r = phi i64 [ %a, %left ], [ %b, %right ]\n"
+	"  ret i64 %r\n"
+	"}\n"
+	"define void @stash(i64 %x, i64 %i) {\n"
+	"entry:\n"
+	"  %p = getelementptr [4 x i64], [4 x i64]* @table, i64 0, i64 %i\n"
+	"  store i64 %x, i64* %p\n"
+	"  ret void\n"
+	"}\n"
+	"define i64 @peek(i64 %i) {\n"
+	"entry:\n"
+	"  %p = getelementptr [4 x i64], [4 x i64]* @table, i64 0, i64 %i\n"
+	"  %v = load i64, i64* %p\n"
+	"  ret i64 %v\n"
+	"}\n"
+	"define i64 @fact(i64 %n) {\n"
+	"entry:\n"
+	"  %c = icmp eq i64 %n, 0\n"
+	"  br i1 %c, label %done, label %rec\n"
+	"rec:\n"
+	"  %m = sub i64 %n, 1\n"
+	"  %f = call i64 @fact(i64 %m)\n"
+	"  %m2 = mul i64 %f, %n\n"
+	"  br label %done\n"
+	"done:\n"
+	"  %r = phi i64 [ 1, %entry ], [ %m2, %rec ]\n"
+	"  ret i64 %r\n"
+	"}\n"
+	"define i64 @indirect(i64 %x) {\n"
+	"entry:\n"
+	"  %f = load i64 (i64)*, i64 (i64)** @fp\n"
+	"  %r = call i64 %f(i64 %x)\n"
+	"  ret i64 %r\n"
+	"}\n"
+	"define void @setCell(i64 %x) {\n"
+	"entry:\n"
+	"  store i64 %x, i64* @cell\n"
+	"  ret void\n"
+	"}\n"
+	"define i64 @getCell() {\n"
+	"entry:\n"
+	"  %v = load i64, i64* @cell\n"
+	"  ret i64 %v\n"
+	"}\n"
+	"define i32 @main() {\n"
+	"entry:\n"
+	"  %buf = alloca i8\n"
+	"  %t = call i64 @read(i32 0, i8* %buf, i64 1)\n"
+	"  %a1 = call i64 @twice(i64 %t)\n"
+	"  %s1 = call i8* @malloc(i64 %a1)\n"
+	"  %a2 = call i64 @twice(i64 3)\n"
+	"  %s2 = call i8* @malloc(i64 %a2)\n"
+	"  %b1 = call i64 @wrap(i64 %t)\n"
+	"  %s3 = call i8* @malloc(i64 %b1)\n"
+	"  %b2 = call i64 @wrap(i64 4)\n"
+	"  %s4 = call i8* @malloc(i64 %b2)\n"
+	"  %c1 = call i64 @pick(i64 %t, i64 1, i1 true)\n"
+	"  %s5 = call i8* @malloc(i64 %c1)\n"
+	"  %c2 = call i64 @pick(i64 2, i64 3, i1 false)\n"
+	"  %s6 = call i8* @malloc(i64 %c2)\n"
+	"  %d1 = call i64 @peek(i64 0)\n"
+	"  %s7 = call i8* @malloc(i64 %d1)\n"
+	"  call void @stash(i64 %t, i64 1)\n"
+	"  %d2 = call i64 @peek(i64 2)\n"
+	"  %s8 = call i8* @malloc(i64 %d2)\n"
+	"  %e1 = call i64 @fact(i64 %t)\n"
+	"  %s9 = call i8* @malloc(i64 %e1)\n"
+	"  %f1 = call i64 @indirect(i64 5)\n"
+	"  %s10 = call i8* @malloc(i64 %f1)\n"
+	"  %f2 = call i64 @indirect(i64 %t)\n"
+	"  %s11 = call i8* @malloc(i64 %f2)\n"
+	"  call void @setCell(i64 6)\n"
+	"  %g1 = call i64 @getCell()\n"
+	"  %s12 = call i8* @malloc(i64 %g1)\n"
+	"  call void @setCell(i64 %t)\n"
+	"  %g2 = call i64 @getCell()\n"
+	"  %s13 = call i8* @malloc(i64 %g2)\n"
+	"  ret i32 0\n"
+	"}\n";
+
+// The violations and the env entries of one taint analysis run. Program points and values are printed, so that the results of two runs can be compared
+struct TaintResult
+{
+	std::set<std::string> violations;
+	std::map<std::string, TaintLattice> env;
+};
+
+// Callers are analyzed with k = 1, so that the same function is called in several contexts
+class FunctionSummaryTableTest: public ::testing::Test
+{
+protected:
+	unsigned oldLimit;
+	LLVMContext context;
+	std::unique_ptr<Module> module;
+	std::unique_ptr<SemiSparsePointerAnalysis> ptrAnalysis;
+	ExternalTaintTable taintTable;
+
+	void SetUp() override
+	{
+		oldLimit = KLimitContext::getLimit();
+		KLimitContext::setLimit(1);
+
+		module = util::io::readModuleFromString(moduleText, context);
+		ASSERT_NE(nullptr, module);
+
+		SemiSparseProgramBuilder ssProgBuilder;
+		auto ssProg = ssProgBuilder.runOnModule(*module);
+		ptrAnalysis = std::make_unique<SemiSparsePointerAnalysis>();
+		ptrAnalysis->loadExternalPointerTable("ptr.config");
+		ptrAnalysis->runOnProgram(ssProg);
+
+		taintTable = ExternalTaintTable::loadFromFile("taint.config");
+	}
+
+	void TearDown() override
+	{
+		KLimitContext::setLimit(oldLimit);
+	}
+
+	const Function* getFunction(const char* name) const
+	{
+		auto f = module->getFunction(name);
+		EXPECT_NE(nullptr, f) << name;
+		return f;
+	}
+
+	// The single object that f loads from
+	const MemoryObject* getLoadedObject(const char* name) const
+	{
+		for (auto const& inst: *getFunction(name)->begin())
+		{
+			if (auto loadInst = dyn_cast<LoadInst>(&inst))
+			{
+				auto pSet = ptrAnalysis->getPtsSet(loadInst->getPointerOperand());
+				EXPECT_EQ(1u, pSet.size());
+				return *pSet.begin();
+			}
+		}
+		ADD_FAILURE() << name << " has no load";
+		return nullptr;
+	}
+
+	// Run the taint analysis the way TaintAnalysis::runOnDefUseModule() does, with or without function summaries. Env entries of summarizable functions are left out, since only the run without summaries walks their bodies
+	TaintResult runTaintAnalysis(bool useSummaries)
+	{
+		DefUseModuleBuilder builder(*ptrAnalysis);
+		builder.setExternalModRefTable(ExternalModRefTable::loadFromFile("modref.config"));
+		auto duModule = builder.buildDefUseModule(*module);
+
+		TaintEnv env;
+		TaintMemo memo;
+		taintTable.bindModule(*module);
+		auto globalState = TaintGlobalState(duModule, *ptrAnalysis, taintTable, env, memo);
+		globalState.getSummaryTable().setEnabled(useSummaries);
+		auto dfa = util::DataFlowAnalysis<TaintGlobalState, TaintMemo, TransferFunction, TaintPropagator>(globalState, memo);
+		dfa.runOnInitialState<Initializer>(TaintStore());
+
+		TaintResult result;
+		auto violationRecord = SinkViolationChecker(env, memo, taintTable, *ptrAnalysis).checkSinkViolation(globalState.getSinks());
+		for (auto const& mapping: violationRecord)
+		{
+			for (auto const& violation: mapping.second)
+			{
+				std::string str;
+				raw_string_ostream os(str);
+				os << mapping.first << " arg " << static_cast<unsigned>(violation.argPos) << ": " << violation.actualVal;
+				result.violations.insert(os.str());
+			}
+		}
+
+		FunctionSummaryTable summaryTable(*ptrAnalysis);
+		for (auto const& mapping: env)
+		{
+			auto value = mapping.first.getValue();
+			const Function* f = nullptr;
+			if (auto arg = dyn_cast<Argument>(value))
+				f = arg->getParent();
+			else if (auto inst = dyn_cast<Instruction>(value))
+				f = inst->getParent()->getParent();
+			if (f == nullptr || summaryTable.isSummarizable(f))
+				continue;
+
+			std::string str;
+			raw_string_ostream os(str);
+			os << *mapping.first.getContext() << "::" << f->getName() << "/" << value->getName();
+			result.env[os.str()] = mapping.second;
+		}
+		return result;
+	}
+};
+
+TEST_F(FunctionSummaryTableTest, Summarizable)
+{
+	FunctionSummaryTable table(*ptrAnalysis);
+	for (auto name: { "twice", "wrap", "pick", "stash", "peek", "getCell" })
+		EXPECT_TRUE(table.isSummarizable(getFunction(name))) << name;
+
+	// External, recursive, calling indirectly, with a strong update, and calling any of those
+	for (auto name: { "read", "malloc", "fact", "indirect", "setCell", "main" })
+		EXPECT_FALSE(table.isSummarizable(getFunction(name))) << name;
+
+	table.setEnabled(false);
+	EXPECT_FALSE(table.isSummarizable(getFunction("twice")));
+}
+
+TEST_F(FunctionSummaryTableTest, ReturnValue)
+{
+	FunctionSummaryTable table(*ptrAnalysis);
+	TaintStore emptyStore;
+
+	auto twice = getFunction("twice");
+	EXPECT_EQ(TaintLattice::Tainted, table.applySummary(twice, { TaintLattice::Tainted }, emptyStore).retVal);
+	EXPECT_EQ(TaintLattice::Untainted, table.applySummary(twice, { TaintLattice::Untainted }, emptyStore).retVal);
+	EXPECT_EQ(TaintLattice::Either, table.applySummary(twice, { TaintLattice::Either }, emptyStore).retVal);
+
+	// The summary of the callee is created along the way. Its result is joined with a constant, like any operand
+	auto wrap = getFunction("wrap");
+	auto numSummaries = table.getNumSummaries();
+	EXPECT_EQ(TaintLattice::Either, table.applySummary(wrap, { TaintLattice::Tainted }, emptyStore).retVal);
+	EXPECT_EQ(numSummaries + 1, table.getNumSummaries());
+	EXPECT_EQ(TaintLattice::Either, table.applySummary(wrap, { TaintLattice::Either }, emptyStore).retVal);
+	EXPECT_EQ(numSummaries + 2, table.getNumSummaries());
+
+	// Both incoming values of the phi are joined
+	auto pick = getFunction("pick");
+	EXPECT_EQ(TaintLattice::Either, table.applySummary(pick, { TaintLattice::Tainted, TaintLattice::Untainted, TaintLattice::Untainted }, emptyStore).retVal);
+	EXPECT_EQ(TaintLattice::Untainted, table.applySummary(pick, { TaintLattice::Untainted, TaintLattice::Untainted, TaintLattice::Tainted }, emptyStore).retVal);
+}
+
+TEST_F(FunctionSummaryTableTest, Memory)
+{
+	FunctionSummaryTable table(*ptrAnalysis);
+	TaintStore emptyStore;
+
+	auto stash = getFunction("stash");
+	auto const& stashSummary = table.applySummary(stash, { TaintLattice::Tainted, TaintLattice::Untainted }, emptyStore);
+	ASSERT_EQ(1u, stashSummary.memEffects.size());
+	auto tableObj = getLoadedObject("peek");
+	EXPECT_EQ(tableObj, stashSummary.memEffects[0].first);
+	EXPECT_EQ(TaintLattice::Tainted, stashSummary.memEffects[0].second);
+
+	// The memory a function reads is part of the key
+	auto peek = getFunction("peek");
+	TaintStore taintedStore, untaintedStore;
+	taintedStore.strongUpdate(tableObj, TaintLattice::Tainted);
+	untaintedStore.strongUpdate(tableObj, TaintLattice::Untainted);
+	EXPECT_EQ(TaintLattice::Tainted, table.applySummary(peek, { TaintLattice::Untainted }, taintedStore).retVal);
+	EXPECT_EQ(TaintLattice::Untainted, table.applySummary(peek, { TaintLattice::Untainted }, untaintedStore).retVal);
+	EXPECT_TRUE(table.applySummary(peek, { TaintLattice::Untainted }, untaintedStore).memEffects.empty());
+
+	// Memory that is not read does not split the summaries
+	auto numSummaries = table.getNumSummaries();
+	auto const& summary = table.applySummary(getFunction("twice"), { TaintLattice::Tainted }, emptyStore);
+	EXPECT_EQ(&summary, &table.applySummary(getFunction("twice"), { TaintLattice::Tainted }, taintedStore));
+	EXPECT_EQ(numSummaries + 1, table.getNumSummaries());
+}
+
+TEST_F(FunctionSummaryTableTest, SameAsWalkingTheBody)
+{
+	auto withSummaries = runTaintAnalysis(true);
+	auto withoutSummaries = runTaintAnalysis(false);
+
+	EXPECT_FALSE(withoutSummaries.violations.empty());
+	EXPECT_EQ(withoutSummaries.violations, withSummaries.violations);
+	EXPECT_FALSE(withoutSummaries.env.empty());
+	EXPECT_EQ(withoutSummaries.env, withSummaries.env);
+}
+
+}
@@ -0,0 +1,266 @@
+#include "Annotation/ModRef/ExternalModRefTable.h"
+#include "Annotation/Taint/ExternalTaintTable.h"
+#include "PointerAnalysis/Analysis/SemiSparsePointerAnalysis.h"
+#include "PointerAnalysis/FrontEnd/SemiSparseProgramBuilder.h"
+#include "TaintAnalysis/Analysis/TaintAnalysis.h"
+#include "TaintAnalysis/FrontEnd/DefUseModuleBuilder.h"
+#include "Util/IO/ReadFile.h"
+#include "Util/IO/ReadIR.h"
+
+#include "gtest/gtest.h"
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <string>
+#include <vector>
+
+using namespace annotation;
+using namespace llvm;
+using namespace taint;
+using namespace tpa;
+
+namespace {
+
+// The size passed to malloc() comes from input(). Whether it is tainted depends on the body of input(), which the tests edit. count() reads tainted data as well but takes no part in the flow, and is restored from the cache whenever it is unchanged
+std::string makeModule(const std::string& inputBody)
+{
+	return
+		"declare i64 @read(i32, i8*, i64)\n"
+		"declare i8* @malloc(i64)\n"
+		"define i64 @input(i8* %buf) {\n"
+		"entry:\n" + inputBody +
+		"}\n"
+		"define void @alloc(i64 %size) {\n"
+		"entry:\n"
+		"  %p = call i8* @malloc(i64 %size)\n"
+		"  ret void\n"
+		"}\n"
+		"define i64 @count(i8* %buf) {\n"
+		"entry:\n"
+		"  %v0 = call i64 @read(i32 0, i8* %buf, i64 1)\n"
+		"  %v1 = add i64 %v0, 1\n"
+		"  %v2 = mul i64 %v1, 3\n"
+		"  %v3 = sub i64 %v2, %v0\n"
+		"  %v4 = xor i64 %v3, %v1\n"
+		"  %v5 = add i64 %v4, %v2\n"
+		"  %v6 = mul i64 %v5, %v3\n"
+		"  %v7 = or i64 %v6, %v4\n"
+		"  %v8 = add i64 %v7, %v5\n"
+		"  ret i64 %v8\n"
+		"}\n"
+		"define i32 @main() {\n"
+		"entry:\n"
+		"  %buf = alloca i8\n"
+		"  %c = call i64 @count(i8* %buf)\n"
+		"  %n = call i64 @input(i8* %buf)\n"
+		"  call void @alloc(i64 %n)\n"
+		"  ret i32 0\n"
+		"}\n";
+}
+
+const char* untaintedInput = "  ret i64 16\n";
+const char* taintedInput =
+	"  %n = call i64 @read(i32 0, i8* %buf, i64 1)\n"
+	"  ret i64 %n\n";
+
+// Cut the actual taint value off every report line, leaving the sinks that are violated. An incremental run may report a coarser value than a full one (see TaintCacheManager)
+std::string getViolatedSinks(const std::string& report)
+{
+	std::string ret;
+	size_t pos = 0;
+	while (pos < report.size())
+	{
+		auto end = report.find('\n', pos);
+		auto line = report.substr(pos, end - pos);
+		ret += line.substr(0, line.find(",\"actual\":")) + "\n";
+		pos = end == std::string::npos ? report.size() : end + 1;
+	}
+	return ret;
+}
+
+struct TaintRun
+{
+	std::string report;
+	size_t numIterations;
+};
+
+class TempFile
+{
+private:
+	std::string path;
+public:
+	TempFile(const char* suffix)
+	{
+		SmallString<128> tmpPath;
+		auto ec = sys::fs::createTemporaryFile("taintcache", suffix, tmpPath);
+		EXPECT_FALSE(ec);
+		path = tmpPath.str();
+	}
+	~TempFile()
+	{
+		sys::fs::remove(path);
+	}
+
+	const char* getName() const { return path.data(); }
+
+	void write(const StringRef& content) const
+	{
+		std::error_code ec;
+		raw_fd_ostream os(path, ec, sys::fs::F_None);
+		ASSERT_FALSE(ec);
+		os << content;
+	}
+};
+
+// The config files are copied to the build directory, which is where ctest runs the test. The taint config is copied once more, so that the tests can edit it
+class TaintCacheManagerTest: public ::testing::Test
+{
+protected:
+	TempFile cacheFile, taintConfig;
+
+	TaintCacheManagerTest(): cacheFile("cache"), taintConfig("config") {}
+
+	void SetUp() override
+	{
+		sys::fs::remove(cacheFile.getName());
+		taintConfig.write(util::io::readFileIntoBuffer("taint.config")->getBuffer());
+	}
+
+	// Run the pointer and the taint analysis on the module. An empty cacheFileName runs without the cache
+	TaintRun run(const std::string& moduleText, const char* cacheFileName, bool rebuild = false)
+	{
+		LLVMContext context;
+		auto module = util::io::readModuleFromString(moduleText.data(), context);
+		EXPECT_NE(nullptr, module);
+
+		SemiSparseProgramBuilder ssProgBuilder;
+		auto ssProg = ssProgBuilder.runOnModule(*module);
+		SemiSparsePointerAnalysis ptrAnalysis;
+		ptrAnalysis.loadExternalPointerTable("ptr.config");
+		ptrAnalysis.runOnProgram(ssProg);
+
+		DefUseModuleBuilder builder(ptrAnalysis);
+		builder.setExternalModRefTable(ExternalModRefTable::loadFromFile("modref.config"));
+		auto duModule = builder.buildDefUseModule(*module);
+
+		TaintRun ret;
+		raw_string_ostream reportStream(ret.report);
+		TaintAnalysis taintAnalysis(ptrAnalysis);
+		taintAnalysis.loadExternalTaintTable(taintConfig.getName());
+		taintAnalysis.setReportStream(reportStream);
+		if (*cacheFileName != '\0')
+			taintAnalysis.enableIncrementalMode(cacheFileName, { "ptr.config", "modref.config", taintConfig.getName() }, rebuild);
+		taintAnalysis.runOnDefUseModule(duModule);
+		reportStream.flush();
+		ret.numIterations = taintAnalysis.getNumIterations();
+		return ret;
+	}
+
+	TaintRun runFull(const std::string& moduleText)
+	{
+		return run(moduleText, "");
+	}
+	TaintRun runCached(const std::string& moduleText, bool rebuild = false)
+	{
+		return run(moduleText, cacheFile.getName(), rebuild);
+	}
+};
+
+TEST_F(TaintCacheManagerTest, UnchangedModule)
+{
+	auto module = makeModule(taintedInput);
+	auto full = runFull(module);
+	EXPECT_NE("", full.report);
+
+	// Without a cache file, everything is analyzed
+	auto first = runCached(module);
+	EXPECT_EQ(full.report, first.report);
+	EXPECT_EQ(full.numIterations, first.numIterations);
+
+	// Nothing has to be re-solved the second time
+	auto second = runCached(module);
+	EXPECT_EQ(full.report, second.report);
+	EXPECT_LT(second.numIterations, full.numIterations);
+
+	// Restoring does not lose anything for the next run either
+	auto third = runCached(module);
+	EXPECT_EQ(full.report, third.report);
+	EXPECT_EQ(second.numIterations, third.numIterations);
+}
+
+TEST_F(TaintCacheManagerTest, ChangedFunction)
+{
+	auto before = makeModule(untaintedInput), after = makeModule(taintedInput);
+	EXPECT_EQ("", runFull(before).report);
+	auto full = runFull(after);
+	ASSERT_NE("", full.report);
+
+	runCached(before);
+	auto unchangedRun = runCached(before);
+
+	// input() changed, and the new taint flows out of it into alloc(), which is unchanged. The taint has to reach the sink all the same, joined with the untainted value cached for it
+	auto changedRun = runCached(after);
+	EXPECT_EQ(getViolatedSinks(full.report), getViolatedSinks(changedRun.report));
+	EXPECT_NE(std::string::npos, changedRun.report.find("\"actual\":\"Either\""));
+	EXPECT_LT(changedRun.numIterations, full.numIterations);
+	EXPECT_GT(changedRun.numIterations, unchangedRun.numIterations);
+
+	// A rebuild drops the cached values
+	EXPECT_EQ(full.report, runCached(after, true).report);
+}
+
+TEST_F(TaintCacheManagerTest, ChangedConfig)
+{
+	auto module = makeModule(taintedInput);
+	auto full = runFull(module);
+	runCached(module);
+
+	// Any edit of an annotation file the analysis depends on invalidates the whole cache
+	taintConfig.write(util::io::readFileIntoBuffer("taint.config")->getBuffer().str() + "# edited\n");
+	auto run = runCached(module);
+	EXPECT_EQ(full.report, run.report);
+	EXPECT_EQ(full.numIterations, run.numIterations);
+
+	// The cache now holds the results for the edited file
+	EXPECT_LT(runCached(module).numIterations, full.numIterations);
+}
+
+TEST_F(TaintCacheManagerTest, Rebuild)
+{
+	auto module = makeModule(taintedInput);
+	auto full = runFull(module);
+	runCached(makeModule(untaintedInput));
+
+	auto run = runCached(module, true);
+	EXPECT_EQ(full.report, run.report);
+	EXPECT_EQ(full.numIterations, run.numIterations);
+	EXPECT_LT(runCached(module).numIterations, full.numIterations);
+}
+
+TEST_F(TaintCacheManagerTest, MalformedCache)
+{
+	auto module = makeModule(taintedInput);
+	auto full = runFull(module);
+
+	for (auto content: { "", "garbage\n", "FUNC\tmain\n", "MODULE\tx\nENV\tctx\tvalue\t1\n" })
+	{
+		cacheFile.write(content);
+		auto run = runCached(module);
+		EXPECT_EQ(full.report, run.report) << content;
+		EXPECT_EQ(full.numIterations, run.numIterations) << content;
+	}
+
+	// A cache cut short while it was written
+	runCached(module);
+	auto cacheText = util::io::readFileIntoBuffer(cacheFile.getName())->getBuffer().str();
+	cacheFile.write(StringRef(cacheText).substr(0, cacheText.size() / 2));
+	auto run = runCached(module);
+	EXPECT_EQ(full.report, run.report);
+	EXPECT_GE(full.numIterations, run.numIterations);
+}
+
+}
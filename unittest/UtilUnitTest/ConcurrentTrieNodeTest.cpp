@@ -0,0 +1,132 @@
+#include "Util/DataStructure/ConcurrentTrieNode.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <random>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+using namespace util;
+
+namespace {
+
+class TestNode: public ConcurrentTrieNode<TestNode>
+{
+private:
+	unsigned key;
+	const TestNode* parent;
+public:
+	TestNode(unsigned k, const TestNode* p): key(k), parent(p) {}
+
+	unsigned getKey() const { return key; }
+	const TestNode* getParent() const { return parent; }
+};
+
+const unsigned numThreads = 8;
+
+// Every thread walks the same keys in its own order, so the threads race to insert each child while the lock-free lookups of the others probe tables that are being outgrown
+class ConcurrentTrieNodeTest: public ::testing::Test
+{
+protected:
+	TestNode root;
+	std::atomic<unsigned> numCreated;
+
+	ConcurrentTrieNodeTest(): root(0, nullptr), numCreated(0) {}
+	~ConcurrentTrieNodeTest() { root.releaseChildren(); }
+
+	const TestNode* getChild(const TestNode* node, unsigned key, std::size_t hash)
+	{
+		return node->getOrInsertChild(
+			hash,
+			[key] (const TestNode& child) { return child.getKey() == key; },
+			[this, node, key] { ++numCreated; return new TestNode(key, node); }
+		);
+	}
+
+	// Return the children each thread got for keys 0 to numKeys - 1, indexed by thread and then by key. Each child also gets a grandchild whose key is the child's modulo numGrandchildren
+	std::vector<std::vector<const TestNode*>> runThreads(unsigned numKeys, unsigned numGrandchildren, std::function<std::size_t(unsigned)> hashKey)
+	{
+		std::vector<std::vector<const TestNode*>> results(numThreads, std::vector<const TestNode*>(numKeys));
+		std::atomic<unsigned> numReady(0);
+
+		auto work = [&] (unsigned threadId)
+		{
+			std::vector<unsigned> keys(numKeys);
+			for (auto i = 0u; i < numKeys; ++i)
+				keys[i] = i;
+			std::shuffle(keys.begin(), keys.end(), std::mt19937(threadId));
+
+			// Start together to make the races as likely as possible
+			++numReady;
+			while (numReady.load() < numThreads)
+				std::this_thread::yield();
+
+			for (auto key: keys)
+			{
+				auto child = getChild(&root, key, hashKey(key));
+				auto grandchildKey = key % numGrandchildren;
+				getChild(child, grandchildKey, hashKey(grandchildKey));
+				results[threadId][key] = child;
+			}
+		};
+
+		std::vector<std::thread> threads;
+		for (auto i = 0u; i < numThreads; ++i)
+			threads.emplace_back(work, i);
+		for (auto& thread: threads)
+			thread.join();
+		return results;
+	}
+
+	void checkResults(const std::vector<std::vector<const TestNode*>>& results, unsigned numKeys, unsigned numGrandchildren)
+	{
+		for (auto key = 0u; key < numKeys; ++key)
+		{
+			auto child = results[0][key];
+			ASSERT_NE(nullptr, child);
+			EXPECT_EQ(key, child->getKey());
+			EXPECT_EQ(&root, child->getParent());
+			for (auto threadId = 1u; threadId < numThreads; ++threadId)
+				EXPECT_EQ(child, results[threadId][key]);
+		}
+
+		// Exactly one node was created for each child and each grandchild, and every one of them is reachable
+		EXPECT_EQ(2 * numKeys, numCreated.load());
+
+		std::unordered_set<const TestNode*> children;
+		root.forEachChild([&children] (const TestNode* child) { children.insert(child); });
+		EXPECT_EQ(numKeys, children.size());
+		for (auto child: children)
+		{
+			auto numGrandchildrenSeen = 0u;
+			child->forEachChild([&numGrandchildrenSeen, child, numGrandchildren] (const TestNode* grandchild)
+			{
+				EXPECT_EQ(child, grandchild->getParent());
+				EXPECT_EQ(child->getKey() % numGrandchildren, grandchild->getKey());
+				++numGrandchildrenSeen;
+			});
+			EXPECT_EQ(1u, numGrandchildrenSeen);
+		}
+	}
+};
+
+TEST_F(ConcurrentTrieNodeTest, ConcurrentInsertion)
+{
+	const unsigned numKeys = 4096;
+	auto results = runThreads(numKeys, 16, [] (unsigned key) { return std::hash<unsigned>()(key); });
+	checkResults(results, numKeys, 16);
+}
+
+TEST_F(ConcurrentTrieNodeTest, CollidingHashes)
+{
+	// Keys with equal hashes land on the same slot, so lookups walk long probe chains that span the copies made when a table grows
+	const unsigned numKeys = 512;
+	auto results = runThreads(numKeys, 4, [] (unsigned key) { return key % 7; });
+	checkResults(results, numKeys, 4);
+}
+
+}
@@ -0,0 +1,219 @@
+#include "Util/pcomb/pcomb.h"
+
+#include "gtest/gtest.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace pcomb;
+
+namespace {
+
+// Inputs that hit the edges of the scanners: the 16-byte blocks of scanWord(), extra chars right after a block, bytes at or above 0x80, and inputs that end in the middle of a token
+std::vector<std::string> getInputs()
+{
+	std::vector<std::string> inputs = {
+		"",
+		"a",
+		"_",
+		".",
+		"abc def",
+		"malloc 1 2",
+		"std.memcpy(",
+		"0123456789abcdef",
+		"0123456789abcdef.",
+		"0123456789abcde.f0123456789abcdef",
+		"0123456789abcdefghijklmnopqrstuvwxyz_ABCDEFGHIJKLMNOPQRSTUVWXYZ rest",
+		"abcdefghijklmno\x80pqr",
+		"\xc3\xa9t\xc3\xa9",
+		"123abc",
+		"42",
+		"-1",
+		"# a comment\nfoo",
+		"#\n",
+		"## nested # comment\r\nfoo",
+		"not a # comment\n",
+		" \t\n\v\f\rx",
+	};
+
+	// Random strings over an alphabet that mixes all the char classes
+	const std::string alphabet = "aZ_9.#- \t\n\r(\x80\xff";
+	std::mt19937 rng(0);
+	for (auto i = 0; i < 2000; ++i)
+	{
+		std::string input;
+		auto len = rng() % 48;
+		for (auto j = 0u; j < len; ++j)
+			input.push_back(alphabet[rng() % alphabet.size()]);
+		inputs.push_back(std::move(input));
+	}
+	return inputs;
+}
+
+// Both parsers must agree on whether the input matches, on the match, and on the rest of the input
+template <typename ParserA, typename ParserB>
+void expectSameParse(const ParserA& expected, const ParserB& actual, const std::string& input)
+{
+	// std::regex_search reads the raw buffer up to the null terminator, which std::string provides
+	auto expectedResult = expected.parse(llvm::StringRef(input));
+	auto actualResult = actual.parse(llvm::StringRef(input));
+	ASSERT_EQ(expectedResult.success(), actualResult.success()) << "input: \"" << input << "\"";
+	if (expectedResult.success())
+	{
+		EXPECT_EQ(expectedResult.getOutput(), actualResult.getOutput()) << "input: \"" << input << "\"";
+		EXPECT_EQ(expectedResult.getInputStream().getRawBuffer(), actualResult.getInputStream().getRawBuffer()) << "input: \"" << input << "\"";
+	}
+}
+
+TEST(ScanParserTest, IdentMatchesRegex)
+{
+	auto re = regex("[\\w\\.]+");
+	auto scanner = ident(".");
+	for (auto const& input: getInputs())
+		expectSameParse(re, scanner, input);
+
+	auto plainRe = regex("\\w+");
+	auto plainScanner = ident();
+	for (auto const& input: getInputs())
+		expectSameParse(plainRe, plainScanner, input);
+}
+
+TEST(ScanParserTest, IntegerMatchesRegex)
+{
+	auto re = regex("\\d+");
+	auto scanner = integer();
+	for (auto const& input: getInputs())
+		expectSameParse(re, scanner, input);
+}
+
+TEST(ScanParserTest, WhitespaceMatchesRegex)
+{
+	auto re = regex("[ \\t\\n\\v\\f\\r]+");
+	auto scanner = whitespace();
+	for (auto const& input: getInputs())
+		expectSameParse(re, scanner, input);
+}
+
+TEST(ScanParserTest, LineCommentMatchesRegex)
+{
+	// "." in a regex stops at '\r' as well as '\n', and the regex needs a newline at the end. lineComment() only stops at '\n' and takes a last line without one, so only compare inputs where these make no difference
+	auto re = regex("#.*\\n");
+	auto scanner = lineComment('#');
+	for (auto const& input: getInputs())
+	{
+		auto commentEnd = input.find('\n');
+		if (input.find('\r') < commentEnd || (!input.empty() && input[0] == '#' && commentEnd == std::string::npos))
+			continue;
+		expectSameParse(re, scanner, input);
+	}
+}
+
+TEST(ScanParserTest, LineCommentWithoutNewline)
+{
+	auto result = lineComment('#').parse(llvm::StringRef("# last line"));
+	ASSERT_TRUE(result.success());
+	EXPECT_EQ("# last line", result.getOutput());
+	EXPECT_TRUE(result.getInputStream().isEOF());
+
+	result = lineComment('#').parse(llvm::StringRef("# dos line\r\nnext"));
+	ASSERT_TRUE(result.success());
+	EXPECT_EQ("# dos line\r\n", result.getOutput());
+}
+
+TEST(ScanParserTest, ScannersStopAtTheEndOfTheInput)
+{
+	// The input is a slice of a longer buffer. Nothing past its end may be matched
+	std::string buffer = "abcdefghijklmnopqrstuvwxyz0123456789";
+	for (auto len = 0u; len <= buffer.size(); ++len)
+	{
+		auto input = llvm::StringRef(buffer.data(), len);
+		auto result = ident().parse(input);
+		ASSERT_EQ(len > 0, result.success());
+		if (len > 0)
+			EXPECT_EQ(input, result.getOutput());
+
+		auto digits = llvm::StringRef(buffer.data() + 26, len > 10 ? 10 : len);
+		auto intResult = integer().parse(digits);
+		ASSERT_EQ(!digits.empty(), intResult.success());
+		if (!digits.empty())
+			EXPECT_EQ(digits, intResult.getOutput());
+	}
+}
+
+// Counts how often the parser it wraps runs
+class CountingParser: public Parser<llvm::StringRef>
+{
+private:
+	IdentifierParser pa;
+	unsigned* count;
+public:
+	using OutputType = llvm::StringRef;
+	using ResultType = typename Parser<llvm::StringRef>::ResultType;
+
+	CountingParser(unsigned* c): pa(ident(".")), count(c) {}
+
+	ResultType parse(const InputStream& input) const override
+	{
+		++*count;
+		return pa.parse(input);
+	}
+};
+
+TEST(MemoParserTest, AlternativesShareThePrefix)
+{
+	unsigned count = 0;
+	auto name = memo(CountingParser(&count));
+	auto entry = alt(
+		rule(seq(name, token(str("ALLOC"))), [] (auto const&) { return 1; }),
+		rule(seq(name, token(str("COPY"))), [] (auto const&) { return 2; }),
+		rule(seq(name, token(str("EXIT"))), [] (auto const&) { return 3; })
+	);
+
+	auto result = entry.parse(llvm::StringRef("strdup EXIT"));
+	ASSERT_TRUE(result.success());
+	EXPECT_EQ(3, result.getOutput());
+	EXPECT_EQ(1u, count);
+
+	// The same result as without the memo
+	auto plainEntry = alt(
+		rule(seq(ident("."), token(str("ALLOC"))), [] (auto const&) { return 1; }),
+		rule(seq(ident("."), token(str("COPY"))), [] (auto const&) { return 2; }),
+		rule(seq(ident("."), token(str("EXIT"))), [] (auto const&) { return 3; })
+	);
+	for (auto input: { "strdup EXIT", "f COPY", "g ALLOC", "h FREE", "", "EXIT" })
+	{
+		auto memoResult = entry.parse(llvm::StringRef(input));
+		auto plainResult = plainEntry.parse(llvm::StringRef(input));
+		ASSERT_EQ(plainResult.success(), memoResult.success()) << input;
+		if (plainResult.success())
+			EXPECT_EQ(plainResult.getOutput(), memoResult.getOutput()) << input;
+	}
+}
+
+TEST(MemoParserTest, DifferentInputsAreParsedAgain)
+{
+	unsigned count = 0;
+	auto name = memo(CountingParser(&count));
+
+	std::string buffer = "first second";
+	auto whole = llvm::StringRef(buffer);
+	EXPECT_EQ("first", name.parse(whole).getOutput());
+	EXPECT_EQ(1u, count);
+	EXPECT_EQ("first", name.parse(whole).getOutput());
+	EXPECT_EQ(1u, count);
+
+	// Same start, different end
+	EXPECT_EQ("fir", name.parse(whole.substr(0, 3)).getOutput());
+	EXPECT_EQ(2u, count);
+
+	EXPECT_EQ("second", name.parse(whole.substr(6)).getOutput());
+	EXPECT_EQ(3u, count);
+
+	// A failure is remembered as well
+	EXPECT_FALSE(name.parse(whole.substr(5)).success());
+	EXPECT_FALSE(name.parse(whole.substr(5)).success());
+	EXPECT_EQ(4u, count);
+}
+
+}